@@ -0,0 +1,66 @@
+/*
+ *  ======== CERuntime.c ========
+ *  Initialize the host Codec Engine runtime.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Lock.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Processor.h>
+#include <ti/sdo/ce/osal/Queue.h>
+#include <ti/sdo/ce/osal/Sem.h>
+#include <ti/sdo/ce/osal/Thread.h>
+#include <ti/sdo/ce/alg/Algorithm.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/Server.h>
+#include <ti/sdo/ce/CERuntime.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static Int refCount = 0;
+
+/*
+ *  ======== CERuntime_exit ========
+ */
+Void CERuntime_exit(Void)
+{
+    pthread_mutex_lock(&mutex);
+    if (refCount > 0 && --refCount == 0) {
+        Algorithm_exit();
+        Processor_exit();
+        Comm_exit();
+        Memory_exit();
+        Thread_exit();
+        Sem_exit();
+        Lock_exit();
+        Queue_exit();
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+/*
+ *  ======== CERuntime_init ========
+ */
+Void CERuntime_init(Void)
+{
+    pthread_mutex_lock(&mutex);
+    if (refCount++ == 0) {
+        GT_init();
+
+        Queue_init();
+        Lock_init();
+        Sem_init();
+        Thread_init();
+        Memory_init();
+        Comm_init();
+        Processor_init();
+        Algorithm_init();
+
+        Engine_init();
+        Server_init();
+    }
+    pthread_mutex_unlock(&mutex);
+}
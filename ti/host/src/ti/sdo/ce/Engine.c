@@ -0,0 +1,1313 @@
+/*
+ *  ======== Engine.c ========
+ *  Host implementation of the Engine module.
+ *
+ *  Engines are described by the app's Engine_config.  An engine with a
+ *  remoteName has a server: opening it starts the in-process RMS (see
+ *  Processor_posix.c), and its algs run in node threads created through
+ *  RMS commands, reached through the algs' stubs.  Engines without one
+ *  run all their algs locally, in the caller's thread.
+ *
+ *  Engine_openShared() hands out one refcounted Engine_Obj per engine name
+ *  and procId.  An engine's RMS traffic is serialized by its rmsLock and
+ *  each node has its own queues, so threads may share the handle freely.
+ *  moduleLock is never held across an RMS round trip: the RMS thread
+ *  itself takes it when a node creation opens the local engine.  Threads
+ *  opening an engine another thread is still opening wait for its
+ *  Engine_Opening instead.
+ *
+ *  Each engine has a Memory account, the parent of those of its codec
+ *  instances (see visa.c), so that Engine_getMemUsage() sums the memory
+ *  of all of them.  A node's memory is charged by the RMS to the account
+ *  of the thread that creates it.
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Lock.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Processor.h>
+#include <ti/sdo/ce/osal/Queue.h>
+#include <ti/sdo/ce/osal/Sem.h>
+#include <ti/sdo/ce/node/node.h>
+#include <ti/sdo/ce/node/_node.h>
+#include <ti/sdo/ce/rms.h>
+#include <ti/sdo/ce/Server.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/visa.h>
+
+/*
+ *  ======== Engine_Obj ========
+ */
+typedef struct Engine_Obj {
+    Engine_Desc         *desc;
+    Processor_Handle    proc;       /* NULL: engine has no server */
+    Comm_Handle         toGppMsgq;  /* RMS replies arrive here */
+    Comm_Queue          toGppQueue;
+    Comm_Queue          toRmsQueue;
+    Lock_Handle         rmsLock;    /* serializes use of rmsMsg */
+    RMS_RmsMsg          *rmsMsg;
+    Engine_Error        lastError;
+    Int                 memAccount; /* parent of its instances' accounts */
+    Int                 refCount;   /* shared engines only */
+    String              procId;     /* shared engines only */
+    struct Engine_Obj   *next;      /* in sharedEngines */
+} Engine_Obj;
+
+/*
+ *  ======== Engine_NodeObj ========
+ */
+typedef struct Engine_NodeObj {
+    Engine_Obj          *engine;
+    RMS_Word            node;       /* RMS's handle for the node */
+    Comm_Queue          stdIn;      /* node's queue */
+    Comm_Handle         stdOutMsgq; /* node's replies arrive here */
+    Comm_Queue          stdOut;
+    UInt32              remoteVisa;
+} Engine_NodeObj;
+
+/*
+ *  ======== Engine_Opening ========
+ *  A shared engine Engine_open() is still opening, so that the threads
+ *  opening it meanwhile share the engine rather than open another.
+ */
+typedef struct Engine_Opening {
+    String              name;
+    String              procId;
+    Sem_Handle          done;       /* posted once per waiter */
+    Int                 numWaiting; /* the last one out frees the opening */
+    Engine_Obj          *engine;    /* NULL: the open failed with err */
+    Engine_Error        err;
+    struct Engine_Opening *next;    /* in openings */
+} Engine_Opening;
+
+/*
+ *  ======== Index ========
+ *  Open-addressed hash table from names to the engine or alg descriptors
+ *  carrying them; a NULL name marks an empty slot.
+ */
+typedef struct IndexEntry {
+    UInt32      uuid;       /* NODE_uuidFromName(name).data */
+    String      name;
+    Ptr         desc;
+} IndexEntry;
+
+typedef struct Index {
+    IndexEntry  *tab;       /* NULL: not built, scan the table instead */
+    UInt32      mask;       /* number of entries - 1 */
+} Index;
+
+Engine_Attrs Engine_ATTRS = {
+    NULL,       /* procId */
+};
+
+Engine_AlgCreateAttrs Engine_ALGCREATEATTRS = {
+    FALSE,      /* useExtHeap */
+    -1,         /* priority */
+};
+
+static RMS_Status callServer(Engine_Obj *engine, RMS_Word cmd);
+static Engine_AlgDesc *findAlg(Engine_Desc *desc, String name, String type);
+static Engine_Desc *findEngine(String name);
+static Engine_Error getError(RMS_Status status);
+static Bool indexCreate(Index *index, Int count);
+static Ptr indexFind(Index *index, String name);
+static Void indexInsert(Index *index, String name, Ptr desc);
+static Int nodeCall(Engine_NodeObj *node, Comm_Msg *msg);
+static Int nodeSend(Engine_NodeObj *node, Comm_Msg msg);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Lock_Handle moduleLock = NULL;
+static Lock_Handle localLock = NULL;        /* serializes opening it */
+static Engine_Handle localEngine = NULL;    /* set once, then only read */
+static Engine_Obj *sharedEngines = NULL;    /* protected by moduleLock */
+static Engine_Opening *openings = NULL;     /* protected by moduleLock */
+static Bool initialized = FALSE;
+static Index engineIndex = {NULL, 0};
+static Index *algIndex = NULL;  /* one per Engine_config.engineTab entry */
+
+/*
+ *  ======== Engine_call ========
+ */
+Int Engine_call(Engine_Node node, Comm_Msg *msg)
+{
+    ((NODE_Msg)*msg)->cmd.id = NODE_CCALL;
+
+    return (nodeCall(node, msg));
+}
+
+/*
+ *  ======== Engine_callAsync ========
+ */
+Int Engine_callAsync(Engine_Node node, Comm_Msg *msg)
+{
+    ((NODE_Msg)*msg)->cmd.id = NODE_CCALL;
+    Comm_setPriority(*msg, Comm_PRIORITYNORMAL);
+
+    return (nodeSend(node, *msg));
+}
+
+/*
+ *  ======== Engine_callPriority ========
+ */
+Int Engine_callPriority(Engine_Node node, Comm_Msg *msg, Int priority)
+{
+    Queue_Fifo early;       /* replies to calls sent before *msg */
+    Comm_Msg sent = *msg;
+    Comm_Msg reply;
+    Int status;
+
+    ((NODE_Msg)sent)->cmd.id = NODE_CCALL;
+    Comm_setPriority(sent, priority);
+
+    if ((status = nodeSend(node, sent)) != Engine_EOK) {
+        return (status);
+    }
+
+    Queue_fifoNew(&early);
+    while ((status = Engine_callWait(node, &reply, Comm_FOREVER)) ==
+        Engine_EOK && reply != sent) {
+        Queue_fifoPut(&early, reply);
+    }
+
+    /* put them back for Engine_callWait(), ahead of any that came later */
+    while ((reply = (Comm_Msg)Queue_fifoGet(&early)) != NULL) {
+        Comm_setPriority(reply, Comm_PRIORITYHIGH);
+        Comm_put(node->stdOut, reply);
+    }
+
+    return (status);
+}
+
+/*
+ *  ======== Engine_callWait ========
+ */
+Int Engine_callWait(Engine_Node node, Comm_Msg *msg, UInt timeout)
+{
+    switch (Comm_get(node->stdOut, msg, timeout)) {
+        case Comm_EOK:
+            return (Engine_EOK);
+
+        case Comm_ETIMEOUT:
+            return (Engine_ETIMEOUT);
+
+        default:
+            return (Engine_ERUNTIME);
+    }
+}
+
+/*
+ *  ======== Engine_close ========
+ */
+Void Engine_close(Engine_Handle engine)
+{
+    Engine_Obj **prev;
+
+    GT_1trace(curTrace, GT_ENTER, "Engine_close> Enter(engine=0x%lx)\n",
+        (IArg)engine);
+
+    if (engine == NULL) {
+        return;
+    }
+
+    /* a shared engine is only closed by its last user */
+    if (engine->procId != NULL) {
+        Lock_acquire(moduleLock);
+        if (--engine->refCount > 0) {
+            Lock_release(moduleLock);
+            return;
+        }
+        for (prev = &sharedEngines; *prev != engine; prev = &(*prev)->next) {
+        }
+        *prev = engine->next;
+        Lock_release(moduleLock);
+
+        free(engine->procId);
+    }
+
+    /* the engine's idle codec instances go with it */
+    VISA_flush(engine);
+
+    if (engine->rmsMsg != NULL) {
+        Comm_free((Comm_Msg)engine->rmsMsg);
+    }
+    if (engine->toGppMsgq != NULL) {
+        Comm_delete(engine->toGppMsgq);
+    }
+    if (engine->rmsLock != NULL) {
+        Lock_delete(engine->rmsLock);
+    }
+    if (engine->proc != NULL) {
+        Processor_delete(engine->proc);
+    }
+    Memory_deleteAccount(engine->memAccount);
+
+    free(engine);
+}
+
+/*
+ *  ======== Engine_createNode ========
+ */
+Engine_Node Engine_createNode(Engine_Handle engine, String name,
+    size_t msgSize, IALG_Params *nodeAttrs, Engine_AlgCreateAttrs *attrs)
+{
+    return (Engine_createNode2(engine, name, msgSize, nodeAttrs,
+        nodeAttrs == NULL ? 0 : nodeAttrs->size, attrs));
+}
+
+/*
+ *  ======== Engine_createNode2 ========
+ */
+Engine_Node Engine_createNode2(Engine_Handle engine, String name,
+    size_t msgSize, IALG_Params *nodeAttrs, Int nodeAttrsSize,
+    Engine_AlgCreateAttrs *attrs)
+{
+    Engine_NodeObj *node;
+    Engine_AlgDesc *alg;
+    RMS_CmdSetCreateNodeIn *in;
+    RMS_Status status;
+
+    GT_4trace(curTrace, GT_ENTER, "Engine_createNode2> Enter(engine=0x%lx, "
+        "name='%s', msgSize=%d, nodeAttrsSize=%d)\n", (IArg)engine, name,
+        (Int)msgSize, nodeAttrsSize);
+
+    if (attrs == NULL) {
+        attrs = &Engine_ALGCREATEATTRS;
+    }
+
+    if (engine->proc == NULL) {
+        engine->lastError = Engine_ENOSERVER;
+        return (NULL);
+    }
+
+    if ((alg = findAlg(engine->desc, name, NULL)) == NULL) {
+        engine->lastError = Engine_ENOTFOUND;
+        return (NULL);
+    }
+
+    if (nodeAttrsSize < 0 || nodeAttrsSize >
+        (Int)sizeof (engine->rmsMsg->cmdBuf.data.createNodeIn.argBuffer)) {
+        GT_1trace(curTrace, GT_7CLASS, "Engine_createNode2> "
+            "create params of %d bytes are too large\n", nodeAttrsSize);
+        engine->lastError = Engine_EINVAL;
+        return (NULL);
+    }
+
+    if ((node = (Engine_NodeObj *)calloc(1, sizeof (Engine_NodeObj))) ==
+            NULL) {
+        engine->lastError = Engine_ENOMEM;
+        return (NULL);
+    }
+    node->engine = engine;
+
+    if ((node->stdOutMsgq = Comm_create(NULL, &node->stdOut, NULL)) == NULL) {
+        free(node);
+        engine->lastError = Engine_ENOCOMM;
+        return (NULL);
+    }
+
+    Lock_acquire(engine->rmsLock);
+
+    in = &engine->rmsMsg->cmdBuf.data.createNodeIn;
+    in->uuid = alg->uuid;
+    in->gppQueue = node->stdOut;
+    in->nodePriority = attrs->priority;
+    in->nodeBlockingTimeout = (RMS_Word)-1;
+    in->argLength = nodeAttrsSize;
+    if (nodeAttrsSize > 0) {
+        memcpy(in->argBuffer, nodeAttrs, nodeAttrsSize);
+    }
+    in->rpcProtocolVersion = alg->rpcProtocolVersion;
+    in->useExtHeap = attrs->useExtHeap;
+    in->memAccount = Memory_getAccount();
+
+    if ((status = callServer(engine, RMS_CREATENODE)) != RMS_EOK) {
+        Lock_release(engine->rmsLock);
+        GT_2trace(curTrace, GT_7CLASS, "Engine_createNode2> "
+            "server failed to create '%s' (0x%x)\n", name, status);
+        Comm_delete(node->stdOutMsgq);
+        free(node);
+        engine->lastError = Engine_ECODECCREATE;
+        return (NULL);
+    }
+    node->node = engine->rmsMsg->cmdBuf.data.createNodeOut.node;
+    node->stdIn = engine->rmsMsg->cmdBuf.data.createNodeOut.nodeQueue;
+    node->remoteVisa = engine->rmsMsg->cmdBuf.data.createNodeOut.remoteVisa;
+
+    engine->rmsMsg->cmdBuf.data.startNodeIn.node = node->node;
+    if ((status = callServer(engine, RMS_STARTNODE)) != RMS_EOK) {
+        engine->rmsMsg->cmdBuf.data.deleteNodeIn.node = node->node;
+        callServer(engine, RMS_DELETENODE);
+        Lock_release(engine->rmsLock);
+        GT_2trace(curTrace, GT_7CLASS, "Engine_createNode2> "
+            "server failed to start '%s' (0x%x)\n", name, status);
+        Comm_delete(node->stdOutMsgq);
+        free(node);
+        engine->lastError = Engine_ECODECSTART;
+        return (NULL);
+    }
+
+    Lock_release(engine->rmsLock);
+
+    engine->lastError = Engine_EOK;
+
+    return (node);
+}
+
+/*
+ *  ======== Engine_ctrlNode ========
+ */
+Int Engine_ctrlNode(Engine_Node node, Comm_Msg *msg, Engine_Ctrl code)
+{
+    if (code != Engine_CEXIT) {
+        return (Engine_EINVAL);
+    }
+
+    ((NODE_Msg)*msg)->cmd.id = NODE_CEXIT;
+
+    return (nodeCall(node, msg));
+}
+
+/*
+ *  ======== Engine_deleteNode ========
+ */
+Void Engine_deleteNode(Engine_Node node)
+{
+    Engine_Obj *engine;
+    Comm_Msg msg;
+
+    GT_1trace(curTrace, GT_ENTER, "Engine_deleteNode> Enter(node=0x%lx)\n",
+        (IArg)node);
+
+    if (node == NULL) {
+        return;
+    }
+    engine = node->engine;
+
+    /* stop the node's thread, then have the server delete the node */
+    if (Comm_alloc(Engine_getMemId(engine), &msg, sizeof (NODE_MsgHeader)) ==
+            Comm_EOK) {
+        if (Engine_ctrlNode(node, &msg, Engine_CEXIT) == Engine_EOK) {
+            Comm_free(msg);
+        }
+    }
+
+    Lock_acquire(engine->rmsLock);
+    engine->rmsMsg->cmdBuf.data.deleteNodeIn.node = node->node;
+    if (callServer(engine, RMS_DELETENODE) != RMS_EOK) {
+        GT_1trace(curTrace, GT_7CLASS, "Engine_deleteNode> "
+            "server failed to delete node %d\n", node->node);
+    }
+    Lock_release(engine->rmsLock);
+
+    Comm_delete(node->stdOutMsgq);
+    free(node);
+}
+
+/*
+ *  ======== Engine_fwriteTrace ========
+ */
+Int Engine_fwriteTrace(Engine_Handle engine, String prefix, FILE *out)
+{
+    RMS_CmdSetGetTraceOut *traceOut;
+    Int count = 0;
+    Int size;
+
+    if (engine->proc == NULL) {
+        return (0);
+    }
+
+    Lock_acquire(engine->rmsLock);
+    traceOut = &engine->rmsMsg->cmdBuf.data.getTraceOut;
+    do {
+        engine->rmsMsg->cmdBuf.data.getTraceIn.curTime = GT_curTime();
+        if (callServer(engine, RMS_GETTRACE) != RMS_EOK) {
+            count = -1;
+            break;
+        }
+        size = traceOut->size;
+        if (size > 0) {
+            fprintf(out, "%s%.*s", prefix == NULL ? "" : prefix, size,
+                (Char *)traceOut->buf);
+            count += size;
+        }
+    } while (traceOut->avail > 0);
+    Lock_release(engine->rmsLock);
+
+    return (count);
+}
+
+/*
+ *  ======== Engine_getAlgInfo ========
+ */
+Engine_Error Engine_getAlgInfo(String name, Engine_AlgInfo *algInfo,
+    Int index)
+{
+    Engine_Desc *desc;
+    Engine_AlgDesc *alg;
+
+    if (algInfo->algInfoSize < (Int)sizeof (Engine_AlgInfo)) {
+        return (Engine_EINVAL);
+    }
+
+    if ((desc = findEngine(name)) == NULL) {
+        return (Engine_EEXIST);
+    }
+
+    if (index < 0 || index >= desc->numAlgs) {
+        return (Engine_ENOTFOUND);
+    }
+
+    alg = &desc->algTab[index];
+    algInfo->name = alg->name;
+    algInfo->typeTab = alg->typeTab;
+    algInfo->isLocal = alg->isLocal;
+
+    return (Engine_EOK);
+}
+
+/*
+ *  ======== Engine_getCodecClassConfig ========
+ */
+Ptr Engine_getCodecClassConfig(Engine_Handle engine, String name,
+    String type)
+{
+    Engine_AlgDesc *alg;
+
+    if ((alg = findAlg(engine->desc, name, type)) == NULL) {
+        return (NULL);
+    }
+
+    return (alg->codecClassConfig);
+}
+
+/*
+ *  ======== Engine_getConstName ========
+ */
+String Engine_getConstName(Engine_Handle engine, String name, String type)
+{
+    Engine_AlgDesc *alg;
+
+    if ((alg = findAlg(engine->desc, name, type)) == NULL) {
+        return (NULL);
+    }
+
+    return (alg->name);
+}
+
+/*
+ *  ======== Engine_getCpuLoad ========
+ */
+Int Engine_getCpuLoad(Engine_Handle engine)
+{
+    RMS_Status status;
+    Int load;
+
+    if (engine->proc == NULL) {
+        engine->lastError = Engine_ENOSERVER;
+        return (-1);
+    }
+
+    Lock_acquire(engine->rmsLock);
+    status = callServer(engine, RMS_GETCPUSTAT);
+    load = engine->rmsMsg->cmdBuf.data.getCpuStatOut.cpuLoad;
+    Lock_release(engine->rmsLock);
+
+    engine->lastError = getError(status);
+
+    return (status == RMS_EOK ? load : -1);
+}
+
+/*
+ *  ======== Engine_getEngine ========
+ */
+Engine_Handle Engine_getEngine(Engine_Node node)
+{
+    return (node->engine);
+}
+
+/*
+ *  ======== Engine_getFxns ========
+ */
+IALG_Fxns *Engine_getFxns(Engine_Handle engine, String name, String type,
+    Bool *isLocal, Ptr *idmaFxns, Ptr *iresFxns, Int *groupId)
+{
+    Engine_AlgDesc *alg;
+
+    if ((alg = findAlg(engine->desc, name, type)) == NULL) {
+        GT_2trace(curTrace, GT_7CLASS, "Engine_getFxns> "
+            "engine '%s' has no alg '%s'\n", engine->desc->name, name);
+        return (NULL);
+    }
+
+    *isLocal = alg->isLocal;
+    *idmaFxns = alg->idmaFxns;
+    *iresFxns = alg->iresFxns;
+    *groupId = alg->groupId;
+
+    return (alg->fxns);
+}
+
+/*
+ *  ======== Engine_getLastError ========
+ */
+Engine_Error Engine_getLastError(Engine_Handle engine)
+{
+    return (engine->lastError);
+}
+
+/*
+ *  ======== Engine_getLocalEngine ========
+ */
+Engine_Handle Engine_getLocalEngine(Void)
+{
+    Engine_Desc *desc;
+    Engine_Handle engine;
+    String name = Engine_config.localEngine;
+
+    /* once it's open, it stays open: no lock on the node creation path */
+    if ((engine = __atomic_load_n(&localEngine, __ATOMIC_ACQUIRE)) != NULL) {
+        return (engine);
+    }
+
+    Lock_acquire(localLock);
+    if (localEngine == NULL) {
+        if (name == NULL) {
+            /* default to the first engine without a server */
+            for (desc = Engine_config.engineTab; desc->name != NULL; desc++) {
+                if (desc->remoteName == NULL) {
+                    name = desc->name;
+                    break;
+                }
+            }
+        }
+        if (name != NULL) {
+            __atomic_store_n(&localEngine, Engine_open(name, NULL, NULL),
+                __ATOMIC_RELEASE);
+        }
+    }
+    engine = localEngine;
+    Lock_release(localLock);
+
+    return (engine);
+}
+
+/*
+ *  ======== Engine_getMemAccount ========
+ */
+Int Engine_getMemAccount(Engine_Handle engine)
+{
+    return (engine->memAccount);
+}
+
+/*
+ *  ======== Engine_getMemId ========
+ */
+Int Engine_getMemId(Engine_Handle engine)
+{
+    return (0);
+}
+
+/*
+ *  ======== Engine_getMemStat ========
+ */
+Engine_Error Engine_getMemStat(Server_Handle server, Int segNum,
+    Engine_MemStat *stat)
+{
+    Engine_Obj *engine = (Engine_Obj *)server;
+    RMS_CmdSetGetSegStatOut *out;
+    RMS_Status status;
+
+    Lock_acquire(engine->rmsLock);
+    engine->rmsMsg->cmdBuf.data.getSegStatIn.segId = segNum;
+    if ((status = callServer(engine, RMS_GETSEGSTAT)) == RMS_EOK) {
+        out = &engine->rmsMsg->cmdBuf.data.getSegStatOut;
+        strncpy(stat->name, (Char *)out->name, Engine_MAXSEGNAMELENGTH);
+        stat->name[Engine_MAXSEGNAMELENGTH] = '\0';
+        stat->base = out->base;
+        stat->size = out->size;
+        stat->used = out->used;
+        stat->maxBlockLen = out->maxBlockLen;
+    }
+    Lock_release(engine->rmsLock);
+
+    return (getError(status));
+}
+
+/*
+ *  ======== Engine_getMemUsage ========
+ */
+Engine_Error Engine_getMemUsage(Engine_Handle engine,
+    Memory_AccountStat *stat)
+{
+    if (!Memory_getAccountStat(engine->memAccount, stat)) {
+        engine->lastError = Engine_ENOTAVAIL;
+        return (Engine_ENOTAVAIL);
+    }
+
+    return (Engine_EOK);
+}
+
+/*
+ *  ======== Engine_getNodeFd ========
+ *  The descriptor of the queue the node's replies arrive on.
+ */
+Int Engine_getNodeFd(Engine_Node node)
+{
+    return (Comm_getFd(node->stdOutMsgq));
+}
+
+/*
+ *  ======== Engine_getNodeQueues ========
+ */
+Void Engine_getNodeQueues(Engine_Node node, Comm_Queue *stdIn,
+    Comm_Queue *stdOut)
+{
+    *stdIn = node->stdIn;
+    *stdOut = node->stdOut;
+}
+
+/*
+ *  ======== Engine_getNumAlgs ========
+ */
+Engine_Error Engine_getNumAlgs(String name, Int *numAlgs)
+{
+    Engine_Desc *desc;
+
+    if ((desc = findEngine(name)) == NULL) {
+        return (Engine_EEXIST);
+    }
+
+    *numAlgs = desc->numAlgs;
+
+    return (Engine_EOK);
+}
+
+/*
+ *  ======== Engine_getNumMemSegs ========
+ */
+Engine_Error Engine_getNumMemSegs(Server_Handle server, Int *numSegs)
+{
+    Engine_Obj *engine = (Engine_Obj *)server;
+    RMS_Status status;
+
+    Lock_acquire(engine->rmsLock);
+    if ((status = callServer(engine, RMS_GETNUMSEGS)) == RMS_EOK) {
+        *numSegs = engine->rmsMsg->cmdBuf.data.getNumSegsOut.numSegs;
+    }
+    Lock_release(engine->rmsLock);
+
+    return (getError(status));
+}
+
+/*
+ *  ======== Engine_getRemoteVisa ========
+ */
+UInt32 Engine_getRemoteVisa(Engine_Node node)
+{
+    return (node->remoteVisa);
+}
+
+/*
+ *  ======== Engine_getServer ========
+ *  An engine's server is represented by the engine itself.
+ */
+Server_Handle Engine_getServer(Engine_Handle engine)
+{
+    return (engine->proc == NULL ? NULL : (Server_Handle)engine);
+}
+
+/*
+ *  ======== Engine_getUsedMem ========
+ */
+UInt32 Engine_getUsedMem(Engine_Handle engine)
+{
+    UInt32 used = 0;
+
+    if (engine->proc == NULL) {
+        engine->lastError = Engine_ENOSERVER;
+        return (0);
+    }
+
+    Lock_acquire(engine->rmsLock);
+    if (callServer(engine, RMS_GETMEMSTAT) == RMS_EOK) {
+        used = engine->rmsMsg->cmdBuf.data.getMemStatOut.used;
+    }
+    Lock_release(engine->rmsLock);
+
+    return (used);
+}
+
+/*
+ *  ======== Engine_hasServer ========
+ */
+Bool Engine_hasServer(Engine_Handle engine)
+{
+    return (engine->proc != NULL);
+}
+
+/*
+ *  ======== Engine_init ========
+ */
+Void Engine_init(Void)
+{
+    Engine_Desc *desc;
+    Engine_AlgDesc *alg;
+    Index *index;
+    Int numEngines;
+
+    if (initialized) {
+        return;
+    }
+    initialized = TRUE;
+
+    GT_create(&curTrace, Engine_GTNAME);
+
+    moduleLock = Lock_create(NULL);
+    localLock = Lock_create(NULL);
+
+    /* fill in what the config left for us to compute */
+    for (desc = Engine_config.engineTab; desc->name != NULL; desc++) {
+        if (desc->numAlgs == 0 && desc->algTab != NULL) {
+            for (alg = desc->algTab; alg->name != NULL; alg++) {
+                desc->numAlgs++;
+            }
+        }
+        for (alg = desc->algTab; alg < desc->algTab + desc->numAlgs; alg++) {
+            if (alg->uuid.data == 0) {
+                alg->uuid = NODE_uuidFromName(alg->name);
+            }
+        }
+    }
+
+    /*
+     *  Build the lookup indices.  Lookups fall back to scanning the
+     *  tables if one can't be allocated.  The first of several entries
+     *  with the same name wins, as it did with the scans.
+     */
+    for (numEngines = 0; Engine_config.engineTab[numEngines].name != NULL;
+        numEngines++) {
+    }
+    if (indexCreate(&engineIndex, numEngines)) {
+        for (desc = Engine_config.engineTab; desc->name != NULL; desc++) {
+            indexInsert(&engineIndex, desc->name, desc);
+        }
+    }
+
+    algIndex = (Index *)calloc(numEngines > 0 ? numEngines : 1,
+        sizeof (Index));
+    for (desc = Engine_config.engineTab; algIndex != NULL &&
+        desc->name != NULL; desc++) {
+        index = &algIndex[desc - Engine_config.engineTab];
+        if (indexCreate(index, desc->numAlgs)) {
+            for (alg = desc->algTab; alg < desc->algTab + desc->numAlgs;
+                alg++) {
+                indexInsert(index, alg->name, alg);
+            }
+        }
+    }
+}
+
+/*
+ *  ======== Engine_open ========
+ */
+Engine_Handle Engine_open(String name, Engine_Attrs *attrs, Engine_Error *ec)
+{
+    Engine_Obj *engine;
+    Engine_Desc *desc;
+    Engine_Error err = Engine_EOK;
+    RMS_Status status;
+
+    GT_1trace(curTrace, GT_ENTER, "Engine_open> Enter(name='%s')\n", name);
+
+    if ((desc = findEngine(name)) == NULL) {
+        GT_1trace(curTrace, GT_7CLASS, "Engine_open> "
+            "no engine named '%s'\n", name);
+        err = Engine_EEXIST;
+        goto fail;
+    }
+
+    if ((engine = (Engine_Obj *)calloc(1, sizeof (Engine_Obj))) == NULL) {
+        err = Engine_ENOMEM;
+        goto fail;
+    }
+    engine->desc = desc;
+
+    /* without one, the engine's memory just isn't accounted */
+    engine->memAccount = Memory_createAccount(Memory_NOACCOUNT);
+
+    if (desc->remoteName != NULL) {
+        if ((engine->rmsLock = Lock_create(NULL)) == NULL) {
+            err = Engine_ENOMEM;
+            goto close;
+        }
+
+        if ((engine->proc = Processor_create(desc->remoteName, desc->linkCfg,
+            NULL)) == NULL) {
+            err = Engine_EDSPLOAD;
+            goto close;
+        }
+
+        if ((engine->toGppMsgq = Comm_create(NULL, &engine->toGppQueue,
+            NULL)) == NULL) {
+            err = Engine_ENOCOMM;
+            goto close;
+        }
+
+        if (Comm_locate(RMS_CMDQNAME, &engine->toRmsQueue) != Comm_EOK) {
+            err = Engine_ENOSERVER;
+            goto close;
+        }
+
+        if (Comm_alloc(Engine_getMemId(engine), (Comm_Msg *)&engine->rmsMsg,
+            sizeof (RMS_RmsMsg)) != Comm_EOK) {
+            err = Engine_ECOMALLOC;
+            goto close;
+        }
+
+        Lock_acquire(engine->rmsLock);
+        status = callServer(engine, RMS_GETVERS);
+        if (status != RMS_EOK ||
+            engine->rmsMsg->cmdBuf.data.getVersOut.rpcMajor !=
+            RMS_VERSION_MAJOR) {
+            err = Engine_EBADSERVER;
+        }
+        Lock_release(engine->rmsLock);
+
+        if (err != Engine_EOK) {
+            goto close;
+        }
+    }
+
+    if (ec != NULL) {
+        *ec = Engine_EOK;
+    }
+
+    return (engine);
+
+close:
+    Engine_close(engine);
+
+fail:
+    if (ec != NULL) {
+        *ec = err;
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== Engine_openShared ========
+ */
+Engine_Handle Engine_openShared(String name, Engine_Attrs *attrs,
+    Engine_Error *ec)
+{
+    Engine_Obj *engine;
+    Engine_Opening *opening;
+    Engine_Opening **prev;
+    Engine_Error err = Engine_EOK;
+    String procId;
+    Int i;
+
+    GT_1trace(curTrace, GT_ENTER, "Engine_openShared> Enter(name='%s')\n",
+        name);
+
+    if (attrs == NULL) {
+        attrs = &Engine_ATTRS;
+    }
+    procId = attrs->procId == NULL ? "" : attrs->procId;
+
+    Lock_acquire(moduleLock);
+
+    for (engine = sharedEngines; engine != NULL; engine = engine->next) {
+        if (strcmp(engine->desc->name, name) == 0 &&
+            strcmp(engine->procId, procId) == 0) {
+            engine->refCount++;
+            Lock_release(moduleLock);
+            goto exit;
+        }
+    }
+
+    /* if another thread is opening it, wait for that open to share it */
+    for (opening = openings; opening != NULL; opening = opening->next) {
+        if (strcmp(opening->name, name) == 0 &&
+            strcmp(opening->procId, procId) == 0) {
+            opening->numWaiting++;
+            Lock_release(moduleLock);
+
+            Sem_pend(opening->done, Sem_FOREVER);
+
+            /* the opener took our reference on the engine for us */
+            Lock_acquire(moduleLock);
+            engine = opening->engine;
+            err = opening->err;
+            if (--opening->numWaiting == 0) {
+                Sem_delete(opening->done);
+                free(opening);
+            }
+            Lock_release(moduleLock);
+            goto exit;
+        }
+    }
+
+    /* publish the opening before leaving moduleLock for the RMS */
+    if ((opening = (Engine_Opening *)calloc(1,
+        sizeof (Engine_Opening))) == NULL ||
+        (opening->done = Sem_create(0, 0)) == NULL) {
+        Lock_release(moduleLock);
+        free(opening);
+        err = Engine_ENOMEM;
+        goto exit;
+    }
+    opening->name = name;
+    opening->procId = procId;
+    opening->next = openings;
+    openings = opening;
+    Lock_release(moduleLock);
+
+    if ((engine = Engine_open(name, attrs, &err)) != NULL &&
+        (engine->procId = strdup(procId)) == NULL) {
+        Engine_close(engine);
+        engine = NULL;
+        err = Engine_ENOMEM;
+    }
+
+    Lock_acquire(moduleLock);
+    for (prev = &openings; *prev != opening; prev = &(*prev)->next) {
+    }
+    *prev = opening->next;
+
+    if (engine != NULL) {
+        engine->refCount = 1 + opening->numWaiting;
+        engine->next = sharedEngines;
+        sharedEngines = engine;
+    }
+
+    opening->engine = engine;
+    opening->err = err;
+    for (i = 0; i < opening->numWaiting; i++) {
+        Sem_post(opening->done);
+    }
+    if (opening->numWaiting == 0) {
+        Sem_delete(opening->done);
+        free(opening);
+    }
+    Lock_release(moduleLock);
+
+exit:
+    if (ec != NULL) {
+        *ec = engine != NULL ? Engine_EOK : err;
+    }
+
+    return (engine);
+}
+
+/*
+ *  ======== Engine_redefineHeap ========
+ */
+Engine_Error Engine_redefineHeap(Server_Handle server, String name,
+    Uint32 base, Uint32 size)
+{
+    Engine_Obj *engine = (Engine_Obj *)server;
+    RMS_CmdSetRedefineHeapIn *in;
+    RMS_Status status;
+
+    Lock_acquire(engine->rmsLock);
+    in = &engine->rmsMsg->cmdBuf.data.redefineHeapIn;
+    memset(in->name, 0, sizeof (in->name));
+    strncpy((Char *)in->name, name, RMS_MAXSEGNAMELENGTH);
+    in->base = base;
+    in->size = size;
+    status = callServer(engine, RMS_REDEFINEHEAP);
+    Lock_release(engine->rmsLock);
+
+    return (getError(status));
+}
+
+/*
+ *  ======== Engine_releaseTraceToken ========
+ */
+Bool Engine_releaseTraceToken(Server_Handle server)
+{
+    Engine_Obj *engine = (Engine_Obj *)server;
+    RMS_Status status;
+
+    Lock_acquire(engine->rmsLock);
+    status = callServer(engine, RMS_RELTRACETOKEN);
+    Lock_release(engine->rmsLock);
+
+    return (status == RMS_EOK);
+}
+
+/*
+ *  ======== Engine_requestTraceToken ========
+ */
+Engine_Error Engine_requestTraceToken(Server_Handle server)
+{
+    Engine_Obj *engine = (Engine_Obj *)server;
+    RMS_Status status;
+
+    Lock_acquire(engine->rmsLock);
+    status = callServer(engine, RMS_REQTRACETOKEN);
+    Lock_release(engine->rmsLock);
+
+    return (getError(status));
+}
+
+/*
+ *  ======== Engine_restoreHeap ========
+ */
+Engine_Error Engine_restoreHeap(Server_Handle server, String name)
+{
+    Engine_Obj *engine = (Engine_Obj *)server;
+    RMS_CmdSetRestoreHeapIn *in;
+    RMS_Status status;
+
+    Lock_acquire(engine->rmsLock);
+    in = (RMS_CmdSetRestoreHeapIn *)&engine->rmsMsg->cmdBuf.data.restoreHeapIn;
+    memset(in->name, 0, sizeof (in->name));
+    strncpy((Char *)in->name, name, RMS_MAXSEGNAMELENGTH);
+    status = callServer(engine, RMS_RESTOREHEAP);
+    Lock_release(engine->rmsLock);
+
+    return (getError(status));
+}
+
+/*
+ *  ======== Engine_setTrace ========
+ */
+Int Engine_setTrace(Engine_Handle engine, String mask)
+{
+    RMS_CmdSetSetTraceMaskIn *in;
+    RMS_Status status;
+
+    if (engine->proc == NULL) {
+        return (Engine_ENOSERVER);
+    }
+
+    Lock_acquire(engine->rmsLock);
+    in = &engine->rmsMsg->cmdBuf.data.setTraceMaskIn;
+    strncpy((Char *)in->traceMask, mask, RMS_MAXTRACEMASKSIZE - 1);
+    ((Char *)in->traceMask)[RMS_MAXTRACEMASKSIZE - 1] = '\0';
+    status = callServer(engine, RMS_SETTRACEMASK);
+    Lock_release(engine->rmsLock);
+
+    return (getError(status));
+}
+
+/*
+ *  ======== callServer ========
+ *  Send cmd, with the arguments already in engine->rmsMsg, to the RMS and
+ *  wait for its reply.  Must be called with engine->rmsLock held.
+ */
+static RMS_Status callServer(Engine_Obj *engine, RMS_Word cmd)
+{
+    Comm_Msg msg = (Comm_Msg)engine->rmsMsg;
+
+    engine->rmsMsg->cmdBuf.cmd = cmd;
+    engine->rmsMsg->cmdBuf.status = RMS_EFAIL;
+
+    Comm_setSrcQueue(msg, engine->toGppQueue);
+    if (Comm_put(engine->toRmsQueue, msg) != Comm_EOK) {
+        return (RMS_EFAIL);
+    }
+
+    if (Comm_get(engine->toGppQueue, &msg, Comm_FOREVER) != Comm_EOK) {
+        GT_1trace(curTrace, GT_7CLASS, "callServer> "
+            "no reply to RMS command 0x%x\n", cmd);
+        return (RMS_EFAIL);
+    }
+
+    return (engine->rmsMsg->cmdBuf.status);
+}
+
+/*
+ *  ======== findAlg ========
+ */
+static Engine_AlgDesc *findAlg(Engine_Desc *desc, String name, String type)
+{
+    Engine_AlgDesc *alg;
+    Index *index = NULL;
+    String *tp;
+
+    if (algIndex != NULL) {
+        index = &algIndex[desc - Engine_config.engineTab];
+    }
+
+    if (index != NULL && index->tab != NULL) {
+        alg = (Engine_AlgDesc *)indexFind(index, name);
+    }
+    else {
+        for (alg = desc->algTab; alg < desc->algTab + desc->numAlgs; alg++) {
+            if (strcmp(alg->name, name) == 0) {
+                break;
+            }
+        }
+        if (alg == desc->algTab + desc->numAlgs) {
+            alg = NULL;
+        }
+    }
+
+    if (alg == NULL || type == NULL || alg->typeTab == NULL) {
+        return (alg);
+    }
+
+    for (tp = alg->typeTab; *tp != NULL; tp++) {
+        if (strcmp(*tp, type) == 0) {
+            return (alg);
+        }
+    }
+    GT_2trace(curTrace, GT_7CLASS, "findAlg> "
+        "alg '%s' does not implement '%s'\n", name, type);
+
+    return (NULL);
+}
+
+/*
+ *  ======== findEngine ========
+ */
+static Engine_Desc *findEngine(String name)
+{
+    Engine_Desc *desc;
+
+    if (engineIndex.tab != NULL) {
+        return ((Engine_Desc *)indexFind(&engineIndex, name));
+    }
+
+    for (desc = Engine_config.engineTab; desc->name != NULL; desc++) {
+        if (strcmp(desc->name, name) == 0) {
+            return (desc);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== getError ========
+ */
+static Engine_Error getError(RMS_Status status)
+{
+    switch (status) {
+        case RMS_EOK:
+            return (Engine_EOK);
+
+        case RMS_EINVAL:
+            return (Engine_EINVAL);
+
+        case RMS_ENOTIMPL:
+            return (Engine_ENOTAVAIL);
+
+        case RMS_ERESOURCE:
+            return (Engine_EINUSE);
+
+        case RMS_ENOTFOUND:
+            return (Engine_ENOTFOUND);
+
+        case RMS_EWRONGSTATE:
+            return (Engine_EWRONGSTATE);
+
+        case RMS_EOUTOFMEMORY:
+            return (Engine_ENOMEM);
+
+        default:
+            return (Engine_ERUNTIME);
+    }
+}
+
+/*
+ *  ======== indexCreate ========
+ *  Allocate an index for count names, at most half full.
+ */
+static Bool indexCreate(Index *index, Int count)
+{
+    UInt32 size = 4;
+
+    while (size < (UInt32)count * 2) {
+        size <<= 1;
+    }
+
+    if ((index->tab = (IndexEntry *)calloc(size, sizeof (IndexEntry))) ==
+            NULL) {
+        GT_1trace(curTrace, GT_6CLASS, "indexCreate> "
+            "can't allocate an index of %d entries\n", (Int)size);
+        return (FALSE);
+    }
+    index->mask = size - 1;
+
+    return (TRUE);
+}
+
+/*
+ *  ======== indexFind ========
+ */
+static Ptr indexFind(Index *index, String name)
+{
+    IndexEntry *entry;
+    UInt32 uuid = NODE_uuidFromName(name).data;
+    UInt32 i;
+
+    for (i = uuid & index->mask; (entry = &index->tab[i])->name != NULL;
+        i = (i + 1) & index->mask) {
+        if (entry->uuid == uuid && strcmp(entry->name, name) == 0) {
+            return (entry->desc);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== indexInsert ========
+ */
+static Void indexInsert(Index *index, String name, Ptr desc)
+{
+    IndexEntry *entry;
+    UInt32 uuid = NODE_uuidFromName(name).data;
+    UInt32 i;
+
+    for (i = uuid & index->mask; (entry = &index->tab[i])->name != NULL;
+        i = (i + 1) & index->mask) {
+        if (entry->uuid == uuid && strcmp(entry->name, name) == 0) {
+            return;
+        }
+    }
+
+    entry->uuid = uuid;
+    entry->name = name;
+    entry->desc = desc;
+}
+
+/*
+ *  ======== nodeCall ========
+ *  Send *msg to node and wait for it to come back.
+ */
+static Int nodeCall(Engine_NodeObj *node, Comm_Msg *msg)
+{
+    Int status;
+
+    if ((status = nodeSend(node, *msg)) != Engine_EOK) {
+        return (status);
+    }
+
+    return (Engine_callWait(node, msg, Comm_FOREVER));
+}
+
+/*
+ *  ======== nodeSend ========
+ *  Send msg to node, with its reply directed to the node's stdOut.
+ */
+static Int nodeSend(Engine_NodeObj *node, Comm_Msg msg)
+{
+    Comm_setSrcQueue(msg, node->stdOut);
+
+    if (Comm_put(node->stdIn, msg) != Comm_EOK) {
+        return (Engine_ERUNTIME);
+    }
+
+    return (Engine_EOK);
+}
@@ -0,0 +1,176 @@
+/*
+ *  ======== Server.c ========
+ *  Host implementation of the Server module.  A Server_Handle is the
+ *  engine whose server it represents (see Engine_getServer()), so every
+ *  call is forwarded to the Engine.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/Server.h>
+
+static Server_Status getStatus(Engine_Error err);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Bool initialized = FALSE;
+
+/*
+ *  ======== Server_connectTrace ========
+ */
+Server_Status Server_connectTrace(Server_Handle server, Int *token)
+{
+    Engine_Error err;
+
+    GT_1trace(curTrace, GT_ENTER, "Server_connectTrace> Enter(server=0x%lx)\n",
+        (IArg)server);
+
+    if ((err = Engine_requestTraceToken(server)) == Engine_EOK) {
+        *token = 1;
+    }
+
+    return (getStatus(err));
+}
+
+/*
+ *  ======== Server_disconnectTrace ========
+ */
+Server_Status Server_disconnectTrace(Server_Handle server, Int token)
+{
+    GT_2trace(curTrace, GT_ENTER, "Server_disconnectTrace> "
+        "Enter(server=0x%lx, token=%d)\n", (IArg)server, token);
+
+    return (Engine_releaseTraceToken(server) ? Server_EOK : Server_EFAIL);
+}
+
+/*
+ *  ======== Server_fwriteTrace ========
+ */
+Int Server_fwriteTrace(Server_Handle server, String prefix, FILE *out)
+{
+    return (Engine_fwriteTrace((Engine_Handle)server, prefix, out));
+}
+
+/*
+ *  ======== Server_getCpuLoad ========
+ */
+Int Server_getCpuLoad(Server_Handle server)
+{
+    return (Engine_getCpuLoad((Engine_Handle)server));
+}
+
+/*
+ *  ======== Server_getMemStat ========
+ */
+Server_Status Server_getMemStat(Server_Handle server, Int segNum,
+    Server_MemStat *memStat)
+{
+    Engine_MemStat engineMemStat;
+    Engine_Error err;
+
+    GT_2trace(curTrace, GT_ENTER, "Server_getMemStat> "
+        "Enter(server=0x%lx, segNum=%d)\n", (IArg)server, segNum);
+
+    if ((err = Engine_getMemStat(server, segNum, &engineMemStat)) ==
+            Engine_EOK) {
+        strncpy(memStat->name, engineMemStat.name, Server_MAXSEGNAMELENGTH);
+        memStat->name[Server_MAXSEGNAMELENGTH] = '\0';
+        memStat->base = engineMemStat.base;
+        memStat->size = engineMemStat.size;
+        memStat->used = engineMemStat.used;
+        memStat->maxBlockLen = engineMemStat.maxBlockLen;
+    }
+
+    return (getStatus(err));
+}
+
+/*
+ *  ======== Server_getNumMemSegs ========
+ */
+Server_Status Server_getNumMemSegs(Server_Handle server, Int *numSegs)
+{
+    GT_1trace(curTrace, GT_ENTER, "Server_getNumMemSegs> "
+        "Enter(server=0x%lx)\n", (IArg)server);
+
+    return (getStatus(Engine_getNumMemSegs(server, numSegs)));
+}
+
+/*
+ *  ======== Server_init ========
+ */
+Void Server_init(Void)
+{
+    if (!initialized) {
+        initialized = TRUE;
+        GT_create(&curTrace, Server_GTNAME);
+    }
+}
+
+/*
+ *  ======== Server_redefineHeap ========
+ */
+Server_Status Server_redefineHeap(Server_Handle server, String name,
+    Uint32 base, Uint32 size)
+{
+    GT_4trace(curTrace, GT_ENTER, "Server_redefineHeap> Enter(server=0x%lx, "
+        "name='%s', base=0x%lx, size=0x%lx)\n", (IArg)server, name,
+        (IArg)base, (IArg)size);
+
+    return (getStatus(Engine_redefineHeap(server, name, base, size)));
+}
+
+/*
+ *  ======== Server_restoreHeap ========
+ */
+Server_Status Server_restoreHeap(Server_Handle server, String name)
+{
+    GT_2trace(curTrace, GT_ENTER, "Server_restoreHeap> Enter(server=0x%lx, "
+        "name='%s')\n", (IArg)server, name);
+
+    return (getStatus(Engine_restoreHeap(server, name)));
+}
+
+/*
+ *  ======== Server_setTrace ========
+ */
+Int Server_setTrace(Server_Handle server, String mask)
+{
+    return (Engine_setTrace((Engine_Handle)server, mask));
+}
+
+/*
+ *  ======== getStatus ========
+ */
+static Server_Status getStatus(Engine_Error err)
+{
+    switch (err) {
+        case Engine_EOK:
+            return (Server_EOK);
+
+        case Engine_ENOSERVER:
+            return (Server_ENOSERVER);
+
+        case Engine_ENOMEM:
+            return (Server_ENOMEM);
+
+        case Engine_EINVAL:
+            return (Server_EINVAL);
+
+        case Engine_EWRONGSTATE:
+            return (Server_EWRONGSTATE);
+
+        case Engine_EINUSE:
+            return (Server_EINUSE);
+
+        case Engine_ENOTFOUND:
+            return (Server_ENOTFOUND);
+
+        case Engine_ERUNTIME:
+            return (Server_ERUNTIME);
+
+        default:
+            return (Server_EFAIL);
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ *  ======== Algorithm.h ========
+ *  Engine-side management of local xDAIS algorithm instances.
+ */
+#ifndef ti_sdo_ce_alg_Algorithm_
+#define ti_sdo_ce_alg_Algorithm_
+
+#include <ti/xdais/ialg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Algorithm_GTNAME "ti.sdo.ce.alg.Algorithm"
+
+/* number of scratch groups; groupIds must be in [0, Algorithm_MAXGROUPS) */
+#define Algorithm_MAXGROUPS 20
+
+/*
+ *  ======== Algorithm_Handle ========
+ */
+typedef struct Algorithm_Obj *Algorithm_Handle;
+
+/*
+ *  ======== Algorithm_Attrs ========
+ */
+typedef struct Algorithm_Attrs {
+    Int     groupId;    /* scratch group; -1: none */
+    Bool    useExtHeap; /* ignored on the host; all memory is contiguous */
+} Algorithm_Attrs;
+
+extern Algorithm_Attrs Algorithm_ATTRS;     /* default attrs */
+
+/*
+ *  ======== Algorithm_activate ========
+ *  Acquire the instance's scratch group and activate it.  Every
+ *  Algorithm_activate() must be paired with an Algorithm_deactivate()
+ *  from the same thread.
+ */
+extern Void Algorithm_activate(Algorithm_Handle alg);
+
+/*
+ *  ======== Algorithm_create ========
+ *  Create an instance of the algorithm fxns.  idmaFxns and iresFxns must
+ *  be NULL; the host has no DMA or resource managers.
+ */
+extern Algorithm_Handle Algorithm_create(IALG_Fxns *fxns, Ptr idmaFxns,
+    Ptr iresFxns, IALG_Params *params, Algorithm_Attrs *attrs);
+
+/*
+ *  ======== Algorithm_deactivate ========
+ *  Release the instance's scratch group.  The instance itself is only
+ *  deactivated when another instance of its group is activated, or when
+ *  it is deleted.
+ */
+extern Void Algorithm_deactivate(Algorithm_Handle alg);
+
+/*
+ *  ======== Algorithm_delete ========
+ */
+extern Void Algorithm_delete(Algorithm_Handle alg);
+
+/*
+ *  ======== Algorithm_getAlgHandle ========
+ */
+extern IALG_Handle Algorithm_getAlgHandle(Algorithm_Handle alg);
+
+/*
+ *  ======== Algorithm_init ========
+ */
+extern Bool Algorithm_init(Void);
+
+/*
+ *  ======== Algorithm_exit ========
+ */
+extern Void Algorithm_exit(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
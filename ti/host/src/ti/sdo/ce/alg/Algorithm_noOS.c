@@ -0,0 +1,223 @@
+/*
+ *  ======== Algorithm_noOS.c ========
+ *  Algorithm implementation for targets without DMA or resource managers.
+ *
+ *  Instances that share a scratch group may not run concurrently, so each
+ *  group has a lock that is held from Algorithm_activate() until the
+ *  matching Algorithm_deactivate().
+ *
+ *  Deactivation is lazy: an instance stays active after
+ *  Algorithm_deactivate(), and is only deactivated when another instance
+ *  of its group is activated or when it is deleted.  An instance that
+ *  keeps being called back to back, the common case of a channel's codec
+ *  processing frame after frame, is activated once instead of per call.
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Lock.h>
+#include <ti/sdo/ce/alg/alg.h>
+#include <ti/sdo/ce/alg/Algorithm.h>
+
+typedef struct Algorithm_Obj {
+    IALG_Handle     alg;
+    Int             groupId;
+    Bool            isActive;   /* groupId < 0 only; see activeAlgs */
+} Algorithm_Obj;
+
+Algorithm_Attrs Algorithm_ATTRS = {
+    -1,         /* groupId */
+    FALSE,      /* useExtHeap */
+};
+
+static Void deactivate(Algorithm_Obj *alg);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Lock_Handle groupLocks[Algorithm_MAXGROUPS];
+static Algorithm_Obj *activeAlgs[Algorithm_MAXGROUPS];  /* under groupLocks */
+static Int refCount = 0;
+
+/*
+ *  ======== Algorithm_activate ========
+ */
+Void Algorithm_activate(Algorithm_Handle alg)
+{
+    GT_1trace(curTrace, GT_ENTER, "Algorithm_activate> Enter(alg=0x%lx)\n",
+        (IArg)alg);
+
+    if (alg->groupId < 0) {
+        if (!alg->isActive) {
+            ALG_activate(alg->alg);
+            alg->isActive = TRUE;
+        }
+        return;
+    }
+
+    Lock_acquire(groupLocks[alg->groupId]);
+
+    /* the group's scratch memory may still hold another instance's state */
+    if (activeAlgs[alg->groupId] != alg) {
+        if (activeAlgs[alg->groupId] != NULL) {
+            ALG_deactivate(activeAlgs[alg->groupId]->alg);
+        }
+        ALG_activate(alg->alg);
+        activeAlgs[alg->groupId] = alg;
+    }
+}
+
+/*
+ *  ======== Algorithm_create ========
+ */
+Algorithm_Handle Algorithm_create(IALG_Fxns *fxns, Ptr idmaFxns,
+    Ptr iresFxns, IALG_Params *params, Algorithm_Attrs *attrs)
+{
+    Algorithm_Obj *pObject;
+
+    GT_4trace(curTrace, GT_ENTER, "Algorithm_create> Enter(fxns=0x%lx, "
+        "idmaFxns=0x%lx, iresFxns=0x%lx, params=0x%lx)\n", (IArg)fxns,
+        (IArg)idmaFxns, (IArg)iresFxns, (IArg)params);
+
+    if (attrs == NULL) {
+        attrs = &Algorithm_ATTRS;
+    }
+
+    if (idmaFxns != NULL || iresFxns != NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "Algorithm_create> "
+            "algs requiring DMA or IRES resources are not supported\n");
+        return (NULL);
+    }
+
+    if (attrs->groupId >= Algorithm_MAXGROUPS) {
+        GT_2trace(curTrace, GT_7CLASS, "Algorithm_create> "
+            "groupId %d is out of range [0, %d)\n", attrs->groupId,
+            Algorithm_MAXGROUPS);
+        return (NULL);
+    }
+
+    if ((pObject = (Algorithm_Obj *)malloc(sizeof (Algorithm_Obj))) == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "Algorithm_create> "
+            "Memory allocation failed\n");
+        return (NULL);
+    }
+    pObject->groupId = attrs->groupId;
+    pObject->isActive = FALSE;
+
+    if ((pObject->alg = ALG_create(fxns, NULL, params)) == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "Algorithm_create> "
+            "Algorithm creation failed\n");
+        free(pObject);
+        return (NULL);
+    }
+
+    GT_1trace(curTrace, GT_ENTER, "Algorithm_create> return (0x%lx)\n",
+        (IArg)pObject);
+
+    return (pObject);
+}
+
+/*
+ *  ======== Algorithm_deactivate ========
+ */
+Void Algorithm_deactivate(Algorithm_Handle alg)
+{
+    GT_1trace(curTrace, GT_ENTER, "Algorithm_deactivate> Enter(alg=0x%lx)\n",
+        (IArg)alg);
+
+    /* alg stays active until another instance of its group needs to be */
+    if (alg->groupId >= 0) {
+        Lock_release(groupLocks[alg->groupId]);
+    }
+}
+
+/*
+ *  ======== Algorithm_delete ========
+ */
+Void Algorithm_delete(Algorithm_Handle alg)
+{
+    GT_1trace(curTrace, GT_ENTER, "Algorithm_delete> Enter(alg=0x%lx)\n",
+        (IArg)alg);
+
+    if (alg != NULL) {
+        if (alg->alg != NULL) {
+            deactivate(alg);
+            ALG_delete(alg->alg);
+        }
+        free(alg);
+    }
+}
+
+/*
+ *  ======== Algorithm_getAlgHandle ========
+ */
+IALG_Handle Algorithm_getAlgHandle(Algorithm_Handle alg)
+{
+    return (alg->alg);
+}
+
+/*
+ *  ======== Algorithm_init ========
+ */
+Bool Algorithm_init(Void)
+{
+    Int i;
+
+    if (refCount++ == 0) {
+        GT_create(&curTrace, Algorithm_GTNAME);
+
+        ALG_init();
+
+        for (i = 0; i < Algorithm_MAXGROUPS; i++) {
+            if ((groupLocks[i] = Lock_create(NULL)) == NULL) {
+                while (--i >= 0) {
+                    Lock_delete(groupLocks[i]);
+                }
+                refCount--;
+                return (FALSE);
+            }
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Algorithm_exit ========
+ */
+Void Algorithm_exit(Void)
+{
+    Int i;
+
+    if (--refCount == 0) {
+        for (i = 0; i < Algorithm_MAXGROUPS; i++) {
+            Lock_delete(groupLocks[i]);
+            groupLocks[i] = NULL;
+            activeAlgs[i] = NULL;
+        }
+
+        ALG_exit();
+    }
+}
+
+/*
+ *  ======== deactivate ========
+ *  Complete alg's pending deactivation, if any.
+ */
+static Void deactivate(Algorithm_Obj *alg)
+{
+    if (alg->groupId < 0) {
+        if (alg->isActive) {
+            ALG_deactivate(alg->alg);
+            alg->isActive = FALSE;
+        }
+        return;
+    }
+
+    Lock_acquire(groupLocks[alg->groupId]);
+    if (activeAlgs[alg->groupId] == alg) {
+        ALG_deactivate(alg->alg);
+        activeAlgs[alg->groupId] = NULL;
+    }
+    Lock_release(groupLocks[alg->groupId]);
+}
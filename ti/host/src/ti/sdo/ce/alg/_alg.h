@@ -0,0 +1,31 @@
+/*
+ *  ======== _alg.h ========
+ *  Internal memory management functions of the ALG module.
+ */
+#ifndef _ALG_
+#define _ALG_
+
+#include <ti/xdais/ialg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *  ======== _ALG_allocMemory ========
+ *  Allocate (zeroed) memory for each of the n records in memTab.
+ *  Returns FALSE, with nothing allocated, if any allocation fails.
+ */
+extern Bool _ALG_allocMemory(IALG_MemRec *memTab, Int n);
+
+/*
+ *  ======== _ALG_freeMemory ========
+ *  Free the memory allocated by _ALG_allocMemory().
+ */
+extern Void _ALG_freeMemory(IALG_MemRec *memTab, Int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
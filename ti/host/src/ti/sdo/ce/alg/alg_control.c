@@ -0,0 +1,21 @@
+/*
+ *  ======== alg_control.c ========
+ *  ALG_control implementation.  This is common to all implementations
+ *  of the ALG module.
+ */
+#include <xdc/std.h>
+
+#include <ti/sdo/ce/alg/alg.h>
+#include <ti/xdais/ialg.h>
+
+/*
+ *  ======== ALG_control ========
+ */
+Int ALG_control(ALG_Handle alg, IALG_Cmd cmd, IALG_Status *statusPtr)
+{
+    if (alg && alg->fxns->algControl) {
+        return (alg->fxns->algControl(alg, cmd, statusPtr));
+    }
+
+    return (IALG_EFAIL);
+}
@@ -0,0 +1,74 @@
+/*
+ *  ======== alg_create.c ========
+ *  This file contains a simple implementation of the ALG_create API
+ *  operation.
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+
+#include <ti/sdo/ce/alg/alg.h>
+#include <ti/sdo/ce/alg/_alg.h>
+#include <ti/xdais/ialg.h>
+
+/*
+ *  ======== ALG_create ========
+ */
+ALG_Handle ALG_create(IALG_Fxns *fxns, IALG_Handle p, IALG_Params *params)
+{
+    IALG_MemRec *memTab;
+    Int n;
+    ALG_Handle alg;
+    IALG_Fxns *fxnsPtr;
+
+    if (fxns != NULL) {
+        n = fxns->algNumAlloc != NULL ? fxns->algNumAlloc() : IALG_DEFMEMRECS;
+
+        if ((memTab = (IALG_MemRec *)malloc(n * sizeof (IALG_MemRec)))) {
+
+            n = fxns->algAlloc(params, &fxnsPtr, memTab);
+            if (n <= 0) {
+                free(memTab);
+                return (NULL);
+            }
+
+            if (_ALG_allocMemory(memTab, n)) {
+                alg = (IALG_Handle)memTab[0].base;
+                alg->fxns = fxns;
+                if (fxns->algInit(alg, memTab, p, params) == IALG_EOK) {
+                    free(memTab);
+                    return (alg);
+                }
+                fxns->algFree(alg, memTab);
+                _ALG_freeMemory(memTab, n);
+            }
+
+            free(memTab);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== ALG_delete ========
+ */
+Void ALG_delete(ALG_Handle alg)
+{
+    IALG_MemRec *memTab;
+    Int n;
+    IALG_Fxns *fxns;
+
+    if (alg != NULL && alg->fxns != NULL) {
+        fxns = alg->fxns;
+        n = fxns->algNumAlloc != NULL ? fxns->algNumAlloc() : IALG_DEFMEMRECS;
+
+        if ((memTab = (IALG_MemRec *)malloc(n * sizeof (IALG_MemRec)))) {
+            memTab[0].base = alg;
+            n = fxns->algFree(alg, memTab);
+            _ALG_freeMemory(memTab, n);
+
+            free(memTab);
+        }
+    }
+}
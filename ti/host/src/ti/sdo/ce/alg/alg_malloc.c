@@ -0,0 +1,90 @@
+/*
+ *  ======== alg_malloc.c ========
+ *  This module implements an algorithm memory management "policy" in which
+ *  no memory is shared among algorithm objects.  Memory is, however,
+ *  reclaimed when objects are deleted.
+ *
+ *  All memory is allocated from the contiguous heap, as it is on the
+ *  target, so that algorithm buffers can be handed to "hardware" (and
+ *  translated by Memory_getBufferPhysicalAddress()) like any other.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/alg/alg.h>
+#include <ti/sdo/ce/alg/_alg.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/xdais/ialg.h>
+
+/*
+ *  ======== ALG_activate ========
+ */
+Void ALG_activate(ALG_Handle alg)
+{
+    /* restore all persistent shared memory */
+    if (alg->fxns->algActivate != NULL) {
+        alg->fxns->algActivate(alg);
+    }
+}
+
+/*
+ *  ======== ALG_deactivate ========
+ */
+Void ALG_deactivate(ALG_Handle alg)
+{
+    /* save all persistent shared memory */
+    if (alg->fxns->algDeactivate != NULL) {
+        alg->fxns->algDeactivate(alg);
+    }
+}
+
+/*
+ *  ======== ALG_exit ========
+ */
+Void ALG_exit(Void)
+{
+}
+
+/*
+ *  ======== ALG_init ========
+ */
+Void ALG_init(Void)
+{
+}
+
+/*
+ *  ======== _ALG_allocMemory ========
+ */
+Bool _ALG_allocMemory(IALG_MemRec memTab[], Int n)
+{
+    Int i;
+
+    for (i = 0; i < n; i++) {
+        memTab[i].base = Memory_contigAlloc(memTab[i].size,
+            memTab[i].alignment > 0 ? (UInt)memTab[i].alignment :
+            Memory_DEFAULTALIGNMENT);
+
+        if (memTab[i].base == NULL) {
+            _ALG_freeMemory(memTab, i);
+            return (FALSE);
+        }
+        memset(memTab[i].base, 0, memTab[i].size);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== _ALG_freeMemory ========
+ */
+Void _ALG_freeMemory(IALG_MemRec memTab[], Int n)
+{
+    Int i;
+
+    for (i = 0; i < n; i++) {
+        if (memTab[i].base != NULL) {
+            Memory_contigFree(memTab[i].base, memTab[i].size);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ *  ======== auddec1.c ========
+ *  The xDM IAUDDEC1 Audio Decoder API.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/xdais/dm/iauddec1.h>
+
+#include <ti/sdo/ce/audio1/auddec1.h>
+#include <ti/sdo/ce/audio1/_auddec1.h>
+
+/*
+ *  ======== AUDDEC1_control ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* audio decoders (both high and low complexity
+ *  decoders are envoked using this method).
+ */
+XDAS_Int32 AUDDEC1_control(AUDDEC1_Handle handle, AUDDEC1_Cmd id,
+    AUDDEC1_DynamicParams *dynParams, AUDDEC1_Status *status)
+{
+    XDAS_Int32 retVal = AUDDEC1_EFAIL;
+    IAUDDEC1_Fxns *fxns;
+    IAUDDEC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IAUDDEC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->control(alg, id, dynParams, status);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== AUDDEC1_create ========
+ */
+AUDDEC1_Handle AUDDEC1_create(Engine_Handle engine, String name,
+    AUDDEC1_Params *params)
+{
+    return ((AUDDEC1_Handle)VISA_create(engine, name, (IALG_Params *)params,
+        sizeof (_AUDDEC1_Msg), "ti.sdo.ce.audio1.IAUDDEC1"));
+}
+
+/*
+ *  ======== AUDDEC1_delete ========
+ */
+Void AUDDEC1_delete(AUDDEC1_Handle handle)
+{
+    VISA_delete((VISA_Handle)handle);
+}
+
+/*
+ *  ======== AUDDEC1_process ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* audio decoders (both high and low complexity
+ *  decoders are envoked using this method).
+ */
+XDAS_Int32 AUDDEC1_process(AUDDEC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDDEC1_InArgs *inArgs, AUDDEC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal = AUDDEC1_EFAIL;
+    IAUDDEC1_Fxns *fxns;
+    IAUDDEC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IAUDDEC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->process(alg, inBufs, outBufs, inArgs, outArgs);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== AUDDEC1_release ========
+ *  Reset the codec, so that it is ready for its next user, and park it
+ *  for reuse.  A codec that can't be reset is simply deleted.
+ */
+Void AUDDEC1_release(AUDDEC1_Handle handle)
+{
+    AUDDEC1_DynamicParams dynParams;
+    AUDDEC1_Status status;
+
+    if (handle == NULL) {
+        return;
+    }
+
+    memset(&dynParams, 0, sizeof (dynParams));
+    dynParams.size = sizeof (dynParams);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+
+    if (AUDDEC1_control(handle, XDM_RESET, &dynParams, &status) ==
+            AUDDEC1_EOK) {
+        VISA_release((VISA_Handle)handle);
+    }
+    else {
+        VISA_delete((VISA_Handle)handle);
+    }
+}
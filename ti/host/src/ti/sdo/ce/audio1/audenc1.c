@@ -0,0 +1,117 @@
+/*
+ *  ======== audenc1.c ========
+ *  The xDM IAUDENC1 Audio Encoder API.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/xdais/dm/iaudenc1.h>
+
+#include <ti/sdo/ce/audio1/audenc1.h>
+#include <ti/sdo/ce/audio1/_audenc1.h>
+
+/*
+ *  ======== AUDENC1_control ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* audio encoders (both high and low complexity
+ *  encoders are envoked using this method).
+ */
+XDAS_Int32 AUDENC1_control(AUDENC1_Handle handle, AUDENC1_Cmd id,
+    AUDENC1_DynamicParams *dynParams, AUDENC1_Status *status)
+{
+    XDAS_Int32 retVal = AUDENC1_EFAIL;
+    IAUDENC1_Fxns *fxns;
+    IAUDENC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IAUDENC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->control(alg, id, dynParams, status);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== AUDENC1_create ========
+ */
+AUDENC1_Handle AUDENC1_create(Engine_Handle engine, String name,
+    AUDENC1_Params *params)
+{
+    return ((AUDENC1_Handle)VISA_create(engine, name, (IALG_Params *)params,
+        sizeof (_AUDENC1_Msg), "ti.sdo.ce.audio1.IAUDENC1"));
+}
+
+/*
+ *  ======== AUDENC1_delete ========
+ */
+Void AUDENC1_delete(AUDENC1_Handle handle)
+{
+    VISA_delete((VISA_Handle)handle);
+}
+
+/*
+ *  ======== AUDENC1_process ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* audio encoders (both high and low complexity
+ *  encoders are envoked using this method).
+ */
+XDAS_Int32 AUDENC1_process(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDENC1_InArgs *inArgs, AUDENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal = AUDENC1_EFAIL;
+    IAUDENC1_Fxns *fxns;
+    IAUDENC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IAUDENC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->process(alg, inBufs, outBufs, inArgs, outArgs);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== AUDENC1_release ========
+ *  Reset the codec, so that it is ready for its next user, and park it
+ *  for reuse.  A codec that can't be reset is simply deleted.
+ */
+Void AUDENC1_release(AUDENC1_Handle handle)
+{
+    AUDENC1_DynamicParams dynParams;
+    AUDENC1_Status status;
+
+    if (handle == NULL) {
+        return;
+    }
+
+    memset(&dynParams, 0, sizeof (dynParams));
+    dynParams.size = sizeof (dynParams);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+
+    if (AUDENC1_control(handle, XDM_RESET, &dynParams, &status) ==
+            AUDENC1_EOK) {
+        VISA_release((VISA_Handle)handle);
+    }
+    else {
+        VISA_delete((VISA_Handle)handle);
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ *  ======== audenc1_skel.c ========
+ *  This file contains the implemenation of the SKEL interface for the
+ *  audio encoder class of algorithms.
+ *
+ *  These functions are the "server-side" of the the stubs defined in
+ *  audenc1_stubs.c
+ */
+#include <xdc/std.h>
+
+#include <ti/sdo/ce/skel.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include <ti/sdo/ce/audio1/audenc1.h>
+#include <ti/sdo/ce/audio1/_audenc1.h>
+
+static Bool argsFit(VISA_Msg msg, XDAS_Int32 *size);
+static Bool framesFit(_AUDENC1_Msg *msg);
+static XDAS_Int32 processFrame(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs);
+static Void unmarshallBufs(XDM1_BufDesc *bufs);
+static Void writebackBufs(XDM1_BufDesc *bufs);
+
+/*
+ *  ======== call ========
+ */
+static VISA_Status call(VISA_Handle visaHandle, VISA_Msg visaMsg)
+{
+    _AUDENC1_Msg *msg = (_AUDENC1_Msg *)visaMsg;
+    AUDENC1_Handle handle = (AUDENC1_Handle)visaHandle;
+    _AUDENC1_BatchFrame *frame;
+    IAUDENC1_Status *pStatus;
+    Int i;
+
+    /*
+     * Do any needed translations on the buffer pointers, then
+     * call the appropriate API function, based on the command.
+     */
+    switch (msg->visa.cmd) {
+
+        case _AUDENC1_CPROCESS: {
+            if (!argsFit(visaMsg, &(msg->cmd.process.inArgs.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            msg->visa.status = processFrame(handle,
+                &(msg->cmd.process.inBufs), &(msg->cmd.process.outBufs),
+                &(msg->cmd.process.inArgs));
+
+            break;
+        }
+
+        case _AUDENC1_CPROCESSBATCH: {
+            if (!framesFit(msg)) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* each frame's status is returned in the frame itself */
+            frame = &(msg->cmd.batch.frame);
+            for (i = 0; i < msg->cmd.batch.numFrames; i++) {
+                frame->status = processFrame(handle, &(frame->inBufs),
+                    &(frame->outBufs), (IAUDENC1_InArgs *)(frame + 1));
+
+                frame = (_AUDENC1_BatchFrame *)((UInt8 *)frame + frame->size);
+            }
+            msg->visa.status = AUDENC1_EOK;
+
+            break;
+        }
+
+        case _AUDENC1_CCONTROL: {
+            if (!argsFit(visaMsg, &(msg->cmd.control.params.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* status follows the variable-sized params */
+            pStatus = (IAUDENC1_Status *)((UInt8 *)
+                &(msg->cmd.control.params) + msg->cmd.control.params.size);
+
+            if (pStatus->data.buf != NULL) {
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferVirtualAddress((UInt32)pStatus->data.buf,
+                        pStatus->data.bufSize);
+
+                Memory_cacheInv(pStatus->data.buf, pStatus->data.bufSize);
+            }
+
+            /* make the control call */
+            msg->visa.status = AUDENC1_control(handle, msg->cmd.control.id,
+                &(msg->cmd.control.params), pStatus);
+
+            if (pStatus->data.buf != NULL) {
+                Memory_cacheWb(pStatus->data.buf, pStatus->data.bufSize);
+
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferPhysicalAddress(pStatus->data.buf,
+                        pStatus->data.bufSize, NULL);
+            }
+
+            break;
+        }
+
+        default: {
+            msg->visa.status = VISA_EFAIL;
+
+            break;
+        }
+    }
+
+    return (VISA_EOK);
+}
+
+/*
+ *  ======== argsFit ========
+ *  Whether msg holds the variable-sized args that start with the size
+ *  field at size, and the args that follow them, as big as their size
+ *  fields say.  The stubs size each message to its args, so a bad size
+ *  would have the call read or write past the message's end.
+ */
+static Bool argsFit(VISA_Msg msg, XDAS_Int32 *size)
+{
+    IArg room = (UInt8 *)msg + Comm_getMsgSize((Comm_Msg)msg) -
+        (UInt8 *)size;
+    IArg inSize;
+    IArg outSize;
+
+    if (room < (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    inSize = *size;
+    if (inSize < (IArg)sizeof (*size) ||
+        inSize > room - (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    outSize = *(XDAS_Int32 *)((UInt8 *)size + inSize);
+
+    return (outSize >= (IArg)sizeof (*size) && outSize <= room - inSize);
+}
+
+/*
+ *  ======== framesFit ========
+ *  Whether msg holds each of its batch's frames, with their args.
+ */
+static Bool framesFit(_AUDENC1_Msg *msg)
+{
+    _AUDENC1_BatchFrame *frame = &(msg->cmd.batch.frame);
+    IArg room = (UInt8 *)msg + Comm_getMsgSize((Comm_Msg)msg) -
+        (UInt8 *)frame;
+    Int i;
+
+    for (i = 0; i < msg->cmd.batch.numFrames; i++) {
+        if (room < (IArg)sizeof (*frame) ||
+            frame->size < (IArg)sizeof (*frame) || frame->size > room ||
+            !argsFit((VISA_Msg)msg,
+                &(((IAUDENC1_InArgs *)(frame + 1))->size))) {
+            return (FALSE);
+        }
+
+        room -= frame->size;
+        frame = (_AUDENC1_BatchFrame *)((UInt8 *)frame + frame->size);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== processFrame ========
+ *  Unmarshall one frame's buffers, in place, and encode it.  The frame's
+ *  outArgs follows the variable-sized inArgs.
+ */
+static XDAS_Int32 processFrame(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs)
+{
+    XDAS_Int32 status;
+    IAUDENC1_OutArgs *pOutArgs;
+
+    unmarshallBufs(inBufs);
+    unmarshallBufs(outBufs);
+
+    if (inArgs->ancData.buf != NULL) {
+        inArgs->ancData.buf = (XDAS_Int8 *)Memory_getBufferVirtualAddress(
+            (UInt32)inArgs->ancData.buf, inArgs->ancData.bufSize);
+
+        Memory_cacheInv(inArgs->ancData.buf, inArgs->ancData.bufSize);
+    }
+
+    pOutArgs = (IAUDENC1_OutArgs *)((UInt8 *)inArgs + inArgs->size);
+
+    /* make the process call */
+    status = AUDENC1_process(handle, inBufs, outBufs, inArgs, pOutArgs);
+
+    /* write back the output buffers the alg filled */
+    writebackBufs(outBufs);
+
+    return (status);
+}
+
+/*
+ *  ======== unmarshallBufs ========
+ *  Translate the sparse array bufs to virtual addresses, in place.
+ */
+static Void unmarshallBufs(XDM1_BufDesc *bufs)
+{
+    Int i;
+    Int numBufs;
+
+    for (i = 0, numBufs = 0;
+        numBufs < bufs->numBufs && i < XDM_MAX_IO_BUFFERS; i++) {
+        if (bufs->descs[i].buf != NULL) {
+            bufs->descs[i].buf = (XDAS_Int8 *)Memory_getBufferVirtualAddress(
+                (UInt32)bufs->descs[i].buf, bufs->descs[i].bufSize);
+
+            Memory_cacheInv(bufs->descs[i].buf, bufs->descs[i].bufSize);
+            numBufs++;
+        }
+    }
+}
+
+/*
+ *  ======== writebackBufs ========
+ */
+static Void writebackBufs(XDM1_BufDesc *bufs)
+{
+    Int i;
+    Int numBufs;
+
+    for (i = 0, numBufs = 0;
+        numBufs < bufs->numBufs && i < XDM_MAX_IO_BUFFERS; i++) {
+        if (bufs->descs[i].buf != NULL) {
+            Memory_cacheWb(bufs->descs[i].buf, bufs->descs[i].bufSize);
+            numBufs++;
+        }
+    }
+}
+
+/*
+ *  ======== AUDENC1_SKEL ========
+ */
+SKEL_Fxns AUDENC1_SKEL = {
+    call,
+    (SKEL_CREATEFXN)&AUDENC1_create,
+    (SKEL_DESTROYFXN)&AUDENC1_delete,
+};
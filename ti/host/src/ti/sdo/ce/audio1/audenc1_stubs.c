@@ -0,0 +1,581 @@
+/*
+ *  ======== audenc1_stubs.c ========
+ *  This file contains an implemenation of the IAUDENC1 interface for the
+ *  audio encoder class of algorithms.
+ *
+ *  These functions are the "client-side" of a "remote" implementation.
+ */
+#include <xdc/std.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/xdais/dm/iaudenc1.h>
+
+#include <ti/sdo/ce/audio1/audenc1.h>
+#include <ti/sdo/ce/audio1/_audenc1.h>
+
+/*
+ *  Size of a message carrying the given inArgs and outArgs, or params and
+ *  status, which follow each other at the end of the message.
+ */
+#define PROCESSMSGSIZE(in, out) \
+    (offsetof(_AUDENC1_Msg, cmd.process.inArgs) + (in)->size + (out)->size)
+#define CONTROLMSGSIZE(in, out) \
+    (offsetof(_AUDENC1_Msg, cmd.control.params) + (in)->size + (out)->size)
+
+/* size of a batch frame with its args, keeping the next frame aligned */
+#define BATCHFRAMESIZE(inArgs, outArgs) \
+    ((sizeof (_AUDENC1_BatchFrame) + (inArgs)->size + (outArgs)->size + \
+    sizeof (Ptr) - 1) & ~(sizeof (Ptr) - 1))
+
+/* most buffers a process call's arguments reference */
+#define MAXRANGES       (2 * XDM_MAX_IO_BUFFERS + 1)
+
+/* most buffers of a batch message, whose cache is maintained in one call */
+#define MAXBATCHRANGES  128
+
+static XDAS_Int32 control(IAUDENC1_Handle h, IAUDENC1_Cmd id,
+    IAUDENC1_DynamicParams *params, IAUDENC1_Status *status);
+static XDAS_Int32 marshallBatch(VISA_Handle visa, XDM1_BufDesc inBufs[],
+    XDM1_BufDesc outBufs[], IAUDENC1_InArgs *inArgs[],
+    IAUDENC1_OutArgs *outArgs[], Int numFrames, Int *numSent,
+    _AUDENC1_Msg **pmsg);
+static Bool marshallBufs(XDM1_BufDesc *msgBufs, XDM1_BufDesc *bufs,
+    Memory_CacheRange ranges[], Int *numRanges);
+static Bool marshallInArgs(IAUDENC1_InArgs *msgInArgs,
+    IAUDENC1_InArgs *inArgs, Memory_CacheRange ranges[], Int *numRanges);
+static XDAS_Int32 marshallMsg(IAUDENC1_Handle h, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs, IAUDENC1_OutArgs *outArgs,
+    _AUDENC1_Msg **pmsg);
+static XDAS_Int32 process(IAUDENC1_Handle h, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs,
+    IAUDENC1_OutArgs *outArgs);
+static XDAS_Int32 unmarshallBatch(VISA_Handle visa, XDM1_BufDesc inBufs[],
+    XDM1_BufDesc outBufs[], IAUDENC1_OutArgs *outArgs[], Int numFrames,
+    _AUDENC1_Msg *msg, XDAS_Int32 retVal, XDAS_Int32 retVals[]);
+static Void unmarshallBufs(XDM1_BufDesc *bufs, XDM1_BufDesc *msgBufs,
+    Memory_CacheRange ranges[], Int *numRanges);
+static XDAS_Int32 unmarshallMsg(IAUDENC1_Handle h, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs, IAUDENC1_OutArgs *outArgs,
+    _AUDENC1_Msg *msg, XDAS_Int32 retVal);
+
+IAUDENC1_Fxns AUDENC1_STUBS = {
+    {&AUDENC1_STUBS, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+    process, control,
+};
+
+/*
+ *  ======== AUDENC1_processAsync ========
+ *  Local instances have nothing to send; their process call runs in
+ *  AUDENC1_processWait(), in the caller's thread.
+ */
+XDAS_Int32 AUDENC1_processAsync(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDENC1_InArgs *inArgs, AUDENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _AUDENC1_Msg *msg;
+
+    if (visa == NULL) {
+        return (AUDENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&AUDENC1_STUBS) {
+        return (AUDENC1_EOK);
+    }
+
+    if ((retVal = marshallMsg((IAUDENC1_Handle)visa, inBufs, outBufs, inArgs,
+        outArgs, &msg)) != IAUDENC1_EOK) {
+        return (retVal);
+    }
+
+    if (VISA_callAsync(visa, (VISA_Msg *)&msg) != VISA_EOK) {
+        VISA_freeMsg(visa, (VISA_Msg)msg);
+        return (AUDENC1_EFAIL);
+    }
+
+    return (AUDENC1_EOK);
+}
+
+/*
+ *  ======== AUDENC1_processBatch ========
+ *  Local instances simply process the frames one by one.
+ */
+XDAS_Int32 AUDENC1_processBatch(AUDENC1_Handle handle, XDM1_BufDesc inBufs[],
+    XDM1_BufDesc outBufs[], AUDENC1_InArgs *inArgs[],
+    AUDENC1_OutArgs *outArgs[], Int numFrames, XDAS_Int32 retVals[])
+{
+    XDAS_Int32 retVal = AUDENC1_EOK;
+    XDAS_Int32 status;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _AUDENC1_Msg *msg;
+    Int first;
+    Int n;
+
+    if (visa == NULL) {
+        return (AUDENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&AUDENC1_STUBS) {
+        for (n = 0; n < numFrames; n++) {
+            retVals[n] = AUDENC1_process(handle, &inBufs[n], &outBufs[n],
+                inArgs[n], outArgs[n]);
+            if (retVals[n] != AUDENC1_EOK) {
+                retVal = AUDENC1_EFAIL;
+            }
+        }
+
+        return (retVal);
+    }
+
+    for (n = 0; n < numFrames; n++) {
+        retVals[n] = AUDENC1_EFAIL;
+    }
+
+    /* send the frames as many to a message as will fit */
+    for (first = 0; first < numFrames; first += n) {
+        if (marshallBatch(visa, &inBufs[first], &outBufs[first],
+            &inArgs[first], &outArgs[first], numFrames - first, &n,
+            &msg) != IAUDENC1_EOK) {
+            return (AUDENC1_EFAIL);
+        }
+
+        /* send the message to the skeleton and wait for completion */
+        status = VISA_call(visa, (VISA_Msg *)&msg);
+
+        if (unmarshallBatch(visa, &inBufs[first], &outBufs[first],
+            &outArgs[first], n, msg, status, &retVals[first]) !=
+            IAUDENC1_EOK) {
+            retVal = AUDENC1_EFAIL;
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== AUDENC1_processWait ========
+ */
+XDAS_Int32 AUDENC1_processWait(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDENC1_InArgs *inArgs, AUDENC1_OutArgs *outArgs,
+    UInt timeout)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _AUDENC1_Msg *msg;
+
+    if (visa == NULL) {
+        return (AUDENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&AUDENC1_STUBS) {
+        return (AUDENC1_process(handle, inBufs, outBufs, inArgs, outArgs));
+    }
+
+    if ((retVal = VISA_wait(visa, (VISA_Msg *)&msg, timeout)) ==
+            VISA_ETIMEOUT) {
+        /* still in flight; the caller must wait again */
+        return (AUDENC1_ETIMEOUT);
+    }
+
+    /* without a reply, there are no outArgs to copy out */
+    if (msg == NULL) {
+        return (AUDENC1_EFAIL);
+    }
+
+    return (unmarshallMsg((IAUDENC1_Handle)visa, inBufs, outBufs, inArgs,
+        outArgs, msg, retVal));
+}
+
+/*
+ *  ======== control ========
+ *  This is the stub-implementation for the control method
+ */
+static XDAS_Int32 control(IAUDENC1_Handle h, IAUDENC1_Cmd id,
+    IAUDENC1_DynamicParams *params, IAUDENC1_Status *status)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _AUDENC1_Msg *msg;
+    IAUDENC1_Status *pMsgStatus;
+    XDAS_Int8 *virtAddr = NULL;
+
+    /* get a message big enough for params and status */
+    if ((msg = (_AUDENC1_Msg *)VISA_allocMsg2(visa,
+        CONTROLMSGSIZE(params, status))) == NULL) {
+        return (IAUDENC1_EFAIL);
+    }
+
+    /* marshall the command */
+    msg->visa.cmd = _AUDENC1_CCONTROL;
+
+    msg->cmd.control.id = id;
+
+    /* params has no pointers so simply copy the struct fields into the msg */
+    memcpy(&(msg->cmd.control.params), params, params->size);
+
+    /* unlike params, status is placed after the variable-sized params */
+    pMsgStatus = (IAUDENC1_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* set status's size field and buffer, translating the latter */
+    pMsgStatus->size = status->size;
+    pMsgStatus->data = status->data;
+    if (status->data.buf != NULL) {
+        virtAddr = status->data.buf;
+        Memory_cacheWbInv(virtAddr, status->data.bufSize);
+        pMsgStatus->data.buf = (XDAS_Int8 *)Memory_getBufferPhysicalAddress(
+            virtAddr, status->data.bufSize, NULL);
+        if (pMsgStatus->data.buf == NULL) {
+            retVal = IAUDENC1_EFAIL;
+            goto exit;
+        }
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_callUrgent(visa, (VISA_Msg *)&msg);
+
+    /* re-locate status, msg may have been changed by VISA_callUrgent() */
+    pMsgStatus = (IAUDENC1_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* copy out status, restoring the caller's buffer address */
+    memcpy(status, pMsgStatus, pMsgStatus->size);
+    if (virtAddr != NULL) {
+        status->data.buf = virtAddr;
+        Memory_cacheInv(virtAddr, status->data.bufSize);
+    }
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== marshallBatch ========
+ *  Marshall as many of the numFrames frames as fit into the instance's
+ *  message.  On success, *numSent frames were marshalled and *pmsg is
+ *  the message, ready to be sent to the skeleton.
+ */
+static XDAS_Int32 marshallBatch(VISA_Handle visa, XDM1_BufDesc inBufs[],
+    XDM1_BufDesc outBufs[], IAUDENC1_InArgs *inArgs[],
+    IAUDENC1_OutArgs *outArgs[], Int numFrames, Int *numSent,
+    _AUDENC1_Msg **pmsg)
+{
+    _AUDENC1_Msg *msg;
+    _AUDENC1_BatchFrame *frame;
+    IAUDENC1_InArgs *pMsgInArgs;
+    IAUDENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[MAXBATCHRANGES];
+    Int numRanges = 0;
+    UInt size;
+    Int n;
+
+    /* a batch fills a Comm_MSGSIZE message with as many frames as fit */
+    if ((msg = (_AUDENC1_Msg *)VISA_allocMsg(visa)) == NULL) {
+        return (IAUDENC1_EFAIL);
+    }
+
+    msg->visa.cmd = _AUDENC1_CPROCESSBATCH;
+
+    frame = &(msg->cmd.batch.frame);
+    for (n = 0; n < numFrames; n++) {
+        size = BATCHFRAMESIZE(inArgs[n], outArgs[n]);
+        if ((UInt8 *)frame + size > (UInt8 *)msg + Comm_MSGSIZE ||
+            numRanges + inBufs[n].numBufs + outBufs[n].numBufs + 1 >
+            MAXBATCHRANGES) {
+            break;
+        }
+
+        if (!marshallBufs(&(frame->inBufs), &inBufs[n], ranges,
+                &numRanges) ||
+            !marshallBufs(&(frame->outBufs), &outBufs[n], ranges,
+                &numRanges)) {
+            goto exit;
+        }
+
+        /* the frame's inArgs follows it, then its outArgs */
+        pMsgInArgs = (IAUDENC1_InArgs *)(frame + 1);
+        if (!marshallInArgs(pMsgInArgs, inArgs[n], ranges, &numRanges)) {
+            goto exit;
+        }
+
+        pMsgOutArgs = (IAUDENC1_OutArgs *)((UInt8 *)pMsgInArgs +
+            inArgs[n]->size);
+        pMsgOutArgs->size = outArgs[n]->size;
+
+        frame->size = size;
+        frame = (_AUDENC1_BatchFrame *)((UInt8 *)frame + size);
+    }
+
+    /* not even one frame fits */
+    if (n == 0) {
+        goto exit;
+    }
+
+    /* write back the buffers of all of the frames at once */
+    Memory_cacheWbInvRanges(ranges, numRanges);
+
+    msg->cmd.batch.numFrames = n;
+    *numSent = n;
+    *pmsg = msg;
+
+    return (IAUDENC1_EOK);
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (IAUDENC1_EFAIL);
+}
+
+/*
+ *  ======== marshallBufs ========
+ *  Copy the sparse array bufs into msgBufs, translating buffer addresses
+ *  to physical ones, and append the buffers to ranges for cache
+ *  maintenance.
+ */
+static Bool marshallBufs(XDM1_BufDesc *msgBufs, XDM1_BufDesc *bufs,
+    Memory_CacheRange ranges[], Int *numRanges)
+{
+    Int i;
+    Int numBufs;
+
+    msgBufs->numBufs = bufs->numBufs;
+    for (i = 0, numBufs = 0; i < XDM_MAX_IO_BUFFERS; i++) {
+        msgBufs->descs[i].buf = NULL;
+
+        if (numBufs < bufs->numBufs && bufs->descs[i].buf != NULL) {
+            ranges[*numRanges].addr = bufs->descs[i].buf;
+            ranges[(*numRanges)++].sizeInBytes = bufs->descs[i].bufSize;
+
+            msgBufs->descs[i].buf = (XDAS_Int8 *)
+                Memory_getBufferPhysicalAddress(bufs->descs[i].buf,
+                    bufs->descs[i].bufSize, NULL);
+            if (msgBufs->descs[i].buf == NULL) {
+                return (FALSE);
+            }
+            msgBufs->descs[i].bufSize = bufs->descs[i].bufSize;
+            msgBufs->descs[i].accessMask = 0;
+            numBufs++;
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== marshallInArgs ========
+ *  Copy inArgs into msgInArgs, translating its ancillary data buffer's
+ *  address to a physical one, and append the buffer to ranges for cache
+ *  maintenance.
+ */
+static Bool marshallInArgs(IAUDENC1_InArgs *msgInArgs,
+    IAUDENC1_InArgs *inArgs, Memory_CacheRange ranges[], Int *numRanges)
+{
+    memcpy(msgInArgs, inArgs, inArgs->size);
+
+    if (inArgs->ancData.buf != NULL) {
+        ranges[*numRanges].addr = inArgs->ancData.buf;
+        ranges[(*numRanges)++].sizeInBytes = inArgs->ancData.bufSize;
+
+        msgInArgs->ancData.buf = (XDAS_Int8 *)Memory_getBufferPhysicalAddress(
+            inArgs->ancData.buf, inArgs->ancData.bufSize, NULL);
+        if (msgInArgs->ancData.buf == NULL) {
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== marshallMsg ========
+ *  Marshall a process call into the instance's message.  On success,
+ *  *pmsg is the message, ready to be sent to the skeleton.
+ */
+static XDAS_Int32 marshallMsg(IAUDENC1_Handle h, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs, IAUDENC1_OutArgs *outArgs,
+    _AUDENC1_Msg **pmsg)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _AUDENC1_Msg *msg;
+    IAUDENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[MAXRANGES];
+    Int numRanges = 0;
+
+    /* get a message big enough for inArgs and outArgs */
+    if ((msg = (_AUDENC1_Msg *)VISA_allocMsg2(visa,
+        PROCESSMSGSIZE(inArgs, outArgs))) == NULL) {
+        return (IAUDENC1_EFAIL);
+    }
+
+    /*
+     * Marshall the command: copy the client-passed arguments into flattened
+     * message data structures, converting every pointer address to alg.
+     * data buffer into physical address.
+     */
+
+    /* First specify the processing command that the skeleton should do */
+    msg->visa.cmd = _AUDENC1_CPROCESS;
+
+    if (!marshallBufs(&(msg->cmd.process.inBufs), inBufs, ranges,
+            &numRanges) ||
+        !marshallBufs(&(msg->cmd.process.outBufs), outBufs, ranges,
+            &numRanges)) {
+        retVal = IAUDENC1_EFAIL;
+        goto exit;
+    }
+
+    if (!marshallInArgs(&(msg->cmd.process.inArgs), inArgs, ranges,
+            &numRanges)) {
+        retVal = IAUDENC1_EFAIL;
+        goto exit;
+    }
+
+    /* point at outArgs and set the "size" */
+    pMsgOutArgs = (IAUDENC1_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /* set the size field - the rest is filled in by the codec */
+    pMsgOutArgs->size = outArgs->size;
+
+    /* write back all the buffers at once */
+    Memory_cacheWbInvRanges(ranges, numRanges);
+
+    *pmsg = msg;
+
+    return (IAUDENC1_EOK);
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== process ========
+ *  This is the stub-implementation for the process method
+ */
+static XDAS_Int32 process(IAUDENC1_Handle h, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs, IAUDENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    _AUDENC1_Msg *msg;
+
+    if ((retVal = marshallMsg(h, inBufs, outBufs, inArgs, outArgs, &msg)) !=
+            IAUDENC1_EOK) {
+        return (retVal);
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_call((VISA_Handle)h, (VISA_Msg *)&msg);
+
+    return (unmarshallMsg(h, inBufs, outBufs, inArgs, outArgs, msg, retVal));
+}
+
+/*
+ *  ======== unmarshallBatch ========
+ *  Copy the results of numFrames batched process calls out of msg, which
+ *  the skeleton returned with status retVal, and release msg.
+ */
+static XDAS_Int32 unmarshallBatch(VISA_Handle visa, XDM1_BufDesc inBufs[],
+    XDM1_BufDesc outBufs[], IAUDENC1_OutArgs *outArgs[], Int numFrames,
+    _AUDENC1_Msg *msg, XDAS_Int32 retVal, XDAS_Int32 retVals[])
+{
+    XDAS_Int32 status = IAUDENC1_EOK;
+    _AUDENC1_BatchFrame *frame;
+    IAUDENC1_InArgs *pMsgInArgs;
+    Memory_CacheRange ranges[MAXBATCHRANGES];
+    Int numRanges = 0;
+    Int n;
+
+    frame = &(msg->cmd.batch.frame);
+    for (n = 0; n < numFrames; n++) {
+        pMsgInArgs = (IAUDENC1_InArgs *)(frame + 1);
+
+        /* outArgs has no pointers so simply copy it back */
+        memcpy(outArgs[n], (UInt8 *)pMsgInArgs + pMsgInArgs->size,
+            outArgs[n]->size);
+
+        unmarshallBufs(&inBufs[n], &(frame->inBufs), NULL, NULL);
+        unmarshallBufs(&outBufs[n], &(frame->outBufs), ranges, &numRanges);
+
+        /* a failed call leaves the frames' status unset */
+        retVals[n] = retVal == VISA_EOK ? frame->status : retVal;
+        if (retVals[n] != IAUDENC1_EOK) {
+            status = IAUDENC1_EFAIL;
+        }
+
+        frame = (_AUDENC1_BatchFrame *)((UInt8 *)frame + frame->size);
+    }
+
+    /* drop the stale lines of all of the frames' output at once */
+    Memory_cacheInvRanges(ranges, numRanges);
+
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (status);
+}
+
+/*
+ *  ======== unmarshallBufs ========
+ *  Return the access masks the alg filled in msgBufs in the sparse array
+ *  bufs.  Unless ranges is NULL, also append the buffers it wrote, which
+ *  the skeleton wrote back, to ranges for their stale cache lines to be
+ *  dropped.
+ */
+static Void unmarshallBufs(XDM1_BufDesc *bufs, XDM1_BufDesc *msgBufs,
+    Memory_CacheRange ranges[], Int *numRanges)
+{
+    Int i;
+    Int numBufs;
+
+    for (i = 0, numBufs = 0;
+        numBufs < bufs->numBufs && i < XDM_MAX_IO_BUFFERS; i++) {
+        if (bufs->descs[i].buf != NULL) {
+            bufs->descs[i].accessMask = msgBufs->descs[i].accessMask;
+            if (ranges != NULL && VISA_WROTEBUF(msgBufs->descs[i])) {
+                ranges[*numRanges].addr = bufs->descs[i].buf;
+                ranges[(*numRanges)++].sizeInBytes = bufs->descs[i].bufSize;
+            }
+            numBufs++;
+        }
+    }
+}
+
+/*
+ *  ======== unmarshallMsg ========
+ *  Copy the results of a process call out of msg, which the skeleton
+ *  returned with status retVal, and release msg.
+ */
+static XDAS_Int32 unmarshallMsg(IAUDENC1_Handle h, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, IAUDENC1_InArgs *inArgs, IAUDENC1_OutArgs *outArgs,
+    _AUDENC1_Msg *msg, XDAS_Int32 retVal)
+{
+    VISA_Handle visa = (VISA_Handle)h;
+    IAUDENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[XDM_MAX_IO_BUFFERS];
+    Int numRanges = 0;
+
+    /* outArgs follows the variable-sized inArgs */
+    pMsgOutArgs = (IAUDENC1_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /* outArgs has no pointers so simply copy it back */
+    memcpy(outArgs, pMsgOutArgs, outArgs->size);
+
+    /* drop the stale lines of the output the alg wrote */
+    unmarshallBufs(inBufs, &(msg->cmd.process.inBufs), NULL, NULL);
+    unmarshallBufs(outBufs, &(msg->cmd.process.outBufs), ranges, &numRanges);
+    Memory_cacheInvRanges(ranges, numRanges);
+
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
@@ -0,0 +1,69 @@
+/*
+ *  ======== _node.h ========
+ *  Server-side node descriptors and the node lifecycle used by the RMS.
+ */
+#ifndef ti_sdo_ce_node__NODE_
+#define ti_sdo_ce_node__NODE_
+
+#include <ti/sdo/ce/node/node.h>
+#include <ti/sdo/ce/skel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NODE_GTNAME "ti.sdo.ce.node"
+
+/*
+ *  ======== NODE_Desc ========
+ *  One entry of the server's node table (RMS_nodeTab), terminated by an
+ *  entry whose name is NULL.  A uuid of 0 is computed from the name by
+ *  RMS_init().
+ */
+typedef struct NODE_Desc {
+    String      name;       /* name of the alg served, as in the algTab */
+    NODE_Uuid   uuid;       /* NODE_uuidFromName(name), or 0 */
+    SKEL_Fxns   *skelFxns;  /* skeleton of the alg's VISA class */
+    Int         priority;   /* unused on the host */
+    UInt        stackSize;  /* node thread stack size; 0: default */
+} NODE_Desc;
+
+/*
+ *  ======== NODE_create ========
+ *  Create the node for desc: its message queue and the skeleton's alg
+ *  instance (created with createArgs, createArgs->size bytes long).
+ *  Replies without a source queue go to gppQueue.
+ */
+extern NODE_Status NODE_create(NODE_Desc *desc, Comm_Queue gppQueue,
+    IALG_Params *createArgs, NODE_EnvPtr *node);
+
+/*
+ *  ======== NODE_delete ========
+ *  Stop the node's thread, if it is still running, and delete the node.
+ */
+extern Void NODE_delete(NODE_EnvPtr node);
+
+/*
+ *  ======== NODE_getQueue ========
+ *  The queue the node reads its messages from.
+ */
+extern Comm_Queue NODE_getQueue(NODE_EnvPtr node);
+
+/*
+ *  ======== NODE_start ========
+ *  Start the node's thread, which serves messages until NODE_CEXIT.
+ */
+extern NODE_Status NODE_start(NODE_EnvPtr node);
+
+/*
+ *  ======== NODE_uuidFromName ========
+ *  The uuid of the node serving name.  Both the Engine (client) and RMS
+ *  (server) use this to fill in uuids left 0 in their tables.
+ */
+extern NODE_Uuid NODE_uuidFromName(String name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ *  ======== node.c ========
+ *  Host implementation of the server-side NODE module.
+ *
+ *  Each node is a thread that reads messages from its own queue, runs
+ *  them through the skeleton and returns them to their sender.  Comm_get()
+ *  hands it the queue's Comm_PRIORITYHIGH messages first, so the control
+ *  calls VISA_callUrgent() sends are served ahead of the process calls
+ *  already queued.
+ */
+#include <xdc/std.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Thread.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/visa.h>
+#include <ti/sdo/ce/node/node.h>
+#include <ti/sdo/ce/node/_node.h>
+
+/* FNV-1a, 32 bit */
+#define FNVOFFSET       2166136261U
+#define FNVPRIME        16777619U
+
+typedef struct NODE_Obj {
+    NODE_Desc       *desc;
+    VISA_Handle     visa;       /* skeleton's instance */
+    Comm_Handle     msgq;
+    Comm_Queue      msgqId;
+    Comm_Queue      gppQueue;   /* default reply queue */
+    Thread_Handle   thread;
+    volatile Bool   exited;     /* thread has seen NODE_CEXIT */
+} NODE_Obj;
+
+static NODE_Config NODE_CONFIG = {
+    0,          /* OBJSEG */
+    0,          /* MSGQPOOLID */
+    0,          /* FIXEDMSGSIZE */
+};
+
+NODE_Config *NODE = &NODE_CONFIG;
+
+static Int nodeThread(Arg arg);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Int refCount = 0;
+
+/*
+ *  ======== NODE_allocMsgBuf ========
+ */
+Ptr NODE_allocMsgBuf(NODE_EnvPtr node, UInt size, UInt align)
+{
+    return (Memory_contigAlloc(size, align));
+}
+
+/*
+ *  ======== NODE_create ========
+ */
+NODE_Status NODE_create(NODE_Desc *desc, Comm_Queue gppQueue,
+    IALG_Params *createArgs, NODE_EnvPtr *node)
+{
+    NODE_Obj *obj;
+    Char name[48];
+
+    GT_2trace(curTrace, GT_ENTER, "NODE_create> Enter(name='%s', "
+        "gppQueue=%d)\n", desc->name, gppQueue);
+
+    if ((obj = (NODE_Obj *)calloc(1, sizeof (NODE_Obj))) == NULL) {
+        return (NODE_EOUTOFMEMORY);
+    }
+    obj->desc = desc;
+    obj->gppQueue = gppQueue;
+
+    snprintf(name, sizeof (name), "%.20s#%lx", desc->name, (ULong)obj);
+    if ((obj->msgq = Comm_create(name, &obj->msgqId, NULL)) == NULL) {
+        free(obj);
+        return (NODE_ERESOURCE);
+    }
+
+    obj->visa = desc->skelFxns->apiCreate(Engine_getLocalEngine(),
+        desc->name, createArgs);
+    if (obj->visa == NULL) {
+        GT_1trace(curTrace, GT_7CLASS, "NODE_create> "
+            "failed to create an instance of '%s'\n", desc->name);
+        Comm_delete(obj->msgq);
+        free(obj);
+        return (NODE_EFAIL);
+    }
+
+    *node = obj;
+
+    return (NODE_EOK);
+}
+
+/*
+ *  ======== NODE_delete ========
+ */
+Void NODE_delete(NODE_EnvPtr node)
+{
+    NODE_Msg msg;
+
+    GT_1trace(curTrace, GT_ENTER, "NODE_delete> Enter(node=0x%lx)\n",
+        (IArg)node);
+
+    if (node->thread != NULL) {
+        /* the client vanished without stopping us; stop ourselves */
+        if (!node->exited && Comm_alloc(NODE->MSGQPOOLID, (Comm_Msg *)&msg,
+                sizeof (NODE_MsgHeader)) == Comm_EOK) {
+            msg->cmd.id = NODE_CEXIT;
+            Comm_put(node->msgqId, (Comm_Msg)msg);
+        }
+        Thread_delete(node->thread);
+    }
+
+    node->desc->skelFxns->apiDestroy(node->visa);
+    Comm_delete(node->msgq);
+
+    free(node);
+}
+
+/*
+ *  ======== NODE_freeMsgBuf ========
+ */
+Bool NODE_freeMsgBuf(NODE_EnvPtr node, Ptr addr, UInt size)
+{
+    return (Memory_contigFree(addr, size));
+}
+
+/*
+ *  ======== NODE_getPri ========
+ */
+UInt NODE_getPri(NODE_EnvPtr node)
+{
+    return (node->desc->priority);
+}
+
+/*
+ *  ======== NODE_getQueue ========
+ */
+Comm_Queue NODE_getQueue(NODE_EnvPtr node)
+{
+    return (node->msgqId);
+}
+
+/*
+ *  ======== NODE_start ========
+ */
+NODE_Status NODE_start(NODE_EnvPtr node)
+{
+    Thread_Attrs attrs = Thread_ATTRS;
+
+    GT_1trace(curTrace, GT_ENTER, "NODE_start> Enter(node=0x%lx)\n",
+        (IArg)node);
+
+    if (node->thread != NULL) {
+        return (NODE_EFAIL);
+    }
+
+    attrs.name = node->desc->name;
+    if (node->desc->stackSize != 0) {
+        attrs.stacksize = node->desc->stackSize;
+    }
+
+    if ((node->thread = Thread_create(nodeThread, &attrs, (Arg)node)) ==
+            NULL) {
+        return (NODE_ETASK);
+    }
+
+    return (NODE_EOK);
+}
+
+/*
+ *  ======== NODE_uuidFromName ========
+ */
+NODE_Uuid NODE_uuidFromName(String name)
+{
+    NODE_Uuid uuid;
+    UInt32 hash = FNVOFFSET;
+
+    for (; *name != '\0'; name++) {
+        hash = ((hash ^ (UInt8)*name) * FNVPRIME) & 0xffffffffU;
+    }
+
+    /* 0 means "not yet computed" in the node and alg tables */
+    uuid.data = hash == 0 ? 1 : hash;
+
+    return (uuid);
+}
+
+/*
+ *  ======== NODE_exit ========
+ */
+Void NODE_exit(Void)
+{
+    --refCount;
+}
+
+/*
+ *  ======== NODE_init ========
+ */
+Void NODE_init(Void)
+{
+    if (refCount++ == 0) {
+        GT_create(&curTrace, NODE_GTNAME);
+    }
+}
+
+/*
+ *  ======== nodeThread ========
+ */
+static Int nodeThread(Arg arg)
+{
+    NODE_Obj *node = (NODE_Obj *)arg;
+    NODE_Msg msg;
+    Comm_Queue replyQueue;
+
+    GT_1trace(curTrace, GT_2CLASS, "nodeThread> '%s' running\n",
+        node->desc->name);
+
+    for (;;) {
+        if (Comm_get(node->msgqId, (Comm_Msg *)&msg, Comm_FOREVER) !=
+            Comm_EOK) {
+            continue;
+        }
+
+        Comm_getSrcQueue((Comm_Msg)msg, &replyQueue);
+
+        if (msg->cmd.id == NODE_CEXIT) {
+            node->exited = TRUE;
+            if (replyQueue == Comm_INVALIDMSGQ) {
+                Comm_free((Comm_Msg)msg);
+            }
+            else {
+                Comm_put(replyQueue, (Comm_Msg)msg);
+            }
+            break;
+        }
+
+        node->desc->skelFxns->call(node->visa, (VISA_Msg)msg);
+
+        Comm_put(replyQueue == Comm_INVALIDMSGQ ? node->gppQueue :
+            replyQueue, (Comm_Msg)msg);
+    }
+
+    GT_1trace(curTrace, GT_2CLASS, "nodeThread> '%s' exiting\n",
+        node->desc->name);
+
+    return (0);
+}
@@ -0,0 +1,69 @@
+/*
+ *  ======== Lock.h ========
+ *  OSAL recursive mutual-exclusion lock.
+ */
+#ifndef ti_sdo_ce_osal_Lock_
+#define ti_sdo_ce_osal_Lock_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Lock_GTNAME "OL"
+
+/*
+ *  ======== Lock_Handle ========
+ */
+typedef struct Lock_Obj *Lock_Handle;
+
+/*
+ *  ======== Lock_Attrs ========
+ */
+typedef struct Lock_Attrs {
+    Int dummy;          /* no attributes yet */
+} Lock_Attrs;
+
+extern Lock_Attrs Lock_ATTRS;   /* default attrs */
+
+/*
+ *  ======== Lock_acquire ========
+ *  Acquire the lock; a thread may acquire a lock it already owns.
+ */
+extern Void Lock_acquire(Lock_Handle lock);
+
+/*
+ *  ======== Lock_create ========
+ */
+extern Lock_Handle Lock_create(Lock_Attrs *attrs);
+
+/*
+ *  ======== Lock_delete ========
+ */
+extern Void Lock_delete(Lock_Handle lock);
+
+/*
+ *  ======== Lock_release ========
+ */
+extern Void Lock_release(Lock_Handle lock);
+
+/*
+ *  ======== Lock_tryAcquire ========
+ *  Acquire the lock if no other thread owns it; returns TRUE if acquired.
+ */
+extern Bool Lock_tryAcquire(Lock_Handle lock);
+
+/*
+ *  ======== Lock_init ========
+ */
+extern Bool Lock_init(Void);
+
+/*
+ *  ======== Lock_exit ========
+ */
+extern Void Lock_exit(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
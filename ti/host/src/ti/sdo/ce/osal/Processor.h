@@ -0,0 +1,55 @@
+/*
+ *  ======== Processor.h ========
+ *  OSAL management of the processor that runs an engine's server.
+ */
+#ifndef ti_sdo_ce_osal_Processor_
+#define ti_sdo_ce_osal_Processor_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Processor_GTNAME "OP"
+
+/*
+ *  ======== Processor_Handle ========
+ */
+typedef struct Processor_Obj *Processor_Handle;
+
+/*
+ *  ======== Processor_Attrs ========
+ */
+typedef struct Processor_Attrs {
+    String  cpuId;      /* id of the processor to load, NULL: default */
+} Processor_Attrs;
+
+extern Processor_Attrs Processor_ATTRS;     /* default attrs */
+
+/*
+ *  ======== Processor_create ========
+ *  Load and start the server image imageName.
+ */
+extern Processor_Handle Processor_create(String imageName, String linkCfg,
+    Processor_Attrs *attrs);
+
+/*
+ *  ======== Processor_delete ========
+ *  Stop the server started by Processor_create().
+ */
+extern Void Processor_delete(Processor_Handle proc);
+
+/*
+ *  ======== Processor_init ========
+ */
+extern Bool Processor_init(Void);
+
+/*
+ *  ======== Processor_exit ========
+ */
+extern Void Processor_exit(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
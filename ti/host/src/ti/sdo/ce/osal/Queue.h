@@ -0,0 +1,142 @@
+/*
+ *  ======== Queue.h ========
+ *  OSAL doubly-linked queue.
+ *
+ *  Elements are intrusive: anything placed on a queue must begin with a
+ *  Queue_Elem.  Comm_MsgHeader's reserved[] words are laid out so that
+ *  every Comm message can be queued directly.
+ *
+ *  A Queue_Fifo is a lock-free alternative for elements that are only
+ *  ever put at the tail and got from the head, by any number of putters
+ *  and one getter at a time.  Its elements need only begin with a
+ *  Queue_Link, which is reserved[0] of a Comm message.
+ */
+#ifndef ti_sdo_ce_osal_Queue_
+#define ti_sdo_ce_osal_Queue_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Queue_GTNAME "OQ"
+
+/*
+ *  ======== Queue_Elem ========
+ *  A queue is represented by its head element; an empty queue's head
+ *  points to itself.
+ */
+typedef struct Queue_Elem {
+    struct Queue_Elem *next;
+    struct Queue_Elem *prev;
+} Queue_Elem;
+
+/*
+ *  ======== Queue_Link ========
+ */
+typedef struct Queue_Link {
+    struct Queue_Link *next;
+} Queue_Link;
+
+/*
+ *  ======== Queue_Fifo ========
+ *  Putters swap themselves in as last, then link the previous last to
+ *  themselves; the getter follows the links from first.  The stub keeps
+ *  the list from ever being empty, so the two ends never race.  The ends
+ *  are on separate cache lines.
+ */
+typedef struct Queue_Fifo {
+    Queue_Link *first;
+    Queue_Link stub;
+    Queue_Link *last __attribute__((aligned(64)));
+} Queue_Fifo;
+
+/*
+ *  ======== Queue_empty ========
+ */
+static inline Bool Queue_empty(Queue_Elem *queue)
+{
+    return (queue->next == queue);
+}
+
+/*
+ *  ======== Queue_fifoEmpty ========
+ *  The stub is last exactly when all elements have been got.
+ */
+static inline Bool Queue_fifoEmpty(Queue_Fifo *fifo)
+{
+    return (__atomic_load_n(&fifo->last, __ATOMIC_ACQUIRE) == &fifo->stub);
+}
+
+/*
+ *  ======== Queue_extract ========
+ *  Remove elem from whatever queue it is on.
+ */
+extern Void Queue_extract(Ptr elem);
+
+/*
+ *  ======== Queue_fifoGet ========
+ *  Remove and return the element at the head of fifo, or NULL if it is
+ *  empty.  If a put has taken its place but not yet linked it, waits for
+ *  that put to finish.  Only one thread at a time may get.
+ */
+extern Ptr Queue_fifoGet(Queue_Fifo *fifo);
+
+/*
+ *  ======== Queue_fifoNew ========
+ *  Initialize fifo to the empty state.  It must not move afterwards.
+ */
+extern Void Queue_fifoNew(Queue_Fifo *fifo);
+
+/*
+ *  ======== Queue_fifoPut ========
+ *  Append elem to the tail of fifo.  Never blocks.
+ */
+extern Void Queue_fifoPut(Queue_Fifo *fifo, Ptr elem);
+
+/*
+ *  ======== Queue_get ========
+ *  Remove and return the element at the head of queue, or NULL if the
+ *  queue is empty.
+ */
+extern Ptr Queue_get(Queue_Elem *queue);
+
+/*
+ *  ======== Queue_head ========
+ *  Return the element at the head of queue without removing it, or NULL
+ *  if the queue is empty.
+ */
+extern Ptr Queue_head(Queue_Elem *queue);
+
+/*
+ *  ======== Queue_new ========
+ *  Initialize queue to the empty state.
+ */
+extern Void Queue_new(Queue_Elem *queue);
+
+/*
+ *  ======== Queue_next ========
+ *  Return the element following elem on queue, or NULL at the end.
+ */
+extern Ptr Queue_next(Queue_Elem *queue, Ptr elem);
+
+/*
+ *  ======== Queue_put ========
+ *  Append elem to the tail of queue.
+ */
+extern Void Queue_put(Queue_Elem *queue, Ptr elem);
+
+/*
+ *  ======== Queue_init ========
+ */
+extern Bool Queue_init(Void);
+
+/*
+ *  ======== Queue_exit ========
+ */
+extern Void Queue_exit(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ *  ======== Sem.h ========
+ *  OSAL counting semaphore.
+ */
+#ifndef ti_sdo_ce_osal_Sem_
+#define ti_sdo_ce_osal_Sem_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Sem_GTNAME "OS"
+
+/*
+ *  ======== error status codes ========
+ */
+#define Sem_EOK         0
+#define Sem_EFAIL       1
+#define Sem_ETIMEOUT    2
+
+/*
+ *  ======== timeout values (in microseconds) ========
+ */
+#define Sem_FOREVER     ((UInt32)-1)
+#define Sem_POLL        ((UInt32)0)
+
+/*
+ *  ======== Sem_Handle ========
+ */
+typedef struct Sem_Obj *Sem_Handle;
+
+/*
+ *  ======== Sem_create ========
+ *  Create a semaphore with an initial count of count.  key is reserved
+ *  for named (inter-process) semaphores and is ignored.
+ */
+extern Sem_Handle Sem_create(Int key, Int count);
+
+/*
+ *  ======== Sem_delete ========
+ */
+extern Void Sem_delete(Sem_Handle sem);
+
+/*
+ *  ======== Sem_getCount ========
+ */
+extern Int Sem_getCount(Sem_Handle sem);
+
+/*
+ *  ======== Sem_pend ========
+ *  Wait up to timeout microseconds for the count to become non-zero,
+ *  then decrement it.
+ */
+extern Int Sem_pend(Sem_Handle sem, UInt32 timeout);
+
+/*
+ *  ======== Sem_post ========
+ */
+extern Void Sem_post(Sem_Handle sem);
+
+/*
+ *  ======== Sem_init ========
+ */
+extern Bool Sem_init(Void);
+
+/*
+ *  ======== Sem_exit ========
+ */
+extern Void Sem_exit(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
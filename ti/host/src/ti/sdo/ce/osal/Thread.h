@@ -0,0 +1,68 @@
+/*
+ *  ======== Thread.h ========
+ *  OSAL thread of execution.
+ */
+#ifndef ti_sdo_ce_osal_Thread_
+#define ti_sdo_ce_osal_Thread_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Thread_GTNAME "OT"
+
+/*
+ *  ======== Thread_Handle ========
+ */
+typedef struct Thread_Obj *Thread_Handle;
+
+/*
+ *  ======== Thread_RunFxn ========
+ */
+typedef Int (*Thread_RunFxn)(Arg arg);
+
+/*
+ *  ======== Thread_Attrs ========
+ */
+typedef struct Thread_Attrs {
+    Int     priority;   /* ignored; all threads run SCHED_OTHER */
+    Int     stacksize;  /* 0: use the system default */
+    String  name;       /* name for debugging, may be NULL */
+} Thread_Attrs;
+
+extern Thread_Attrs Thread_ATTRS;       /* default attrs */
+
+/*
+ *  ======== Thread_create ========
+ *  Start a new thread running fxn(arg).
+ */
+extern Thread_Handle Thread_create(Thread_RunFxn fxn, Thread_Attrs *attrs,
+    Arg arg);
+
+/*
+ *  ======== Thread_delete ========
+ *  Wait for the thread to return from its run function and free it.
+ */
+extern Void Thread_delete(Thread_Handle thread);
+
+/*
+ *  ======== Thread_self ========
+ *  Return an identifier for the calling thread, suitable for tracing.
+ */
+extern UInt32 Thread_self(Void);
+
+/*
+ *  ======== Thread_init ========
+ */
+extern Bool Thread_init(Void);
+
+/*
+ *  ======== Thread_exit ========
+ */
+extern Void Thread_exit(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
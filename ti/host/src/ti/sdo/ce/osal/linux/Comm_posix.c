@@ -0,0 +1,1320 @@
+/*
+ *  ======== Comm_posix.c ========
+ *  In-process implementation of the OSAL Comm module.
+ *
+ *  Queues live in this process and messages are passed by reference:
+ *  Comm_put() links the message onto the destination queue and wakes its
+ *  reader, so a stub->skeleton round trip costs two queue operations and
+ *  two thread switches, with no copies.  Queue ids index a fixed table so
+ *  that put and get never search.
+ *
+ *  Puts take no lock shared with other queues: the messages are on a
+ *  lock-free Queue_Fifo, linked through reserved[0], and the queue is
+ *  kept alive by a count of the puts in progress in its table slot,
+ *  which Comm_delete() waits to drain after emptying the slot.  So
+ *  senders to different queues, or many to one, don't wait for each
+ *  other; the reader's semaphore is the only lock a put takes.
+ *
+ *  Messages of up to Comm_MSGSIZE bytes, but too large for the C heap's
+ *  own per-thread caches, are pooled: they are all allocated at that
+ *  size, and freed ones are kept in a small cache of
+ *  the freeing thread, which allocations take them from without a lock.
+ *  A thread's cache is refilled from, or its excess returned to, the
+ *  module's pool CACHEBATCH messages at a time, under poolLock; the pool
+ *  starts with Comm_poolMsgs messages and keeps up to that many idle.
+ *  Comm_poolStat() reports on it.
+ *
+ *  A queue has a lane per message priority, which Comm_setPriority() keeps
+ *  in the header's reserved1.  Comm_get() takes from the highest lane
+ *  with a message waiting, so a Comm_PRIORITYHIGH message overtakes the
+ *  normal ones queued before it; within a lane the order is that of the
+ *  puts.  The semaphore counts the messages on all lanes.
+ *
+ *  Timeouts passed to Comm_get() are in microseconds.
+ *
+ *  For event loops, Comm_getFd() gives a queue an eventfd in semaphore
+ *  mode, which Comm_put() increments before it wakes the reader and
+ *  Comm_get() decrements, so it is readable exactly while messages wait.
+ *  Queues that were never asked for one don't make these system calls.
+ *
+ *  If the application sets Comm_shmName, queues are also reachable from
+ *  one other process, through a POSIX shared memory object of that name,
+ *  as the DSP's are through DSP/Link: a server process, which sets
+ *  Comm_shmServer and runs RMS_init(), creates it, and a client attaches
+ *  when it first locates a queue it doesn't have, such as the server's
+ *  RMS command queue.  Queue ids carry the side of the link they are on,
+ *  so ids passed in messages work on both.  Each direction is a
+ *  single-producer single-consumer ring of message copies; a thread of
+ *  each process takes the peer's messages off its ring, sleeping on a
+ *  futex in the shared memory while it is empty, and puts them on the
+ *  queues here.  A message copied from the peer remembers the peer's
+ *  message, and a message put back to the peer is copied into that
+ *  original rather than into a new one, so request and reply traffic
+ *  keeps the message identity that VISA and the Engine rely on.  A copy
+ *  freed without being answered loses the peer its original.  The link
+ *  serves one client at a time; another may attach after it exits.
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Lock.h>
+#include <ti/sdo/ce/osal/Queue.h>
+#include <ti/sdo/ce/osal/Sem.h>
+#include <ti/sdo/ce/osal/Thread.h>
+
+/* queue ids of both sides of a link must stay below Comm_INVALIDMSGQ */
+#define MAXQUEUES       4096
+#define MAXNAMELEN      31
+
+/* messages a thread caches, and moves to or from the pool at a time */
+#define CACHEDEPTH      32
+#define CACHEBATCH      16
+
+/* smaller messages are left to the C heap's thread caches (glibc tcache) */
+#define POOLMINSIZE     1024
+
+/* slotUsers flag: puts must wait for Comm_getFd() */
+#define SLOTBLOCKED     0x40000000
+
+/* named queues each side of a link can publish */
+#define MAXLINKNAMES    64
+
+/* Link.magic, once the server has initialized the link */
+#define LINKMAGIC       0x436f6d6d
+
+#define CACHELINE       64
+
+/* size of a ring record of an n byte message: whole LinkRecords */
+#define RECORDSIZE(n)   ((sizeof (LinkRecord) + (n) + \
+    sizeof (LinkRecord) - 1) & ~(sizeof (LinkRecord) - 1))
+
+/* offset of the rings' data in the link's shared memory */
+#define DATAOFFSET      ((sizeof (Link) + CACHELINE - 1) & ~(CACHELINE - 1))
+
+/* the prefix Comm_alloc() puts before a message */
+#define PREFIX(msg)     ((MsgPrefix *)(msg) - 1)
+
+/*
+ *  ======== Comm_Obj ========
+ */
+typedef struct Comm_Obj {
+    Queue_Fifo      msgs[Comm_NUMPRIORITIES];  /* waiting, by priority */
+    Comm_Queue      id;
+    Char            name[MAXNAMELEN + 1];
+    Sem_Handle      sem;        /* counts messages on all of msgs */
+    Int             fd;         /* eventfd counting them too, or -1 */
+    Comm_Attrs      attrs;
+} Comm_Obj;
+
+/*
+ *  ======== MsgPrefix ========
+ *  Hidden before every message's header, which it keeps 16-byte aligned.
+ */
+typedef struct MsgPrefix {
+    Comm_Msg        peerMsg;    /* peer's message this is a copy of */
+    struct MsgPrefix *nextIdle; /* in the pool, while idle */
+    UInt32          capacity;   /* bytes after the prefix */
+    UInt32          generation; /* poolGeneration of a pooled message */
+} MsgPrefix;
+
+/*
+ *  ======== MsgCache ========
+ *  The idle pooled messages a thread caches.
+ */
+typedef struct MsgCache {
+    UInt32          generation; /* poolGeneration it was filled in */
+    Bool            registered; /* cacheKey's destructor will flush it */
+    Int             numIdle;
+    MsgPrefix       *idle[CACHEDEPTH];  /* most recently freed last */
+    UInt32          hits;       /* not yet added to poolStat */
+} MsgCache;
+
+/*
+ *  ======== LinkName ========
+ *  A named queue one side of a link publishes for the other to locate.
+ */
+typedef struct LinkName {
+    Int             used;       /* set after, and cleared before, the rest */
+    Comm_Queue      id;
+    Char            name[MAXNAMELEN + 1];
+} LinkName;
+
+/*
+ *  ======== LinkRecord ========
+ *  Header of a message copy in a ring.  Records don't wrap: one that
+ *  doesn't fit before the end of the ring is preceded by a pad record.
+ */
+typedef struct LinkRecord {
+    UInt            length;     /* of the record, header included */
+    Comm_Queue      dst;        /* Comm_INVALIDMSGQ: pad record */
+    Comm_Msg        reply;      /* receiver's message to copy into, or NULL */
+    Comm_Msg        origin;     /* sender's message to answer, or NULL */
+} LinkRecord;
+
+/*
+ *  ======== Ring ========
+ *  head and tail are free-running byte counts, written only by the
+ *  receiver and the sender respectively.
+ */
+typedef struct Ring {
+    UInt            head __attribute__((aligned(CACHELINE)));
+    UInt            tail __attribute__((aligned(CACHELINE)));
+    Int             waiting;    /* the receiver may sleep on doorbell */
+    UInt            doorbell;   /* futex word, bumped to wake it */
+} Ring;
+
+/*
+ *  ======== Link ========
+ *  Start of the shared memory; the rings' data follows, at DATAOFFSET.
+ */
+typedef struct Link {
+    UInt            magic;      /* set last by the server */
+    UInt32          ringSize;   /* bytes of each ring; a power of 2 */
+    Int             attached;   /* a client has attached */
+    LinkName        names[2][MAXLINKNAMES];
+    Ring            rings[2];   /* rings[s] carries messages to side s */
+} Link;
+
+static Void flushCache(Ptr arg);
+static Void futexWait(UInt *addr, UInt value);
+static Void futexWake(UInt *addr);
+static Bool linkAttach(Void);
+static Bool linkCreate(Void);
+static Void linkDeliver(LinkRecord *rec, UInt length);
+static Void linkDetach(Void);
+static Bool linkLocate(String queueName, Comm_Queue *queue);
+static Void linkPublish(Comm_Obj *obj, Bool publish);
+static Int linkPut(Comm_Queue queue, Comm_Msg msg);
+static Int linkReceive(Arg arg);
+static MsgCache *msgCache(Void);
+static MsgPrefix *poolAlloc(Void);
+static Void poolFill(MsgCache *mc);
+static Void poolReturn(MsgCache *mc, Int count);
+static UInt8 *ringData(Int to);
+static Comm_Obj *slotEnter(Int index);
+static Void slotLeave(Int index);
+static Void slotQuiesce(Int index);
+
+/*
+ *  Twice the DSP/Link message size: class args have 8-byte longs and
+ *  pointers on LP64 hosts, and IVIDDEC2_OutArgs alone is almost 4 KB.
+ */
+UInt32 Comm_MSGSIZE = 8192;
+
+Int Comm_poolMsgs __attribute__((weak)) = 64;
+String Comm_shmName __attribute__((weak)) = NULL;
+Bool Comm_shmServer __attribute__((weak)) = FALSE;
+UInt32 Comm_shmRingSize __attribute__((weak)) = 1024 * 1024;
+
+Comm_Attrs Comm_ATTRS = {
+    Comm_PEND,  /* type */
+    NULL,       /* callHandle */
+    NULL,       /* callFxn */
+};
+
+static GT_Mask curTrace = {NULL, NULL};
+static Lock_Handle moduleLock = NULL;
+static Comm_Obj *queueTab[MAXQUEUES];
+static Int slotUsers[MAXQUEUES];    /* puts in progress to queueTab[i] */
+static Int refCount = 0;
+static UInt side = 0;               /* of the link: 0 client, 1 server */
+static Link *shm = NULL;            /* NULL: no link */
+static UInt32 shmSize = 0;
+static Lock_Handle sendLock = NULL; /* serializes sends to the peer */
+static Thread_Handle receiver = NULL;
+static Bool stopReceiver = FALSE;
+static Lock_Handle poolLock = NULL;
+static MsgPrefix *poolIdle = NULL;  /* the pool's idle messages */
+static UInt32 poolMsgSize = 0;      /* 0: nothing is pooled */
+static UInt32 poolGeneration = 0;   /* changes when the pool is emptied */
+static Comm_PoolStat poolStat;
+static pthread_key_t cacheKey;      /* flushes msgCache on thread exit */
+static __thread MsgCache threadCache;
+
+/*
+ *  ======== Comm_alloc ========
+ */
+Int Comm_alloc(UInt16 poolId, Comm_Msg *msg, UInt16 size)
+{
+    MsgPrefix *prefix;
+    Comm_Msg m;
+
+    if (size < sizeof (Comm_MsgHeader)) {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_alloc> "
+            "size %d is smaller than the message header\n", size);
+        return (Comm_EFAIL);
+    }
+
+    if (size < POOLMINSIZE || size > poolMsgSize ||
+        (prefix = poolAlloc()) == NULL) {
+        if ((prefix = (MsgPrefix *)Memory_alloc(sizeof (MsgPrefix) + size,
+            NULL)) == NULL) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm_alloc> "
+                "failed to allocate %d byte message\n", size);
+            return (Comm_EFAIL);
+        }
+        prefix->capacity = size;
+        prefix->generation = 0;
+        __atomic_add_fetch(&poolStat.numUnpooled, 1, __ATOMIC_RELAXED);
+    }
+    prefix->peerMsg = NULL;
+    m = (Comm_Msg)(prefix + 1);
+
+    memset(m, 0, sizeof (Comm_MsgHeader));
+    m->reserved2 = poolId;
+    m->size = size;
+    m->reserved3 = Comm_INVALIDMSGQ;
+    m->reserved4 = Comm_INVALIDMSGQ;
+
+    *msg = m;
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_create ========
+ */
+Comm_Handle Comm_create(String queueName, Comm_Queue *queue,
+    Comm_Attrs *attrs)
+{
+    Comm_Obj *obj;
+    Int lane;
+    Int id;
+
+    GT_1trace(curTrace, GT_ENTER, "Comm_create> Enter(queueName='%s')\n",
+        queueName == NULL ? "" : queueName);
+
+    if (attrs == NULL) {
+        attrs = &Comm_ATTRS;
+    }
+
+    if ((obj = (Comm_Obj *)calloc(1, sizeof (Comm_Obj))) == NULL) {
+        return (NULL);
+    }
+
+    for (lane = 0; lane < Comm_NUMPRIORITIES; lane++) {
+        Queue_fifoNew(&obj->msgs[lane]);
+    }
+    obj->attrs = *attrs;
+    obj->fd = -1;
+    if (queueName != NULL) {
+        strncpy(obj->name, queueName, MAXNAMELEN);
+    }
+
+    if ((obj->sem = Sem_create(0, 0)) == NULL) {
+        free(obj);
+        return (NULL);
+    }
+
+    Lock_acquire(moduleLock);
+    for (id = 0; id < MAXQUEUES && queueTab[id] != NULL; id++) {
+    }
+    if (id < MAXQUEUES) {
+        obj->id = side * MAXQUEUES + id;
+        __atomic_store_n(&queueTab[id], obj, __ATOMIC_RELEASE);
+        if (shm != NULL && queueName != NULL) {
+            linkPublish(obj, TRUE);
+        }
+    }
+    Lock_release(moduleLock);
+
+    if (id == MAXQUEUES) {
+        GT_0trace(curTrace, GT_7CLASS, "Comm_create> out of queue ids\n");
+        Sem_delete(obj->sem);
+        free(obj);
+        return (NULL);
+    }
+
+    *queue = obj->id;
+
+    return (obj);
+}
+
+/*
+ *  ======== Comm_delete ========
+ */
+Void Comm_delete(Comm_Handle msgq)
+{
+    Int index;
+    Int lane;
+
+    if (msgq == NULL) {
+        return;
+    }
+    index = msgq->id % MAXQUEUES;
+
+    /* no put can reach it once those in progress are done */
+    Lock_acquire(moduleLock);
+    __atomic_store_n(&queueTab[index], NULL, __ATOMIC_SEQ_CST);
+    slotQuiesce(index);
+    if (shm != NULL && msgq->name[0] != '\0') {
+        linkPublish(msgq, FALSE);
+    }
+    Lock_release(moduleLock);
+
+    for (lane = 0; lane < Comm_NUMPRIORITIES; lane++) {
+        if (!Queue_fifoEmpty(&msgq->msgs[lane])) {
+            GT_1trace(curTrace, GT_6CLASS, "Comm_delete> "
+                "queue %d deleted with messages pending\n", msgq->id);
+            break;
+        }
+    }
+
+    if (msgq->fd != -1) {
+        close(msgq->fd);
+    }
+    Sem_delete(msgq->sem);
+    free(msgq);
+}
+
+/*
+ *  ======== Comm_free ========
+ */
+Int Comm_free(Comm_Msg msg)
+{
+    MsgPrefix *prefix = PREFIX(msg);
+    MsgCache *mc;
+
+    if (prefix->generation == __atomic_load_n(&poolGeneration,
+        __ATOMIC_ACQUIRE) && (mc = msgCache()) != NULL) {
+        if (mc->numIdle == CACHEDEPTH) {
+            poolReturn(mc, CACHEBATCH);
+        }
+        mc->idle[mc->numIdle++] = prefix;
+    }
+    else {
+        Memory_free(prefix, sizeof (MsgPrefix) + prefix->capacity, NULL);
+    }
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_get ========
+ */
+Int Comm_get(Comm_Queue queue, Comm_Msg *msg, UInt timeout)
+{
+    Comm_Obj *obj;
+    eventfd_t value;
+    Int status;
+    Int lane;
+
+    if (queue / MAXQUEUES != side ||
+        (obj = queueTab[queue % MAXQUEUES]) == NULL) {
+        return (Comm_EFAIL);
+    }
+
+    status = Sem_pend(obj->sem, timeout == Comm_FOREVER ? Sem_FOREVER :
+        (UInt32)timeout);
+    if (status != Sem_EOK) {
+        return (status == Sem_ETIMEOUT ? Comm_ETIMEOUT : Comm_EFAIL);
+    }
+
+    /* the counted message is on some lane; a later urgent one may be too */
+    for (lane = Comm_NUMPRIORITIES - 1; lane > 0; lane--) {
+        if (!Queue_fifoEmpty(&obj->msgs[lane])) {
+            break;
+        }
+    }
+    *msg = (Comm_Msg)Queue_fifoGet(&obj->msgs[lane]);
+
+    /* Comm_put() incremented it before posting sem */
+    if (obj->fd != -1) {
+        eventfd_read(obj->fd, &value);
+    }
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_getFd ========
+ */
+Int Comm_getFd(Comm_Handle msgq)
+{
+    Int index = msgq->id % MAXQUEUES;
+    Int fd;
+
+    /* with puts held off, and the reader not getting, sem is exact */
+    Lock_acquire(moduleLock);
+    if (msgq->fd == -1) {
+        __atomic_or_fetch(&slotUsers[index], SLOTBLOCKED, __ATOMIC_SEQ_CST);
+        slotQuiesce(index);
+        fd = eventfd(Sem_getCount(msgq->sem),
+            EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+        if (fd == -1) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm_getFd> "
+                "can't create an eventfd for queue %d\n", msgq->id);
+        }
+        msgq->fd = fd;
+        __atomic_and_fetch(&slotUsers[index], ~SLOTBLOCKED,
+            __ATOMIC_SEQ_CST);
+    }
+    fd = msgq->fd;
+    Lock_release(moduleLock);
+
+    return (fd);
+}
+
+/*
+ *  ======== Comm_getMsgSize ========
+ */
+Int Comm_getMsgSize(Comm_Msg msg)
+{
+    return (msg->size);
+}
+
+/*
+ *  ======== Comm_getPriority ========
+ */
+Int Comm_getPriority(Comm_Msg msg)
+{
+    return (msg->reserved1);
+}
+
+/*
+ *  ======== Comm_getSrcQueue ========
+ */
+Int Comm_getSrcQueue(Comm_Msg msg, Comm_Queue *queue)
+{
+    *queue = msg->reserved4;
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_isLocal ========
+ */
+Bool Comm_isLocal(Comm_Queue queue)
+{
+    return (queue / MAXQUEUES == side);
+}
+
+/*
+ *  ======== Comm_locate ========
+ */
+Int Comm_locate(String queueName, Comm_Queue *queue)
+{
+    Int status = Comm_EFAIL;
+    Int id;
+
+    Lock_acquire(moduleLock);
+    for (id = 0; id < MAXQUEUES; id++) {
+        if (queueTab[id] != NULL &&
+            strcmp(queueTab[id]->name, queueName) == 0) {
+            *queue = queueTab[id]->id;
+            status = Comm_EOK;
+            break;
+        }
+    }
+    if (status != Comm_EOK && Comm_shmName != NULL &&
+        linkLocate(queueName, queue)) {
+        status = Comm_EOK;
+    }
+    Lock_release(moduleLock);
+
+    return (status);
+}
+
+/*
+ *  ======== Comm_poolStat ========
+ */
+Bool Comm_poolStat(Comm_PoolStat *statbuf)
+{
+    Lock_acquire(poolLock);
+    *statbuf = poolStat;
+    Lock_release(poolLock);
+
+    statbuf->msgSize = poolMsgSize;
+    statbuf->numUnpooled = __atomic_load_n(&poolStat.numUnpooled,
+        __ATOMIC_RELAXED);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Comm_put ========
+ */
+Int Comm_put(Comm_Queue queue, Comm_Msg msg)
+{
+    Comm_Obj *obj;
+    Comm_Attrs attrs;
+    UInt lane;
+
+    if (queue / MAXQUEUES != side) {
+        if (shm != NULL && queue / MAXQUEUES == 1 - side) {
+            return (linkPut(queue, msg));
+        }
+        GT_1trace(curTrace, GT_7CLASS, "Comm_put> invalid queue %d\n",
+            queue);
+        return (Comm_EFAIL);
+    }
+
+    /* once woken, the receiver may delete the queue; don't touch it after */
+    if ((obj = slotEnter(queue % MAXQUEUES)) == NULL) {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_put> invalid queue %d\n",
+            queue);
+        return (Comm_EFAIL);
+    }
+
+    msg->reserved3 = queue;
+    attrs = obj->attrs;
+    lane = msg->reserved1 < Comm_NUMPRIORITIES ? msg->reserved1 :
+        Comm_PRIORITYHIGH;
+    Queue_fifoPut(&obj->msgs[lane], msg);
+    if (obj->fd != -1) {
+        eventfd_write(obj->fd, 1);
+    }
+    Sem_post(obj->sem);
+
+    slotLeave(queue % MAXQUEUES);
+
+    if (attrs.type == Comm_CALL && attrs.callFxn != NULL) {
+        attrs.callFxn(attrs.callHandle);
+    }
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_release ========
+ */
+Int Comm_release(Comm_Queue queue)
+{
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_setMsgSize ========
+ */
+Int Comm_setMsgSize(Comm_Msg msg, UInt16 size)
+{
+    if (size < sizeof (Comm_MsgHeader) || size > PREFIX(msg)->capacity) {
+        return (Comm_EFAIL);
+    }
+
+    msg->size = size;
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== Comm_setPriority ========
+ */
+Void Comm_setPriority(Comm_Msg msg, Int priority)
+{
+    msg->reserved1 = priority < Comm_PRIORITYNORMAL ? Comm_PRIORITYNORMAL :
+        priority > Comm_PRIORITYHIGH ? Comm_PRIORITYHIGH : priority;
+}
+
+/*
+ *  ======== Comm_setSrcQueue ========
+ */
+Void Comm_setSrcQueue(Comm_Msg msg, Comm_Queue queue)
+{
+    msg->reserved4 = queue;
+}
+
+/*
+ *  ======== Comm_init ========
+ */
+Bool Comm_init(Void)
+{
+    if (refCount++ == 0) {
+        GT_create(&curTrace, Comm_GTNAME);
+
+        if ((moduleLock = Lock_create(NULL)) == NULL) {
+            refCount--;
+            return (FALSE);
+        }
+        if ((sendLock = Lock_create(NULL)) == NULL) {
+            Lock_delete(moduleLock);
+            moduleLock = NULL;
+            refCount--;
+            return (FALSE);
+        }
+        if ((poolLock = Lock_create(NULL)) == NULL ||
+            pthread_key_create(&cacheKey, flushCache) != 0) {
+            if (poolLock != NULL) {
+                Lock_delete(poolLock);
+                poolLock = NULL;
+            }
+            Lock_delete(sendLock);
+            sendLock = NULL;
+            Lock_delete(moduleLock);
+            moduleLock = NULL;
+            refCount--;
+            return (FALSE);
+        }
+
+        /* the server's link is up before RMS_init() creates its queue */
+        side = Comm_shmName != NULL && Comm_shmServer ? 1 : 0;
+        if (side == 1 && !linkCreate()) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm_init> "
+                "can't create link '%s'\n", Comm_shmName);
+            pthread_key_delete(cacheKey);
+            Lock_delete(poolLock);
+            poolLock = NULL;
+            Lock_delete(sendLock);
+            sendLock = NULL;
+            Lock_delete(moduleLock);
+            moduleLock = NULL;
+            refCount--;
+            return (FALSE);
+        }
+
+        /* threads' caches of an earlier pool are stale */
+        poolMsgSize = Comm_MSGSIZE;
+        __atomic_store_n(&poolGeneration, poolGeneration + 1,
+            __ATOMIC_RELEASE);
+        poolFill(NULL);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Comm_exit ========
+ */
+Void Comm_exit(Void)
+{
+    MsgPrefix *prefix;
+
+    if (--refCount == 0) {
+        if (shm != NULL) {
+            linkDetach();
+        }
+
+        /* messages freed from now on, even if cached, aren't pooled */
+        __atomic_store_n(&poolGeneration, poolGeneration + 1,
+            __ATOMIC_RELEASE);
+        poolMsgSize = 0;
+        while ((prefix = poolIdle) != NULL) {
+            poolIdle = prefix->nextIdle;
+            Memory_free(prefix, sizeof (MsgPrefix) + prefix->capacity, NULL);
+        }
+        memset(&poolStat, 0, sizeof (poolStat));
+        pthread_key_delete(cacheKey);
+        Lock_delete(poolLock);
+        poolLock = NULL;
+        Lock_delete(sendLock);
+        sendLock = NULL;
+        Lock_delete(moduleLock);
+        moduleLock = NULL;
+    }
+}
+
+/*
+ *  ======== flushCache ========
+ *  cacheKey's destructor: return an exiting thread's cached messages to
+ *  the pool.
+ */
+static Void flushCache(Ptr arg)
+{
+    MsgCache *mc = (MsgCache *)arg;
+
+    if (mc->generation == __atomic_load_n(&poolGeneration,
+        __ATOMIC_ACQUIRE)) {
+        poolReturn(mc, mc->numIdle);
+    }
+    mc->registered = FALSE;
+}
+
+/*
+ *  ======== futexWait ========
+ *  Sleep while *addr is value.  The futex is in memory shared with the
+ *  peer, so it can't be a process-private one.
+ */
+static Void futexWait(UInt *addr, UInt value)
+{
+    syscall(SYS_futex, addr, FUTEX_WAIT, value, NULL, NULL, 0);
+}
+
+/*
+ *  ======== futexWake ========
+ */
+static Void futexWake(UInt *addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/*
+ *  ======== linkAttach ========
+ *  Attach a client to the server's link.  Must be called with moduleLock
+ *  held.
+ */
+static Bool linkAttach(Void)
+{
+    Thread_Attrs attrs = Thread_ATTRS;
+    struct stat st;
+    Link *map;
+    Int attached = 0;
+    Int fd;
+    Int id;
+
+    if ((fd = shm_open(Comm_shmName, O_RDWR | O_CLOEXEC, 0)) == -1) {
+        GT_1trace(curTrace, GT_6CLASS, "Comm_locate> "
+            "no server has created link '%s'\n", Comm_shmName);
+        return (FALSE);
+    }
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < DATAOFFSET ||
+        (map = (Link *)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        return (FALSE);
+    }
+    close(fd);
+
+    if (__atomic_load_n(&map->magic, __ATOMIC_ACQUIRE) != LINKMAGIC ||
+        DATAOFFSET + 2 * (size_t)map->ringSize > (size_t)st.st_size) {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_locate> "
+            "link '%s' isn't initialized\n", Comm_shmName);
+        munmap(map, st.st_size);
+        return (FALSE);
+    }
+    if (!__atomic_compare_exchange_n(&map->attached, &attached, 1, FALSE,
+        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_locate> "
+            "link '%s' already has a client\n", Comm_shmName);
+        munmap(map, st.st_size);
+        return (FALSE);
+    }
+
+    shm = map;
+    shmSize = st.st_size;
+    for (id = 0; id < MAXQUEUES; id++) {
+        if (queueTab[id] != NULL && queueTab[id]->name[0] != '\0') {
+            linkPublish(queueTab[id], TRUE);
+        }
+    }
+
+    stopReceiver = FALSE;
+    attrs.name = "comm";
+    if ((receiver = Thread_create(linkReceive, &attrs, 0)) == NULL) {
+        memset(shm->names[side], 0, sizeof (shm->names[side]));
+        __atomic_store_n(&shm->attached, 0, __ATOMIC_RELEASE);
+        munmap(shm, shmSize);
+        shm = NULL;
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== linkCreate ========
+ *  Create the server's link, replacing one a crashed server left.
+ */
+static Bool linkCreate(Void)
+{
+    Thread_Attrs attrs = Thread_ATTRS;
+    UInt32 ringSize = 64 * 1024;
+    Int fd;
+
+    while (ringSize < Comm_shmRingSize) {
+        ringSize <<= 1;
+    }
+    shmSize = DATAOFFSET + 2 * ringSize;
+
+    shm_unlink(Comm_shmName);
+    if ((fd = shm_open(Comm_shmName, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+        0600)) == -1) {
+        return (FALSE);
+    }
+    if (ftruncate(fd, shmSize) == -1 ||
+        (shm = (Link *)mmap(NULL, shmSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        shm_unlink(Comm_shmName);
+        shm = NULL;
+        return (FALSE);
+    }
+    close(fd);
+
+    shm->ringSize = ringSize;
+    __atomic_store_n(&shm->magic, LINKMAGIC, __ATOMIC_RELEASE);
+
+    stopReceiver = FALSE;
+    attrs.name = "comm";
+    if ((receiver = Thread_create(linkReceive, &attrs, 0)) == NULL) {
+        munmap(shm, shmSize);
+        shm_unlink(Comm_shmName);
+        shm = NULL;
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== linkDeliver ========
+ *  Copy a record of length bytes into the message it answers, or else a
+ *  new one, and put that on its queue.
+ *
+ *  The peer's header is only as good as the peer: a message size that
+ *  its record or the answered message can't hold drops the record, and
+ *  the priority is clamped.
+ */
+static Void linkDeliver(LinkRecord *rec, UInt length)
+{
+    Comm_Msg src = (Comm_Msg)(rec + 1);
+    Comm_Msg msg = rec->reply;
+    UInt16 size = src->size;
+
+    if (size < sizeof (Comm_MsgHeader) ||
+        size > length - sizeof (LinkRecord)) {
+        GT_2trace(curTrace, GT_7CLASS, "Comm> dropped a %d byte message "
+            "from the peer to queue %d\n", size, rec->dst);
+        return;
+    }
+
+    if (msg == NULL) {
+        if (Comm_alloc(src->reserved2, &msg, size) != Comm_EOK) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm> dropped a message "
+                "from the peer to queue %d\n", rec->dst);
+            return;
+        }
+        PREFIX(msg)->peerMsg = rec->origin;
+    }
+    else if (Comm_setMsgSize(msg, size) != Comm_EOK) {
+        GT_2trace(curTrace, GT_7CLASS, "Comm> dropped a %d byte answer "
+            "from the peer, larger than message 0x%lx\n", size, msg);
+        return;
+    }
+
+    memcpy(msg, src, size);
+    msg->size = size;
+
+    Comm_setPriority(msg, msg->reserved1);
+
+    /* an answer's message stays with whoever deleted the queue */
+    if (Comm_put(rec->dst, msg) != Comm_EOK && rec->reply == NULL) {
+        Comm_free(msg);
+    }
+}
+
+/*
+ *  ======== linkDetach ========
+ *  Stop the receiver and unmap the link; the server removes it too.
+ */
+static Void linkDetach(Void)
+{
+    Ring *ring = &shm->rings[side];
+
+    __atomic_store_n(&stopReceiver, TRUE, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&ring->doorbell, 1, __ATOMIC_SEQ_CST);
+    futexWake(&ring->doorbell);
+    Thread_delete(receiver);
+    receiver = NULL;
+
+    if (side == 1) {
+        shm_unlink(Comm_shmName);
+    }
+    else {
+        memset(shm->names[side], 0, sizeof (shm->names[side]));
+        __atomic_store_n(&shm->attached, 0, __ATOMIC_RELEASE);
+    }
+    munmap(shm, shmSize);
+    shm = NULL;
+    shmSize = 0;
+}
+
+/*
+ *  ======== linkLocate ========
+ *  Look for a queue the peer published, attaching a client to the link
+ *  first if need be.  Must be called with moduleLock held.
+ */
+static Bool linkLocate(String queueName, Comm_Queue *queue)
+{
+    LinkName *names;
+    Int i;
+
+    if (shm == NULL && (side == 1 || !linkAttach())) {
+        return (FALSE);
+    }
+
+    names = shm->names[1 - side];
+    for (i = 0; i < MAXLINKNAMES; i++) {
+        if (__atomic_load_n(&names[i].used, __ATOMIC_ACQUIRE) &&
+            strncmp(names[i].name, queueName, MAXNAMELEN) == 0) {
+            *queue = names[i].id;
+            return (TRUE);
+        }
+    }
+
+    return (FALSE);
+}
+
+/*
+ *  ======== linkPublish ========
+ *  Publish a named queue to the peer, or withdraw it.  Must be called
+ *  with moduleLock held.
+ */
+static Void linkPublish(Comm_Obj *obj, Bool publish)
+{
+    LinkName *names = shm->names[side];
+    Int i;
+
+    for (i = 0; i < MAXLINKNAMES; i++) {
+        if (publish ? !names[i].used :
+            names[i].used && names[i].id == obj->id) {
+            break;
+        }
+    }
+
+    if (i == MAXLINKNAMES) {
+        if (publish) {
+            GT_1trace(curTrace, GT_6CLASS, "Comm_create> "
+                "queue '%s' is not visible to the peer: too many named "
+                "queues\n", obj->name);
+        }
+        return;
+    }
+
+    if (publish) {
+        names[i].id = obj->id;
+        strcpy(names[i].name, obj->name);
+        __atomic_store_n(&names[i].used, 1, __ATOMIC_RELEASE);
+    }
+    else {
+        __atomic_store_n(&names[i].used, 0, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ *  ======== linkPut ========
+ *  Copy a message into the peer's ring.  A copy of one of the peer's
+ *  messages goes back into that message, and is freed; a message of our
+ *  own is kept, for the peer's answer to be copied into.
+ */
+static Int linkPut(Comm_Queue queue, Comm_Msg msg)
+{
+    Ring *ring = &shm->rings[1 - side];
+    UInt8 *data = ringData(1 - side);
+    UInt32 size = shm->ringSize;
+    UInt length = RECORDSIZE(msg->size);
+    Comm_Msg peerMsg = PREFIX(msg)->peerMsg;
+    LinkRecord *rec;
+    UInt tail;
+    UInt pad;
+
+    if (length > size / 4) {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_put> "
+            "%d byte message is too large for the link\n", msg->size);
+        return (Comm_EFAIL);
+    }
+
+    msg->reserved3 = queue;
+
+    Lock_acquire(sendLock);
+
+    tail = ring->tail;
+    pad = (tail & (size - 1)) + length > size ? size - (tail & (size - 1)) :
+        0;
+
+    /* while the ring is full, the peer's receiver is busy emptying it */
+    while (tail + pad + length - __atomic_load_n(&ring->head,
+        __ATOMIC_ACQUIRE) > size) {
+        sched_yield();
+    }
+
+    if (pad != 0) {
+        rec = (LinkRecord *)(data + (tail & (size - 1)));
+        rec->length = pad;
+        rec->dst = Comm_INVALIDMSGQ;
+        tail += pad;
+    }
+
+    rec = (LinkRecord *)(data + (tail & (size - 1)));
+    rec->length = length;
+    rec->dst = queue;
+    rec->reply = peerMsg;
+    rec->origin = peerMsg == NULL ? msg : NULL;
+    memcpy(rec + 1, msg, msg->size);
+
+    /* pairs with the receiver's store of waiting and load of tail */
+    __atomic_store_n(&ring->tail, tail + length, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiting, __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&ring->doorbell, 1, __ATOMIC_SEQ_CST);
+        futexWake(&ring->doorbell);
+    }
+
+    Lock_release(sendLock);
+
+    if (peerMsg != NULL) {
+        Comm_free(msg);
+    }
+
+    return (Comm_EOK);
+}
+
+/*
+ *  ======== linkReceive ========
+ *  Body of the thread that delivers the peer's messages, in order.
+ */
+static Int linkReceive(Arg arg)
+{
+    Ring *ring = &shm->rings[side];
+    UInt8 *data = ringData(side);
+    UInt32 mask = shm->ringSize - 1;
+    UInt head = ring->head;
+    UInt tail;
+    UInt length;
+    UInt doorbell;
+    LinkRecord *rec;
+
+    for (;;) {
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            /* a sender that misses waiting has its tail seen here */
+            doorbell = __atomic_load_n(&ring->doorbell, __ATOMIC_SEQ_CST);
+            __atomic_store_n(&ring->waiting, 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&stopReceiver, __ATOMIC_SEQ_CST)) {
+                break;
+            }
+            if (head == __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST)) {
+                futexWait(&ring->doorbell, doorbell);
+            }
+            __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        /*
+         *  A record off the grid of whole LinkRecords, or past the end of
+         *  the ring or of what the peer has sent, leaves nowhere to find
+         *  the next one: drop everything sent so far.
+         */
+        rec = (LinkRecord *)(data + (head & mask));
+        length = rec->length;
+        if (length < sizeof (LinkRecord) ||
+            length % sizeof (LinkRecord) != 0 ||
+            (head & mask) + length > mask + 1 || length > tail - head) {
+            GT_2trace(curTrace, GT_7CLASS, "Comm> bad %d byte record from "
+                "the peer; dropped %d bytes of messages\n", length,
+                tail - head);
+            head = tail;
+        }
+        else {
+            if (rec->dst != Comm_INVALIDMSGQ) {
+                linkDeliver(rec, length);
+            }
+            head += length;
+        }
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    }
+
+    return (0);
+}
+
+/*
+ *  ======== msgCache ========
+ *  The calling thread's message cache, or NULL if it can't have one.
+ */
+static MsgCache *msgCache(Void)
+{
+    MsgCache *mc = &threadCache;
+    UInt32 generation = __atomic_load_n(&poolGeneration, __ATOMIC_ACQUIRE);
+
+    /* messages cached before Comm_exit() are no longer the pool's */
+    if (mc->generation != generation) {
+        while (mc->numIdle > 0) {
+            mc->numIdle--;
+            Memory_free(mc->idle[mc->numIdle], sizeof (MsgPrefix) +
+                mc->idle[mc->numIdle]->capacity, NULL);
+        }
+        mc->generation = generation;
+        mc->registered = FALSE;
+        mc->hits = 0;
+    }
+    if (!mc->registered) {
+        if (pthread_setspecific(cacheKey, mc) != 0) {
+            return (NULL);
+        }
+        mc->registered = TRUE;
+    }
+
+    return (mc);
+}
+
+/*
+ *  ======== poolAlloc ========
+ *  Take a pooled message from the calling thread's cache, refilling it
+ *  first if it's empty.
+ */
+static MsgPrefix *poolAlloc(Void)
+{
+    MsgCache *mc;
+
+    if ((mc = msgCache()) == NULL) {
+        return (NULL);
+    }
+
+    if (mc->numIdle > 0) {
+        mc->hits++;
+    }
+    else {
+        poolFill(mc);
+        if (mc->numIdle == 0) {
+            return (NULL);
+        }
+    }
+
+    return (mc->idle[--mc->numIdle]);
+}
+
+/*
+ *  ======== poolFill ========
+ *  Move CACHEBATCH messages from the pool to a thread's cache, allocating
+ *  any the pool lacks; or, given no cache, put Comm_poolMsgs new messages
+ *  in the pool.
+ */
+static Void poolFill(MsgCache *mc)
+{
+    MsgPrefix *prefix;
+    Int count = mc == NULL ? Comm_poolMsgs : CACHEBATCH;
+    Int i;
+
+    Lock_acquire(poolLock);
+    if (mc != NULL) {
+        poolStat.hits += mc->hits;
+        poolStat.misses++;
+        mc->hits = 0;
+        while (count > 0 && (prefix = poolIdle) != NULL) {
+            poolIdle = prefix->nextIdle;
+            poolStat.numIdle--;
+            mc->idle[mc->numIdle++] = prefix;
+            count--;
+        }
+    }
+    Lock_release(poolLock);
+
+    for (i = 0; i < count; i++) {
+        if ((prefix = (MsgPrefix *)Memory_alloc(sizeof (MsgPrefix) +
+            poolMsgSize, NULL)) == NULL) {
+            break;
+        }
+        prefix->capacity = poolMsgSize;
+        prefix->generation = poolGeneration;
+
+        Lock_acquire(poolLock);
+        poolStat.numMsgs++;
+        if (mc == NULL) {
+            prefix->nextIdle = poolIdle;
+            poolIdle = prefix;
+            poolStat.numIdle++;
+        }
+        Lock_release(poolLock);
+
+        if (mc != NULL) {
+            mc->idle[mc->numIdle++] = prefix;
+        }
+    }
+}
+
+/*
+ *  ======== poolReturn ========
+ *  Move the count least recently freed messages of a thread's cache to
+ *  the pool, freeing those beyond the Comm_poolMsgs it keeps idle.
+ */
+static Void poolReturn(MsgCache *mc, Int count)
+{
+    MsgPrefix *excess = NULL;
+    MsgPrefix *prefix;
+    Int i;
+
+    Lock_acquire(poolLock);
+    poolStat.hits += mc->hits;
+    mc->hits = 0;
+    for (i = 0; i < count; i++) {
+        prefix = mc->idle[i];
+        if (poolStat.numIdle < (UInt32)Comm_poolMsgs) {
+            prefix->nextIdle = poolIdle;
+            poolIdle = prefix;
+            poolStat.numIdle++;
+        }
+        else {
+            prefix->nextIdle = excess;
+            excess = prefix;
+            poolStat.numMsgs--;
+        }
+    }
+    Lock_release(poolLock);
+
+    mc->numIdle -= count;
+    memmove(mc->idle, mc->idle + count, mc->numIdle * sizeof (MsgPrefix *));
+
+    while ((prefix = excess) != NULL) {
+        excess = prefix->nextIdle;
+        Memory_free(prefix, sizeof (MsgPrefix) + prefix->capacity, NULL);
+    }
+}
+
+/*
+ *  ======== ringData ========
+ *  Data of the ring carrying messages to side to.
+ */
+static UInt8 *ringData(Int to)
+{
+    return ((UInt8 *)shm + DATAOFFSET + (size_t)to * shm->ringSize);
+}
+
+/*
+ *  ======== slotEnter ========
+ *  Get the queue in a slot of queueTab, if any, and keep it from being
+ *  deleted until slotLeave().  The count is raised before the slot is
+ *  read, and Comm_delete() empties the slot before reading the count,
+ *  so one of them sees the other.
+ */
+static Comm_Obj *slotEnter(Int index)
+{
+    Comm_Obj *obj;
+
+    while (__atomic_add_fetch(&slotUsers[index], 1, __ATOMIC_SEQ_CST) &
+        SLOTBLOCKED) {
+        slotLeave(index);
+        while (__atomic_load_n(&slotUsers[index], __ATOMIC_ACQUIRE) &
+            SLOTBLOCKED) {
+            sched_yield();
+        }
+    }
+
+    if ((obj = __atomic_load_n(&queueTab[index], __ATOMIC_SEQ_CST)) ==
+        NULL) {
+        slotLeave(index);
+    }
+
+    return (obj);
+}
+
+/*
+ *  ======== slotLeave ========
+ */
+static Void slotLeave(Int index)
+{
+    __atomic_sub_fetch(&slotUsers[index], 1, __ATOMIC_RELEASE);
+}
+
+/*
+ *  ======== slotQuiesce ========
+ *  Wait for the puts in progress to a slot to finish.
+ */
+static Void slotQuiesce(Int index)
+{
+    while ((__atomic_load_n(&slotUsers[index], __ATOMIC_SEQ_CST) &
+        ~SLOTBLOCKED) != 0) {
+        sched_yield();
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ *  ======== Lock_posix.c ========
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <ti/sdo/ce/osal/Lock.h>
+
+typedef struct Lock_Obj {
+    pthread_mutex_t mutex;
+} Lock_Obj;
+
+Lock_Attrs Lock_ATTRS = {
+    0,          /* dummy */
+};
+
+/*
+ *  ======== Lock_acquire ========
+ */
+Void Lock_acquire(Lock_Handle lock)
+{
+    pthread_mutex_lock(&lock->mutex);
+}
+
+/*
+ *  ======== Lock_create ========
+ */
+Lock_Handle Lock_create(Lock_Attrs *attrs)
+{
+    pthread_mutexattr_t mattrs;
+    Lock_Obj *lock;
+
+    if ((lock = (Lock_Obj *)malloc(sizeof (Lock_Obj))) == NULL) {
+        return (NULL);
+    }
+
+    pthread_mutexattr_init(&mattrs);
+    pthread_mutexattr_settype(&mattrs, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&lock->mutex, &mattrs);
+    pthread_mutexattr_destroy(&mattrs);
+
+    return (lock);
+}
+
+/*
+ *  ======== Lock_delete ========
+ */
+Void Lock_delete(Lock_Handle lock)
+{
+    if (lock != NULL) {
+        pthread_mutex_destroy(&lock->mutex);
+        free(lock);
+    }
+}
+
+/*
+ *  ======== Lock_release ========
+ */
+Void Lock_release(Lock_Handle lock)
+{
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+/*
+ *  ======== Lock_tryAcquire ========
+ */
+Bool Lock_tryAcquire(Lock_Handle lock)
+{
+    return (pthread_mutex_trylock(&lock->mutex) == 0);
+}
+
+/*
+ *  ======== Lock_init ========
+ */
+Bool Lock_init(Void)
+{
+    return (TRUE);
+}
+
+/*
+ *  ======== Lock_exit ========
+ */
+Void Lock_exit(Void)
+{
+}
@@ -0,0 +1,2622 @@
+/*
+ *  ======== Memory_posix.c ========
+ *  Host implementation of the OSAL Memory module.
+ *
+ *  On the host, the "remote" server runs in the application's address
+ *  space, so every buffer is trivially shared and physical addresses are
+ *  the same as virtual ones.  Contiguous allocations come from the C
+ *  heap, but are still recorded in the known-contiguous-buffer list,
+ *  exactly as Memory_cmem does on the target, so address translation
+ *  costs what it costs there.
+ *
+ *  Buffers registered with Memory_registerBuf() are also entered, with
+ *  the physical address computed once, in a fixed open-addressed table
+ *  keyed by their base addresses.  Translations of a registered buffer's
+ *  base address are found there without taking moduleLock or walking the
+ *  list: each entry is guarded by a sequence count that writers, who do
+ *  hold moduleLock, make odd while they change the entry.
+ *
+ *  Memory_contigAlloc() and Memory_CONTIGPOOL allocations are pooled: on
+ *  Memory_contigFree() their memory is kept, up to Memory_poolMaxIdle
+ *  bytes, on the idle list of its size class, and later allocations of
+ *  the class take it from there instead of the C heap.  Frame-sized
+ *  buffers are mmap()ed by the C heap, so in a pipeline that allocates
+ *  and frees its frames this saves two system calls and the page faults
+ *  of fresh memory per frame.  Memory_CONTIGHEAP allocations are not
+ *  pooled.
+ *
+ *  Pooled buffers stay in the known-buffer list while idle, and are also
+ *  entered in a pooled buffer index that, like the registered buffer
+ *  table, is read without moduleLock.  So allocating and freeing them
+ *  needn't take the lock: a freed buffer is kept in a small cache of the
+ *  freeing thread, or else in the lock-free depot of its size class, and
+ *  an allocation looks in the same places.  Only the overflow of the
+ *  depots, the idle lists, and new memory take moduleLock, whose
+ *  acquisitions and waits Memory_contigStat() counts.  Memory_MALLOC
+ *  allocations come straight from the C heap, whose arenas and caches
+ *  are already per-thread.
+ *
+ *  If the application sets Memory_contigHeapSize, Memory_CONTIGHEAP
+ *  allocations instead come from a buddy heap of that size, mapped when
+ *  the module is initialized.  Blocks are powers of 2 from
+ *  Memory_HEAPMINBLOCK bytes, aligned on their size, and a freed block
+ *  is merged with its buddy whenever that is free too, so long-running
+ *  allocate/free churn can't splinter the heap the way a first-fit heap
+ *  does.  Memory_contigStat() and Memory_contigHeapStat() report on it.
+ *
+ *  If the application sets Memory_emulateCmem, the module instead behaves
+ *  like the CMEM-based one, for testing the memory paths without cmemk.ko:
+ *  the heap is always created, in a memfd shared mapping, and all
+ *  contiguous buffers, pooled ones included, come from it.  The buffers'
+ *  physical addresses are faked, as their offset in the heap from
+ *  Memory_emulatedPhysBase, and memory that isn't in a known contiguous
+ *  buffer has no physical address at all.
+ *
+ *  If Memory_emulatedHeapName is set too, the heap is mapped from the
+ *  POSIX shared memory object of that name instead, which a server
+ *  process, linked to this one by Comm_shmName, maps as well: as
+ *  Memory_emulateCmem isn't set there, it maps the object the first time
+ *  it translates a physical address, and enters it as an imported buffer
+ *  at Memory_emulatedPhysBase, so the physical addresses the codecs pass
+ *  between the processes are the same in both.
+ *
+ *  Blocks of the emulated CMEM heap can also be exported as dma-bufs, by
+ *  udmabuf, which makes them from the pages of a sealed memfd; and
+ *  dma-bufs of other drivers can be imported, as registered contiguous
+ *  buffers, so frames pass between the codecs and V4L2 or DRM devices
+ *  without copies.
+ *
+ *  Each contiguous allocation is charged to the account its thread set
+ *  with Memory_setAccount(), if any, and to that account's parents; the
+ *  buffer remembers the account, so it is credited back when freed, by
+ *  whichever thread.  Accounts live in a fixed table, and their ids carry
+ *  a generation, so a buffer freed after its account was deleted, or its
+ *  slot reused, credits nothing.  The statistics are kept with atomic
+ *  operations, so charging takes no lock.
+ *
+ *  If the application sets Memory_hugePageMinSize, pools of buffers at
+ *  least that big and the heap are backed by huge pages: from hugetlbfs
+ *  if the system has reserved some, or else transparent huge pages.
+ *  Frame buffers then take a handful of TLB entries instead of hundreds.
+ *
+ *  The cache maintenance calls are no-ops: host CPUs are cache coherent.
+ *  The dirty flags Memory_setBufferDirty() sets are kept all the same,
+ *  so applications see the same flags as on a device.
+ */
+#include <xdc/std.h>
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <linux/udmabuf.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Lock.h>
+#include <ti/sdo/ce/osal/Queue.h>
+
+/* default alignment of contiguous buffers, sized for DMA engines */
+#define CONTIGALIGN     128
+
+/* pool size classes: multiples of CONTIGALIGN, then of POOLPAGE */
+#define POOLPAGE        4096
+
+/* log2(Memory_HEAPMINBLOCK) */
+#define HEAPMINORDER    7
+
+/* size of a huge page */
+#define HUGEPAGE        (2 * 1024 * 1024)
+
+/* the heap's base is aligned on this, for blocks' larger alignments */
+#define HEAPALIGN       HUGEPAGE
+
+/* ContigBuf.cpuState values */
+#define BUFUNTRACKED    0       /* always written back */
+#define BUFDIRTY        1       /* written by the CPU since its writeback */
+#define BUFCLEAN        2
+
+/* ContigBuf.poolState values */
+#define POOLINUSE       0
+#define POOLIDLE        1
+
+/* size classes a thread caches idle buffers of, and buffers per class */
+#define CACHECLASSES    8
+#define CACHEDEPTH      8
+
+/* largest size class a thread caches */
+#define CACHEMAXSIZE    (64 * 1024)
+
+/* idle buffers a size class keeps in its lock-free depot */
+#define DEPOTSLOTS      32
+
+/* size of an emulated CMEM heap, if Memory_contigHeapSize doesn't say */
+#define EMUHEAPSIZE     (64 * 1024 * 1024)
+
+/* heapOrders entry flag: the block starting there is free */
+#define HEAPFREE        0x80
+
+/* size of the registered buffer table, a power of 2 */
+#define REGBUFSBITS     10
+#define MAXREGBUFS      (1 << REGBUFSBITS)
+
+/* Memory_BufObj.state */
+#define REGBUFEMPTY     0       /* never used: ends a probe */
+#define REGBUFUSED      1
+#define REGBUFDELETED   2       /* unregistered: probes continue past it */
+
+/* a slot of physIndex whose entry was unregistered */
+#define PHYSDELETED     ((Memory_BufObj *)-1)
+
+/* size of the pooled buffer index; hashed like regBufs */
+#define MAXPOOLBUFS     MAXREGBUFS
+
+/* a slot of poolIndex whose buffer was released: probes continue past it */
+#define POOLDELETED     ((struct ContigBuf *)-1)
+
+/* size of the account table (a power of 2); slot 0 is Memory_NOACCOUNT */
+#define MAXACCOUNTS     256
+
+/* account ids are a slot plus MAXACCOUNTS times the slot's generation */
+#define ACCOUNTGENMASK  0x7fffff
+
+/*
+ *  ======== TreeNode ========
+ *  A node of an interval tree, covering [start, end).  Nodes are ordered
+ *  by start, then by their own addresses, so equal starts are allowed.
+ */
+typedef struct TreeNode {
+    struct TreeNode *left;
+    struct TreeNode *right;
+    UInt32          start;
+    UInt32          end;
+    UInt32          maxEnd;     /* greatest end in this subtree */
+    Int             height;
+} TreeNode;
+
+/*
+ *  ======== ContigBuf ========
+ *  An entry in the known-contiguous-buffer list.  Pooled buffers stay in
+ *  the list, idle or not, until their memory is released.
+ */
+typedef struct ContigBuf {
+    Queue_Elem  link;
+    TreeNode    virtNode;       /* in virtTree */
+    TreeNode    physNode;       /* in physTree */
+    UInt32      virtualAddress;
+    UInt32      physicalAddress;
+    UInt32      sizeInBytes;
+    Bool        isAllocated;    /* TRUE if from Memory_contigAlloc() */
+    UInt32      poolSize;       /* size class of a pooled buffer, or 0 */
+    struct PoolClass *pool;     /* class of a pooled buffer, or NULL */
+    Int         poolState;      /* POOLINUSE or POOLIDLE */
+    Int         cpuState;       /* BUFUNTRACKED, BUFDIRTY or BUFCLEAN */
+    Bool        isImported;     /* mapped by Memory_importDmaBuf() */
+    Int         account;        /* charged for it, or Memory_NOACCOUNT */
+    struct ContigBuf *nextIdle; /* in PoolClass.idle */
+} ContigBuf;
+
+/*
+ *  ======== PoolClass ========
+ *  The idle buffers of one pool size class that no thread caches: up to
+ *  DEPOTSLOTS of them in the depot, which threads fill and empty with
+ *  atomic operations, and the rest on the idle list, under moduleLock.
+ */
+typedef struct PoolClass {
+    UInt32      size;
+    ContigBuf   *depot[DEPOTSLOTS];     /* NULL: empty slot */
+    ContigBuf   *idle;          /* most recently freed first */
+    struct PoolClass *next;
+} PoolClass;
+
+/*
+ *  ======== PoolSlot ========
+ *  An entry in the pooled buffer index.  The fields after seq are only
+ *  read between two reads of an even, unchanged seq.
+ */
+typedef struct PoolSlot {
+    UInt32      seq;
+    UInt32      virtualAddress;
+    ContigBuf   *cb;            /* NULL: never used: ends a probe */
+} PoolSlot;
+
+/*
+ *  ======== CacheClass ========
+ *  The idle buffers of one size class a thread caches.
+ */
+typedef struct CacheClass {
+    PoolClass   *pool;
+    Int         numIdle;
+    ContigBuf   *idle[CACHEDEPTH];      /* most recently freed last */
+} CacheClass;
+
+/*
+ *  ======== ThreadCache ========
+ */
+typedef struct ThreadCache {
+    UInt32      generation;     /* poolGeneration it was filled in */
+    Bool        registered;     /* cacheKey's destructor will flush it */
+    Int         numClasses;
+    CacheClass  classes[CACHECLASSES];
+} ThreadCache;
+
+/*
+ *  ======== Account ========
+ *  An entry in the account table.  The fields after id are only written
+ *  before id is published, or with atomic operations.
+ */
+typedef struct Account {
+    Int         id;             /* Memory_NOACCOUNT: free slot */
+    UInt32      generation;     /* of the slot's next id */
+    Int         parent;
+    Memory_AccountStat stat;
+} Account;
+
+/*
+ *  ======== HeapBlock ========
+ *  The start of a free heap block, linking it into its order's free list.
+ */
+typedef struct HeapBlock {
+    struct HeapBlock *next;
+    struct HeapBlock *prev;
+} HeapBlock;
+
+/*
+ *  ======== Memory_BufObj ========
+ *  An entry in the registered buffer table.  The fields after seq are
+ *  only read between two reads of an even, unchanged seq.
+ */
+typedef struct Memory_BufObj {
+    UInt32      seq;
+    Int         state;
+    UInt32      virtualAddress;
+    UInt32      physicalAddress;
+    Int         sizeInBytes;
+} Memory_BufObj;
+
+Memory_AllocParams Memory_DEFAULTPARAMS = {
+    Memory_MALLOC,              /* type */
+    Memory_CACHED,              /* flags */
+    Memory_DEFAULTALIGNMENT,    /* align */
+    0,                          /* seg */
+};
+
+UInt32 Memory_poolMaxIdle __attribute__((weak)) = 64 * 1024 * 1024;
+UInt32 Memory_contigHeapSize __attribute__((weak)) = 0;
+Bool Memory_emulateCmem __attribute__((weak)) = FALSE;
+UInt32 Memory_emulatedPhysBase __attribute__((weak)) = 0x80000000;
+String Memory_emulatedHeapName __attribute__((weak)) = NULL;
+UInt32 Memory_hugePageMinSize __attribute__((weak)) = 0;
+
+static Void acquireLock(Void);
+static ContigBuf *addContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
+    UInt32 physicalAddress, Bool isAllocated, PoolClass *pool);
+static Ptr blockAlloc(UInt32 size, UInt align, Bool pooled);
+static Void blockFree(Ptr addr);
+static UInt32 blockPhys(Ptr addr);
+static CacheClass *cacheClass(UInt32 size);
+static Void charge(Int account, UInt32 size);
+static Ptr contigAlloc(UInt size, UInt align, Bool pooled);
+static Void credit(Int account, UInt32 size);
+static Bool depotPut(PoolClass *pc, ContigBuf *cb);
+static Account *findAccount(Int account);
+static ContigBuf *findByPhys(UInt32 physicalAddress);
+static ContigBuf *findByVirt(UInt32 virtualAddress);
+static PoolClass *findPool(UInt32 size, Bool create);
+static ContigBuf *findPoolBuf(UInt32 virtualAddress);
+static Memory_BufObj *findRegBuf(UInt32 address, Bool byPhys,
+    Memory_BufObj *copy);
+static Void flushCache(Ptr arg);
+static UInt32 hashAddress(UInt32 address);
+static Ptr heapAlloc(UInt32 size, UInt align);
+static Bool heapCreate(UInt32 size, Bool shared);
+static Void heapDelete(Void);
+static Void heapFree(Ptr addr);
+static UInt8 *heapMap(UInt32 size, Bool shared, Bool huge);
+static Int heapOpen(Void);
+static Void heapPush(UInt32 offset, Int order);
+static Void heapRemove(HeapBlock *block, Int order);
+static Void insertContigBuf(ContigBuf *cb);
+static Void peerHeapMap(Void);
+static UInt32 poolSize(UInt size);
+static Bool putIdle(ContigBuf *cb, Bool cache);
+static Void readPoolSlot(PoolSlot *ps, PoolSlot *copy);
+static Void readRegBuf(Memory_BufObj *rb, Memory_BufObj *copy);
+static Void releaseBuf(ContigBuf *cb);
+static Void removeContigBuf(ContigBuf *cb);
+static ContigBuf *takeIdle(UInt32 size, UInt align);
+static TreeNode *treeBalance(TreeNode *node);
+static TreeNode *treeFind(TreeNode *root, UInt32 address);
+static TreeNode *treeInsert(TreeNode *root, TreeNode *node);
+static TreeNode *treeRemove(TreeNode *root, TreeNode *node);
+static TreeNode *treeRemoveMin(TreeNode *root, TreeNode **min);
+static TreeNode *treeRotate(TreeNode *node, Bool left);
+static Void treeUpdate(TreeNode *node);
+static Void writePoolSlot(PoolSlot *ps, UInt32 virtualAddress,
+    ContigBuf *cb);
+static Void writeRegBuf(Memory_BufObj *rb, Int state, UInt32 virtualAddress,
+    UInt32 physicalAddress, Int sizeInBytes);
+static Void writebackRanges(Memory_CacheRange ranges[], Int numRanges);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Lock_Handle moduleLock = NULL;
+static Queue_Elem contigBufList;
+static TreeNode *virtTree = NULL;   /* contigBufList, by virtual address */
+static TreeNode *physTree = NULL;   /* contigBufList, by physical address */
+static UInt32 contigUsed = 0;
+static Int refCount = 0;
+static Memory_BufObj regBufs[MAXREGBUFS];       /* keyed by virt address */
+static Memory_BufObj *physIndex[MAXREGBUFS];    /* regBufs, keyed by phys */
+static Int numRegBufs = 0;                      /* in regBufs */
+static PoolClass *poolClasses = NULL;
+static Memory_PoolStat poolStat = {0, 0, 0, 0};
+static PoolSlot poolIndex[MAXPOOLBUFS];         /* keyed by virt address */
+static UInt32 poolGeneration = 0;   /* changes when the pool is emptied */
+static pthread_key_t cacheKey;      /* flushes threadCache on thread exit */
+static __thread ThreadCache threadCache;
+static UInt32 lockAcquires = 0;
+static UInt32 lockWaits = 0;
+static UInt32 numMarked = 0;        /* Memory_setBufferDirty() calls */
+static UInt8 *heapBase = NULL;      /* NULL: no heap */
+static UInt32 heapSize = 0;
+static UInt8 *heapOrders = NULL;    /* order of the block at each minblock */
+static HeapBlock *heapFreeList[Memory_HEAPORDERS];
+static UInt32 heapNumFree[Memory_HEAPORDERS];
+static UInt32 heapUsed = 0;
+static Int heapFd = -1;             /* memfd of an emulated CMEM heap */
+static UInt32 importPhys = 0;       /* next fake phys of an imported buf */
+static Bool peerHeapMapped = FALSE; /* Memory_emulatedHeapName of a peer */
+static Account accounts[MAXACCOUNTS];
+static __thread Int curAccount = Memory_NOACCOUNT;
+
+/*
+ *  ======== Memory_alloc ========
+ */
+Ptr Memory_alloc(UInt size, Memory_AllocParams *params)
+{
+    Ptr addr = NULL;
+
+    if (params == NULL) {
+        params = &Memory_DEFAULTPARAMS;
+    }
+
+    GT_3trace(curTrace, GT_ENTER, "Memory_alloc> "
+        "Enter(size=0x%x, type=%d, align=0x%x)\n", size, params->type,
+        params->align);
+
+    switch (params->type) {
+        case Memory_MALLOC:
+            if (params->align == Memory_DEFAULTALIGNMENT) {
+                addr = malloc(size);
+            }
+            else if (posix_memalign(&addr, params->align < sizeof (Ptr) ?
+                    sizeof (Ptr) : params->align, size) != 0) {
+                addr = NULL;
+            }
+            break;
+
+        case Memory_CONTIGPOOL:
+            addr = contigAlloc(size, params->align, TRUE);
+            break;
+
+        case Memory_CONTIGHEAP:
+            addr = contigAlloc(size, params->align, FALSE);
+            break;
+
+        case Memory_SEG:
+        default:
+            GT_1trace(curTrace, GT_7CLASS, "Memory_alloc> "
+                "allocation type %d not supported on the host\n",
+                params->type);
+            break;
+    }
+
+    GT_1trace(curTrace, GT_ENTER, "Memory_alloc> return (0x%lx)\n", addr);
+
+    return (addr);
+}
+
+/*
+ *  ======== Memory_cacheInv ========
+ */
+Void Memory_cacheInv(Ptr addr, Int sizeInBytes)
+{
+}
+
+/*
+ *  ======== Memory_cacheInvRanges ========
+ */
+Void Memory_cacheInvRanges(Memory_CacheRange ranges[], Int numRanges)
+{
+}
+
+/*
+ *  ======== Memory_cacheWb ========
+ */
+Void Memory_cacheWb(Ptr addr, Int sizeInBytes)
+{
+}
+
+/*
+ *  ======== Memory_cacheWbInv ========
+ */
+Void Memory_cacheWbInv(Ptr addr, Int sizeInBytes)
+{
+}
+
+/*
+ *  ======== Memory_cacheWbInvRanges ========
+ */
+Void Memory_cacheWbInvRanges(Memory_CacheRange ranges[], Int numRanges)
+{
+    writebackRanges(ranges, numRanges);
+}
+
+/*
+ *  ======== Memory_cacheWbRanges ========
+ */
+Void Memory_cacheWbRanges(Memory_CacheRange ranges[], Int numRanges)
+{
+    writebackRanges(ranges, numRanges);
+}
+
+/*
+ *  ======== Memory_contigAlloc ========
+ */
+Ptr Memory_contigAlloc(UInt size, UInt align)
+{
+    return (contigAlloc(size, align, TRUE));
+}
+
+/*
+ *  ======== Memory_contigFree ========
+ */
+Bool Memory_contigFree(Ptr addr, UInt size)
+{
+    Int state = POOLINUSE;
+    ContigBuf *cb;
+
+    GT_2trace(curTrace, GT_ENTER, "Memory_contigFree> "
+        "Enter(addr=0x%lx, size=0x%x)\n", addr, size);
+
+    /* pooled buffers are looked up, and idled, without moduleLock */
+    if ((cb = findPoolBuf((UInt32)addr)) == NULL) {
+        acquireLock();
+
+        cb = findByVirt((UInt32)addr);
+        if (cb != NULL && cb->isAllocated && cb->poolSize == 0 &&
+            cb->virtualAddress == (UInt32)addr) {
+            removeContigBuf(cb);
+            Lock_release(moduleLock);
+
+            if (cb->sizeInBytes != size) {
+                GT_2trace(curTrace, GT_6CLASS, "Memory_contigFree> "
+                    "size 0x%x does not match allocated size 0x%x\n", size,
+                    cb->sizeInBytes);
+            }
+            __atomic_sub_fetch(&contigUsed, cb->sizeInBytes,
+                __ATOMIC_RELAXED);
+            credit(cb->account, cb->sizeInBytes);
+            free(cb);
+            blockFree(addr);
+
+            return (TRUE);
+        }
+
+        Lock_release(moduleLock);
+    }
+
+    /* an idle pooled buffer is freed twice, and so not allocated */
+    if (cb == NULL || cb->poolSize == 0 ||
+        cb->virtualAddress != (UInt32)addr ||
+        !__atomic_compare_exchange_n(&cb->poolState, &state, POOLIDLE,
+        FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        GT_1trace(curTrace, GT_7CLASS, "Memory_contigFree> "
+            "0x%lx was not allocated by Memory_contigAlloc()\n", addr);
+        return (FALSE);
+    }
+
+    if (cb->sizeInBytes != size) {
+        GT_2trace(curTrace, GT_6CLASS, "Memory_contigFree> "
+            "size 0x%x does not match allocated size 0x%x\n", size,
+            cb->sizeInBytes);
+    }
+
+    __atomic_sub_fetch(&contigUsed, cb->sizeInBytes, __ATOMIC_RELAXED);
+    credit(cb->account, cb->sizeInBytes);
+    if (!putIdle(cb, TRUE)) {
+        releaseBuf(cb);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_contigHeapStat ========
+ */
+Bool Memory_contigHeapStat(Memory_HeapStat *statbuf)
+{
+    UInt32 freeBytes = 0;
+    Int i;
+
+    memset(statbuf, 0, sizeof (Memory_HeapStat));
+
+    acquireLock();
+
+    if (heapBase == NULL) {
+        Lock_release(moduleLock);
+        return (FALSE);
+    }
+
+    statbuf->size = heapSize;
+    statbuf->used = heapUsed;
+    for (i = 0; i < Memory_HEAPORDERS; i++) {
+        statbuf->numFree[i] = heapNumFree[i];
+        if (heapNumFree[i] != 0) {
+            statbuf->largestFree = (UInt32)Memory_HEAPMINBLOCK << i;
+            freeBytes += heapNumFree[i] * ((UInt32)Memory_HEAPMINBLOCK << i);
+        }
+    }
+
+    Lock_release(moduleLock);
+
+    /* in units of Memory_HEAPMINBLOCK, so a 32-bit UInt32 can't overflow */
+    if (freeBytes != 0) {
+        statbuf->fragmentation = (Int)(100 -
+            (statbuf->largestFree >> HEAPMINORDER) * 100 /
+            (freeBytes >> HEAPMINORDER));
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_contigStat ========
+ *  Without a heap the host allocator has no fixed segment, so only the
+ *  number of bytes in use, and the lock counts, are meaningful.
+ */
+Bool Memory_contigStat(Memory_Stat *statbuf)
+{
+    Int i;
+
+    acquireLock();
+
+    statbuf->name = "host";
+    statbuf->base = heapBase == NULL ? 0 : blockPhys(heapBase);
+    statbuf->size = heapSize;
+    statbuf->used = __atomic_load_n(&contigUsed, __ATOMIC_RELAXED);
+    statbuf->lockAcquires = lockAcquires;
+    statbuf->lockWaits = lockWaits;
+    statbuf->length = 0;
+    for (i = Memory_HEAPORDERS - 1; i >= 0; i--) {
+        if (heapNumFree[i] != 0) {
+            statbuf->length = (UInt32)Memory_HEAPMINBLOCK << i;
+            break;
+        }
+    }
+
+    Lock_release(moduleLock);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_createAccount ========
+ */
+Int Memory_createAccount(Int parent)
+{
+    Account *acct;
+    Int id = Memory_NOACCOUNT;
+    Int i;
+
+    acquireLock();
+
+    for (i = 1; i < MAXACCOUNTS; i++) {
+        acct = &accounts[i];
+        if (acct->id == Memory_NOACCOUNT) {
+            id = (Int)((acct->generation++ & ACCOUNTGENMASK) * MAXACCOUNTS +
+                i);
+            acct->parent = parent;
+            memset(&acct->stat, 0, sizeof (acct->stat));
+            __atomic_store_n(&acct->id, id, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+
+    Lock_release(moduleLock);
+
+    if (id == Memory_NOACCOUNT) {
+        GT_0trace(curTrace, GT_6CLASS, "Memory_createAccount> "
+            "all accounts are in use\n");
+    }
+
+    return (id);
+}
+
+/*
+ *  ======== Memory_deleteAccount ========
+ */
+Void Memory_deleteAccount(Int account)
+{
+    Account *acct = &accounts[account & (MAXACCOUNTS - 1)];
+
+    if (account == Memory_NOACCOUNT) {
+        return;
+    }
+
+    acquireLock();
+    if (acct->id == account) {
+        __atomic_store_n(&acct->id, Memory_NOACCOUNT, __ATOMIC_RELEASE);
+    }
+    Lock_release(moduleLock);
+}
+
+/*
+ *  ======== Memory_dumpKnownContigBufsList ========
+ */
+Void Memory_dumpKnownContigBufsList(Void)
+{
+    ContigBuf *cb;
+
+    acquireLock();
+
+    GT_0trace(curTrace, GT_5CLASS, "Memory_dumpKnownContigBufsList> "
+        "known contiguous buffers:\n");
+
+    for (cb = Queue_head(&contigBufList); cb != NULL;
+        cb = Queue_next(&contigBufList, cb)) {
+        GT_4trace(curTrace, GT_5CLASS, "  virt=0x%lx phys=0x%lx size=0x%lx "
+            "%s\n", cb->virtualAddress, cb->physicalAddress, cb->sizeInBytes,
+            !cb->isAllocated ? "(registered)" : cb->poolSize != 0 &&
+            cb->poolState == POOLIDLE ? "(idle)" : "(allocated)");
+    }
+
+    Lock_release(moduleLock);
+}
+
+/*
+ *  ======== Memory_exportDmaBuf ========
+ *  udmabuf makes a dma-buf of pages of a sealed memfd, so only the
+ *  emulated CMEM heap's blocks of at least a page can be exported.
+ */
+Int Memory_exportDmaBuf(Ptr virtualAddress, UInt32 sizeInBytes)
+{
+    UInt32 pageSize = (UInt32)sysconf(_SC_PAGESIZE);
+    UInt32 offset = (UInt8 *)virtualAddress - heapBase;
+    struct udmabuf_create create;
+    UInt32 blockSize = 0;
+    Int dev;
+    Int fd;
+
+    GT_2trace(curTrace, GT_ENTER, "Memory_exportDmaBuf> "
+        "Enter(virt=0x%lx, size=0x%lx)\n", virtualAddress, sizeInBytes);
+
+    create.size = (sizeInBytes + pageSize - 1) & ~(pageSize - 1);
+
+    acquireLock();
+    if (heapFd != -1 && (UInt8 *)virtualAddress >= heapBase &&
+        offset < heapSize && (offset & (pageSize - 1)) == 0 &&
+        !(heapOrders[offset >> HEAPMINORDER] & HEAPFREE)) {
+        blockSize = (UInt32)Memory_HEAPMINBLOCK <<
+            heapOrders[offset >> HEAPMINORDER];
+    }
+    Lock_release(moduleLock);
+
+    if (sizeInBytes == 0 || create.size > blockSize) {
+        GT_2trace(curTrace, GT_7CLASS, "Memory_exportDmaBuf> "
+            "0x%lx (size 0x%lx) is not whole pages of a block of the "
+            "emulated CMEM heap\n", virtualAddress, sizeInBytes);
+        return (-1);
+    }
+
+    if ((dev = open("/dev/udmabuf", O_RDWR | O_CLOEXEC)) == -1) {
+        GT_0trace(curTrace, GT_7CLASS, "Memory_exportDmaBuf> "
+            "can't open /dev/udmabuf\n");
+        return (-1);
+    }
+
+    create.memfd = heapFd;
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = offset;
+    if ((fd = ioctl(dev, UDMABUF_CREATE, &create)) == -1) {
+        GT_1trace(curTrace, GT_7CLASS, "Memory_exportDmaBuf> "
+            "UDMABUF_CREATE of 0x%lx failed\n", virtualAddress);
+    }
+
+    close(dev);
+
+    return (fd);
+}
+
+/*
+ *  ======== Memory_free ========
+ */
+Bool Memory_free(Ptr addr, UInt size, Memory_AllocParams *params)
+{
+    Bool status = TRUE;
+
+    if (params == NULL) {
+        params = &Memory_DEFAULTPARAMS;
+    }
+
+    GT_3trace(curTrace, GT_ENTER, "Memory_free> "
+        "Enter(addr=0x%lx, size=0x%x, type=%d)\n", addr, size, params->type);
+
+    switch (params->type) {
+        case Memory_MALLOC:
+            free(addr);
+            break;
+
+        case Memory_CONTIGPOOL:
+        case Memory_CONTIGHEAP:
+            status = Memory_contigFree(addr, size);
+            break;
+
+        case Memory_SEG:
+        default:
+            status = FALSE;
+            break;
+    }
+
+    return (status);
+}
+
+/*
+ *  ======== Memory_getAccount ========
+ */
+Int Memory_getAccount(Void)
+{
+    return (curAccount);
+}
+
+/*
+ *  ======== Memory_getAccountStat ========
+ */
+Bool Memory_getAccountStat(Int account, Memory_AccountStat *statbuf)
+{
+    Account *acct;
+
+    if ((acct = findAccount(account)) == NULL) {
+        return (FALSE);
+    }
+
+    statbuf->used = __atomic_load_n(&acct->stat.used, __ATOMIC_RELAXED);
+    statbuf->peak = __atomic_load_n(&acct->stat.peak, __ATOMIC_RELAXED);
+    statbuf->numAllocs = __atomic_load_n(&acct->stat.numAllocs,
+        __ATOMIC_RELAXED);
+    statbuf->numFrees = __atomic_load_n(&acct->stat.numFrees,
+        __ATOMIC_RELAXED);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_getBufPhysicalAddress ========
+ */
+UInt32 Memory_getBufPhysicalAddress(Memory_BufHandle buf)
+{
+    return (buf->physicalAddress);
+}
+
+/*
+ *  ======== Memory_getBufferPhysicalAddress ========
+ */
+UInt32 Memory_getBufferPhysicalAddress(Ptr virtualAddress, Int sizeInBytes,
+    Bool *isContiguous)
+{
+    UInt32 va = (UInt32)virtualAddress;
+    UInt32 pa;
+    ContigBuf *cb;
+    Memory_BufObj rb;
+    Bool contig = TRUE;
+
+    if (findRegBuf(va, FALSE, &rb) != NULL && sizeInBytes <= rb.sizeInBytes) {
+        if (isContiguous != NULL) {
+            *isContiguous = TRUE;
+        }
+        return (rb.physicalAddress);
+    }
+
+    acquireLock();
+
+    if ((cb = findByVirt(va)) == NULL) {
+        /* unknown buffers are reachable as-is by the in-process server */
+        pa = heapFd == -1 ? va : 0;
+        contig = heapFd == -1;
+    }
+    else if (va + sizeInBytes > cb->virtualAddress + cb->sizeInBytes) {
+        pa = 0;
+        contig = FALSE;
+    }
+    else {
+        pa = cb->physicalAddress + (va - cb->virtualAddress);
+    }
+
+    Lock_release(moduleLock);
+
+    if (isContiguous != NULL) {
+        *isContiguous = contig;
+    }
+    else if (!contig) {
+        GT_2trace(curTrace, GT_7CLASS, "Memory_getBufferPhysicalAddress> "
+            "buffer 0x%lx (size 0x%x) is not contiguous\n", virtualAddress,
+            sizeInBytes);
+    }
+
+    return (pa);
+}
+
+/*
+ *  ======== Memory_getBufferVirtualAddress ========
+ */
+Ptr Memory_getBufferVirtualAddress(UInt32 physicalAddress, Int sizeInBytes)
+{
+    ContigBuf *cb;
+    Memory_BufObj rb;
+    Ptr va;
+
+    if (findRegBuf(physicalAddress, TRUE, &rb) != NULL) {
+        return ((Ptr)rb.virtualAddress);
+    }
+
+    /* the peer's heap is mapped when its first buffer arrives */
+    if (Memory_emulatedHeapName != NULL && !Memory_emulateCmem &&
+        !__atomic_load_n(&peerHeapMapped, __ATOMIC_ACQUIRE)) {
+        peerHeapMap();
+    }
+
+    acquireLock();
+
+    if ((cb = findByPhys(physicalAddress)) == NULL) {
+        va = heapFd == -1 ? (Ptr)physicalAddress : NULL;
+    }
+    else {
+        va = (Ptr)(cb->virtualAddress +
+            (physicalAddress - cb->physicalAddress));
+    }
+
+    Lock_release(moduleLock);
+
+    return (va);
+}
+
+/*
+ *  ======== Memory_importDmaBuf ========
+ */
+Ptr Memory_importDmaBuf(Int fd, UInt32 sizeInBytes)
+{
+    UInt32 pageSize = (UInt32)sysconf(_SC_PAGESIZE);
+    off_t end;
+    ContigBuf *cb;
+    UInt32 pa;
+    Ptr va;
+
+    GT_2trace(curTrace, GT_ENTER, "Memory_importDmaBuf> "
+        "Enter(fd=%d, size=0x%lx)\n", fd, sizeInBytes);
+
+    /* a dma-buf's size is where it seeks to from its end */
+    if (sizeInBytes == 0) {
+        if ((end = lseek(fd, 0, SEEK_END)) <= 0) {
+            GT_1trace(curTrace, GT_7CLASS, "Memory_importDmaBuf> "
+                "can't get the size of dma-buf %d\n", fd);
+            return (NULL);
+        }
+        sizeInBytes = (UInt32)end;
+    }
+
+    if ((va = mmap(NULL, sizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0)) == MAP_FAILED) {
+        GT_1trace(curTrace, GT_7CLASS, "Memory_importDmaBuf> "
+            "can't map dma-buf %d\n", fd);
+        return (NULL);
+    }
+
+    /* emulated CMEM fakes the phys of imports above the heap's */
+    acquireLock();
+    if (heapFd == -1) {
+        pa = (UInt32)va;
+    }
+    else {
+        pa = Memory_emulatedPhysBase + heapSize + importPhys;
+        importPhys += (sizeInBytes + pageSize - 1) & ~(pageSize - 1);
+    }
+    Lock_release(moduleLock);
+
+    if ((cb = addContigBuf((UInt32)va, sizeInBytes, pa, FALSE, NULL)) ==
+        NULL) {
+        munmap(va, sizeInBytes);
+        return (NULL);
+    }
+    cb->isImported = TRUE;
+
+    return (va);
+}
+
+/*
+ *  ======== Memory_init ========
+ */
+Bool Memory_init(Void)
+{
+    if (refCount++ == 0) {
+        GT_create(&curTrace, Memory_GTNAME);
+
+        if ((moduleLock = Lock_create(NULL)) == NULL) {
+            refCount--;
+            return (FALSE);
+        }
+        if (pthread_key_create(&cacheKey, flushCache) != 0) {
+            Lock_delete(moduleLock);
+            moduleLock = NULL;
+            refCount--;
+            return (FALSE);
+        }
+        Queue_new(&contigBufList);
+
+        /* threads' caches of an earlier pool are stale */
+        __atomic_store_n(&poolGeneration, poolGeneration + 1,
+            __ATOMIC_RELEASE);
+
+        if (Memory_emulateCmem) {
+            if (!heapCreate(Memory_contigHeapSize != 0 ?
+                Memory_contigHeapSize : EMUHEAPSIZE, TRUE)) {
+                GT_0trace(curTrace, GT_7CLASS, "Memory_init> "
+                    "can't create the emulated CMEM heap; contiguous "
+                    "buffers will use the C heap\n");
+            }
+        }
+        else if (Memory_contigHeapSize != 0 &&
+            !heapCreate(Memory_contigHeapSize, FALSE)) {
+            GT_1trace(curTrace, GT_7CLASS, "Memory_init> "
+                "can't create a 0x%lx byte heap; Memory_CONTIGHEAP "
+                "allocations will use the C heap\n", Memory_contigHeapSize);
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_exit ========
+ */
+Void Memory_exit(Void)
+{
+    ContigBuf *cb;
+    PoolClass *pc;
+
+    if (--refCount == 0) {
+        pthread_key_delete(cacheKey);
+
+        /* idle buffers, in threads' caches too, are all in the list */
+        while ((cb = Queue_get(&contigBufList)) != NULL) {
+            if (cb->poolSize != 0 && cb->poolState == POOLIDLE) {
+                blockFree((Ptr)cb->virtualAddress);
+            }
+            else if (cb->isAllocated) {
+                GT_2trace(curTrace, GT_6CLASS, "Memory_exit> "
+                    "leaked contiguous buffer 0x%lx (size 0x%lx)\n",
+                    cb->virtualAddress, cb->sizeInBytes);
+            }
+            else if (cb->isImported) {
+                munmap((Ptr)cb->virtualAddress, cb->sizeInBytes);
+            }
+            free(cb);
+        }
+        while ((pc = poolClasses) != NULL) {
+            poolClasses = pc->next;
+            free(pc);
+        }
+        memset(&poolStat, 0, sizeof (poolStat));
+        memset(poolIndex, 0, sizeof (poolIndex));
+        heapDelete();
+        Lock_delete(moduleLock);
+        moduleLock = NULL;
+        virtTree = NULL;
+        physTree = NULL;
+        contigUsed = 0;
+        memset(regBufs, 0, sizeof (regBufs));
+        memset(physIndex, 0, sizeof (physIndex));
+        numRegBufs = 0;
+        lockAcquires = 0;
+        lockWaits = 0;
+        importPhys = 0;
+        peerHeapMapped = FALSE;
+    }
+}
+
+/*
+ *  ======== Memory_poolReserve ========
+ */
+Bool Memory_poolReserve(UInt size, Int count)
+{
+    UInt32 allocSize = poolSize(size);
+    PoolClass *pc;
+    ContigBuf *cb;
+    Ptr addr;
+
+    GT_2trace(curTrace, GT_ENTER, "Memory_poolReserve> "
+        "Enter(size=0x%x, count=%d)\n", size, count);
+
+    if ((pc = findPool(allocSize, TRUE)) == NULL) {
+        return (FALSE);
+    }
+
+    for (; count > 0; count--) {
+        if ((addr = blockAlloc(allocSize, CONTIGALIGN, TRUE)) == NULL) {
+            return (FALSE);
+        }
+        if ((cb = addContigBuf((UInt32)addr, allocSize, blockPhys(addr),
+            TRUE, pc)) == NULL) {
+            blockFree(addr);
+            return (FALSE);
+        }
+
+        /* reserved buffers go to the pool, not to this thread's cache */
+        cb->poolState = POOLIDLE;
+        if (!putIdle(cb, FALSE)) {
+            GT_1trace(curTrace, GT_6CLASS, "Memory_poolReserve> "
+                "pool is at Memory_poolMaxIdle (0x%lx bytes)\n",
+                Memory_poolMaxIdle);
+            releaseBuf(cb);
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_poolStat ========
+ */
+Bool Memory_poolStat(Memory_PoolStat *statbuf)
+{
+    statbuf->hits = __atomic_load_n(&poolStat.hits, __ATOMIC_RELAXED);
+    statbuf->misses = __atomic_load_n(&poolStat.misses, __ATOMIC_RELAXED);
+    statbuf->numIdle = __atomic_load_n(&poolStat.numIdle, __ATOMIC_RELAXED);
+    statbuf->idleBytes = __atomic_load_n(&poolStat.idleBytes,
+        __ATOMIC_RELAXED);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_redefine ========
+ */
+Bool Memory_redefine(Int segId, Uint32 base, Uint32 size)
+{
+    return (FALSE);
+}
+
+/*
+ *  ======== Memory_registerBuf ========
+ */
+Memory_BufHandle Memory_registerBuf(Ptr virtualAddress, Int sizeInBytes)
+{
+    UInt32 va = (UInt32)virtualAddress;
+    UInt32 pa;
+    Memory_BufObj *rb;
+    Memory_BufObj *slot = NULL;
+    UInt32 i;
+    UInt32 n;
+
+    GT_2trace(curTrace, GT_ENTER, "Memory_registerBuf> "
+        "Enter(virt=0x%lx, size=0x%x)\n", virtualAddress, sizeInBytes);
+
+    if (va == 0 || sizeInBytes <= 0 ||
+        (pa = Memory_getBufferPhysicalAddress(virtualAddress, sizeInBytes,
+        NULL)) == 0) {
+        return (NULL);
+    }
+
+    acquireLock();
+
+    for (i = hashAddress(va), n = 0; n < MAXREGBUFS;
+        i = (i + 1) & (MAXREGBUFS - 1), n++) {
+        rb = &regBufs[i];
+        if (rb->state == REGBUFUSED) {
+            if (rb->virtualAddress == va) {
+                break;
+            }
+        }
+        else {
+            if (slot == NULL) {
+                slot = rb;
+            }
+            if (rb->state == REGBUFEMPTY) {
+                break;
+            }
+        }
+    }
+
+    if (n < MAXREGBUFS && rb->state == REGBUFUSED) {
+        Lock_release(moduleLock);
+        GT_1trace(curTrace, GT_7CLASS, "Memory_registerBuf> "
+            "0x%lx is already registered\n", virtualAddress);
+        return (NULL);
+    }
+    if (slot == NULL) {
+        Lock_release(moduleLock);
+        GT_1trace(curTrace, GT_7CLASS, "Memory_registerBuf> "
+            "more than %d buffers registered\n", MAXREGBUFS);
+        return (NULL);
+    }
+
+    writeRegBuf(slot, REGBUFUSED, va, pa, sizeInBytes);
+
+    /* every entry has a slot here, so a free one can always be found */
+    for (i = hashAddress(pa); physIndex[i] != NULL &&
+        physIndex[i] != PHYSDELETED; i = (i + 1) & (MAXREGBUFS - 1)) {
+    }
+    __atomic_store_n(&physIndex[i], slot, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&numRegBufs, numRegBufs + 1, __ATOMIC_RELEASE);
+
+    Lock_release(moduleLock);
+
+    return (slot);
+}
+
+/*
+ *  ======== Memory_registerContigBuf ========
+ */
+Void Memory_registerContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
+    UInt32 physicalAddress)
+{
+    GT_3trace(curTrace, GT_ENTER, "Memory_registerContigBuf> "
+        "Enter(virt=0x%lx, size=0x%lx, phys=0x%lx)\n", virtualAddress,
+        sizeInBytes, physicalAddress);
+
+    addContigBuf(virtualAddress, sizeInBytes, physicalAddress, FALSE, NULL);
+}
+
+/*
+ *  ======== Memory_releaseDmaBuf ========
+ */
+Bool Memory_releaseDmaBuf(Ptr virtualAddress)
+{
+    ContigBuf *cb;
+
+    acquireLock();
+
+    cb = findByVirt((UInt32)virtualAddress);
+    if (cb == NULL || !cb->isImported ||
+        cb->virtualAddress != (UInt32)virtualAddress) {
+        Lock_release(moduleLock);
+        GT_1trace(curTrace, GT_7CLASS, "Memory_releaseDmaBuf> "
+            "0x%lx is not an imported dma-buf\n", virtualAddress);
+        return (FALSE);
+    }
+
+    removeContigBuf(cb);
+
+    Lock_release(moduleLock);
+
+    munmap(virtualAddress, cb->sizeInBytes);
+    free(cb);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_segAlloc ========
+ */
+Ptr Memory_segAlloc(Int segId, UInt size, UInt align)
+{
+    return (NULL);
+}
+
+/*
+ *  ======== Memory_segFree ========
+ */
+Bool Memory_segFree(Int segId, Ptr addr, UInt size)
+{
+    return (FALSE);
+}
+
+/*
+ *  ======== Memory_segStat ========
+ */
+Bool Memory_segStat(Int segId, Memory_Stat *statbuf)
+{
+    return (FALSE);
+}
+
+/*
+ *  ======== Memory_setAccount ========
+ */
+Int Memory_setAccount(Int account)
+{
+    Int prev = curAccount;
+
+    curAccount = account;
+
+    return (prev);
+}
+
+/*
+ *  ======== Memory_setAccountParent ========
+ */
+Bool Memory_setAccountParent(Int account, Int parent)
+{
+    Account *acct;
+    Account *anc;
+    UInt32 size;
+    UInt32 used;
+    UInt32 peak;
+
+    acquireLock();
+
+    /* a parent below the account would make a loop of the chain */
+    if ((acct = findAccount(account)) != NULL) {
+        for (anc = findAccount(parent); anc != NULL && anc != acct;
+            anc = findAccount(anc->parent)) {
+        }
+    }
+    if (acct == NULL || anc != NULL) {
+        Lock_release(moduleLock);
+        return (FALSE);
+    }
+
+    /* move what is in use; the allocation counts stay where they were */
+    size = __atomic_load_n(&acct->stat.used, __ATOMIC_RELAXED);
+    for (anc = findAccount(acct->parent); anc != NULL;
+        anc = findAccount(anc->parent)) {
+        __atomic_sub_fetch(&anc->stat.used, size, __ATOMIC_RELAXED);
+    }
+    for (anc = findAccount(parent); anc != NULL;
+        anc = findAccount(anc->parent)) {
+        used = __atomic_add_fetch(&anc->stat.used, size, __ATOMIC_RELAXED);
+
+        peak = __atomic_load_n(&anc->stat.peak, __ATOMIC_RELAXED);
+        while (used > peak && !__atomic_compare_exchange_n(&anc->stat.peak,
+            &peak, used, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+    __atomic_store_n(&acct->parent, parent, __ATOMIC_RELAXED);
+
+    Lock_release(moduleLock);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Memory_setBufferDirty ========
+ */
+Bool Memory_setBufferDirty(Ptr addr, Bool dirty)
+{
+    ContigBuf *cb;
+
+    acquireLock();
+
+    if ((cb = findByVirt((UInt32)addr)) != NULL) {
+        cb->cpuState = dirty ? BUFDIRTY : BUFCLEAN;
+        __atomic_add_fetch(&numMarked, 1, __ATOMIC_RELEASE);
+    }
+
+    Lock_release(moduleLock);
+
+    return (cb != NULL);
+}
+
+/*
+ *  ======== Memory_unregisterBuf ========
+ */
+Void Memory_unregisterBuf(Memory_BufHandle buf)
+{
+    UInt32 i;
+
+    GT_1trace(curTrace, GT_ENTER, "Memory_unregisterBuf> Enter(buf=0x%lx)\n",
+        buf);
+
+    if (buf == NULL) {
+        return;
+    }
+
+    acquireLock();
+
+    if (buf->state != REGBUFUSED) {
+        Lock_release(moduleLock);
+        GT_1trace(curTrace, GT_7CLASS, "Memory_unregisterBuf> "
+            "0x%lx is not a registered buffer\n", buf);
+        return;
+    }
+
+    for (i = hashAddress(buf->physicalAddress); physIndex[i] != buf;
+        i = (i + 1) & (MAXREGBUFS - 1)) {
+    }
+    __atomic_store_n(&physIndex[i], PHYSDELETED, __ATOMIC_RELEASE);
+
+    writeRegBuf(buf, REGBUFDELETED, 0, 0, 0);
+
+    __atomic_store_n(&numRegBufs, numRegBufs - 1, __ATOMIC_RELEASE);
+
+    Lock_release(moduleLock);
+}
+
+/*
+ *  ======== Memory_unregisterContigBuf ========
+ */
+Void Memory_unregisterContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes)
+{
+    ContigBuf *cb;
+
+    acquireLock();
+
+    cb = findByVirt(virtualAddress);
+    if (cb == NULL || cb->isAllocated ||
+        cb->virtualAddress != virtualAddress) {
+        Lock_release(moduleLock);
+        GT_1trace(curTrace, GT_7CLASS, "Memory_unregisterContigBuf> "
+            "0x%lx is not a registered buffer\n", virtualAddress);
+        return;
+    }
+
+    removeContigBuf(cb);
+
+    Lock_release(moduleLock);
+
+    free(cb);
+}
+
+/*
+ *  ======== acquireLock ========
+ *  Acquire moduleLock, counting the times another thread held it.
+ */
+static Void acquireLock(Void)
+{
+    Bool waited = FALSE;
+
+    if (!Lock_tryAcquire(moduleLock)) {
+        Lock_acquire(moduleLock);
+        waited = TRUE;
+    }
+
+    lockAcquires++;
+    if (waited) {
+        lockWaits++;
+    }
+}
+
+/*
+ *  ======== addContigBuf ========
+ *  Enter a buffer in the known-buffer list; pooled ones, of a class pool,
+ *  are entered in use.
+ */
+static ContigBuf *addContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
+    UInt32 physicalAddress, Bool isAllocated, PoolClass *pool)
+{
+    ContigBuf *cb;
+
+    if ((cb = (ContigBuf *)malloc(sizeof (ContigBuf))) == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "Memory> "
+            "out of memory for contiguous buffer list entry\n");
+        return (NULL);
+    }
+
+    cb->virtualAddress = virtualAddress;
+    cb->physicalAddress = physicalAddress;
+    cb->sizeInBytes = sizeInBytes;
+    cb->isAllocated = isAllocated;
+    cb->poolSize = pool == NULL ? 0 : pool->size;
+    cb->pool = pool;
+    cb->poolState = POOLINUSE;
+    cb->isImported = FALSE;
+    cb->account = isAllocated ? curAccount : Memory_NOACCOUNT;
+
+    acquireLock();
+    insertContigBuf(cb);
+    Lock_release(moduleLock);
+
+    return (cb);
+}
+
+/*
+ *  ======== blockAlloc ========
+ *  Allocate the memory of a contiguous buffer, from the heap if there is
+ *  one for it, or else from the C heap.  C heap buffers of at least
+ *  Memory_hugePageMinSize bytes are aligned on huge pages, and the kernel
+ *  is asked to back them with some.
+ */
+static Ptr blockAlloc(UInt32 size, UInt align, Bool pooled)
+{
+    Bool huge = Memory_hugePageMinSize != 0 && size >= Memory_hugePageMinSize;
+    Ptr addr;
+
+    if (heapBase != NULL && (!pooled || heapFd != -1)) {
+        acquireLock();
+        addr = heapAlloc(size, align);
+        Lock_release(moduleLock);
+    }
+    else if (posix_memalign(&addr, huge && align < HUGEPAGE ? HUGEPAGE :
+        align, size) != 0) {
+        addr = NULL;
+    }
+    else if (huge) {
+        madvise(addr, size & ~(HUGEPAGE - 1), MADV_HUGEPAGE);
+    }
+
+    return (addr);
+}
+
+/*
+ *  ======== blockFree ========
+ */
+static Void blockFree(Ptr addr)
+{
+    if ((UInt8 *)addr >= heapBase && (UInt8 *)addr < heapBase + heapSize) {
+        acquireLock();
+        heapFree(addr);
+        Lock_release(moduleLock);
+    }
+    else {
+        free(addr);
+    }
+}
+
+/*
+ *  ======== blockPhys ========
+ *  The physical address of a block from blockAlloc().
+ */
+static UInt32 blockPhys(Ptr addr)
+{
+    /* emulated CMEM memory is at its offset from the fake physical base */
+    if (heapFd != -1) {
+        return (Memory_emulatedPhysBase + ((UInt8 *)addr - heapBase));
+    }
+
+    /* the host shares one address space with its server: phys == virt */
+    return ((UInt32)addr);
+}
+
+/*
+ *  ======== cacheClass ========
+ *  The calling thread's cache of the size class, or NULL if it doesn't
+ *  cache the class.
+ */
+static CacheClass *cacheClass(UInt32 size)
+{
+    ThreadCache *tc = &threadCache;
+    UInt32 generation = __atomic_load_n(&poolGeneration, __ATOMIC_ACQUIRE);
+    PoolClass *pc;
+    Int i;
+
+    if (size > CACHEMAXSIZE) {
+        return (NULL);
+    }
+
+    /* the buffers cached before Memory_exit() were freed by it */
+    if (tc->generation != generation) {
+        memset(tc, 0, sizeof (ThreadCache));
+        tc->generation = generation;
+    }
+    if (!tc->registered) {
+        if (pthread_setspecific(cacheKey, tc) != 0) {
+            return (NULL);
+        }
+        tc->registered = TRUE;
+    }
+
+    for (i = 0; i < tc->numClasses; i++) {
+        if (tc->classes[i].pool->size == size) {
+            return (&tc->classes[i]);
+        }
+    }
+
+    if (tc->numClasses == CACHECLASSES ||
+        (pc = findPool(size, TRUE)) == NULL) {
+        return (NULL);
+    }
+    tc->classes[i].pool = pc;
+    tc->classes[i].numIdle = 0;
+    tc->numClasses++;
+
+    return (&tc->classes[i]);
+}
+
+/*
+ *  ======== charge ========
+ *  Charge an allocation to an account and its parents.  Parents are
+ *  created before their children, and Memory_setAccountParent() makes
+ *  no loops, so the chain ends.
+ */
+static Void charge(Int account, UInt32 size)
+{
+    Account *acct;
+    UInt32 used;
+    UInt32 peak;
+
+    for (acct = findAccount(account); acct != NULL;
+        acct = findAccount(__atomic_load_n(&acct->parent, __ATOMIC_RELAXED))) {
+        used = __atomic_add_fetch(&acct->stat.used, size, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&acct->stat.numAllocs, 1, __ATOMIC_RELAXED);
+
+        peak = __atomic_load_n(&acct->stat.peak, __ATOMIC_RELAXED);
+        while (used > peak && !__atomic_compare_exchange_n(&acct->stat.peak,
+            &peak, used, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+/*
+ *  ======== contigAlloc ========
+ */
+static Ptr contigAlloc(UInt size, UInt align, Bool pooled)
+{
+    UInt32 allocSize = pooled ? poolSize(size) : size;
+    PoolClass *pc = NULL;
+    ContigBuf *cb;
+    Ptr addr;
+
+    GT_3trace(curTrace, GT_ENTER, "Memory_contigAlloc> "
+        "Enter(size=0x%x, align=0x%x, pooled=%d)\n", size, align, pooled);
+
+    if (align == Memory_DEFAULTALIGNMENT || align < CONTIGALIGN) {
+        align = CONTIGALIGN;
+    }
+
+    if (pooled) {
+        /* an idle buffer is still in the known-buffer list */
+        if ((cb = takeIdle(allocSize, align)) != NULL) {
+            __atomic_add_fetch(&poolStat.hits, 1, __ATOMIC_RELAXED);
+            cb->sizeInBytes = size;
+            cb->cpuState = BUFUNTRACKED;
+            cb->account = curAccount;
+            __atomic_store_n(&cb->poolState, POOLINUSE, __ATOMIC_RELEASE);
+            __atomic_add_fetch(&contigUsed, size, __ATOMIC_RELAXED);
+            charge(curAccount, size);
+
+            return ((Ptr)cb->virtualAddress);
+        }
+        __atomic_add_fetch(&poolStat.misses, 1, __ATOMIC_RELAXED);
+
+        /* without a class, the buffer is freed rather than pooled */
+        pc = findPool(allocSize, TRUE);
+    }
+
+    if ((addr = blockAlloc(allocSize, align, pooled)) == NULL) {
+        GT_1trace(curTrace, GT_7CLASS, "Memory_contigAlloc> "
+            "failed to allocate 0x%x bytes\n", size);
+        return (NULL);
+    }
+
+    if (addContigBuf((UInt32)addr, size, blockPhys(addr), TRUE, pc) ==
+        NULL) {
+        blockFree(addr);
+        return (NULL);
+    }
+    __atomic_add_fetch(&contigUsed, size, __ATOMIC_RELAXED);
+    charge(curAccount, size);
+
+    GT_1trace(curTrace, GT_ENTER, "Memory_contigAlloc> return (0x%lx)\n",
+        addr);
+
+    return (addr);
+}
+
+/*
+ *  ======== credit ========
+ *  Credit a free to the account, and its parents, charged for the
+ *  allocation.
+ */
+static Void credit(Int account, UInt32 size)
+{
+    Account *acct;
+
+    for (acct = findAccount(account); acct != NULL;
+        acct = findAccount(__atomic_load_n(&acct->parent, __ATOMIC_RELAXED))) {
+        __atomic_sub_fetch(&acct->stat.used, size, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&acct->stat.numFrees, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/*
+ *  ======== depotPut ========
+ *  Put an idle buffer in an empty slot of its class' depot, if there is
+ *  one.  Safe to call without moduleLock.
+ */
+static Bool depotPut(PoolClass *pc, ContigBuf *cb)
+{
+    ContigBuf *empty;
+    Int i;
+
+    for (i = 0; i < DEPOTSLOTS; i++) {
+        empty = NULL;
+        if (__atomic_load_n(&pc->depot[i], __ATOMIC_RELAXED) == NULL &&
+            __atomic_compare_exchange_n(&pc->depot[i], &empty, cb, FALSE,
+            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return (TRUE);
+        }
+    }
+
+    return (FALSE);
+}
+
+/*
+ *  ======== findAccount ========
+ *  Returns NULL if account has been deleted.  Safe to call without
+ *  moduleLock.
+ */
+static Account *findAccount(Int account)
+{
+    Account *acct = &accounts[account & (MAXACCOUNTS - 1)];
+
+    if (account == Memory_NOACCOUNT ||
+        __atomic_load_n(&acct->id, __ATOMIC_ACQUIRE) != account) {
+        return (NULL);
+    }
+
+    return (acct);
+}
+
+/*
+ *  ======== findByPhys ========
+ *  Must be called with moduleLock held.
+ */
+static ContigBuf *findByPhys(UInt32 physicalAddress)
+{
+    TreeNode *node;
+
+    if ((node = treeFind(physTree, physicalAddress)) == NULL) {
+        return (NULL);
+    }
+
+    return ((ContigBuf *)((UInt8 *)node - offsetof(ContigBuf, physNode)));
+}
+
+/*
+ *  ======== findByVirt ========
+ *  Must be called with moduleLock held.
+ */
+static ContigBuf *findByVirt(UInt32 virtualAddress)
+{
+    TreeNode *node;
+
+    if ((node = treeFind(virtTree, virtualAddress)) == NULL) {
+        return (NULL);
+    }
+
+    return ((ContigBuf *)((UInt8 *)node - offsetof(ContigBuf, virtNode)));
+}
+
+/*
+ *  ======== findPool ========
+ *  Find, or create, the pool size class of size bytes.  Classes are only
+ *  deleted by Memory_exit(), so they are found without moduleLock.
+ */
+static PoolClass *findPool(UInt32 size, Bool create)
+{
+    PoolClass *pc;
+
+    for (pc = __atomic_load_n(&poolClasses, __ATOMIC_ACQUIRE); pc != NULL;
+        pc = pc->next) {
+        if (pc->size == size) {
+            return (pc);
+        }
+    }
+    if (!create) {
+        return (NULL);
+    }
+
+    acquireLock();
+
+    /* another thread may have just created it */
+    for (pc = poolClasses; pc != NULL && pc->size != size; pc = pc->next) {
+    }
+    if (pc == NULL &&
+        (pc = (PoolClass *)calloc(1, sizeof (PoolClass))) != NULL) {
+        pc->size = size;
+        pc->next = poolClasses;
+        __atomic_store_n(&poolClasses, pc, __ATOMIC_RELEASE);
+    }
+
+    Lock_release(moduleLock);
+
+    return (pc);
+}
+
+/*
+ *  ======== findPoolBuf ========
+ *  Find the pooled buffer based at a virtual address.  Safe to call
+ *  without moduleLock; the buffer, if found, is only safe to use if the
+ *  caller owns it.
+ */
+static ContigBuf *findPoolBuf(UInt32 virtualAddress)
+{
+    PoolSlot copy;
+    UInt32 i;
+    UInt32 n;
+
+    for (i = hashAddress(virtualAddress), n = 0; n < MAXPOOLBUFS;
+        i = (i + 1) & (MAXPOOLBUFS - 1), n++) {
+        readPoolSlot(&poolIndex[i], &copy);
+        if (copy.cb == NULL) {
+            break;
+        }
+        if (copy.cb != POOLDELETED &&
+            copy.virtualAddress == virtualAddress) {
+            return (copy.cb);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== findRegBuf ========
+ *  Find the registered buffer based at a virtual or physical address, and
+ *  copy its entry.  Safe to call without moduleLock.
+ */
+static Memory_BufObj *findRegBuf(UInt32 address, Bool byPhys,
+    Memory_BufObj *copy)
+{
+    Memory_BufObj *rb;
+    UInt32 i;
+    UInt32 n;
+
+    if (__atomic_load_n(&numRegBufs, __ATOMIC_ACQUIRE) == 0) {
+        return (NULL);
+    }
+
+    for (i = hashAddress(address), n = 0; n < MAXREGBUFS;
+        i = (i + 1) & (MAXREGBUFS - 1), n++) {
+        if (byPhys) {
+            if ((rb = __atomic_load_n(&physIndex[i], __ATOMIC_ACQUIRE)) ==
+                    NULL) {
+                break;
+            }
+            if (rb == PHYSDELETED) {
+                continue;
+            }
+            readRegBuf(rb, copy);
+            if (copy->state == REGBUFUSED &&
+                copy->physicalAddress == address) {
+                return (rb);
+            }
+        }
+        else {
+            rb = &regBufs[i];
+            readRegBuf(rb, copy);
+            if (copy->state == REGBUFEMPTY) {
+                break;
+            }
+            if (copy->state == REGBUFUSED &&
+                copy->virtualAddress == address) {
+                return (rb);
+            }
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== flushCache ========
+ *  cacheKey's destructor: return an exiting thread's cached buffers to
+ *  the pool.
+ */
+static Void flushCache(Ptr arg)
+{
+    ThreadCache *tc = (ThreadCache *)arg;
+    CacheClass *cc;
+    ContigBuf *cb;
+    Int i;
+
+    if (tc->generation != __atomic_load_n(&poolGeneration,
+        __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    for (i = 0; i < tc->numClasses; i++) {
+        cc = &tc->classes[i];
+        while (cc->numIdle > 0) {
+            cb = cc->idle[--cc->numIdle];
+            if (!putIdle(cb, FALSE)) {
+                releaseBuf(cb);
+            }
+        }
+    }
+    tc->numClasses = 0;
+    tc->registered = FALSE;
+}
+
+/*
+ *  ======== hashAddress ========
+ *  Frame buffers are spaced by sizes that are multiples of large powers
+ *  of 2, so any few bits of their addresses take only a few values.  The
+ *  top bits of their product with 2^64 / phi depend on all of them.
+ */
+static UInt32 hashAddress(UInt32 address)
+{
+    return ((UInt32)(((__u64)address * 0x9e3779b97f4a7c15ULL) >>
+        (64 - REGBUFSBITS)));
+}
+
+/*
+ *  ======== heapAlloc ========
+ *  Allocate the smallest block holding size bytes aligned on align.
+ *  Must be called with moduleLock held.
+ */
+static Ptr heapAlloc(UInt32 size, UInt align)
+{
+    HeapBlock *block;
+    UInt32 offset;
+    Int order = 0;
+    Int k;
+
+    /* blocks are aligned on their size */
+    if (size < align) {
+        size = align;
+    }
+    while (((UInt32)Memory_HEAPMINBLOCK << order) < size) {
+        if (++order == Memory_HEAPORDERS) {
+            return (NULL);
+        }
+    }
+
+    for (k = order; k < Memory_HEAPORDERS && heapFreeList[k] == NULL; k++) {
+    }
+    if (k == Memory_HEAPORDERS) {
+        return (NULL);
+    }
+
+    block = heapFreeList[k];
+    heapRemove(block, k);
+    offset = (UInt8 *)block - heapBase;
+
+    /* return the upper halves of larger blocks to the free lists */
+    while (k > order) {
+        k--;
+        heapPush(offset + ((UInt32)Memory_HEAPMINBLOCK << k), k);
+    }
+
+    heapOrders[offset >> HEAPMINORDER] = order;
+    heapUsed += (UInt32)Memory_HEAPMINBLOCK << order;
+
+    return (block);
+}
+
+/*
+ *  ======== heapCreate ========
+ *  Map the heap and put all of it on the free lists, in the largest
+ *  blocks it can be cut into.
+ */
+static Bool heapCreate(UInt32 size, Bool shared)
+{
+    Bool huge = Memory_hugePageMinSize != 0;
+    UInt8 *map;
+    UInt32 offset;
+    Int order;
+
+    /* a heap on huge pages uses whole ones */
+    if (huge) {
+        size = (size + HUGEPAGE - 1) & ~(UInt32)(HUGEPAGE - 1);
+    }
+    size &= ~(UInt32)(Memory_HEAPMINBLOCK - 1);
+    if (size == 0 || (map = heapMap(size, shared, huge)) == NULL) {
+        return (FALSE);
+    }
+
+    /* udmabuf only exports memfds that can't shrink */
+    if (heapFd != -1) {
+        fcntl(heapFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+    }
+
+    if ((heapOrders = (UInt8 *)calloc(size >> HEAPMINORDER, 1)) == NULL) {
+        goto fail;
+    }
+    heapBase = map;
+    heapSize = size;
+
+    for (offset = 0; offset < size;
+        offset += (UInt32)Memory_HEAPMINBLOCK << order) {
+        for (order = Memory_HEAPORDERS - 1; order > 0; order--) {
+            if ((offset & (((UInt32)Memory_HEAPMINBLOCK << order) - 1)) ==
+                0 && offset + ((UInt32)Memory_HEAPMINBLOCK << order) <= size) {
+                break;
+            }
+        }
+        heapPush(offset, order);
+    }
+
+    return (TRUE);
+
+fail:
+    if (heapFd != -1) {
+        close(heapFd);
+        heapFd = -1;
+    }
+    munmap(map, size);
+
+    return (FALSE);
+}
+
+/*
+ *  ======== heapDelete ========
+ */
+static Void heapDelete(Void)
+{
+    if (heapBase == NULL) {
+        return;
+    }
+
+    if (heapUsed != 0) {
+        GT_1trace(curTrace, GT_6CLASS, "Memory_exit> "
+            "0x%lx bytes of the heap are still allocated\n", heapUsed);
+    }
+
+    munmap(heapBase, heapSize);
+    if (heapFd != -1) {
+        close(heapFd);
+        heapFd = -1;
+    }
+    free(heapOrders);
+    heapBase = NULL;
+    heapSize = 0;
+    heapOrders = NULL;
+    heapUsed = 0;
+    memset(heapFreeList, 0, sizeof (heapFreeList));
+    memset(heapNumFree, 0, sizeof (heapNumFree));
+}
+
+/*
+ *  ======== heapFree ========
+ *  Free a block, merging it with its buddy for as long as that is free.
+ *  Must be called with moduleLock held.
+ */
+static Void heapFree(Ptr addr)
+{
+    UInt32 offset = (UInt8 *)addr - heapBase;
+    UInt32 buddy;
+    Int order = heapOrders[offset >> HEAPMINORDER];
+
+    heapUsed -= (UInt32)Memory_HEAPMINBLOCK << order;
+
+    while (order < Memory_HEAPORDERS - 1) {
+        buddy = offset ^ ((UInt32)Memory_HEAPMINBLOCK << order);
+        if (buddy + ((UInt32)Memory_HEAPMINBLOCK << order) > heapSize ||
+            heapOrders[buddy >> HEAPMINORDER] != (HEAPFREE | order)) {
+            break;
+        }
+        heapRemove((HeapBlock *)(heapBase + buddy), order);
+        offset &= buddy;
+        order++;
+    }
+
+    heapPush(offset, order);
+}
+
+/*
+ *  ======== heapMap ========
+ *  Map size bytes for the heap, on a HEAPALIGN boundary.  A shared heap
+ *  is mapped from a file, as CMEM maps its memory from cmemk.ko.  Huge
+ *  pages come from hugetlbfs if the system has reserved some, or else
+ *  from transparent huge pages; a named heap only gets the latter.
+ */
+static UInt8 *heapMap(UInt32 size, Bool shared, Bool huge)
+{
+    UInt8 *map = MAP_FAILED;
+    UInt32 slack;
+
+    /* hugetlbfs mappings are aligned on their page size */
+    if (huge && shared && Memory_emulatedHeapName == NULL) {
+        if ((heapFd = memfd_create("cmem", MFD_CLOEXEC |
+            MFD_ALLOW_SEALING | MFD_HUGETLB)) != -1) {
+            if (ftruncate(heapFd, size) == -1 ||
+                (map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                heapFd, 0)) == MAP_FAILED) {
+                close(heapFd);
+                heapFd = -1;
+            }
+        }
+    }
+    else if (huge) {
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (map != MAP_FAILED) {
+        GT_1trace(curTrace, GT_2CLASS, "Memory_init> "
+            "heap is on hugetlbfs pages at 0x%lx\n", map);
+        return (map);
+    }
+
+    /* map extra, to trim the base to a HEAPALIGN boundary */
+    if ((map = mmap(NULL, size + HEAPALIGN, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED) {
+        return (NULL);
+    }
+    slack = (HEAPALIGN - ((UInt32)map & (HEAPALIGN - 1))) & (HEAPALIGN - 1);
+    if (slack != 0) {
+        munmap(map, slack);
+    }
+    munmap(map + slack + size, HEAPALIGN - slack);
+    map += slack;
+
+    if (shared && ((heapFd = heapOpen()) == -1 ||
+        ftruncate(heapFd, size) == -1 ||
+        mmap(map, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+            heapFd, 0) == MAP_FAILED)) {
+        if (heapFd != -1) {
+            close(heapFd);
+            heapFd = -1;
+        }
+        munmap(map, size);
+        return (NULL);
+    }
+
+    if (huge) {
+        madvise(map, size, MADV_HUGEPAGE);
+    }
+
+    return (map);
+}
+
+/*
+ *  ======== heapOpen ========
+ *  Open the file a shared heap is mapped from: a memfd, or the shared
+ *  memory object Memory_emulatedHeapName, which is left for the peer
+ *  to map.
+ */
+static Int heapOpen(Void)
+{
+    if (Memory_emulatedHeapName != NULL) {
+        return (shm_open(Memory_emulatedHeapName,
+            O_RDWR | O_CREAT | O_CLOEXEC, 0600));
+    }
+
+    return (memfd_create("cmem", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+}
+
+/*
+ *  ======== heapPush ========
+ */
+static Void heapPush(UInt32 offset, Int order)
+{
+    HeapBlock *block = (HeapBlock *)(heapBase + offset);
+
+    block->prev = NULL;
+    block->next = heapFreeList[order];
+    if (block->next != NULL) {
+        block->next->prev = block;
+    }
+    heapFreeList[order] = block;
+    heapNumFree[order]++;
+    heapOrders[offset >> HEAPMINORDER] = HEAPFREE | order;
+}
+
+/*
+ *  ======== heapRemove ========
+ */
+static Void heapRemove(HeapBlock *block, Int order)
+{
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    }
+    else {
+        heapFreeList[order] = block->next;
+    }
+    if (block->next != NULL) {
+        block->next->prev = block->prev;
+    }
+    heapNumFree[order]--;
+}
+
+/*
+ *  ======== insertContigBuf ========
+ *  Must be called with moduleLock held.
+ */
+static Void insertContigBuf(ContigBuf *cb)
+{
+    /* a pooled buffer covers its whole class, whatever size it's used at */
+    UInt32 size = cb->poolSize != 0 ? cb->poolSize : cb->sizeInBytes;
+    PoolSlot *ps;
+    UInt32 i;
+    UInt32 n;
+
+    cb->virtNode.start = cb->virtualAddress;
+    cb->virtNode.end = cb->virtualAddress + size;
+    cb->physNode.start = cb->physicalAddress;
+    cb->physNode.end = cb->physicalAddress + size;
+    cb->cpuState = BUFUNTRACKED;
+
+    Queue_put(&contigBufList, cb);
+    virtTree = treeInsert(virtTree, &cb->virtNode);
+    physTree = treeInsert(physTree, &cb->physNode);
+
+    /* if the index is full, the buffer is freed under moduleLock */
+    if (cb->poolSize != 0) {
+        for (i = hashAddress(cb->virtualAddress), n = 0; n < MAXPOOLBUFS;
+            i = (i + 1) & (MAXPOOLBUFS - 1), n++) {
+            ps = &poolIndex[i];
+            if (ps->cb == NULL || ps->cb == POOLDELETED) {
+                writePoolSlot(ps, cb->virtualAddress, cb);
+                break;
+            }
+        }
+    }
+}
+
+/*
+ *  ======== peerHeapMap ========
+ *  Map the emulated CMEM heap a peer created as Memory_emulatedHeapName,
+ *  if it has yet, as an imported buffer at the physical address it has
+ *  there.
+ */
+static Void peerHeapMap(Void)
+{
+    struct stat st;
+    ContigBuf *cb;
+    Ptr va;
+    Int fd;
+
+    acquireLock();
+
+    if (peerHeapMapped || (fd = shm_open(Memory_emulatedHeapName,
+        O_RDWR | O_CLOEXEC, 0)) == -1) {
+        Lock_release(moduleLock);
+        return;
+    }
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && (va = mmap(NULL,
+        st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) !=
+        MAP_FAILED) {
+        if ((cb = addContigBuf((UInt32)va, st.st_size,
+            Memory_emulatedPhysBase, FALSE, NULL)) != NULL) {
+            cb->isImported = TRUE;
+            __atomic_store_n(&peerHeapMapped, TRUE, __ATOMIC_RELEASE);
+            GT_2trace(curTrace, GT_2CLASS, "Memory> "
+                "mapped the peer's heap '%s' at 0x%lx\n",
+                Memory_emulatedHeapName, va);
+        }
+        else {
+            munmap(va, st.st_size);
+        }
+    }
+    close(fd);
+
+    Lock_release(moduleLock);
+}
+
+/*
+ *  ======== poolSize ========
+ *  The size class of a pooled allocation of size bytes.
+ */
+static UInt32 poolSize(UInt size)
+{
+    UInt32 grain = size < POOLPAGE ? CONTIGALIGN : POOLPAGE;
+
+    /* classes on huge pages use whole ones */
+    if (Memory_hugePageMinSize != 0 && size >= Memory_hugePageMinSize) {
+        grain = HUGEPAGE;
+    }
+
+    return (((UInt32)size + grain - 1) & ~(grain - 1));
+}
+
+/*
+ *  ======== putIdle ========
+ *  Keep an idle pooled buffer: in the calling thread's cache if cache is
+ *  TRUE and there's room, or else in its class' depot, or else on its
+ *  class' idle list.  Returns FALSE, for the caller to release the
+ *  buffer, if the pool is at Memory_poolMaxIdle.  Only the idle list
+ *  takes moduleLock.
+ */
+static Bool putIdle(ContigBuf *cb, Bool cache)
+{
+    PoolClass *pc = cb->pool;
+    CacheClass *cc;
+
+    /* cached buffers are bounded by the cache, not Memory_poolMaxIdle */
+    if (cache && Memory_poolMaxIdle != 0 &&
+        (cc = cacheClass(cb->poolSize)) != NULL &&
+        cc->numIdle < CACHEDEPTH) {
+        cc->idle[cc->numIdle++] = cb;
+        return (TRUE);
+    }
+
+    if (__atomic_add_fetch(&poolStat.idleBytes, cb->poolSize,
+        __ATOMIC_RELAXED) > Memory_poolMaxIdle) {
+        __atomic_sub_fetch(&poolStat.idleBytes, cb->poolSize,
+            __ATOMIC_RELAXED);
+        return (FALSE);
+    }
+    __atomic_add_fetch(&poolStat.numIdle, 1, __ATOMIC_RELAXED);
+
+    if (!depotPut(pc, cb)) {
+        acquireLock();
+        cb->nextIdle = pc->idle;
+        __atomic_store_n(&pc->idle, cb, __ATOMIC_RELAXED);
+        Lock_release(moduleLock);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== readPoolSlot ========
+ *  Copy ps, retrying while a writer is changing it.
+ */
+static Void readPoolSlot(PoolSlot *ps, PoolSlot *copy)
+{
+    UInt32 seq;
+
+    do {
+        while ((seq = __atomic_load_n(&ps->seq, __ATOMIC_ACQUIRE)) & 1) {
+        }
+
+        copy->virtualAddress = __atomic_load_n(&ps->virtualAddress,
+            __ATOMIC_RELAXED);
+        copy->cb = __atomic_load_n(&ps->cb, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&ps->seq, __ATOMIC_RELAXED) != seq);
+}
+
+/*
+ *  ======== readRegBuf ========
+ *  Copy rb, retrying while a writer is changing it.
+ */
+static Void readRegBuf(Memory_BufObj *rb, Memory_BufObj *copy)
+{
+    UInt32 seq;
+
+    do {
+        while ((seq = __atomic_load_n(&rb->seq, __ATOMIC_ACQUIRE)) & 1) {
+        }
+
+        copy->state = __atomic_load_n(&rb->state, __ATOMIC_RELAXED);
+        copy->virtualAddress = __atomic_load_n(&rb->virtualAddress,
+            __ATOMIC_RELAXED);
+        copy->physicalAddress = __atomic_load_n(&rb->physicalAddress,
+            __ATOMIC_RELAXED);
+        copy->sizeInBytes = __atomic_load_n(&rb->sizeInBytes,
+            __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&rb->seq, __ATOMIC_RELAXED) != seq);
+}
+
+/*
+ *  ======== releaseBuf ========
+ *  Remove an idle pooled buffer from the known-buffer list, and free it.
+ */
+static Void releaseBuf(ContigBuf *cb)
+{
+    acquireLock();
+    removeContigBuf(cb);
+    Lock_release(moduleLock);
+
+    blockFree((Ptr)cb->virtualAddress);
+    free(cb);
+}
+
+/*
+ *  ======== removeContigBuf ========
+ *  Must be called with moduleLock held.
+ */
+static Void removeContigBuf(ContigBuf *cb)
+{
+    UInt32 i;
+    UInt32 n;
+
+    Queue_extract(cb);
+    virtTree = treeRemove(virtTree, &cb->virtNode);
+    physTree = treeRemove(physTree, &cb->physNode);
+
+    if (cb->poolSize != 0) {
+        for (i = hashAddress(cb->virtualAddress), n = 0; n < MAXPOOLBUFS;
+            i = (i + 1) & (MAXPOOLBUFS - 1), n++) {
+            if (poolIndex[i].cb == cb) {
+                writePoolSlot(&poolIndex[i], 0, POOLDELETED);
+                break;
+            }
+            if (poolIndex[i].cb == NULL) {
+                break;
+            }
+        }
+    }
+}
+
+/*
+ *  ======== takeIdle ========
+ *  Take an idle buffer of the size class, aligned on align: from the
+ *  calling thread's cache, or else from the class' depot, or else from
+ *  its idle list.  Only the idle list takes moduleLock.
+ */
+static ContigBuf *takeIdle(UInt32 size, UInt align)
+{
+    CacheClass *cc;
+    PoolClass *pc;
+    ContigBuf **prev;
+    ContigBuf *cb = NULL;
+    Int i;
+
+    if ((cc = cacheClass(size)) != NULL) {
+        for (i = cc->numIdle - 1; i >= 0; i--) {
+            if (cc->idle[i]->virtualAddress % align == 0) {
+                cb = cc->idle[i];
+                cc->idle[i] = cc->idle[--cc->numIdle];
+                return (cb);
+            }
+        }
+        pc = cc->pool;
+    }
+    else if ((pc = findPool(size, FALSE)) == NULL) {
+        return (NULL);
+    }
+
+    /* a buffer is only looked at once it's taken, so it can't be freed */
+    for (i = 0; i < DEPOTSLOTS && cb == NULL; i++) {
+        if (__atomic_load_n(&pc->depot[i], __ATOMIC_RELAXED) != NULL &&
+            (cb = __atomic_exchange_n(&pc->depot[i], NULL,
+            __ATOMIC_ACQUIRE)) != NULL && cb->virtualAddress % align != 0) {
+            if (!depotPut(pc, cb)) {
+                acquireLock();
+                cb->nextIdle = pc->idle;
+                __atomic_store_n(&pc->idle, cb, __ATOMIC_RELAXED);
+                Lock_release(moduleLock);
+            }
+            cb = NULL;
+        }
+    }
+
+    if (cb == NULL && __atomic_load_n(&pc->idle, __ATOMIC_RELAXED) != NULL) {
+        acquireLock();
+        for (prev = &pc->idle; (cb = *prev) != NULL; prev = &cb->nextIdle) {
+            if (cb->virtualAddress % align == 0) {
+                __atomic_store_n(prev, cb->nextIdle, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+        Lock_release(moduleLock);
+    }
+
+    if (cb != NULL) {
+        __atomic_sub_fetch(&poolStat.numIdle, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&poolStat.idleBytes, cb->poolSize,
+            __ATOMIC_RELAXED);
+    }
+
+    return (cb);
+}
+
+/*
+ *  ======== treeBalance ========
+ *  Restore the AVL balance of node, whose subtrees differ in height by at
+ *  most 2, and return the subtree's new root.
+ */
+static TreeNode *treeBalance(TreeNode *node)
+{
+    Int lh = node->left == NULL ? 0 : node->left->height;
+    Int rh = node->right == NULL ? 0 : node->right->height;
+    TreeNode *child;
+
+    if (lh > rh + 1) {
+        child = node->left;
+        if ((child->left == NULL ? 0 : child->left->height) <
+            (child->right == NULL ? 0 : child->right->height)) {
+            node->left = treeRotate(child, TRUE);
+        }
+        return (treeRotate(node, FALSE));
+    }
+    if (rh > lh + 1) {
+        child = node->right;
+        if ((child->right == NULL ? 0 : child->right->height) <
+            (child->left == NULL ? 0 : child->left->height)) {
+            node->right = treeRotate(child, FALSE);
+        }
+        return (treeRotate(node, TRUE));
+    }
+
+    treeUpdate(node);
+
+    return (node);
+}
+
+/*
+ *  ======== treeFind ========
+ *  Find a node whose interval contains address.  If the left subtree
+ *  ends past address but has no such node, neither has the right one
+ *  (its intervals start after all of the left's), so one path suffices.
+ */
+static TreeNode *treeFind(TreeNode *root, UInt32 address)
+{
+    TreeNode *node = root;
+
+    while (node != NULL) {
+        if (address >= node->start && address < node->end) {
+            break;
+        }
+        if (node->left != NULL && node->left->maxEnd > address) {
+            node = node->left;
+        }
+        else {
+            node = node->right;
+        }
+    }
+
+    return (node);
+}
+
+/*
+ *  ======== treeInsert ========
+ */
+static TreeNode *treeInsert(TreeNode *root, TreeNode *node)
+{
+    if (root == NULL) {
+        node->left = NULL;
+        node->right = NULL;
+        treeUpdate(node);
+        return (node);
+    }
+
+    if (node->start < root->start ||
+        (node->start == root->start && node < root)) {
+        root->left = treeInsert(root->left, node);
+    }
+    else {
+        root->right = treeInsert(root->right, node);
+    }
+
+    return (treeBalance(root));
+}
+
+/*
+ *  ======== treeRemove ========
+ *  Remove node, which must be in the tree, and return the new root.
+ */
+static TreeNode *treeRemove(TreeNode *root, TreeNode *node)
+{
+    TreeNode *min;
+
+    if (root == node) {
+        if (node->right == NULL) {
+            return (node->left);
+        }
+        node->right = treeRemoveMin(node->right, &min);
+        min->left = node->left;
+        min->right = node->right;
+        return (treeBalance(min));
+    }
+
+    if (node->start < root->start ||
+        (node->start == root->start && node < root)) {
+        root->left = treeRemove(root->left, node);
+    }
+    else {
+        root->right = treeRemove(root->right, node);
+    }
+
+    return (treeBalance(root));
+}
+
+/*
+ *  ======== treeRemoveMin ========
+ *  Remove the first node of a non-empty tree into *min, and return the
+ *  new root.
+ */
+static TreeNode *treeRemoveMin(TreeNode *root, TreeNode **min)
+{
+    if (root->left == NULL) {
+        *min = root;
+        return (root->right);
+    }
+
+    root->left = treeRemoveMin(root->left, min);
+
+    return (treeBalance(root));
+}
+
+/*
+ *  ======== treeRotate ========
+ *  Rotate node left (its right child takes its place) or right, and
+ *  return the subtree's new root.
+ */
+static TreeNode *treeRotate(TreeNode *node, Bool left)
+{
+    TreeNode *child;
+
+    if (left) {
+        child = node->right;
+        node->right = child->left;
+        child->left = node;
+    }
+    else {
+        child = node->left;
+        node->left = child->right;
+        child->right = node;
+    }
+
+    treeUpdate(node);
+    treeUpdate(child);
+
+    return (child);
+}
+
+/*
+ *  ======== treeUpdate ========
+ *  Recompute node's height and maxEnd from its children's.
+ */
+static Void treeUpdate(TreeNode *node)
+{
+    Int lh = node->left == NULL ? 0 : node->left->height;
+    Int rh = node->right == NULL ? 0 : node->right->height;
+
+    node->height = (lh > rh ? lh : rh) + 1;
+
+    node->maxEnd = node->end;
+    if (node->left != NULL && node->left->maxEnd > node->maxEnd) {
+        node->maxEnd = node->left->maxEnd;
+    }
+    if (node->right != NULL && node->right->maxEnd > node->maxEnd) {
+        node->maxEnd = node->right->maxEnd;
+    }
+}
+
+/*
+ *  ======== writePoolSlot ========
+ *  Must be called with moduleLock held.
+ */
+static Void writePoolSlot(PoolSlot *ps, UInt32 virtualAddress,
+    ContigBuf *cb)
+{
+    __atomic_store_n(&ps->seq, ps->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&ps->virtualAddress, virtualAddress, __ATOMIC_RELAXED);
+    __atomic_store_n(&ps->cb, cb, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&ps->seq, ps->seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ *  ======== writeRegBuf ========
+ *  Must be called with moduleLock held.
+ */
+static Void writeRegBuf(Memory_BufObj *rb, Int state, UInt32 virtualAddress,
+    UInt32 physicalAddress, Int sizeInBytes)
+{
+    __atomic_store_n(&rb->seq, rb->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&rb->state, state, __ATOMIC_RELAXED);
+    __atomic_store_n(&rb->virtualAddress, virtualAddress, __ATOMIC_RELAXED);
+    __atomic_store_n(&rb->physicalAddress, physicalAddress,
+        __ATOMIC_RELAXED);
+    __atomic_store_n(&rb->sizeInBytes, sizeInBytes, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&rb->seq, rb->seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ *  ======== writebackRanges ========
+ *  Skip the ranges of buffers the application has marked clean, and mark
+ *  dirty buffers clean once a range covers all of them; there's nothing
+ *  else to write back on the host.  Until a buffer is marked, there are
+ *  no flags to keep, and the stubs' calls take no lock.
+ */
+static Void writebackRanges(Memory_CacheRange ranges[], Int numRanges)
+{
+    ContigBuf *cb;
+    Int i;
+
+    if (__atomic_load_n(&numMarked, __ATOMIC_ACQUIRE) == 0) {
+        return;
+    }
+
+    acquireLock();
+
+    for (i = 0; i < numRanges; i++) {
+        cb = findByVirt((UInt32)ranges[i].addr);
+        if (cb != NULL && cb->cpuState == BUFDIRTY &&
+            (UInt32)ranges[i].addr == cb->virtualAddress &&
+            (UInt32)ranges[i].sizeInBytes >= cb->sizeInBytes) {
+            cb->cpuState = BUFCLEAN;
+        }
+    }
+
+    Lock_release(moduleLock);
+}
@@ -0,0 +1,134 @@
+/*
+ *  ======== Processor_posix.c ========
+ *  Host implementation of the OSAL Processor module.
+ *
+ *  There is no DSP to load: the "server image" is the RMS configured into
+ *  this process (RMS_nodeTab), and starting it means calling RMS_init(),
+ *  just as the DSP server's startup does.  All engines share that one
+ *  server, so it is reference counted and runs until the last engine
+ *  using it is closed.
+ *
+ *  If Comm_shmName links this process to a server process, though, that
+ *  is the server: it was started on its own, and "loading" it is just
+ *  locating its RMS command queue across the link.
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Lock.h>
+#include <ti/sdo/ce/osal/Processor.h>
+#include <ti/sdo/ce/rms.h>
+
+typedef struct Processor_Obj {
+    String  imageName;
+} Processor_Obj;
+
+Processor_Attrs Processor_ATTRS = {
+    NULL,       /* cpuId */
+};
+
+static Bool remoteServer(Void);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Lock_Handle serverLock = NULL;
+static Int serverRefCount = 0;
+static Int refCount = 0;
+
+/*
+ *  ======== Processor_create ========
+ */
+Processor_Handle Processor_create(String imageName, String linkCfg,
+    Processor_Attrs *attrs)
+{
+    Processor_Obj *proc;
+    Comm_Queue rmsQueue;
+
+    GT_2trace(curTrace, GT_ENTER, "Processor_create> "
+        "Enter(imageName='%s', linkCfg='%s')\n", imageName,
+        linkCfg == NULL ? "" : linkCfg);
+
+    if ((proc = (Processor_Obj *)malloc(sizeof (Processor_Obj))) == NULL) {
+        return (NULL);
+    }
+    proc->imageName = imageName;
+
+    Lock_acquire(serverLock);
+    if (serverRefCount == 0 && !remoteServer()) {
+        RMS_init();
+    }
+    if (Comm_locate(RMS_CMDQNAME, &rmsQueue) != Comm_EOK) {
+        if (serverRefCount == 0 && !remoteServer()) {
+            RMS_exit();
+        }
+        Lock_release(serverLock);
+        GT_1trace(curTrace, GT_7CLASS, "Processor_create> "
+            "failed to start server '%s'\n", imageName);
+        free(proc);
+        return (NULL);
+    }
+    serverRefCount++;
+    Lock_release(serverLock);
+
+    return (proc);
+}
+
+/*
+ *  ======== Processor_delete ========
+ */
+Void Processor_delete(Processor_Handle proc)
+{
+    if (proc == NULL) {
+        return;
+    }
+
+    GT_1trace(curTrace, GT_ENTER, "Processor_delete> Enter(imageName='%s')\n",
+        proc->imageName);
+
+    Lock_acquire(serverLock);
+    if (--serverRefCount == 0 && !remoteServer()) {
+        RMS_exit();
+    }
+    Lock_release(serverLock);
+
+    free(proc);
+}
+
+/*
+ *  ======== Processor_init ========
+ */
+Bool Processor_init(Void)
+{
+    if (refCount++ == 0) {
+        GT_create(&curTrace, Processor_GTNAME);
+
+        if ((serverLock = Lock_create(NULL)) == NULL) {
+            refCount--;
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== Processor_exit ========
+ */
+Void Processor_exit(Void)
+{
+    if (--refCount == 0) {
+        Lock_delete(serverLock);
+        serverLock = NULL;
+    }
+}
+
+/*
+ *  ======== remoteServer ========
+ *  Whether the server is another process, at the end of a Comm link.
+ */
+static Bool remoteServer(Void)
+{
+    return (Comm_shmName != NULL && !Comm_shmServer);
+}
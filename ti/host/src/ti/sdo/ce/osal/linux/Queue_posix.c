@@ -0,0 +1,198 @@
+/*
+ *  ======== Queue_posix.c ========
+ *  Mutex-protected implementation of the OSAL Queue module.
+ *
+ *  A single module-wide mutex serializes all queue operations, which is
+ *  what allows Queue_extract() to work without knowing which queue the
+ *  element is on.
+ *
+ *  Queue_Fifo takes no lock: it is Vyukov's intrusive multi-producer
+ *  single-consumer queue.  A put is one atomic exchange and a store, so
+ *  putters never wait for each other or for the getter, and nothing a
+ *  getter removes is touched by anyone else again, so elements may be
+ *  freed as soon as they are got.  The price is a window, between a
+ *  put's exchange and its store, in which the getter can't see past its
+ *  element; Queue_fifoGet() yields until the put is done.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <ti/sdo/ce/osal/Queue.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ *  ======== Queue_extract ========
+ */
+Void Queue_extract(Ptr elem)
+{
+    Queue_Elem *e = (Queue_Elem *)elem;
+
+    pthread_mutex_lock(&mutex);
+
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+    e->next = e->prev = e;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/*
+ *  ======== Queue_fifoGet ========
+ */
+Ptr Queue_fifoGet(Queue_Fifo *fifo)
+{
+    Queue_Link *first;
+    Queue_Link *next;
+
+    for (;;) {
+        first = fifo->first;
+        next = __atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+
+        /* step over the stub */
+        if (first == &fifo->stub) {
+            if (next == NULL) {
+                if (Queue_fifoEmpty(fifo)) {
+                    return (NULL);
+                }
+                sched_yield();
+                continue;
+            }
+            fifo->first = next;
+            first = next;
+            next = __atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+        }
+
+        if (next != NULL) {
+            fifo->first = next;
+            return (first);
+        }
+
+        /* first is last: put the stub behind it, to take it off */
+        if (first == __atomic_load_n(&fifo->last, __ATOMIC_ACQUIRE)) {
+            Queue_fifoPut(fifo, &fifo->stub);
+            next = __atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+            if (next != NULL) {
+                fifo->first = next;
+                return (first);
+            }
+        }
+
+        /* a put is between its exchange and its link */
+        sched_yield();
+    }
+}
+
+/*
+ *  ======== Queue_fifoNew ========
+ */
+Void Queue_fifoNew(Queue_Fifo *fifo)
+{
+    fifo->stub.next = NULL;
+    fifo->first = &fifo->stub;
+    fifo->last = &fifo->stub;
+}
+
+/*
+ *  ======== Queue_fifoPut ========
+ */
+Void Queue_fifoPut(Queue_Fifo *fifo, Ptr elem)
+{
+    Queue_Link *link = (Queue_Link *)elem;
+    Queue_Link *prev;
+
+    link->next = NULL;
+    prev = __atomic_exchange_n(&fifo->last, link, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, link, __ATOMIC_RELEASE);
+}
+
+/*
+ *  ======== Queue_get ========
+ */
+Ptr Queue_get(Queue_Elem *queue)
+{
+    Queue_Elem *elem = NULL;
+
+    pthread_mutex_lock(&mutex);
+
+    if (queue->next != queue) {
+        elem = queue->next;
+        queue->next = elem->next;
+        elem->next->prev = queue;
+        elem->next = elem->prev = elem;
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    return (elem);
+}
+
+/*
+ *  ======== Queue_head ========
+ */
+Ptr Queue_head(Queue_Elem *queue)
+{
+    Queue_Elem *elem;
+
+    pthread_mutex_lock(&mutex);
+    elem = (queue->next == queue) ? NULL : queue->next;
+    pthread_mutex_unlock(&mutex);
+
+    return (elem);
+}
+
+/*
+ *  ======== Queue_new ========
+ */
+Void Queue_new(Queue_Elem *queue)
+{
+    queue->next = queue->prev = queue;
+}
+
+/*
+ *  ======== Queue_next ========
+ */
+Ptr Queue_next(Queue_Elem *queue, Ptr elem)
+{
+    Queue_Elem *next;
+
+    pthread_mutex_lock(&mutex);
+    next = ((Queue_Elem *)elem)->next;
+    pthread_mutex_unlock(&mutex);
+
+    return (next == queue ? NULL : next);
+}
+
+/*
+ *  ======== Queue_put ========
+ */
+Void Queue_put(Queue_Elem *queue, Ptr elem)
+{
+    Queue_Elem *e = (Queue_Elem *)elem;
+
+    pthread_mutex_lock(&mutex);
+
+    e->next = queue;
+    e->prev = queue->prev;
+    queue->prev->next = e;
+    queue->prev = e;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/*
+ *  ======== Queue_init ========
+ */
+Bool Queue_init(Void)
+{
+    return (TRUE);
+}
+
+/*
+ *  ======== Queue_exit ========
+ */
+Void Queue_exit(Void)
+{
+}
@@ -0,0 +1,138 @@
+/*
+ *  ======== Sem_posix.c ========
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <ti/sdo/ce/osal/Sem.h>
+
+typedef struct Sem_Obj {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    Int             count;
+} Sem_Obj;
+
+/*
+ *  ======== Sem_create ========
+ */
+Sem_Handle Sem_create(Int key, Int count)
+{
+    pthread_condattr_t cattrs;
+    Sem_Obj *sem;
+
+    if ((sem = (Sem_Obj *)malloc(sizeof (Sem_Obj))) == NULL) {
+        return (NULL);
+    }
+
+    pthread_mutex_init(&sem->mutex, NULL);
+
+    /* timed waits are measured against the monotonic clock */
+    pthread_condattr_init(&cattrs);
+    pthread_condattr_setclock(&cattrs, CLOCK_MONOTONIC);
+    pthread_cond_init(&sem->cond, &cattrs);
+    pthread_condattr_destroy(&cattrs);
+
+    sem->count = count;
+
+    return (sem);
+}
+
+/*
+ *  ======== Sem_delete ========
+ */
+Void Sem_delete(Sem_Handle sem)
+{
+    if (sem != NULL) {
+        pthread_cond_destroy(&sem->cond);
+        pthread_mutex_destroy(&sem->mutex);
+        free(sem);
+    }
+}
+
+/*
+ *  ======== Sem_getCount ========
+ */
+Int Sem_getCount(Sem_Handle sem)
+{
+    Int count;
+
+    pthread_mutex_lock(&sem->mutex);
+    count = sem->count;
+    pthread_mutex_unlock(&sem->mutex);
+
+    return (count);
+}
+
+/*
+ *  ======== Sem_pend ========
+ */
+Int Sem_pend(Sem_Handle sem, UInt32 timeout)
+{
+    struct timespec abstime;
+    Int status = Sem_EOK;
+
+    pthread_mutex_lock(&sem->mutex);
+
+    if (timeout == Sem_FOREVER) {
+        while (sem->count == 0) {
+            pthread_cond_wait(&sem->cond, &sem->mutex);
+        }
+    }
+    else if (sem->count == 0 && timeout != Sem_POLL) {
+        clock_gettime(CLOCK_MONOTONIC, &abstime);
+        abstime.tv_sec += timeout / 1000000;
+        abstime.tv_nsec += (timeout % 1000000) * 1000;
+        if (abstime.tv_nsec >= 1000000000) {
+            abstime.tv_sec++;
+            abstime.tv_nsec -= 1000000000;
+        }
+
+        while (sem->count == 0) {
+            if (pthread_cond_timedwait(&sem->cond, &sem->mutex,
+                    &abstime) == ETIMEDOUT) {
+                break;
+            }
+        }
+    }
+
+    if (sem->count > 0) {
+        sem->count--;
+    }
+    else {
+        status = Sem_ETIMEOUT;
+    }
+
+    pthread_mutex_unlock(&sem->mutex);
+
+    return (status);
+}
+
+/*
+ *  ======== Sem_post ========
+ */
+Void Sem_post(Sem_Handle sem)
+{
+    pthread_mutex_lock(&sem->mutex);
+    sem->count++;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+}
+
+/*
+ *  ======== Sem_init ========
+ */
+Bool Sem_init(Void)
+{
+    return (TRUE);
+}
+
+/*
+ *  ======== Sem_exit ========
+ */
+Void Sem_exit(Void)
+{
+}
@@ -0,0 +1,114 @@
+/*
+ *  ======== Thread_posix.c ========
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <ti/sdo/ce/osal/Thread.h>
+
+typedef struct Thread_Obj {
+    pthread_t       tid;
+    Thread_RunFxn   fxn;
+    Arg             arg;
+    Char            name[16];
+} Thread_Obj;
+
+Thread_Attrs Thread_ATTRS = {
+    0,          /* priority */
+    0,          /* stacksize */
+    NULL,       /* name */
+};
+
+static Void *runStub(Void *arg);
+
+/*
+ *  ======== Thread_create ========
+ */
+Thread_Handle Thread_create(Thread_RunFxn fxn, Thread_Attrs *attrs, Arg arg)
+{
+    pthread_attr_t pattrs;
+    Thread_Obj *thread;
+    Int status;
+
+    if (attrs == NULL) {
+        attrs = &Thread_ATTRS;
+    }
+
+    if ((thread = (Thread_Obj *)calloc(1, sizeof (Thread_Obj))) == NULL) {
+        return (NULL);
+    }
+
+    thread->fxn = fxn;
+    thread->arg = arg;
+    if (attrs->name != NULL) {
+        /* pthread names are limited to 15 characters */
+        strncpy(thread->name, attrs->name, sizeof (thread->name) - 1);
+    }
+
+    pthread_attr_init(&pattrs);
+    if (attrs->stacksize > 0) {
+        pthread_attr_setstacksize(&pattrs, attrs->stacksize);
+    }
+    status = pthread_create(&thread->tid, &pattrs, runStub, thread);
+    pthread_attr_destroy(&pattrs);
+
+    if (status != 0) {
+        free(thread);
+        return (NULL);
+    }
+
+    return (thread);
+}
+
+/*
+ *  ======== Thread_delete ========
+ */
+Void Thread_delete(Thread_Handle thread)
+{
+    if (thread != NULL) {
+        pthread_join(thread->tid, NULL);
+        free(thread);
+    }
+}
+
+/*
+ *  ======== Thread_self ========
+ */
+UInt32 Thread_self(Void)
+{
+    return ((UInt32)pthread_self());
+}
+
+/*
+ *  ======== Thread_init ========
+ */
+Bool Thread_init(Void)
+{
+    return (TRUE);
+}
+
+/*
+ *  ======== Thread_exit ========
+ */
+Void Thread_exit(Void)
+{
+}
+
+/*
+ *  ======== runStub ========
+ */
+static Void *runStub(Void *arg)
+{
+    Thread_Obj *thread = (Thread_Obj *)arg;
+
+    if (thread->name[0] != '\0') {
+        pthread_setname_np(pthread_self(), thread->name);
+    }
+
+    thread->fxn(thread->arg);
+
+    return (NULL);
+}
@@ -0,0 +1,426 @@
+/*
+ *  ======== rms.c ========
+ *  Host implementation of the Resource Manager Server.
+ *
+ *  The RMS is a thread of this process serving the RMS_CMDQNAME queue
+ *  exactly as the DSP server's RMS task does: it creates, starts and
+ *  deletes the nodes listed in RMS_nodeTab and answers the engine's
+ *  memory, version and trace queries.  Node handles returned to the
+ *  engine are indices into the RMS's table of live nodes, since an
+ *  RMS_Word can't hold a host pointer.  RMS_nodeTab is indexed by uuid
+ *  in an open-addressed hash table when the RMS starts.
+ *
+ *  The RMS shares the application's Memory module, so the memory a node
+ *  allocates while it is created is charged to the Memory account the
+ *  engine passes in the create command, that of the node's codec
+ *  instance.
+ */
+#include <xdc/std.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Thread.h>
+#include <ti/sdo/ce/node/node.h>
+#include <ti/sdo/ce/node/_node.h>
+#include <ti/sdo/ce/rms.h>
+
+#define GTNAME          "ti.sdo.ce.rms"
+
+#define MAXNODES        256
+
+#define VERSIONSTRING   "ti.sdo.ce host runtime 1.0"
+
+/* the only memory "segment" of the host server */
+#define SEGNAME         "host"
+
+RMS_Config RMS_CONFIG = RMS_CONFIGDEFAULT;
+
+/* the node table is optional: apps with only local engines don't have one */
+extern NODE_Desc RMS_nodeTab[] __attribute__((weak));
+
+static Int rmsThread(Arg arg);
+static Void exec(RMS_CmdBuf *cmdBuf);
+static Void createNode(RMS_CmdBuf *cmdBuf);
+static Void deleteNode(RMS_CmdBuf *cmdBuf);
+static Void startNode(RMS_CmdBuf *cmdBuf);
+static NODE_Desc *findNode(NODE_Uuid *uuid);
+static Void indexNodes(Void);
+
+static GT_Mask curTrace = {NULL, NULL};
+static Comm_Handle rmsMsgq = NULL;
+static Comm_Queue rmsQueue = Comm_INVALIDMSGQ;
+static Thread_Handle rmsThreadHandle = NULL;
+static NODE_EnvPtr nodes[MAXNODES];
+static Bool traceTokenHeld = FALSE;
+static NODE_Desc **nodeIndex = NULL;   /* NULL: scan RMS_nodeTab instead */
+static UInt32 nodeIndexMask = 0;
+
+/*
+ *  ======== RMS_exit ========
+ */
+Void RMS_exit(Void)
+{
+    RMS_RmsMsg *msg;
+    Int i;
+
+    GT_0trace(curTrace, GT_ENTER, "RMS_exit> Enter\n");
+
+    if (rmsThreadHandle != NULL) {
+        if (Comm_alloc(0, (Comm_Msg *)&msg, sizeof (RMS_RmsMsg)) ==
+                Comm_EOK) {
+            msg->cmdBuf.cmd = RMS_EXIT;
+            Comm_put(rmsQueue, (Comm_Msg)msg);
+        }
+        Thread_delete(rmsThreadHandle);
+        rmsThreadHandle = NULL;
+    }
+
+    for (i = 0; i < MAXNODES; i++) {
+        if (nodes[i] != NULL) {
+            GT_1trace(curTrace, GT_6CLASS, "RMS_exit> "
+                "deleting node %d left behind by its engine\n", i);
+            NODE_delete(nodes[i]);
+            nodes[i] = NULL;
+        }
+    }
+
+    if (rmsMsgq != NULL) {
+        Comm_delete(rmsMsgq);
+        rmsMsgq = NULL;
+    }
+
+    free(nodeIndex);
+    nodeIndex = NULL;
+
+    NODE_exit();
+}
+
+/*
+ *  ======== RMS_init ========
+ */
+Void RMS_init(Void)
+{
+    Thread_Attrs attrs = Thread_ATTRS;
+    NODE_Desc *desc;
+
+    GT_create(&curTrace, GTNAME);
+
+    GT_0trace(curTrace, GT_ENTER, "RMS_init> Enter\n");
+
+    NODE_init();
+
+    if (RMS_nodeTab != NULL) {
+        for (desc = RMS_nodeTab; desc->name != NULL; desc++) {
+            if (desc->uuid.data == 0) {
+                desc->uuid = NODE_uuidFromName(desc->name);
+            }
+        }
+        indexNodes();
+    }
+
+    if ((rmsMsgq = Comm_create(RMS_CMDQNAME, &rmsQueue, NULL)) == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "RMS_init> "
+            "failed to create the command queue\n");
+        NODE_exit();
+        return;
+    }
+
+    attrs.name = "rms";
+    if ((rmsThreadHandle = Thread_create(rmsThread, &attrs, 0)) == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "RMS_init> "
+            "failed to create the server thread\n");
+        Comm_delete(rmsMsgq);
+        rmsMsgq = NULL;
+        NODE_exit();
+    }
+}
+
+/*
+ *  ======== createNode ========
+ */
+static Void createNode(RMS_CmdBuf *cmdBuf)
+{
+    RMS_CmdSetCreateNodeIn *in = &cmdBuf->data.createNodeIn;
+    RMS_CmdSetCreateNodeOut *out = &cmdBuf->data.createNodeOut;
+    IALG_Params *params;
+    NODE_Desc *desc;
+    NODE_Status status;
+    Int account;
+    Int i;
+
+    if ((desc = findNode(&in->uuid)) == NULL) {
+        GT_1trace(curTrace, GT_7CLASS, "createNode> "
+            "no node with uuid 0x%lx\n", (IArg)in->uuid.data);
+        cmdBuf->status = RMS_EINVUUID;
+        return;
+    }
+
+    for (i = 0; i < MAXNODES && nodes[i] != NULL; i++) {
+    }
+    if (i == MAXNODES) {
+        cmdBuf->status = RMS_ERESOURCE;
+        return;
+    }
+
+    params = in->argLength == 0 ? NULL : (IALG_Params *)in->argBuffer;
+
+    /*
+     *  in and out share cmdBuf->data; out is written only after create.
+     *  Accounts are per process, so a client's across a link is no use.
+     */
+    account = Memory_setAccount(Comm_isLocal(in->gppQueue) ?
+        (Int)in->memAccount : Memory_NOACCOUNT);
+    status = NODE_create(desc, in->gppQueue, params, &nodes[i]);
+    Memory_setAccount(account);
+    switch (status) {
+        case NODE_EOK:
+            out->node = i;
+            out->nodeQueue = NODE_getQueue(nodes[i]);
+            out->remoteVisa = i;
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case NODE_EOUTOFMEMORY:
+            cmdBuf->status = RMS_EOUTOFMEMORY;
+            break;
+
+        case NODE_ERESOURCE:
+            cmdBuf->status = RMS_ERESOURCE;
+            break;
+
+        default:
+            cmdBuf->status = RMS_EFAIL;
+            break;
+    }
+}
+
+/*
+ *  ======== deleteNode ========
+ */
+static Void deleteNode(RMS_CmdBuf *cmdBuf)
+{
+    RMS_Word node = cmdBuf->data.deleteNodeIn.node;
+
+    if (node >= MAXNODES || nodes[node] == NULL) {
+        cmdBuf->status = RMS_EINVAL;
+        return;
+    }
+
+    NODE_delete(nodes[node]);
+    nodes[node] = NULL;
+
+    cmdBuf->data.deleteNodeOut.node = node;
+    cmdBuf->data.deleteNodeOut.stackSize = 0;
+    cmdBuf->data.deleteNodeOut.stackUsed = 0;
+    cmdBuf->status = RMS_EOK;
+}
+
+/*
+ *  ======== exec ========
+ */
+static Void exec(RMS_CmdBuf *cmdBuf)
+{
+    Memory_Stat stat;
+
+    GT_1trace(curTrace, GT_2CLASS, "exec> cmd 0x%x\n", cmdBuf->cmd);
+
+    switch (cmdBuf->cmd) {
+        case RMS_CREATENODE:
+            createNode(cmdBuf);
+            break;
+
+        case RMS_STARTNODE:
+            startNode(cmdBuf);
+            break;
+
+        case RMS_DELETENODE:
+            deleteNode(cmdBuf);
+            break;
+
+        case RMS_GETMEMSTAT:
+            Memory_contigStat(&stat);
+            cmdBuf->data.getMemStatOut.used = stat.used;
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case RMS_GETTRACE:
+            /* server trace goes straight to stdout; nothing is buffered */
+            cmdBuf->data.getTraceOut.size = 0;
+            cmdBuf->data.getTraceOut.max = 0;
+            cmdBuf->data.getTraceOut.avail = 0;
+            cmdBuf->data.getTraceOut.lost = 0;
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case RMS_GETVERS:
+            strncpy((Char *)cmdBuf->data.getVersOut.vers, VERSIONSTRING,
+                RMS_READBUFSIZE - 1);
+            cmdBuf->data.getVersOut.rpcMajor = RMS_VERSION_MAJOR;
+            cmdBuf->data.getVersOut.rpcSource = RMS_VERSION_SOURCE;
+            cmdBuf->data.getVersOut.rpcMinor = RMS_VERSION_MINOR;
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case RMS_SETTRACEMASK:
+            ((Char *)cmdBuf->data.setTraceMaskIn.traceMask)
+                [RMS_MAXTRACEMASKSIZE - 1] = '\0';
+            GT_set((String)cmdBuf->data.setTraceMaskIn.traceMask);
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case RMS_GETNUMSEGS:
+            cmdBuf->data.getNumSegsOut.numSegs = 1;
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case RMS_GETSEGSTAT:
+            if (cmdBuf->data.getSegStatIn.segId != 0) {
+                cmdBuf->status = RMS_EINVAL;
+                break;
+            }
+            Memory_contigStat(&stat);
+            memset(cmdBuf->data.getSegStatOut.name, 0,
+                sizeof (cmdBuf->data.getSegStatOut.name));
+            strncpy((Char *)cmdBuf->data.getSegStatOut.name, SEGNAME,
+                RMS_MAXSEGNAMELENGTH);
+            cmdBuf->data.getSegStatOut.base = stat.base;
+            cmdBuf->data.getSegStatOut.size = stat.size;
+            cmdBuf->data.getSegStatOut.used = stat.used;
+            cmdBuf->data.getSegStatOut.maxBlockLen = stat.length;
+            cmdBuf->status = RMS_EOK;
+            break;
+
+        case RMS_REQTRACETOKEN:
+            cmdBuf->status = traceTokenHeld ? RMS_ERESOURCE : RMS_EOK;
+            traceTokenHeld = TRUE;
+            break;
+
+        case RMS_RELTRACETOKEN:
+            cmdBuf->status = traceTokenHeld ? RMS_EOK : RMS_EFAIL;
+            traceTokenHeld = FALSE;
+            break;
+
+        default:
+            /* CPU load, heap redefinition and raw memory writes */
+            cmdBuf->status = RMS_ENOTIMPL;
+            break;
+    }
+}
+
+/*
+ *  ======== findNode ========
+ */
+static NODE_Desc *findNode(NODE_Uuid *uuid)
+{
+    NODE_Desc *desc;
+
+    UInt32 i;
+
+    if (RMS_nodeTab == NULL) {
+        return (NULL);
+    }
+
+    if (nodeIndex != NULL) {
+        for (i = uuid->data & nodeIndexMask; (desc = nodeIndex[i]) != NULL;
+            i = (i + 1) & nodeIndexMask) {
+            if (NODE_uuidMatch(&desc->uuid, uuid)) {
+                return (desc);
+            }
+        }
+        return (NULL);
+    }
+
+    for (desc = RMS_nodeTab; desc->name != NULL; desc++) {
+        if (NODE_uuidMatch(&desc->uuid, uuid)) {
+            return (desc);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== indexNodes ========
+ *  Build nodeIndex, at most half full.  As with the scan, the first of
+ *  several nodes with the same uuid wins.
+ */
+static Void indexNodes(Void)
+{
+    NODE_Desc *desc;
+    UInt32 size = 4;
+    UInt32 i;
+
+    for (desc = RMS_nodeTab; desc->name != NULL; desc++) {
+    }
+    while (size < (UInt32)(desc - RMS_nodeTab) * 2) {
+        size <<= 1;
+    }
+
+    if ((nodeIndex = (NODE_Desc **)calloc(size, sizeof (NODE_Desc *))) ==
+            NULL) {
+        GT_0trace(curTrace, GT_6CLASS, "indexNodes> "
+            "can't allocate the node index\n");
+        return;
+    }
+    nodeIndexMask = size - 1;
+
+    for (desc = RMS_nodeTab; desc->name != NULL; desc++) {
+        for (i = desc->uuid.data & nodeIndexMask; nodeIndex[i] != NULL &&
+            !NODE_uuidMatch(&nodeIndex[i]->uuid, &desc->uuid);
+            i = (i + 1) & nodeIndexMask) {
+        }
+        if (nodeIndex[i] == NULL) {
+            nodeIndex[i] = desc;
+        }
+    }
+}
+
+/*
+ *  ======== rmsThread ========
+ */
+static Int rmsThread(Arg arg)
+{
+    RMS_RmsMsg *msg;
+    Comm_Queue replyQueue;
+
+    for (;;) {
+        if (Comm_get(rmsQueue, (Comm_Msg *)&msg, Comm_FOREVER) != Comm_EOK) {
+            continue;
+        }
+
+        if (msg->cmdBuf.cmd == RMS_EXIT) {
+            Comm_free((Comm_Msg)msg);
+            break;
+        }
+
+        exec(&msg->cmdBuf);
+
+        Comm_getSrcQueue((Comm_Msg)msg, &replyQueue);
+        if (replyQueue == Comm_INVALIDMSGQ ||
+            Comm_put(replyQueue, (Comm_Msg)msg) != Comm_EOK) {
+            Comm_free((Comm_Msg)msg);
+        }
+    }
+
+    return (0);
+}
+
+/*
+ *  ======== startNode ========
+ */
+static Void startNode(RMS_CmdBuf *cmdBuf)
+{
+    RMS_Word node = cmdBuf->data.startNodeIn.node;
+
+    if (node >= MAXNODES || nodes[node] == NULL) {
+        cmdBuf->status = RMS_EINVAL;
+        return;
+    }
+
+    cmdBuf->status = NODE_start(nodes[node]) == NODE_EOK ?
+        RMS_EOK : RMS_ETASK;
+}
@@ -0,0 +1,118 @@
+/*
+ *  ======== sphdec1.c ========
+ *  The xDM ISPHDEC1 Speech Decoder API.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/xdais/dm/isphdec1.h>
+
+#include <ti/sdo/ce/speech1/sphdec1.h>
+#include <ti/sdo/ce/speech1/_sphdec1.h>
+
+/*
+ *  ======== SPHDEC1_control ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* speech decoders (both high and low complexity
+ *  decoders are envoked using this method).
+ */
+XDAS_Int32 SPHDEC1_control(SPHDEC1_Handle handle, SPHDEC1_Cmd id,
+    SPHDEC1_DynamicParams *dynParams, SPHDEC1_Status *status)
+{
+    XDAS_Int32 retVal = SPHDEC1_EFAIL;
+    ISPHDEC1_Fxns *fxns;
+    ISPHDEC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (ISPHDEC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->control(alg, id, dynParams, status);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== SPHDEC1_create ========
+ */
+SPHDEC1_Handle SPHDEC1_create(Engine_Handle engine, String name,
+    SPHDEC1_Params *params)
+{
+    return ((SPHDEC1_Handle)VISA_create(engine, name, (IALG_Params *)params,
+        sizeof (_SPHDEC1_Msg), "ti.sdo.ce.speech1.ISPHDEC1"));
+}
+
+/*
+ *  ======== SPHDEC1_delete ========
+ */
+Void SPHDEC1_delete(SPHDEC1_Handle handle)
+{
+    VISA_delete((VISA_Handle)handle);
+}
+
+/*
+ *  ======== SPHDEC1_process ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* speech decoders (both high and low complexity
+ *  decoders are envoked using this method).
+ */
+XDAS_Int32 SPHDEC1_process(SPHDEC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHDEC1_InArgs *inArgs, SPHDEC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal = SPHDEC1_EFAIL;
+    ISPHDEC1_Fxns *fxns;
+    ISPHDEC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (ISPHDEC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->process(alg, inBuf, outBuf, inArgs, outArgs);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== SPHDEC1_release ========
+ *  Reset the codec, so that it is ready for its next user, and park it
+ *  for reuse.  A codec that can't be reset is simply deleted.
+ */
+Void SPHDEC1_release(SPHDEC1_Handle handle)
+{
+    SPHDEC1_DynamicParams dynParams;
+    SPHDEC1_Status status;
+
+    if (handle == NULL) {
+        return;
+    }
+
+    memset(&dynParams, 0, sizeof (dynParams));
+    dynParams.size = sizeof (dynParams);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+
+    if (SPHDEC1_control(handle, XDM_RESET, &dynParams, &status) ==
+            SPHDEC1_EOK) {
+        VISA_release((VISA_Handle)handle);
+    }
+    else {
+        VISA_delete((VISA_Handle)handle);
+    }
+}
@@ -0,0 +1,216 @@
+/*
+ *  ======== sphdec1_skel.c ========
+ *  This file contains the implemenation of the SKEL interface for the
+ *  speech decoder class of algorithms.
+ *
+ *  These functions are the "server-side" of the the stubs defined in
+ *  sphdec1_stubs.c
+ */
+#include <xdc/std.h>
+
+#include <ti/sdo/ce/skel.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include <ti/sdo/ce/speech1/sphdec1.h>
+#include <ti/sdo/ce/speech1/_sphdec1.h>
+
+static Bool argsFit(VISA_Msg msg, XDAS_Int16 *size);
+static Bool framesFit(_SPHDEC1_Msg *msg);
+static XDAS_Int32 processFrame(SPHDEC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    ISPHDEC1_InArgs *inArgs);
+static Void unmarshallBuf(XDM1_SingleBufDesc *buf);
+
+/*
+ *  ======== call ========
+ */
+static VISA_Status call(VISA_Handle visaHandle, VISA_Msg visaMsg)
+{
+    _SPHDEC1_Msg *msg = (_SPHDEC1_Msg *)visaMsg;
+    SPHDEC1_Handle handle = (SPHDEC1_Handle)visaHandle;
+    _SPHDEC1_BatchFrame *frame;
+    ISPHDEC1_Status *pStatus;
+    Int i;
+
+    /*
+     * Do any needed translations on the buffer pointers, then
+     * call the appropriate API function, based on the command.
+     */
+    switch (msg->visa.cmd) {
+
+        case _SPHDEC1_CPROCESS: {
+            if (!argsFit(visaMsg, &(msg->cmd.process.inArgs.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            msg->visa.status = processFrame(handle,
+                &(msg->cmd.process.inBuf), &(msg->cmd.process.outBuf),
+                &(msg->cmd.process.inArgs));
+
+            break;
+        }
+
+        case _SPHDEC1_CPROCESSBATCH: {
+            if (!framesFit(msg)) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* each frame's status is returned in the frame itself */
+            frame = &(msg->cmd.batch.frame);
+            for (i = 0; i < msg->cmd.batch.numFrames; i++) {
+                frame->status = processFrame(handle, &(frame->inBuf),
+                    &(frame->outBuf), (ISPHDEC1_InArgs *)(frame + 1));
+
+                frame = (_SPHDEC1_BatchFrame *)((UInt8 *)frame + frame->size);
+            }
+            msg->visa.status = SPHDEC1_EOK;
+
+            break;
+        }
+
+        case _SPHDEC1_CCONTROL: {
+            if (!argsFit(visaMsg, &(msg->cmd.control.params.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* status follows the variable-sized params */
+            pStatus = (ISPHDEC1_Status *)((UInt8 *)
+                &(msg->cmd.control.params) + msg->cmd.control.params.size);
+
+            unmarshallBuf(&(pStatus->data));
+
+            /* make the control call */
+            msg->visa.status = SPHDEC1_control(handle, msg->cmd.control.id,
+                &(msg->cmd.control.params), pStatus);
+
+            if (pStatus->data.buf != NULL) {
+                Memory_cacheWb(pStatus->data.buf, pStatus->data.bufSize);
+
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferPhysicalAddress(pStatus->data.buf,
+                        pStatus->data.bufSize, NULL);
+            }
+
+            break;
+        }
+
+        default: {
+            msg->visa.status = VISA_EFAIL;
+
+            break;
+        }
+    }
+
+    return (VISA_EOK);
+}
+
+/*
+ *  ======== argsFit ========
+ *  Whether msg holds the variable-sized args that start with the size
+ *  field at size, and the args that follow them, as big as their size
+ *  fields say.  The stubs size each message to its args, so a bad size
+ *  would have the call read or write past the message's end.
+ */
+static Bool argsFit(VISA_Msg msg, XDAS_Int16 *size)
+{
+    IArg room = (UInt8 *)msg + Comm_getMsgSize((Comm_Msg)msg) -
+        (UInt8 *)size;
+    IArg inSize;
+    IArg outSize;
+
+    if (room < (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    inSize = *size;
+    if (inSize < (IArg)sizeof (*size) ||
+        inSize > room - (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    outSize = *(XDAS_Int16 *)((UInt8 *)size + inSize);
+
+    return (outSize >= (IArg)sizeof (*size) && outSize <= room - inSize);
+}
+
+/*
+ *  ======== framesFit ========
+ *  Whether msg holds each of its batch's frames, with their args.
+ */
+static Bool framesFit(_SPHDEC1_Msg *msg)
+{
+    _SPHDEC1_BatchFrame *frame = &(msg->cmd.batch.frame);
+    IArg room = (UInt8 *)msg + Comm_getMsgSize((Comm_Msg)msg) -
+        (UInt8 *)frame;
+    Int i;
+
+    for (i = 0; i < msg->cmd.batch.numFrames; i++) {
+        if (room < (IArg)sizeof (*frame) ||
+            frame->size < (IArg)sizeof (*frame) || frame->size > room ||
+            !argsFit((VISA_Msg)msg,
+                &(((ISPHDEC1_InArgs *)(frame + 1))->size))) {
+            return (FALSE);
+        }
+
+        room -= frame->size;
+        frame = (_SPHDEC1_BatchFrame *)((UInt8 *)frame + frame->size);
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== processFrame ========
+ *  Unmarshall one frame's buffers, in place, and decode it.  The frame's
+ *  outArgs follows the variable-sized inArgs.
+ */
+static XDAS_Int32 processFrame(SPHDEC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    ISPHDEC1_InArgs *inArgs)
+{
+    XDAS_Int32 status;
+    ISPHDEC1_OutArgs *pOutArgs;
+
+    unmarshallBuf(inBuf);
+    unmarshallBuf(outBuf);
+    unmarshallBuf(&(inArgs->data));
+
+    pOutArgs = (ISPHDEC1_OutArgs *)((UInt8 *)inArgs + inArgs->size);
+
+    /* make the process call */
+    status = SPHDEC1_process(handle, inBuf, outBuf, inArgs, pOutArgs);
+
+    /* write back the output buffer the alg filled */
+    if (outBuf->buf != NULL) {
+        Memory_cacheWb(outBuf->buf, outBuf->bufSize);
+    }
+
+    return (status);
+}
+
+/*
+ *  ======== unmarshallBuf ========
+ *  Translate buf to a virtual address, in place.
+ */
+static Void unmarshallBuf(XDM1_SingleBufDesc *buf)
+{
+    if (buf->buf != NULL) {
+        buf->buf = (XDAS_Int8 *)Memory_getBufferVirtualAddress(
+            (UInt32)buf->buf, buf->bufSize);
+
+        Memory_cacheInv(buf->buf, buf->bufSize);
+    }
+}
+
+/*
+ *  ======== SPHDEC1_SKEL ========
+ */
+SKEL_Fxns SPHDEC1_SKEL = {
+    call,
+    (SKEL_CREATEFXN)&SPHDEC1_create,
+    (SKEL_DESTROYFXN)&SPHDEC1_delete,
+};
@@ -0,0 +1,118 @@
+/*
+ *  ======== sphenc1.c ========
+ *  The xDM ISPHENC1 Speech Encoder API.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/xdais/dm/isphenc1.h>
+
+#include <ti/sdo/ce/speech1/sphenc1.h>
+#include <ti/sdo/ce/speech1/_sphenc1.h>
+
+/*
+ *  ======== SPHENC1_control ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* speech encoders (both high and low complexity
+ *  encoders are envoked using this method).
+ */
+XDAS_Int32 SPHENC1_control(SPHENC1_Handle handle, SPHENC1_Cmd id,
+    SPHENC1_DynamicParams *dynParams, SPHENC1_Status *status)
+{
+    XDAS_Int32 retVal = SPHENC1_EFAIL;
+    ISPHENC1_Fxns *fxns;
+    ISPHENC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (ISPHENC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->control(alg, id, dynParams, status);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== SPHENC1_create ========
+ */
+SPHENC1_Handle SPHENC1_create(Engine_Handle engine, String name,
+    SPHENC1_Params *params)
+{
+    return ((SPHENC1_Handle)VISA_create(engine, name, (IALG_Params *)params,
+        sizeof (_SPHENC1_Msg), "ti.sdo.ce.speech1.ISPHENC1"));
+}
+
+/*
+ *  ======== SPHENC1_delete ========
+ */
+Void SPHENC1_delete(SPHENC1_Handle handle)
+{
+    VISA_delete((VISA_Handle)handle);
+}
+
+/*
+ *  ======== SPHENC1_process ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* speech encoders (both high and low complexity
+ *  encoders are envoked using this method).
+ */
+XDAS_Int32 SPHENC1_process(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHENC1_InArgs *inArgs, SPHENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal = SPHENC1_EFAIL;
+    ISPHENC1_Fxns *fxns;
+    ISPHENC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (ISPHENC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->process(alg, inBuf, outBuf, inArgs, outArgs);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== SPHENC1_release ========
+ *  Reset the codec, so that it is ready for its next user, and park it
+ *  for reuse.  A codec that can't be reset is simply deleted.
+ */
+Void SPHENC1_release(SPHENC1_Handle handle)
+{
+    SPHENC1_DynamicParams dynParams;
+    SPHENC1_Status status;
+
+    if (handle == NULL) {
+        return;
+    }
+
+    memset(&dynParams, 0, sizeof (dynParams));
+    dynParams.size = sizeof (dynParams);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+
+    if (SPHENC1_control(handle, XDM_RESET, &dynParams, &status) ==
+            SPHENC1_EOK) {
+        VISA_release((VISA_Handle)handle);
+    }
+    else {
+        VISA_delete((VISA_Handle)handle);
+    }
+}
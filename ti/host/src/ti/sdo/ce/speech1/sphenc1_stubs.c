@@ -0,0 +1,524 @@
+/*
+ *  ======== sphenc1_stubs.c ========
+ *  This file contains an implemenation of the ISPHENC1 interface for the
+ *  speech encoder class of algorithms.
+ *
+ *  These functions are the "client-side" of a "remote" implementation.
+ */
+#include <xdc/std.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/xdais/dm/isphenc1.h>
+
+#include <ti/sdo/ce/speech1/sphenc1.h>
+#include <ti/sdo/ce/speech1/_sphenc1.h>
+
+/*
+ *  Size of a message carrying the given inArgs and outArgs, or params and
+ *  status, which follow each other at the end of the message.
+ */
+#define PROCESSMSGSIZE(in, out) \
+    (offsetof(_SPHENC1_Msg, cmd.process.inArgs) + (in)->size + (out)->size)
+#define CONTROLMSGSIZE(in, out) \
+    (offsetof(_SPHENC1_Msg, cmd.control.params) + (in)->size + (out)->size)
+
+/* size of a batch frame with its args, keeping the next frame aligned */
+#define BATCHFRAMESIZE(inArgs, outArgs) \
+    ((sizeof (_SPHENC1_BatchFrame) + (inArgs)->size + (outArgs)->size + \
+    sizeof (Ptr) - 1) & ~(sizeof (Ptr) - 1))
+
+/* most buffers a process call's arguments reference */
+#define MAXRANGES       3
+
+/* most buffers of a batch message, whose cache is maintained in one call */
+#define MAXBATCHRANGES  128
+
+static XDAS_Int32 control(ISPHENC1_Handle h, ISPHENC1_Cmd id,
+    ISPHENC1_DynamicParams *params, ISPHENC1_Status *status);
+static XDAS_Int32 marshallBatch(VISA_Handle visa,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    ISPHENC1_InArgs *inArgs[], ISPHENC1_OutArgs *outArgs[], Int numFrames,
+    Int *numSent, _SPHENC1_Msg **pmsg);
+static Bool marshallBuf(XDM1_SingleBufDesc *msgBuf, XDM1_SingleBufDesc *buf,
+    Memory_CacheRange ranges[], Int *numRanges);
+static XDAS_Int32 marshallMsg(ISPHENC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHENC1_InArgs *inArgs,
+    ISPHENC1_OutArgs *outArgs, _SPHENC1_Msg **pmsg);
+static XDAS_Int32 process(ISPHENC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHENC1_InArgs *inArgs,
+    ISPHENC1_OutArgs *outArgs);
+static XDAS_Int32 unmarshallBatch(VISA_Handle visa,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    ISPHENC1_OutArgs *outArgs[], Int numFrames, _SPHENC1_Msg *msg,
+    XDAS_Int32 retVal, XDAS_Int32 retVals[]);
+static XDAS_Int32 unmarshallMsg(ISPHENC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHENC1_InArgs *inArgs,
+    ISPHENC1_OutArgs *outArgs, _SPHENC1_Msg *msg, XDAS_Int32 retVal);
+
+ISPHENC1_Fxns SPHENC1_STUBS = {
+    {&SPHENC1_STUBS, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+    process, control,
+};
+
+/*
+ *  ======== SPHENC1_processAsync ========
+ *  Local instances have nothing to send; their process call runs in
+ *  SPHENC1_processWait(), in the caller's thread.
+ */
+XDAS_Int32 SPHENC1_processAsync(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHENC1_InArgs *inArgs, SPHENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _SPHENC1_Msg *msg;
+
+    if (visa == NULL) {
+        return (SPHENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&SPHENC1_STUBS) {
+        return (SPHENC1_EOK);
+    }
+
+    if ((retVal = marshallMsg((ISPHENC1_Handle)visa, inBuf, outBuf, inArgs,
+        outArgs, &msg)) != ISPHENC1_EOK) {
+        return (retVal);
+    }
+
+    if (VISA_callAsync(visa, (VISA_Msg *)&msg) != VISA_EOK) {
+        VISA_freeMsg(visa, (VISA_Msg)msg);
+        return (SPHENC1_EFAIL);
+    }
+
+    return (SPHENC1_EOK);
+}
+
+/*
+ *  ======== SPHENC1_processBatch ========
+ *  Local instances simply process the frames one by one.
+ */
+XDAS_Int32 SPHENC1_processBatch(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    SPHENC1_InArgs *inArgs[], SPHENC1_OutArgs *outArgs[], Int numFrames,
+    XDAS_Int32 retVals[])
+{
+    XDAS_Int32 retVal = SPHENC1_EOK;
+    XDAS_Int32 status;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _SPHENC1_Msg *msg;
+    Int first;
+    Int n;
+
+    if (visa == NULL) {
+        return (SPHENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&SPHENC1_STUBS) {
+        for (n = 0; n < numFrames; n++) {
+            retVals[n] = SPHENC1_process(handle, &inBufs[n], &outBufs[n],
+                inArgs[n], outArgs[n]);
+            if (retVals[n] != SPHENC1_EOK) {
+                retVal = SPHENC1_EFAIL;
+            }
+        }
+
+        return (retVal);
+    }
+
+    for (n = 0; n < numFrames; n++) {
+        retVals[n] = SPHENC1_EFAIL;
+    }
+
+    /* send the frames as many to a message as will fit */
+    for (first = 0; first < numFrames; first += n) {
+        if (marshallBatch(visa, &inBufs[first], &outBufs[first],
+            &inArgs[first], &outArgs[first], numFrames - first, &n,
+            &msg) != ISPHENC1_EOK) {
+            return (SPHENC1_EFAIL);
+        }
+
+        /* send the message to the skeleton and wait for completion */
+        status = VISA_call(visa, (VISA_Msg *)&msg);
+
+        if (unmarshallBatch(visa, &inBufs[first], &outBufs[first],
+            &outArgs[first], n, msg, status, &retVals[first]) !=
+            ISPHENC1_EOK) {
+            retVal = SPHENC1_EFAIL;
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== SPHENC1_processWait ========
+ */
+XDAS_Int32 SPHENC1_processWait(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHENC1_InArgs *inArgs, SPHENC1_OutArgs *outArgs, UInt timeout)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _SPHENC1_Msg *msg;
+
+    if (visa == NULL) {
+        return (SPHENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&SPHENC1_STUBS) {
+        return (SPHENC1_process(handle, inBuf, outBuf, inArgs, outArgs));
+    }
+
+    if ((retVal = VISA_wait(visa, (VISA_Msg *)&msg, timeout)) ==
+            VISA_ETIMEOUT) {
+        /* still in flight; the caller must wait again */
+        return (SPHENC1_ETIMEOUT);
+    }
+
+    /* without a reply, there are no outArgs to copy out */
+    if (msg == NULL) {
+        return (SPHENC1_EFAIL);
+    }
+
+    return (unmarshallMsg((ISPHENC1_Handle)visa, inBuf, outBuf, inArgs,
+        outArgs, msg, retVal));
+}
+
+/*
+ *  ======== control ========
+ *  This is the stub-implementation for the control method
+ */
+static XDAS_Int32 control(ISPHENC1_Handle h, ISPHENC1_Cmd id,
+    ISPHENC1_DynamicParams *params, ISPHENC1_Status *status)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _SPHENC1_Msg *msg;
+    ISPHENC1_Status *pMsgStatus;
+    XDAS_Int8 *virtAddr = NULL;
+    Memory_CacheRange range;
+    Int numRanges = 0;
+
+    /* get a message big enough for params and status */
+    if ((msg = (_SPHENC1_Msg *)VISA_allocMsg2(visa,
+        CONTROLMSGSIZE(params, status))) == NULL) {
+        return (ISPHENC1_EFAIL);
+    }
+
+    /* marshall the command */
+    msg->visa.cmd = _SPHENC1_CCONTROL;
+
+    msg->cmd.control.id = id;
+
+    /* params has no pointers so simply copy the struct fields into the msg */
+    memcpy(&(msg->cmd.control.params), params, params->size);
+
+    /* unlike params, status is placed after the variable-sized params */
+    pMsgStatus = (ISPHENC1_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* set status's size field and buffer, translating the latter */
+    pMsgStatus->size = status->size;
+    if (!marshallBuf(&(pMsgStatus->data), &(status->data), &range,
+        &numRanges)) {
+        retVal = ISPHENC1_EFAIL;
+        goto exit;
+    }
+    Memory_cacheWbInvRanges(&range, numRanges);
+    virtAddr = status->data.buf;
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_callUrgent(visa, (VISA_Msg *)&msg);
+
+    /* re-locate status, msg may have been changed by VISA_callUrgent() */
+    pMsgStatus = (ISPHENC1_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* copy out status, restoring the caller's buffer address */
+    memcpy(status, pMsgStatus, pMsgStatus->size);
+    if (virtAddr != NULL) {
+        status->data.buf = virtAddr;
+        Memory_cacheInv(virtAddr, status->data.bufSize);
+    }
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== marshallBatch ========
+ *  Marshall as many of the numFrames frames as fit into the instance's
+ *  message.  On success, *numSent frames were marshalled and *pmsg is
+ *  the message, ready to be sent to the skeleton.
+ */
+static XDAS_Int32 marshallBatch(VISA_Handle visa,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    ISPHENC1_InArgs *inArgs[], ISPHENC1_OutArgs *outArgs[], Int numFrames,
+    Int *numSent, _SPHENC1_Msg **pmsg)
+{
+    _SPHENC1_Msg *msg;
+    _SPHENC1_BatchFrame *frame;
+    ISPHENC1_InArgs *pMsgInArgs;
+    ISPHENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[MAXBATCHRANGES];
+    Int numRanges = 0;
+    UInt size;
+    Int n;
+
+    /* a batch fills a Comm_MSGSIZE message with as many frames as fit */
+    if ((msg = (_SPHENC1_Msg *)VISA_allocMsg(visa)) == NULL) {
+        return (ISPHENC1_EFAIL);
+    }
+
+    msg->visa.cmd = _SPHENC1_CPROCESSBATCH;
+
+    frame = &(msg->cmd.batch.frame);
+    for (n = 0; n < numFrames; n++) {
+        size = BATCHFRAMESIZE(inArgs[n], outArgs[n]);
+        if ((UInt8 *)frame + size > (UInt8 *)msg + Comm_MSGSIZE ||
+            numRanges + MAXRANGES > MAXBATCHRANGES) {
+            break;
+        }
+
+        if (!marshallBuf(&(frame->inBuf), &inBufs[n], ranges, &numRanges) ||
+            !marshallBuf(&(frame->outBuf), &outBufs[n], ranges, &numRanges)) {
+            goto exit;
+        }
+
+        /* the frame's inArgs follows it, then its outArgs */
+        pMsgInArgs = (ISPHENC1_InArgs *)(frame + 1);
+        memcpy(pMsgInArgs, inArgs[n], inArgs[n]->size);
+        if (!marshallBuf(&(pMsgInArgs->data), &(inArgs[n]->data), ranges,
+            &numRanges)) {
+            goto exit;
+        }
+
+        pMsgOutArgs = (ISPHENC1_OutArgs *)((UInt8 *)pMsgInArgs +
+            inArgs[n]->size);
+        pMsgOutArgs->size = outArgs[n]->size;
+
+        frame->size = size;
+        frame = (_SPHENC1_BatchFrame *)((UInt8 *)frame + size);
+    }
+
+    /* not even one frame fits */
+    if (n == 0) {
+        goto exit;
+    }
+
+    /* write back the buffers of all of the frames at once */
+    Memory_cacheWbInvRanges(ranges, numRanges);
+
+    msg->cmd.batch.numFrames = n;
+    *numSent = n;
+    *pmsg = msg;
+
+    return (ISPHENC1_EOK);
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (ISPHENC1_EFAIL);
+}
+
+/*
+ *  ======== marshallBuf ========
+ *  Copy buf into msgBuf, translating its address to a physical one, and
+ *  append the buffer to ranges for cache maintenance.
+ */
+static Bool marshallBuf(XDM1_SingleBufDesc *msgBuf, XDM1_SingleBufDesc *buf,
+    Memory_CacheRange ranges[], Int *numRanges)
+{
+    *msgBuf = *buf;
+    msgBuf->accessMask = 0;
+
+    if (buf->buf != NULL) {
+        ranges[*numRanges].addr = buf->buf;
+        ranges[(*numRanges)++].sizeInBytes = buf->bufSize;
+
+        msgBuf->buf = (XDAS_Int8 *)Memory_getBufferPhysicalAddress(buf->buf,
+            buf->bufSize, NULL);
+        if (msgBuf->buf == NULL) {
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ *  ======== marshallMsg ========
+ *  Marshall a process call into the instance's message.  On success,
+ *  *pmsg is the message, ready to be sent to the skeleton.
+ */
+static XDAS_Int32 marshallMsg(ISPHENC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHENC1_InArgs *inArgs,
+    ISPHENC1_OutArgs *outArgs, _SPHENC1_Msg **pmsg)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _SPHENC1_Msg *msg;
+    ISPHENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[MAXRANGES];
+    Int numRanges = 0;
+
+    /* get a message big enough for inArgs and outArgs */
+    if ((msg = (_SPHENC1_Msg *)VISA_allocMsg2(visa,
+        PROCESSMSGSIZE(inArgs, outArgs))) == NULL) {
+        return (ISPHENC1_EFAIL);
+    }
+
+    /*
+     * Marshall the command: copy the client-passed arguments into flattened
+     * message data structures, converting every pointer address to alg.
+     * data buffer into physical address.
+     */
+
+    /* First specify the processing command that the skeleton should do */
+    msg->visa.cmd = _SPHENC1_CPROCESS;
+
+    if (!marshallBuf(&(msg->cmd.process.inBuf), inBuf, ranges, &numRanges) ||
+        !marshallBuf(&(msg->cmd.process.outBuf), outBuf, ranges,
+            &numRanges)) {
+        retVal = ISPHENC1_EFAIL;
+        goto exit;
+    }
+
+    /* copy inArgs into the msg and translate its data buffer */
+    memcpy(&(msg->cmd.process.inArgs), inArgs, inArgs->size);
+    if (!marshallBuf(&(msg->cmd.process.inArgs.data), &(inArgs->data),
+        ranges, &numRanges)) {
+        retVal = ISPHENC1_EFAIL;
+        goto exit;
+    }
+
+    /* point at outArgs and set the "size" */
+    pMsgOutArgs = (ISPHENC1_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /* set the size field - the rest is filled in by the codec */
+    pMsgOutArgs->size = outArgs->size;
+
+    /* write back all the buffers at once */
+    Memory_cacheWbInvRanges(ranges, numRanges);
+
+    *pmsg = msg;
+
+    return (ISPHENC1_EOK);
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== process ========
+ *  This is the stub-implementation for the process method
+ */
+static XDAS_Int32 process(ISPHENC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHENC1_InArgs *inArgs,
+    ISPHENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    _SPHENC1_Msg *msg;
+
+    if ((retVal = marshallMsg(h, inBuf, outBuf, inArgs, outArgs, &msg)) !=
+            ISPHENC1_EOK) {
+        return (retVal);
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_call((VISA_Handle)h, (VISA_Msg *)&msg);
+
+    return (unmarshallMsg(h, inBuf, outBuf, inArgs, outArgs, msg, retVal));
+}
+
+/*
+ *  ======== unmarshallBatch ========
+ *  Copy the results of numFrames batched process calls out of msg, which
+ *  the skeleton returned with status retVal, and release msg.
+ */
+static XDAS_Int32 unmarshallBatch(VISA_Handle visa,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    ISPHENC1_OutArgs *outArgs[], Int numFrames, _SPHENC1_Msg *msg,
+    XDAS_Int32 retVal, XDAS_Int32 retVals[])
+{
+    XDAS_Int32 status = ISPHENC1_EOK;
+    _SPHENC1_BatchFrame *frame;
+    ISPHENC1_InArgs *pMsgInArgs;
+    Memory_CacheRange ranges[MAXBATCHRANGES];
+    Int numRanges = 0;
+    Int n;
+
+    frame = &(msg->cmd.batch.frame);
+    for (n = 0; n < numFrames; n++) {
+        pMsgInArgs = (ISPHENC1_InArgs *)(frame + 1);
+
+        /* outArgs has no pointers so simply copy it back */
+        memcpy(outArgs[n], (UInt8 *)pMsgInArgs + pMsgInArgs->size,
+            outArgs[n]->size);
+
+        /* if the alg wrote the output buffer, it has stale lines */
+        inBufs[n].accessMask = frame->inBuf.accessMask;
+        outBufs[n].accessMask = frame->outBuf.accessMask;
+        if (outBufs[n].buf != NULL && VISA_WROTEBUF(frame->outBuf)) {
+            ranges[numRanges].addr = outBufs[n].buf;
+            ranges[numRanges++].sizeInBytes = outBufs[n].bufSize;
+        }
+
+        /* a failed call leaves the frames' status unset */
+        retVals[n] = retVal == VISA_EOK ? frame->status : retVal;
+        if (retVals[n] != ISPHENC1_EOK) {
+            status = ISPHENC1_EFAIL;
+        }
+
+        frame = (_SPHENC1_BatchFrame *)((UInt8 *)frame + frame->size);
+    }
+
+    /* drop the stale lines of all of the frames' output at once */
+    Memory_cacheInvRanges(ranges, numRanges);
+
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (status);
+}
+
+/*
+ *  ======== unmarshallMsg ========
+ *  Copy the results of a process call out of msg, which the skeleton
+ *  returned with status retVal, and release msg.
+ */
+static XDAS_Int32 unmarshallMsg(ISPHENC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHENC1_InArgs *inArgs,
+    ISPHENC1_OutArgs *outArgs, _SPHENC1_Msg *msg, XDAS_Int32 retVal)
+{
+    VISA_Handle visa = (VISA_Handle)h;
+    ISPHENC1_OutArgs *pMsgOutArgs;
+
+    /* outArgs follows the variable-sized inArgs */
+    pMsgOutArgs = (ISPHENC1_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /* outArgs has no pointers so simply copy it back */
+    memcpy(outArgs, pMsgOutArgs, outArgs->size);
+
+    /* if the alg wrote the output buffer, drop any stale lines */
+    inBuf->accessMask = msg->cmd.process.inBuf.accessMask;
+    outBuf->accessMask = msg->cmd.process.outBuf.accessMask;
+    if (outBuf->buf != NULL && VISA_WROTEBUF(msg->cmd.process.outBuf)) {
+        Memory_cacheInv(outBuf->buf, outBuf->bufSize);
+    }
+
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
@@ -0,0 +1,117 @@
+/*
+ *  ======== videnc1.c ========
+ *  The xDM IVIDENC1 Video Encoder API.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/xdais/dm/ividenc1.h>
+
+#include <ti/sdo/ce/video1/videnc1.h>
+#include <ti/sdo/ce/video1/_videnc1.h>
+
+/*
+ *  ======== VIDENC1_control ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* video encoders (both high and low complexity
+ *  encoders are envoked using this method).
+ */
+XDAS_Int32 VIDENC1_control(VIDENC1_Handle handle, VIDENC1_Cmd id,
+    VIDENC1_DynamicParams *dynParams, VIDENC1_Status *status)
+{
+    XDAS_Int32 retVal = VIDENC1_EFAIL;
+    IVIDENC1_Fxns *fxns;
+    IVIDENC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IVIDENC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->control(alg, id, dynParams, status);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== VIDENC1_create ========
+ */
+VIDENC1_Handle VIDENC1_create(Engine_Handle engine, String name,
+    VIDENC1_Params *params)
+{
+    return ((VIDENC1_Handle)VISA_create(engine, name, (IALG_Params *)params,
+        sizeof (_VIDENC1_Msg), "ti.sdo.ce.video1.IVIDENC1"));
+}
+
+/*
+ *  ======== VIDENC1_delete ========
+ */
+Void VIDENC1_delete(VIDENC1_Handle handle)
+{
+    VISA_delete((VISA_Handle)handle);
+}
+
+/*
+ *  ======== VIDENC1_process ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* video encoders (both high and low complexity
+ *  encoders are envoked using this method).
+ */
+XDAS_Int32 VIDENC1_process(VIDENC1_Handle handle, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, VIDENC1_InArgs *inArgs, VIDENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal = VIDENC1_EFAIL;
+    IVIDENC1_Fxns *fxns;
+    IVIDENC1_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IVIDENC1_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->process(alg, inBufs, outBufs, inArgs, outArgs);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== VIDENC1_release ========
+ *  Reset the codec, so that it is ready for its next user, and park it
+ *  for reuse.  A codec that can't be reset is simply deleted.
+ */
+Void VIDENC1_release(VIDENC1_Handle handle)
+{
+    VIDENC1_DynamicParams dynParams;
+    VIDENC1_Status status;
+
+    if (handle == NULL) {
+        return;
+    }
+
+    memset(&dynParams, 0, sizeof (dynParams));
+    dynParams.size = sizeof (dynParams);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+
+    if (VIDENC1_control(handle, XDM_RESET, &dynParams, &status) ==
+            VIDENC1_EOK) {
+        VISA_release((VISA_Handle)handle);
+    }
+    else {
+        VISA_delete((VISA_Handle)handle);
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ *  ======== videnc1_skel.c ========
+ *  This file contains the implemenation of the SKEL interface for the
+ *  video encoder class of algorithms.
+ *
+ *  These functions are the "server-side" of the the stubs defined in
+ *  videnc1_stubs.c
+ */
+#include <xdc/std.h>
+
+#include <ti/sdo/ce/skel.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include <ti/sdo/ce/video1/videnc1.h>
+#include <ti/sdo/ce/video1/_videnc1.h>
+
+static Bool argsFit(VISA_Msg msg, XDAS_Int32 *size);
+
+/*
+ *  ======== call ========
+ */
+static VISA_Status call(VISA_Handle visaHandle, VISA_Msg visaMsg)
+{
+    _VIDENC1_Msg *msg = (_VIDENC1_Msg *)visaMsg;
+    VIDENC1_Handle handle = (VIDENC1_Handle)visaHandle;
+    Int i;
+    IVIDEO1_BufDescIn *pInBufs;
+    XDM_BufDesc outBufs;
+    IVIDENC1_OutArgs *pOutArgs;
+    IVIDENC1_Status *pStatus;
+
+    /*
+     * Do any needed translations on the buffer pointers, then
+     * call the appropriate API function, based on the command.
+     */
+    switch (msg->visa.cmd) {
+
+        case _VIDENC1_CPROCESS: {
+            if (!argsFit(visaMsg, &(msg->cmd.process.inArgs.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* unmarshall inBufs, translating in place */
+            pInBufs = &(msg->cmd.process.inBufs);
+            for (i = 0; i < pInBufs->numBufs; i++) {
+                if (pInBufs->bufDesc[i].buf != NULL) {
+                    pInBufs->bufDesc[i].buf = (XDAS_Int8 *)
+                        Memory_getBufferVirtualAddress(
+                            (UInt32)pInBufs->bufDesc[i].buf,
+                            pInBufs->bufDesc[i].bufSize);
+
+                    Memory_cacheInv(pInBufs->bufDesc[i].buf,
+                        pInBufs->bufDesc[i].bufSize);
+                }
+            }
+
+            /* unflatten outBufs, translating in place */
+            outBufs.numBufs = msg->cmd.process.numOutBufs;
+            outBufs.bufSizes = msg->cmd.process.outBufSizes;
+            outBufs.bufs = msg->cmd.process.outBufs;
+
+            for (i = 0; i < outBufs.numBufs; i++) {
+                if (outBufs.bufs[i] != NULL) {
+                    outBufs.bufs[i] = (XDAS_Int8 *)
+                        Memory_getBufferVirtualAddress((UInt32)outBufs.bufs[i],
+                            outBufs.bufSizes[i]);
+
+                    Memory_cacheInv(outBufs.bufs[i], outBufs.bufSizes[i]);
+                }
+            }
+
+            /* outArgs follows the variable-sized inArgs */
+            pOutArgs = (IVIDENC1_OutArgs *)((UInt8 *)
+                &(msg->cmd.process.inArgs) + msg->cmd.process.inArgs.size);
+
+            /* make the process call */
+            msg->visa.status = VIDENC1_process(handle, pInBufs, &outBufs,
+                &(msg->cmd.process.inArgs), pOutArgs);
+
+            /* write back the output buffers the alg filled */
+            for (i = 0; i < outBufs.numBufs; i++) {
+                if (outBufs.bufs[i] != NULL) {
+                    Memory_cacheWb(outBufs.bufs[i], outBufs.bufSizes[i]);
+                }
+            }
+
+            /* marshall the buffers referenced by outArgs */
+            if (pOutArgs->encodedBuf.buf != NULL) {
+                pOutArgs->encodedBuf.buf = (XDAS_Int8 *)
+                    Memory_getBufferPhysicalAddress(pOutArgs->encodedBuf.buf,
+                        pOutArgs->encodedBuf.bufSize, NULL);
+            }
+            for (i = 0; i < pOutArgs->reconBufs.numBufs &&
+                i < IVIDEO_MAX_YUV_BUFFERS; i++) {
+                if (pOutArgs->reconBufs.bufDesc[i].buf != NULL) {
+                    pOutArgs->reconBufs.bufDesc[i].buf = (XDAS_Int8 *)
+                        Memory_getBufferPhysicalAddress(
+                            pOutArgs->reconBufs.bufDesc[i].buf,
+                            pOutArgs->reconBufs.bufDesc[i].bufSize, NULL);
+                }
+            }
+
+            break;
+        }
+
+        case _VIDENC1_CCONTROL: {
+            if (!argsFit(visaMsg, &(msg->cmd.control.params.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* status follows the variable-sized params */
+            pStatus = (IVIDENC1_Status *)((UInt8 *)
+                &(msg->cmd.control.params) + msg->cmd.control.params.size);
+
+            if (pStatus->data.buf != NULL) {
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferVirtualAddress((UInt32)pStatus->data.buf,
+                        pStatus->data.bufSize);
+
+                Memory_cacheInv(pStatus->data.buf, pStatus->data.bufSize);
+            }
+
+            /* make the control call */
+            msg->visa.status = VIDENC1_control(handle, msg->cmd.control.id,
+                &(msg->cmd.control.params), pStatus);
+
+            if (pStatus->data.buf != NULL) {
+                Memory_cacheWb(pStatus->data.buf, pStatus->data.bufSize);
+
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferPhysicalAddress(pStatus->data.buf,
+                        pStatus->data.bufSize, NULL);
+            }
+
+            break;
+        }
+
+        default: {
+            msg->visa.status = VISA_EFAIL;
+
+            break;
+        }
+    }
+
+    return (VISA_EOK);
+}
+
+/*
+ *  ======== argsFit ========
+ *  Whether msg holds the variable-sized args that start with the size
+ *  field at size, and the args that follow them, as big as their size
+ *  fields say.  The stubs size each message to its args, so a bad size
+ *  would have the call read or write past the message's end.
+ */
+static Bool argsFit(VISA_Msg msg, XDAS_Int32 *size)
+{
+    IArg room = (UInt8 *)msg + Comm_getMsgSize((Comm_Msg)msg) -
+        (UInt8 *)size;
+    IArg inSize;
+    IArg outSize;
+
+    if (room < (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    inSize = *size;
+    if (inSize < (IArg)sizeof (*size) ||
+        inSize > room - (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    outSize = *(XDAS_Int32 *)((UInt8 *)size + inSize);
+
+    return (outSize >= (IArg)sizeof (*size) && outSize <= room - inSize);
+}
+
+/*
+ *  ======== VIDENC1_SKEL ========
+ */
+SKEL_Fxns VIDENC1_SKEL = {
+    call,
+    (SKEL_CREATEFXN)&VIDENC1_create,
+    (SKEL_DESTROYFXN)&VIDENC1_delete,
+};
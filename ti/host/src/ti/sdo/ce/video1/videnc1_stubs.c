@@ -0,0 +1,393 @@
+/*
+ *  ======== videnc1_stubs.c ========
+ *  This file contains an implemenation of the IVIDENC1 interface for the
+ *  video encoder class of algorithms.
+ *
+ *  These functions are the "client-side" of a "remote" implementation.
+ */
+#include <xdc/std.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/xdais/dm/ividenc1.h>
+
+#include <ti/sdo/ce/video1/videnc1.h>
+#include <ti/sdo/ce/video1/_videnc1.h>
+
+/*
+ *  Size of a message carrying the given inArgs and outArgs, or params and
+ *  status, which follow each other at the end of the message.
+ */
+#define PROCESSMSGSIZE(in, out) \
+    (offsetof(_VIDENC1_Msg, cmd.process.inArgs) + (in)->size + (out)->size)
+#define CONTROLMSGSIZE(in, out) \
+    (offsetof(_VIDENC1_Msg, cmd.control.params) + (in)->size + (out)->size)
+
+static XDAS_Int32 control(IVIDENC1_Handle h, IVIDENC1_Cmd id,
+    IVIDENC1_DynamicParams *params, IVIDENC1_Status *status);
+static XDAS_Int32 marshallMsg(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, IVIDENC1_InArgs *inArgs, IVIDENC1_OutArgs *outArgs,
+    _VIDENC1_Msg **pmsg);
+static XDAS_Int32 process(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, IVIDENC1_InArgs *inArgs,
+    IVIDENC1_OutArgs *outArgs);
+static XDAS_Int32 unmarshallMsg(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, IVIDENC1_InArgs *inArgs, IVIDENC1_OutArgs *outArgs,
+    _VIDENC1_Msg *msg, XDAS_Int32 retVal);
+static Bool wroteBuf(IVIDENC1_OutArgs *outArgs, XDAS_Int8 *buf,
+    XDAS_Int32 size);
+
+IVIDENC1_Fxns VIDENC1_STUBS = {
+    {&VIDENC1_STUBS, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+    process, control,
+};
+
+/*
+ *  ======== VIDENC1_processAsync ========
+ *  Local instances have nothing to send; their process call runs in
+ *  VIDENC1_processWait(), in the caller's thread.
+ */
+XDAS_Int32 VIDENC1_processAsync(VIDENC1_Handle handle,
+    IVIDEO1_BufDescIn *inBufs, XDM_BufDesc *outBufs, VIDENC1_InArgs *inArgs,
+    VIDENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _VIDENC1_Msg *msg;
+
+    if (visa == NULL) {
+        return (VIDENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&VIDENC1_STUBS) {
+        return (VIDENC1_EOK);
+    }
+
+    if ((retVal = marshallMsg((IVIDENC1_Handle)visa, inBufs, outBufs, inArgs,
+        outArgs, &msg)) != IVIDENC1_EOK) {
+        return (retVal);
+    }
+
+    if (VISA_callAsync(visa, (VISA_Msg *)&msg) != VISA_EOK) {
+        VISA_freeMsg(visa, (VISA_Msg)msg);
+        return (VIDENC1_EFAIL);
+    }
+
+    return (VIDENC1_EOK);
+}
+
+/*
+ *  ======== VIDENC1_processWait ========
+ */
+XDAS_Int32 VIDENC1_processWait(VIDENC1_Handle handle,
+    IVIDEO1_BufDescIn *inBufs, XDM_BufDesc *outBufs, VIDENC1_InArgs *inArgs,
+    VIDENC1_OutArgs *outArgs, UInt timeout)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _VIDENC1_Msg *msg;
+
+    if (visa == NULL) {
+        return (VIDENC1_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&VIDENC1_STUBS) {
+        return (VIDENC1_process(handle, inBufs, outBufs, inArgs, outArgs));
+    }
+
+    if ((retVal = VISA_wait(visa, (VISA_Msg *)&msg, timeout)) ==
+            VISA_ETIMEOUT) {
+        /* still in flight; the caller must wait again */
+        return (VIDENC1_ETIMEOUT);
+    }
+
+    /* without a reply, there are no outArgs to copy out */
+    if (msg == NULL) {
+        return (VIDENC1_EFAIL);
+    }
+
+    return (unmarshallMsg((IVIDENC1_Handle)visa, inBufs, outBufs, inArgs,
+        outArgs, msg, retVal));
+}
+
+/*
+ *  ======== control ========
+ *  This is the stub-implementation for the control method
+ */
+static XDAS_Int32 control(IVIDENC1_Handle h, IVIDENC1_Cmd id,
+    IVIDENC1_DynamicParams *params, IVIDENC1_Status *status)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _VIDENC1_Msg *msg;
+    IVIDENC1_Status *pMsgStatus;
+    XDAS_Int8 *virtAddr = NULL;
+
+    /* get a message big enough for params and status */
+    if ((msg = (_VIDENC1_Msg *)VISA_allocMsg2(visa,
+        CONTROLMSGSIZE(params, status))) == NULL) {
+        return (IVIDENC1_EFAIL);
+    }
+
+    /* marshall the command */
+    msg->visa.cmd = _VIDENC1_CCONTROL;
+
+    msg->cmd.control.id = id;
+
+    /* params has no pointers so simply copy the struct fields into the msg */
+    memcpy(&(msg->cmd.control.params), params, params->size);
+
+    /* unlike params, status is placed after the variable-sized params */
+    pMsgStatus = (IVIDENC1_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* set status's size field and buffer, translating the latter */
+    pMsgStatus->size = status->size;
+    pMsgStatus->data = status->data;
+    if (status->data.buf != NULL) {
+        virtAddr = status->data.buf;
+        Memory_cacheWbInv(virtAddr, status->data.bufSize);
+        pMsgStatus->data.buf = (XDAS_Int8 *)Memory_getBufferPhysicalAddress(
+            virtAddr, status->data.bufSize, NULL);
+        if (pMsgStatus->data.buf == NULL) {
+            retVal = IVIDENC1_EFAIL;
+            goto exit;
+        }
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_callUrgent(visa, (VISA_Msg *)&msg);
+
+    /* re-locate status, msg may have been changed by VISA_callUrgent() */
+    pMsgStatus = (IVIDENC1_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* copy out status, restoring the caller's buffer address */
+    memcpy(status, pMsgStatus, pMsgStatus->size);
+    if (virtAddr != NULL) {
+        status->data.buf = virtAddr;
+        Memory_cacheInv(virtAddr, status->data.bufSize);
+    }
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== marshallMsg ========
+ *  Marshall a process call into the instance's message.  On success,
+ *  *pmsg is the message, ready to be sent to the skeleton.
+ */
+static XDAS_Int32 marshallMsg(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, IVIDENC1_InArgs *inArgs, IVIDENC1_OutArgs *outArgs,
+    _VIDENC1_Msg **pmsg)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _VIDENC1_Msg *msg;
+    IVIDENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[2 * XDM_MAX_IO_BUFFERS];
+    Int numRanges = 0;
+    Int i;
+
+    if (inBufs->numBufs > XDM_MAX_IO_BUFFERS ||
+        outBufs->numBufs > XDM_MAX_IO_BUFFERS) {
+        return (IVIDENC1_EFAIL);
+    }
+
+    /* get a message big enough for inArgs and outArgs */
+    if ((msg = (_VIDENC1_Msg *)VISA_allocMsg2(visa,
+        PROCESSMSGSIZE(inArgs, outArgs))) == NULL) {
+        return (IVIDENC1_EFAIL);
+    }
+
+    /*
+     * Marshall the command: copy the client-passed arguments into flattened
+     * message data structures, converting every pointer address to alg.
+     * data buffer into physical address.
+     */
+
+    /* First specify the processing command that the skeleton should do */
+    msg->visa.cmd = _VIDENC1_CPROCESS;
+
+    /* inBufs is flat; copy it and translate its buffers */
+    msg->cmd.process.inBufs = *inBufs;
+    for (i = 0; i < inBufs->numBufs; i++) {
+        if (inBufs->bufDesc[i].buf != NULL) {
+            ranges[numRanges].addr = inBufs->bufDesc[i].buf;
+            ranges[numRanges++].sizeInBytes = inBufs->bufDesc[i].bufSize;
+
+            msg->cmd.process.inBufs.bufDesc[i].accessMask = 0;
+            msg->cmd.process.inBufs.bufDesc[i].buf = (XDAS_Int8 *)
+                Memory_getBufferPhysicalAddress(inBufs->bufDesc[i].buf,
+                    inBufs->bufDesc[i].bufSize, NULL);
+            if (msg->cmd.process.inBufs.bufDesc[i].buf == NULL) {
+                retVal = IVIDENC1_EFAIL;
+                goto exit;
+            }
+        }
+    }
+
+    /* flatten outBufs */
+    msg->cmd.process.numOutBufs = outBufs->numBufs;
+    for (i = 0; i < outBufs->numBufs; i++) {
+        msg->cmd.process.outBufSizes[i] = outBufs->bufSizes[i];
+        msg->cmd.process.outBufs[i] = NULL;
+
+        if (outBufs->bufs[i] != NULL) {
+            ranges[numRanges].addr = outBufs->bufs[i];
+            ranges[numRanges++].sizeInBytes = outBufs->bufSizes[i];
+
+            msg->cmd.process.outBufs[i] = (XDAS_Int8 *)
+                Memory_getBufferPhysicalAddress(outBufs->bufs[i],
+                    outBufs->bufSizes[i], NULL);
+            if (msg->cmd.process.outBufs[i] == NULL) {
+                retVal = IVIDENC1_EFAIL;
+                goto exit;
+            }
+        }
+    }
+
+    /* inArgs has no pointers so simply copy the struct fields into the msg */
+    memcpy(&(msg->cmd.process.inArgs), inArgs, inArgs->size);
+
+    /* point at outArgs and set the "size" */
+    pMsgOutArgs = (IVIDENC1_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /*
+     * Clear outArgs so the encoded and recon descriptors' accessMasks only
+     * say what this call's codec reported, then set the size field - the
+     * rest is filled in by the codec.
+     */
+    memset(pMsgOutArgs, 0, outArgs->size);
+    pMsgOutArgs->size = outArgs->size;
+
+    /* write back all the buffers at once */
+    Memory_cacheWbInvRanges(ranges, numRanges);
+
+    *pmsg = msg;
+
+    return (IVIDENC1_EOK);
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== process ========
+ *  This is the stub-implementation for the process method
+ */
+static XDAS_Int32 process(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, IVIDENC1_InArgs *inArgs, IVIDENC1_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    _VIDENC1_Msg *msg;
+
+    if ((retVal = marshallMsg(h, inBufs, outBufs, inArgs, outArgs, &msg)) !=
+            IVIDENC1_EOK) {
+        return (retVal);
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_call((VISA_Handle)h, (VISA_Msg *)&msg);
+
+    return (unmarshallMsg(h, inBufs, outBufs, inArgs, outArgs, msg, retVal));
+}
+
+/*
+ *  ======== unmarshallMsg ========
+ *  Copy the results of a process call out of msg, which the skeleton
+ *  returned with status retVal, and release msg.
+ */
+static XDAS_Int32 unmarshallMsg(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
+    XDM_BufDesc *outBufs, IVIDENC1_InArgs *inArgs, IVIDENC1_OutArgs *outArgs,
+    _VIDENC1_Msg *msg, XDAS_Int32 retVal)
+{
+    VISA_Handle visa = (VISA_Handle)h;
+    IVIDENC1_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[XDM_MAX_IO_BUFFERS];
+    Int numRanges = 0;
+    Int i;
+
+    /* outArgs follows the variable-sized inArgs */
+    pMsgOutArgs = (IVIDENC1_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /* copy out the outArgs and translate the buffers they reference */
+    memcpy(outArgs, pMsgOutArgs, outArgs->size);
+
+    if (outArgs->encodedBuf.buf != NULL) {
+        outArgs->encodedBuf.buf = (XDAS_Int8 *)Memory_getBufferVirtualAddress(
+            (UInt32)outArgs->encodedBuf.buf, outArgs->encodedBuf.bufSize);
+    }
+    for (i = 0; i < outArgs->reconBufs.numBufs &&
+        i < IVIDEO_MAX_YUV_BUFFERS; i++) {
+        if (outArgs->reconBufs.bufDesc[i].buf != NULL) {
+            outArgs->reconBufs.bufDesc[i].buf = (XDAS_Int8 *)
+                Memory_getBufferVirtualAddress(
+                    (UInt32)outArgs->reconBufs.bufDesc[i].buf,
+                    outArgs->reconBufs.bufDesc[i].bufSize);
+        }
+    }
+
+    /* return the codec's inBufs accessMasks */
+    for (i = 0; i < inBufs->numBufs; i++) {
+        if (inBufs->bufDesc[i].buf != NULL) {
+            inBufs->bufDesc[i].accessMask =
+                msg->cmd.process.inBufs.bufDesc[i].accessMask;
+        }
+    }
+
+    /*
+     * The skeleton wrote the output buffers back; drop any stale lines,
+     * except in buffers whose descriptors the codec says it only read.
+     */
+    for (i = 0; i < outBufs->numBufs; i++) {
+        if (outBufs->bufs[i] != NULL &&
+            wroteBuf(outArgs, outBufs->bufs[i], outBufs->bufSizes[i])) {
+            ranges[numRanges].addr = outBufs->bufs[i];
+            ranges[numRanges++].sizeInBytes = outBufs->bufSizes[i];
+        }
+    }
+    Memory_cacheInvRanges(ranges, numRanges);
+
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== wroteBuf ========
+ *  Return TRUE unless the encoded or recon buffers in outArgs describe
+ *  [buf, buf + size) and the codec wrote none of them.  A buffer nothing
+ *  describes may still hold output, so it counts as written.
+ */
+static Bool wroteBuf(IVIDENC1_OutArgs *outArgs, XDAS_Int8 *buf,
+    XDAS_Int32 size)
+{
+    XDM1_SingleBufDesc *desc;
+    Bool described = FALSE;
+    Int i;
+
+    for (i = -1; i < outArgs->reconBufs.numBufs &&
+        i < IVIDEO_MAX_YUV_BUFFERS; i++) {
+        desc = i < 0 ? &outArgs->encodedBuf : &outArgs->reconBufs.bufDesc[i];
+        if (desc->buf != NULL && desc->buf >= buf && desc->buf < buf + size) {
+            if (VISA_WROTEBUF(*desc)) {
+                return (TRUE);
+            }
+            described = TRUE;
+        }
+    }
+
+    return (!described);
+}
@@ -0,0 +1,117 @@
+/*
+ *  ======== viddec2.c ========
+ *  The xDM IVIDDEC2 Video Decoder API.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/xdais/dm/ividdec2.h>
+
+#include <ti/sdo/ce/video2/viddec2.h>
+#include <ti/sdo/ce/video2/_viddec2.h>
+
+/*
+ *  ======== VIDDEC2_control ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* video decoders (both high and low complexity
+ *  decoders are envoked using this method).
+ */
+XDAS_Int32 VIDDEC2_control(VIDDEC2_Handle handle, VIDDEC2_Cmd id,
+    VIDDEC2_DynamicParams *dynParams, VIDDEC2_Status *status)
+{
+    XDAS_Int32 retVal = VIDDEC2_EFAIL;
+    IVIDDEC2_Fxns *fxns;
+    IVIDDEC2_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IVIDDEC2_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->control(alg, id, dynParams, status);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== VIDDEC2_create ========
+ */
+VIDDEC2_Handle VIDDEC2_create(Engine_Handle engine, String name,
+    VIDDEC2_Params *params)
+{
+    return ((VIDDEC2_Handle)VISA_create(engine, name, (IALG_Params *)params,
+        sizeof (_VIDDEC2_Msg), "ti.sdo.ce.video2.IVIDDEC2"));
+}
+
+/*
+ *  ======== VIDDEC2_delete ========
+ */
+Void VIDDEC2_delete(VIDDEC2_Handle handle)
+{
+    VISA_delete((VISA_Handle)handle);
+}
+
+/*
+ *  ======== VIDDEC2_process ========
+ *  This method must be the same for both local and remote invocation;
+ *  each call site in the client might be calling different implementations
+ *  (one that marshalls & sends and one that simply calls).  This API
+ *  abstracts *all* video decoders (both high and low complexity
+ *  decoders are envoked using this method).
+ */
+XDAS_Int32 VIDDEC2_process(VIDDEC2_Handle handle, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, VIDDEC2_InArgs *inArgs, VIDDEC2_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal = VIDDEC2_EFAIL;
+    IVIDDEC2_Fxns *fxns;
+    IVIDDEC2_Handle alg;
+
+    if (handle != NULL) {
+        fxns = (IVIDDEC2_Fxns *)VISA_getAlgFxns((VISA_Handle)handle);
+        alg = VISA_getAlgHandle((VISA_Handle)handle);
+
+        if (fxns != NULL && alg != NULL) {
+            VISA_enter((VISA_Handle)handle);
+            retVal = fxns->process(alg, inBufs, outBufs, inArgs, outArgs);
+            VISA_exit((VISA_Handle)handle);
+        }
+    }
+
+    return (retVal);
+}
+
+/*
+ *  ======== VIDDEC2_release ========
+ *  Reset the codec, so that it is ready for its next user, and park it
+ *  for reuse.  A codec that can't be reset is simply deleted.
+ */
+Void VIDDEC2_release(VIDDEC2_Handle handle)
+{
+    VIDDEC2_DynamicParams dynParams;
+    VIDDEC2_Status status;
+
+    if (handle == NULL) {
+        return;
+    }
+
+    memset(&dynParams, 0, sizeof (dynParams));
+    dynParams.size = sizeof (dynParams);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+
+    if (VIDDEC2_control(handle, XDM_RESET, &dynParams, &status) ==
+            VIDDEC2_EOK) {
+        VISA_release((VISA_Handle)handle);
+    }
+    else {
+        VISA_delete((VISA_Handle)handle);
+    }
+}
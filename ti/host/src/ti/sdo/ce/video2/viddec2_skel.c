@@ -0,0 +1,205 @@
+/*
+ *  ======== viddec2_skel.c ========
+ *  This file contains the implemenation of the SKEL interface for the
+ *  video decoder class of algorithms.
+ *
+ *  These functions are the "server-side" of the the stubs defined in
+ *  viddec2_stubs.c
+ */
+#include <xdc/std.h>
+
+#include <ti/sdo/ce/skel.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include <ti/sdo/ce/video2/viddec2.h>
+#include <ti/sdo/ce/video2/_viddec2.h>
+
+static Bool argsFit(VISA_Msg msg, XDAS_Int32 *size);
+static Void marshallBufDesc(IVIDEO1_BufDesc *bufDesc);
+
+/*
+ *  ======== call ========
+ */
+static VISA_Status call(VISA_Handle visaHandle, VISA_Msg visaMsg)
+{
+    _VIDDEC2_Msg *msg = (_VIDDEC2_Msg *)visaMsg;
+    VIDDEC2_Handle handle = (VIDDEC2_Handle)visaHandle;
+    Int i;
+    Int numBufs;
+    XDM_BufDesc outBufs;
+    IVIDDEC2_OutArgs *pOutArgs;
+    IVIDDEC2_Status *pStatus;
+
+    /*
+     * Do any needed translations on the buffer pointers, then
+     * call the appropriate API function, based on the command.
+     */
+    switch (msg->visa.cmd) {
+
+        case _VIDDEC2_CPROCESS: {
+            if (!argsFit(visaMsg, &(msg->cmd.process.inArgs.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* unmarshall inBufs; it's a sparse array */
+            for (i = 0, numBufs = 0;
+                numBufs < msg->cmd.process.inBufs.numBufs &&
+                i < XDM_MAX_IO_BUFFERS; i++) {
+
+                if (msg->cmd.process.inBufs.descs[i].buf != NULL) {
+                    msg->cmd.process.inBufs.descs[i].buf = (XDAS_Int8 *)
+                        Memory_getBufferVirtualAddress(
+                            (UInt32)msg->cmd.process.inBufs.descs[i].buf,
+                            msg->cmd.process.inBufs.descs[i].bufSize);
+
+                    Memory_cacheInv(msg->cmd.process.inBufs.descs[i].buf,
+                        msg->cmd.process.inBufs.descs[i].bufSize);
+                    numBufs++;
+                }
+            }
+
+            /* unflatten outBufs, translating in place */
+            outBufs.numBufs = msg->cmd.process.numOutBufs;
+            outBufs.bufSizes = msg->cmd.process.outBufSizes;
+            outBufs.bufs = msg->cmd.process.outBufs;
+
+            for (i = 0; i < outBufs.numBufs; i++) {
+                if (outBufs.bufs[i] != NULL) {
+                    outBufs.bufs[i] = (XDAS_Int8 *)
+                        Memory_getBufferVirtualAddress((UInt32)outBufs.bufs[i],
+                            outBufs.bufSizes[i]);
+
+                    Memory_cacheInv(outBufs.bufs[i], outBufs.bufSizes[i]);
+                }
+            }
+
+            /* outArgs follows the variable-sized inArgs */
+            pOutArgs = (IVIDDEC2_OutArgs *)((UInt8 *)
+                &(msg->cmd.process.inArgs) + msg->cmd.process.inArgs.size);
+
+            /* make the process call */
+            msg->visa.status = VIDDEC2_process(handle,
+                &(msg->cmd.process.inBufs), &outBufs,
+                &(msg->cmd.process.inArgs), pOutArgs);
+
+            /* write back the output buffers the alg filled */
+            for (i = 0; i < outBufs.numBufs; i++) {
+                if (outBufs.bufs[i] != NULL) {
+                    Memory_cacheWb(outBufs.bufs[i], outBufs.bufSizes[i]);
+                }
+            }
+
+            /* marshall the buffers referenced by outArgs */
+            marshallBufDesc(&pOutArgs->decodedBufs);
+            for (i = 0; i < IVIDDEC2_MAX_IO_BUFFERS &&
+                pOutArgs->outputID[i] != 0; i++) {
+                marshallBufDesc(&pOutArgs->displayBufs[i]);
+            }
+            if (pOutArgs->mbDataBuf.buf != NULL) {
+                pOutArgs->mbDataBuf.buf = (XDAS_Int8 *)
+                    Memory_getBufferPhysicalAddress(pOutArgs->mbDataBuf.buf,
+                        pOutArgs->mbDataBuf.bufSize, NULL);
+            }
+
+            break;
+        }
+
+        case _VIDDEC2_CCONTROL: {
+            if (!argsFit(visaMsg, &(msg->cmd.control.params.size))) {
+                msg->visa.status = VISA_EFAIL;
+                return (VISA_EFAIL);
+            }
+
+            /* status follows the variable-sized params */
+            pStatus = (IVIDDEC2_Status *)((UInt8 *)
+                &(msg->cmd.control.params) + msg->cmd.control.params.size);
+
+            if (pStatus->data.buf != NULL) {
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferVirtualAddress((UInt32)pStatus->data.buf,
+                        pStatus->data.bufSize);
+
+                Memory_cacheInv(pStatus->data.buf, pStatus->data.bufSize);
+            }
+
+            /* make the control call */
+            msg->visa.status = VIDDEC2_control(handle, msg->cmd.control.id,
+                &(msg->cmd.control.params), pStatus);
+
+            if (pStatus->data.buf != NULL) {
+                Memory_cacheWb(pStatus->data.buf, pStatus->data.bufSize);
+
+                pStatus->data.buf = (XDAS_Int8 *)
+                    Memory_getBufferPhysicalAddress(pStatus->data.buf,
+                        pStatus->data.bufSize, NULL);
+            }
+
+            break;
+        }
+
+        default: {
+            msg->visa.status = VISA_EFAIL;
+
+            break;
+        }
+    }
+
+    return (VISA_EOK);
+}
+
+/*
+ *  ======== argsFit ========
+ *  Whether msg holds the variable-sized args that start with the size
+ *  field at size, and the args that follow them, as big as their size
+ *  fields say.  The stubs size each message to its args, so a bad size
+ *  would have the call read or write past the message's end.
+ */
+static Bool argsFit(VISA_Msg msg, XDAS_Int32 *size)
+{
+    IArg room = (UInt8 *)msg + Comm_getMsgSize((Comm_Msg)msg) -
+        (UInt8 *)size;
+    IArg inSize;
+    IArg outSize;
+
+    if (room < (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    inSize = *size;
+    if (inSize < (IArg)sizeof (*size) ||
+        inSize > room - (IArg)sizeof (*size)) {
+        return (FALSE);
+    }
+
+    outSize = *(XDAS_Int32 *)((UInt8 *)size + inSize);
+
+    return (outSize >= (IArg)sizeof (*size) && outSize <= room - inSize);
+}
+
+/*
+ *  ======== marshallBufDesc ========
+ *  Translate the (virtual) buffer addresses in bufDesc to physical ones.
+ */
+static Void marshallBufDesc(IVIDEO1_BufDesc *bufDesc)
+{
+    Int i;
+
+    for (i = 0; i < bufDesc->numBufs && i < IVIDEO_MAX_YUV_BUFFERS; i++) {
+        if (bufDesc->bufDesc[i].buf != NULL) {
+            bufDesc->bufDesc[i].buf = (XDAS_Int8 *)
+                Memory_getBufferPhysicalAddress(bufDesc->bufDesc[i].buf,
+                    bufDesc->bufDesc[i].bufSize, NULL);
+        }
+    }
+}
+
+/*
+ *  ======== VIDDEC2_SKEL ========
+ */
+SKEL_Fxns VIDDEC2_SKEL = {
+    call,
+    (SKEL_CREATEFXN)&VIDDEC2_create,
+    (SKEL_DESTROYFXN)&VIDDEC2_delete,
+};
@@ -0,0 +1,435 @@
+/*
+ *  ======== viddec2_stubs.c ========
+ *  This file contains an implemenation of the IVIDDEC2 interface for the
+ *  video decoder class of algorithms.
+ *
+ *  These functions are the "client-side" of a "remote" implementation.
+ */
+#include <xdc/std.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include <ti/sdo/ce/visa.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/xdais/dm/ividdec2.h>
+
+#include <ti/sdo/ce/video2/viddec2.h>
+#include <ti/sdo/ce/video2/_viddec2.h>
+
+/*
+ *  Size of a message carrying the given inArgs and outArgs, or params and
+ *  status, which follow each other at the end of the message.
+ */
+#define PROCESSMSGSIZE(in, out) \
+    (offsetof(_VIDDEC2_Msg, cmd.process.inArgs) + (in)->size + (out)->size)
+#define CONTROLMSGSIZE(in, out) \
+    (offsetof(_VIDDEC2_Msg, cmd.control.params) + (in)->size + (out)->size)
+
+static Void accessBufDesc(IVIDEO1_BufDesc *bufDesc, XDAS_Int8 *buf,
+    XDAS_Int32 size, Bool *described, Bool *wrote);
+static XDAS_Int32 control(IVIDDEC2_Handle h, IVIDDEC2_Cmd id,
+    IVIDDEC2_DynamicParams *params, IVIDDEC2_Status *status);
+static XDAS_Int32 marshallMsg(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs, IVIDDEC2_OutArgs *outArgs,
+    _VIDDEC2_Msg **pmsg);
+static XDAS_Int32 process(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs,
+    IVIDDEC2_OutArgs *outArgs);
+static XDAS_Int32 unmarshallMsg(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs, IVIDDEC2_OutArgs *outArgs,
+    _VIDDEC2_Msg *msg, XDAS_Int32 retVal);
+static Void unmarshallBufDesc(IVIDEO1_BufDesc *bufDesc);
+static Bool wroteBuf(IVIDDEC2_OutArgs *outArgs, XDAS_Int8 *buf,
+    XDAS_Int32 size);
+
+IVIDDEC2_Fxns VIDDEC2_STUBS = {
+    {&VIDDEC2_STUBS, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+    process, control,
+};
+
+/*
+ *  ======== VIDDEC2_processAsync ========
+ *  Local instances have nothing to send; their process call runs in
+ *  VIDDEC2_processWait(), in the caller's thread.
+ */
+XDAS_Int32 VIDDEC2_processAsync(VIDDEC2_Handle handle, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, VIDDEC2_InArgs *inArgs, VIDDEC2_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _VIDDEC2_Msg *msg;
+
+    if (visa == NULL) {
+        return (VIDDEC2_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&VIDDEC2_STUBS) {
+        return (VIDDEC2_EOK);
+    }
+
+    if ((retVal = marshallMsg((IVIDDEC2_Handle)visa, inBufs, outBufs, inArgs,
+        outArgs, &msg)) != IVIDDEC2_EOK) {
+        return (retVal);
+    }
+
+    if (VISA_callAsync(visa, (VISA_Msg *)&msg) != VISA_EOK) {
+        VISA_freeMsg(visa, (VISA_Msg)msg);
+        return (VIDDEC2_EFAIL);
+    }
+
+    return (VIDDEC2_EOK);
+}
+
+/*
+ *  ======== VIDDEC2_processWait ========
+ */
+XDAS_Int32 VIDDEC2_processWait(VIDDEC2_Handle handle, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, VIDDEC2_InArgs *inArgs, VIDDEC2_OutArgs *outArgs,
+    UInt timeout)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)handle;
+    _VIDDEC2_Msg *msg;
+
+    if (visa == NULL) {
+        return (VIDDEC2_EFAIL);
+    }
+
+    if (VISA_getAlgFxns(visa) != (IALG_Fxns *)&VIDDEC2_STUBS) {
+        return (VIDDEC2_process(handle, inBufs, outBufs, inArgs, outArgs));
+    }
+
+    if ((retVal = VISA_wait(visa, (VISA_Msg *)&msg, timeout)) ==
+            VISA_ETIMEOUT) {
+        /* still in flight; the caller must wait again */
+        return (VIDDEC2_ETIMEOUT);
+    }
+
+    /* without a reply, there are no outArgs to copy out */
+    if (msg == NULL) {
+        return (VIDDEC2_EFAIL);
+    }
+
+    return (unmarshallMsg((IVIDDEC2_Handle)visa, inBufs, outBufs, inArgs,
+        outArgs, msg, retVal));
+}
+
+/*
+ *  ======== accessBufDesc ========
+ *  Note in *described whether any buffer in bufDesc lies within
+ *  [buf, buf + size), and in *wrote whether the codec wrote any of them.
+ */
+static Void accessBufDesc(IVIDEO1_BufDesc *bufDesc, XDAS_Int8 *buf,
+    XDAS_Int32 size, Bool *described, Bool *wrote)
+{
+    XDM1_SingleBufDesc *desc;
+    Int i;
+
+    for (i = 0; i < bufDesc->numBufs && i < IVIDEO_MAX_YUV_BUFFERS; i++) {
+        desc = &bufDesc->bufDesc[i];
+        if (desc->buf != NULL && desc->buf >= buf && desc->buf < buf + size) {
+            *described = TRUE;
+            if (VISA_WROTEBUF(*desc)) {
+                *wrote = TRUE;
+            }
+        }
+    }
+}
+
+/*
+ *  ======== control ========
+ *  This is the stub-implementation for the control method
+ */
+static XDAS_Int32 control(IVIDDEC2_Handle h, IVIDDEC2_Cmd id,
+    IVIDDEC2_DynamicParams *params, IVIDDEC2_Status *status)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _VIDDEC2_Msg *msg;
+    IVIDDEC2_Status *pMsgStatus;
+    XDAS_Int8 *virtAddr = NULL;
+
+    /* get a message big enough for params and status */
+    if ((msg = (_VIDDEC2_Msg *)VISA_allocMsg2(visa,
+        CONTROLMSGSIZE(params, status))) == NULL) {
+        return (IVIDDEC2_EFAIL);
+    }
+
+    /* marshall the command */
+    msg->visa.cmd = _VIDDEC2_CCONTROL;
+
+    msg->cmd.control.id = id;
+
+    /* params has no pointers so simply copy the struct fields into the msg */
+    memcpy(&(msg->cmd.control.params), params, params->size);
+
+    /* unlike params, status is placed after the variable-sized params */
+    pMsgStatus = (IVIDDEC2_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* set status's size field and buffer, translating the latter */
+    pMsgStatus->size = status->size;
+    pMsgStatus->data = status->data;
+    if (status->data.buf != NULL) {
+        virtAddr = status->data.buf;
+        Memory_cacheWbInv(virtAddr, status->data.bufSize);
+        pMsgStatus->data.buf = (XDAS_Int8 *)Memory_getBufferPhysicalAddress(
+            virtAddr, status->data.bufSize, NULL);
+        if (pMsgStatus->data.buf == NULL) {
+            retVal = IVIDDEC2_EFAIL;
+            goto exit;
+        }
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_callUrgent(visa, (VISA_Msg *)&msg);
+
+    /* re-locate status, msg may have been changed by VISA_callUrgent() */
+    pMsgStatus = (IVIDDEC2_Status *)((UInt8 *)&(msg->cmd.control.params) +
+        params->size);
+
+    /* copy out status, restoring the caller's buffer address */
+    memcpy(status, pMsgStatus, pMsgStatus->size);
+    if (virtAddr != NULL) {
+        status->data.buf = virtAddr;
+        Memory_cacheInv(virtAddr, status->data.bufSize);
+    }
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== marshallMsg ========
+ *  Marshall a process call into the instance's message.  On success,
+ *  *pmsg is the message, ready to be sent to the skeleton.
+ */
+static XDAS_Int32 marshallMsg(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs, IVIDDEC2_OutArgs *outArgs,
+    _VIDDEC2_Msg **pmsg)
+{
+    XDAS_Int32 retVal;
+    VISA_Handle visa = (VISA_Handle)h;
+    _VIDDEC2_Msg *msg;
+    IVIDDEC2_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[2 * XDM_MAX_IO_BUFFERS];
+    Int numRanges = 0;
+    Int i;
+    Int numBufs;
+
+    if (inBufs->numBufs > XDM_MAX_IO_BUFFERS ||
+        outBufs->numBufs > XDM_MAX_IO_BUFFERS) {
+        return (IVIDDEC2_EFAIL);
+    }
+
+    /* get a message big enough for inArgs and outArgs */
+    if ((msg = (_VIDDEC2_Msg *)VISA_allocMsg2(visa,
+        PROCESSMSGSIZE(inArgs, outArgs))) == NULL) {
+        return (IVIDDEC2_EFAIL);
+    }
+
+    /* zero out msg->cmd (not msg->visa!) */
+    memset(&(msg->cmd), 0, offsetof(_VIDDEC2_Msg, cmd.process.inArgs) -
+        offsetof(_VIDDEC2_Msg, cmd));
+
+    /*
+     * Marshall the command: copy the client-passed arguments into flattened
+     * message data structures, converting every pointer address to alg.
+     * data buffer into physical address.
+     */
+
+    /* First specify the processing command that the skeleton should do */
+    msg->visa.cmd = _VIDDEC2_CPROCESS;
+
+    /* inBufs is a sparse array; numBufs counts its non-NULL entries */
+    msg->cmd.process.inBufs.numBufs = inBufs->numBufs;
+    for (i = 0, numBufs = 0;
+        numBufs < inBufs->numBufs && i < XDM_MAX_IO_BUFFERS; i++) {
+
+        if (inBufs->descs[i].buf != NULL) {
+            ranges[numRanges].addr = inBufs->descs[i].buf;
+            ranges[numRanges++].sizeInBytes = inBufs->descs[i].bufSize;
+
+            msg->cmd.process.inBufs.descs[i].buf = (XDAS_Int8 *)
+                Memory_getBufferPhysicalAddress(inBufs->descs[i].buf,
+                    inBufs->descs[i].bufSize, NULL);
+            if (msg->cmd.process.inBufs.descs[i].buf == NULL) {
+                retVal = IVIDDEC2_EFAIL;
+                goto exit;
+            }
+            msg->cmd.process.inBufs.descs[i].bufSize =
+                inBufs->descs[i].bufSize;
+            numBufs++;
+        }
+    }
+
+    /* flatten outBufs */
+    msg->cmd.process.numOutBufs = outBufs->numBufs;
+    for (i = 0; i < outBufs->numBufs; i++) {
+        msg->cmd.process.outBufSizes[i] = outBufs->bufSizes[i];
+
+        if (outBufs->bufs[i] != NULL) {
+            ranges[numRanges].addr = outBufs->bufs[i];
+            ranges[numRanges++].sizeInBytes = outBufs->bufSizes[i];
+
+            msg->cmd.process.outBufs[i] = (XDAS_Int8 *)
+                Memory_getBufferPhysicalAddress(outBufs->bufs[i],
+                    outBufs->bufSizes[i], NULL);
+            if (msg->cmd.process.outBufs[i] == NULL) {
+                retVal = IVIDDEC2_EFAIL;
+                goto exit;
+            }
+        }
+    }
+
+    /* inArgs has no pointers so simply copy the struct fields into the msg */
+    memcpy(&(msg->cmd.process.inArgs), inArgs, inArgs->size);
+
+    /* point at outArgs and set the "size" */
+    pMsgOutArgs = (IVIDDEC2_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /*
+     * Clear outArgs so the frame descriptors' accessMasks only say what
+     * this call's codec reported, then set the size field - the rest is
+     * filled in by the codec.
+     */
+    memset(pMsgOutArgs, 0, outArgs->size);
+    pMsgOutArgs->size = outArgs->size;
+
+    /* write back all the buffers at once */
+    Memory_cacheWbInvRanges(ranges, numRanges);
+
+    *pmsg = msg;
+
+    return (IVIDDEC2_EOK);
+
+exit:
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== process ========
+ *  This is the stub-implementation for the process method
+ */
+static XDAS_Int32 process(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs, IVIDDEC2_OutArgs *outArgs)
+{
+    XDAS_Int32 retVal;
+    _VIDDEC2_Msg *msg;
+
+    if ((retVal = marshallMsg(h, inBufs, outBufs, inArgs, outArgs, &msg)) !=
+            IVIDDEC2_EOK) {
+        return (retVal);
+    }
+
+    /* send the message to the skeleton and wait for completion */
+    retVal = VISA_call((VISA_Handle)h, (VISA_Msg *)&msg);
+
+    return (unmarshallMsg(h, inBufs, outBufs, inArgs, outArgs, msg, retVal));
+}
+
+/*
+ *  ======== unmarshallMsg ========
+ *  Copy the results of a process call out of msg, which the skeleton
+ *  returned with status retVal, and release msg.
+ */
+static XDAS_Int32 unmarshallMsg(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs, IVIDDEC2_OutArgs *outArgs,
+    _VIDDEC2_Msg *msg, XDAS_Int32 retVal)
+{
+    VISA_Handle visa = (VISA_Handle)h;
+    IVIDDEC2_OutArgs *pMsgOutArgs;
+    Memory_CacheRange ranges[XDM_MAX_IO_BUFFERS];
+    Int numRanges = 0;
+    Int i;
+
+    /* outArgs follows the variable-sized inArgs */
+    pMsgOutArgs = (IVIDDEC2_OutArgs *)((UInt8 *)&(msg->cmd.process.inArgs) +
+        inArgs->size);
+
+    /* copy out the outArgs and translate the buffers they reference */
+    memcpy(outArgs, pMsgOutArgs, outArgs->size);
+
+    unmarshallBufDesc(&outArgs->decodedBufs);
+    for (i = 0; i < IVIDDEC2_MAX_IO_BUFFERS && outArgs->outputID[i] != 0;
+        i++) {
+        unmarshallBufDesc(&outArgs->displayBufs[i]);
+    }
+    if (outArgs->mbDataBuf.buf != NULL) {
+        outArgs->mbDataBuf.buf = (XDAS_Int8 *)Memory_getBufferVirtualAddress(
+            (UInt32)outArgs->mbDataBuf.buf, outArgs->mbDataBuf.bufSize);
+    }
+
+    /* return the codec's inBufs accessMasks */
+    for (i = 0; i < XDM_MAX_IO_BUFFERS; i++) {
+        if (inBufs->descs[i].buf != NULL) {
+            inBufs->descs[i].accessMask =
+                msg->cmd.process.inBufs.descs[i].accessMask;
+        }
+    }
+
+    /*
+     * The skeleton wrote the output buffers back; drop any stale lines,
+     * except in buffers whose frames the codec says it only read.
+     */
+    for (i = 0; i < outBufs->numBufs; i++) {
+        if (outBufs->bufs[i] != NULL &&
+            wroteBuf(outArgs, outBufs->bufs[i], outBufs->bufSizes[i])) {
+            ranges[numRanges].addr = outBufs->bufs[i];
+            ranges[numRanges++].sizeInBytes = outBufs->bufSizes[i];
+        }
+    }
+    Memory_cacheInvRanges(ranges, numRanges);
+
+    VISA_freeMsg(visa, (VISA_Msg)msg);
+
+    return (retVal);
+}
+
+/*
+ *  ======== unmarshallBufDesc ========
+ *  Translate the (physical) buffer addresses in bufDesc to virtual ones.
+ */
+static Void unmarshallBufDesc(IVIDEO1_BufDesc *bufDesc)
+{
+    Int i;
+
+    for (i = 0; i < bufDesc->numBufs && i < IVIDEO_MAX_YUV_BUFFERS; i++) {
+        if (bufDesc->bufDesc[i].buf != NULL) {
+            bufDesc->bufDesc[i].buf = (XDAS_Int8 *)
+                Memory_getBufferVirtualAddress(
+                    (UInt32)bufDesc->bufDesc[i].buf,
+                    bufDesc->bufDesc[i].bufSize);
+        }
+    }
+}
+
+/*
+ *  ======== wroteBuf ========
+ *  Return TRUE unless the decoded or display frames in outArgs describe
+ *  [buf, buf + size) and the codec wrote none of them.  A buffer no frame
+ *  describes may still hold output, so it counts as written.
+ */
+static Bool wroteBuf(IVIDDEC2_OutArgs *outArgs, XDAS_Int8 *buf,
+    XDAS_Int32 size)
+{
+    Bool described = FALSE;
+    Bool wrote = FALSE;
+    Int i;
+
+    accessBufDesc(&outArgs->decodedBufs, buf, size, &described, &wrote);
+    for (i = 0; i < IVIDDEC2_MAX_IO_BUFFERS && outArgs->outputID[i] != 0;
+        i++) {
+        accessBufDesc(&outArgs->displayBufs[i], buf, size, &described,
+            &wrote);
+    }
+
+    return (wrote || !described);
+}
@@ -0,0 +1,631 @@
+/*
+ *  ======== visa.c ========
+ *  Host implementation of the VISA module.
+ *
+ *  A VISA instance wraps either a local alg instance, whose fxns the class
+ *  APIs call directly, or a node on the engine's server.  For the latter
+ *  the alg handle is the VISA handle itself and the fxns are the class
+ *  stubs, which marshal each call into one of the instance's messages and
+ *  pass it to VISA_call() or VISA_callAsync().
+ *
+ *  A remote instance owns a ring of VISA_numMsgs messages.  VISA_allocMsg()
+ *  hands out the slot at the tail, VISA_callAsync() sends it, and
+ *  VISA_wait() collects the reply for the slot at the head; the node
+ *  serves its queue in order, so replies arrive in the order sent.
+ *
+ *  VISA_call() may be made with calls in flight, and is served after
+ *  them.  VISA_callUrgent(), which the stubs' control() uses, doesn't
+ *  queue behind them: it sends its message at Comm_PRIORITYHIGH, which
+ *  the node takes ahead of them, so a control call waits for at most the
+ *  process call the node is running.  Engine_callPriority() keeps the
+ *  replies to the earlier calls that come back first for VISA_wait().
+ *  While the ring is full, VISA_allocMsg() hands out a spare message of
+ *  the instance's own, for either of these to use.
+ *
+ *  The ring's messages are allocated on first use and sized by the stubs
+ *  from the size fields of the args they carry (see VISA_allocMsg2()).  A
+ *  slot's message is only reallocated to grow beyond what it can hold,
+ *  which for a pooled one is Comm_MSGSIZE, so an instance settles at the
+ *  size of its largest call instead of reserving Comm_MSGSIZE per slot.
+ *
+ *  VISA_getFd() hands out the descriptor of the node's reply queue, so
+ *  that event loops can poll for completions and collect them with
+ *  VISA_wait() and a VISA_POLL timeout.
+ *
+ *  VISA_release() parks an instance, which its class has reset, on the
+ *  idle list instead of deleting it.  VISA_create2() takes a parked
+ *  instance of the same engine, alg, type and creation params in
+ *  preference to creating one, which saves the server's algAlloc() and
+ *  algInit().  At most VISA_maxIdle instances are kept.
+ *
+ *  Each instance has a Memory account that is charged the contiguous
+ *  memory allocated while the instance is created: its memTabs, by
+ *  Algorithm_create() or, for a remote instance, by the RMS.  The memory
+ *  is credited back as it is freed, by VISA_delete().  The account is a
+ *  child of the one the creating thread charges, if any, and else of the
+ *  engine's: the server-side instance the RMS creates for a remote one
+ *  is thereby charged to it, and not to the server's local engine.  A
+ *  reused idle instance's account is moved under its new creator's.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/alg/Algorithm.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/visa.h>
+
+#define GTNAME "ti.sdo.ce.visa"
+
+#define MAXMSGSIZE  0xffff      /* Comm_alloc() takes a UInt16 size */
+#define MSGALIGN    256         /* granularity of message growth */
+
+/*
+ *  ======== VISA_Obj ========
+ */
+typedef struct VISA_Obj {
+    Ptr                 algHandle;  /* IALG_Handle, or this VISA_Obj */
+    IALG_Fxns           *fxns;      /* alg's fxns, or the class stubs */
+    Algorithm_Handle    alg;        /* local instances only */
+    Engine_Node         node;       /* remote instances only */
+    VISA_Msg            *msgs;      /* ring of numMsgs, remote only */
+    VISA_Msg            spareMsg;   /* for VISA_call() while msgs is full */
+    UInt                numMsgs;
+    UInt                head;       /* oldest call in flight */
+    UInt                count;      /* calls in flight */
+    Ptr                 codecClassConfig;
+    UInt32              context;
+    Int                 memAccount; /* charged for the instance's memory */
+    Engine_Handle       engine;     /* the rest is the idle list key */
+    String              name;
+    String              type;
+    IALG_Params         *params;
+    Int                 paramsSize;
+    UInt32              paramsHash;
+    struct VISA_Obj     *next;      /* in idleList */
+} VISA_Obj;
+
+Bool VISA_checked __attribute__((weak)) = FALSE;
+UInt VISA_numMsgs __attribute__((weak)) = 1;
+UInt VISA_maxIdle __attribute__((weak)) = 4;
+
+static VISA_Status callNode(VISA_Obj *visa, VISA_Msg *msg, Int priority);
+static UInt32 hashParams(IALG_Params *params, Int paramsSize);
+static VISA_Obj *takeIdle(Engine_Handle engine, String name, String type,
+    IALG_Params *params, Int paramsSize, UInt32 paramsHash);
+
+static GT_Mask curTrace = {NULL, NULL};
+static pthread_mutex_t idleMutex = PTHREAD_MUTEX_INITIALIZER;
+static VISA_Obj *idleList = NULL;   /* most recently released first */
+static UInt numIdle = 0;
+
+/*
+ *  ======== VISA_allocMsg ========
+ */
+VISA_Msg VISA_allocMsg(VISA_Handle visa)
+{
+    return (VISA_allocMsg2(visa, Comm_MSGSIZE));
+}
+
+/*
+ *  ======== VISA_allocMsg2 ========
+ */
+VISA_Msg VISA_allocMsg2(VISA_Handle visa, size_t size)
+{
+    VISA_Msg *slot;
+
+    if (size > MAXMSGSIZE) {
+        GT_2trace(curTrace, GT_7CLASS, "VISA_allocMsg2> "
+            "a %d byte message exceeds the maximum of %d bytes\n",
+            (Int)size, MAXMSGSIZE);
+        return (NULL);
+    }
+
+    /* with all of the ring in flight, only a synchronous call can be made */
+    slot = visa->count == visa->numMsgs ? &visa->spareMsg :
+        &visa->msgs[(visa->head + visa->count) % visa->numMsgs];
+
+    if (size < sizeof (VISA_MsgHeader)) {
+        size = sizeof (VISA_MsgHeader);
+    }
+    size = (size + MSGALIGN - 1) & ~(size_t)(MSGALIGN - 1);
+    if (size > MAXMSGSIZE) {
+        size = MAXMSGSIZE;
+    }
+
+    /* a pooled message holds more than it was allocated for */
+    if (*slot != NULL && Comm_setMsgSize((Comm_Msg)*slot, (UInt16)size) !=
+            Comm_EOK) {
+        Comm_free((Comm_Msg)*slot);
+        *slot = NULL;
+    }
+
+    if (*slot == NULL) {
+        if (Comm_alloc(Engine_getMemId(visa->engine), (Comm_Msg *)slot,
+            (UInt16)size) != Comm_EOK) {
+            *slot = NULL;
+            GT_2trace(curTrace, GT_7CLASS, "VISA_allocMsg2> "
+                "failed to allocate a %d byte message for visa 0x%lx\n",
+                (Int)size, (IArg)visa);
+            return (NULL);
+        }
+    }
+
+    return (*slot);
+}
+
+/*
+ *  ======== VISA_call ========
+ */
+VISA_Status VISA_call(VISA_Handle visa, VISA_Msg *msg)
+{
+    return (callNode(visa, msg, Comm_PRIORITYNORMAL));
+}
+
+/*
+ *  ======== VISA_callAsync ========
+ */
+VISA_Status VISA_callAsync(VISA_Handle visa, VISA_Msg *msg)
+{
+    if (visa->count == visa->numMsgs ||
+        *msg != visa->msgs[(visa->head + visa->count) % visa->numMsgs]) {
+        GT_2trace(curTrace, GT_7CLASS, "VISA_callAsync> "
+            "msg 0x%lx is not the next free message of visa 0x%lx\n",
+            (IArg)*msg, (IArg)visa);
+        return (VISA_EFAIL);
+    }
+
+    if (Engine_callAsync(visa->node, (Comm_Msg *)msg) != Engine_EOK) {
+        GT_1trace(curTrace, GT_7CLASS, "VISA_callAsync> "
+            "transport failure on visa 0x%lx\n", (IArg)visa);
+        return (VISA_ERUNTIME);
+    }
+    visa->count++;
+
+    return (VISA_EOK);
+}
+
+/*
+ *  ======== VISA_callUrgent ========
+ */
+VISA_Status VISA_callUrgent(VISA_Handle visa, VISA_Msg *msg)
+{
+    return (callNode(visa, msg, Comm_PRIORITYHIGH));
+}
+
+/*
+ *  ======== VISA_create ========
+ */
+VISA_Handle VISA_create(Engine_Handle engine, String name,
+    IALG_Params *params, size_t msgSize, String type)
+{
+    return (VISA_create2(engine, name, params,
+        params == NULL ? 0 : params->size, msgSize, type));
+}
+
+/*
+ *  ======== VISA_create2 ========
+ */
+VISA_Handle VISA_create2(Engine_Handle engine, String name,
+    IALG_Params *params, Int paramsSize, size_t msgSize, String type)
+{
+    VISA_Obj *visa;
+    IALG_Fxns *fxns;
+    Algorithm_Attrs algAttrs = Algorithm_ATTRS;
+    Bool isLocal;
+    Ptr idmaFxns;
+    Ptr iresFxns;
+    UInt32 paramsHash;
+    Int account;
+
+    if (curTrace.modName == NULL) {
+        GT_create(&curTrace, GTNAME);
+    }
+
+    GT_5trace(curTrace, GT_ENTER, "VISA_create2> Enter(engine=0x%lx, "
+        "name='%s', params=0x%lx, msgSize=%d, type='%s')\n", (IArg)engine,
+        name, (IArg)params, (Int)msgSize, type);
+
+    if (engine == NULL) {
+        return (NULL);
+    }
+
+    if (params == NULL) {
+        paramsSize = 0;
+    }
+    paramsHash = hashParams(params, paramsSize);
+
+    if ((account = Memory_getAccount()) == Memory_NOACCOUNT) {
+        account = Engine_getMemAccount(engine);
+    }
+
+    if ((visa = takeIdle(engine, name, type, params, paramsSize,
+        paramsHash)) != NULL) {
+        GT_1trace(curTrace, GT_2CLASS, "VISA_create2> "
+            "reusing idle instance 0x%lx\n", (IArg)visa);
+        Memory_setAccountParent(visa->memAccount, account);
+        return (visa);
+    }
+
+    fxns = Engine_getFxns(engine, name, type, &isLocal, &idmaFxns,
+        &iresFxns, &algAttrs.groupId);
+    if (fxns == NULL) {
+        return (NULL);
+    }
+
+    if ((visa = (VISA_Obj *)calloc(1, sizeof (VISA_Obj))) == NULL) {
+        return (NULL);
+    }
+    visa->fxns = fxns;
+    visa->codecClassConfig = Engine_getCodecClassConfig(engine, name, type);
+
+    visa->engine = engine;
+    visa->name = strdup(name);
+    visa->type = type == NULL ? NULL : strdup(type);
+    visa->params = paramsSize > 0 ? malloc(paramsSize) : NULL;
+    if (visa->name == NULL || (type != NULL && visa->type == NULL) ||
+        (paramsSize > 0 && visa->params == NULL)) {
+        VISA_delete(visa);
+        return (NULL);
+    }
+    if (paramsSize > 0) {
+        memcpy(visa->params, params, paramsSize);
+    }
+    visa->paramsSize = paramsSize;
+    visa->paramsHash = paramsHash;
+
+    visa->memAccount = Memory_createAccount(account);
+
+    if (isLocal) {
+        account = Memory_setAccount(visa->memAccount);
+        visa->alg = Algorithm_create(fxns, idmaFxns, iresFxns, params,
+            &algAttrs);
+        Memory_setAccount(account);
+        if (visa->alg == NULL) {
+            GT_1trace(curTrace, GT_7CLASS, "VISA_create2> "
+                "failed to create local alg '%s'\n", name);
+            VISA_delete(visa);
+            return (NULL);
+        }
+        visa->algHandle = Algorithm_getAlgHandle(visa->alg);
+    }
+    else {
+        /* the messages themselves are allocated by VISA_allocMsg2() */
+        visa->numMsgs = VISA_numMsgs > 0 ? VISA_numMsgs : 1;
+        visa->msgs = (VISA_Msg *)calloc(visa->numMsgs, sizeof (VISA_Msg));
+        if (visa->msgs == NULL) {
+            VISA_delete(visa);
+            return (NULL);
+        }
+
+        account = Memory_setAccount(visa->memAccount);
+        visa->node = Engine_createNode2(engine, name, msgSize, params,
+            paramsSize, NULL);
+        Memory_setAccount(account);
+        if (visa->node == NULL) {
+            GT_1trace(curTrace, GT_7CLASS, "VISA_create2> "
+                "failed to create remote alg '%s'\n", name);
+            VISA_delete(visa);
+            return (NULL);
+        }
+        visa->algHandle = visa;
+    }
+
+    return (visa);
+}
+
+/*
+ *  ======== VISA_delete ========
+ */
+Void VISA_delete(VISA_Handle visa)
+{
+    VISA_Msg msg;
+    UInt i;
+
+    GT_1trace(curTrace, GT_ENTER, "VISA_delete> Enter(visa=0x%lx)\n",
+        (IArg)visa);
+
+    if (visa == NULL) {
+        return;
+    }
+
+    /* the node may still be using some of the messages */
+    while (visa->count > 0) {
+        if (VISA_wait(visa, &msg, VISA_FOREVER) == VISA_ERUNTIME) {
+            break;
+        }
+    }
+
+    if (visa->node != NULL) {
+        Engine_deleteNode(visa->node);
+    }
+    if (visa->msgs != NULL) {
+        for (i = 0; i < visa->numMsgs; i++) {
+            if (visa->msgs[i] != NULL) {
+                Comm_free((Comm_Msg)visa->msgs[i]);
+            }
+        }
+        free(visa->msgs);
+    }
+    if (visa->spareMsg != NULL) {
+        Comm_free((Comm_Msg)visa->spareMsg);
+    }
+    if (visa->alg != NULL) {
+        Algorithm_delete(visa->alg);
+    }
+    Memory_deleteAccount(visa->memAccount);
+
+    free(visa->params);
+    free(visa->type);
+    free(visa->name);
+    free(visa);
+}
+
+/*
+ *  ======== VISA_enter ========
+ */
+Void VISA_enter(VISA_Handle visa)
+{
+    if (visa->alg != NULL) {
+        Algorithm_activate(visa->alg);
+    }
+}
+
+/*
+ *  ======== VISA_exit ========
+ */
+Void VISA_exit(VISA_Handle visa)
+{
+    if (visa->alg != NULL) {
+        Algorithm_deactivate(visa->alg);
+    }
+}
+
+/*
+ *  ======== VISA_flush ========
+ */
+Void VISA_flush(Engine_Handle engine)
+{
+    VISA_Obj **prev;
+    VISA_Obj *visa;
+    VISA_Obj *flushed = NULL;
+
+    pthread_mutex_lock(&idleMutex);
+    for (prev = &idleList; (visa = *prev) != NULL; ) {
+        if (engine == NULL || visa->engine == engine) {
+            *prev = visa->next;
+            visa->next = flushed;
+            flushed = visa;
+            numIdle--;
+        }
+        else {
+            prev = &visa->next;
+        }
+    }
+    pthread_mutex_unlock(&idleMutex);
+
+    while ((visa = flushed) != NULL) {
+        flushed = visa->next;
+        VISA_delete(visa);
+    }
+}
+
+/*
+ *  ======== VISA_freeMsg ========
+ */
+Void VISA_freeMsg(VISA_Handle visa, VISA_Msg msg)
+{
+    /* the instance's messages are recycled by VISA_wait() */
+}
+
+/*
+ *  ======== VISA_getAlgFxns ========
+ */
+IALG_Fxns *VISA_getAlgFxns(VISA_Handle visa)
+{
+    return (visa->fxns);
+}
+
+/*
+ *  ======== VISA_getAlgHandle ========
+ */
+Ptr VISA_getAlgHandle(VISA_Handle visa)
+{
+    return (visa->algHandle);
+}
+
+/*
+ *  ======== VISA_getCodecClassConfig ========
+ */
+Ptr VISA_getCodecClassConfig(VISA_Handle visa)
+{
+    return (visa->codecClassConfig);
+}
+
+/*
+ *  ======== VISA_getContext ========
+ */
+Void VISA_getContext(VISA_Handle visa, UInt32 *pContext)
+{
+    *pContext = visa->context;
+}
+
+/*
+ *  ======== VISA_getFd ========
+ */
+Int VISA_getFd(VISA_Handle visa)
+{
+    return (visa->node == NULL ? -1 : Engine_getNodeFd(visa->node));
+}
+
+/*
+ *  ======== VISA_getMemUsage ========
+ */
+VISA_Status VISA_getMemUsage(VISA_Handle visa, Memory_AccountStat *stat)
+{
+    return (Memory_getAccountStat(visa->memAccount, stat) ? VISA_EOK :
+        VISA_EFAIL);
+}
+
+/*
+ *  ======== VISA_release ========
+ */
+Void VISA_release(VISA_Handle visa)
+{
+    VISA_Obj **prev;
+    VISA_Obj *evicted = NULL;
+
+    GT_1trace(curTrace, GT_ENTER, "VISA_release> Enter(visa=0x%lx)\n",
+        (IArg)visa);
+
+    if (visa == NULL) {
+        return;
+    }
+
+    /* an instance with calls in flight can't be handed to someone else */
+    if (visa->count != 0 || VISA_maxIdle == 0) {
+        VISA_delete(visa);
+        return;
+    }
+
+    pthread_mutex_lock(&idleMutex);
+    visa->next = idleList;
+    idleList = visa;
+
+    /* evict the least recently released instance */
+    if (++numIdle > VISA_maxIdle) {
+        for (prev = &idleList; (*prev)->next != NULL; prev = &(*prev)->next) {
+        }
+        evicted = *prev;
+        *prev = NULL;
+        numIdle--;
+    }
+    pthread_mutex_unlock(&idleMutex);
+
+    if (evicted != NULL) {
+        VISA_delete(evicted);
+    }
+}
+
+/*
+ *  ======== VISA_setContext ========
+ */
+Void VISA_setContext(VISA_Handle visa, UInt32 context)
+{
+    visa->context = context;
+}
+
+/*
+ *  ======== VISA_wait ========
+ */
+VISA_Status VISA_wait(VISA_Handle visa, VISA_Msg *msg, UInt timeout)
+{
+    Comm_Msg reply;
+    Int status;
+
+    /* only a reply is handed back; stubs mustn't unmarshal a stale slot */
+    *msg = NULL;
+
+    if (visa->count == 0) {
+        GT_1trace(curTrace, GT_7CLASS, "VISA_wait> "
+            "visa 0x%lx has no call in flight\n", (IArg)visa);
+        return (VISA_EFAIL);
+    }
+
+    if ((status = Engine_callWait(visa->node, &reply, timeout)) !=
+            Engine_EOK) {
+        if (status == Engine_ETIMEOUT) {
+            return (VISA_ETIMEOUT);
+        }
+        GT_1trace(curTrace, GT_7CLASS, "VISA_wait> "
+            "transport failure on visa 0x%lx\n", (IArg)visa);
+        return (VISA_ERUNTIME);
+    }
+
+    /* replies arrive in order, so this is the message at the head */
+    *msg = (VISA_Msg)reply;
+    visa->head = (visa->head + 1) % visa->numMsgs;
+    visa->count--;
+
+    return ((*msg)->status);
+}
+
+/*
+ *  ======== callNode ========
+ *  Send msg, the instance's free message, at priority and wait for its
+ *  reply.
+ */
+static VISA_Status callNode(VISA_Obj *visa, VISA_Msg *msg, Int priority)
+{
+    if (*msg != visa->spareMsg && (visa->count == visa->numMsgs ||
+        *msg != visa->msgs[(visa->head + visa->count) % visa->numMsgs])) {
+        GT_2trace(curTrace, GT_7CLASS, "VISA_call> "
+            "msg 0x%lx is not the next free message of visa 0x%lx\n",
+            (IArg)*msg, (IArg)visa);
+        return (VISA_EFAIL);
+    }
+
+    /* replies to the calls in flight are kept for VISA_wait() */
+    if (Engine_callPriority(visa->node, (Comm_Msg *)msg, priority) !=
+            Engine_EOK) {
+        GT_1trace(curTrace, GT_7CLASS, "VISA_call> "
+            "transport failure on visa 0x%lx\n", (IArg)visa);
+        return (VISA_ERUNTIME);
+    }
+
+    return ((*msg)->status);
+}
+
+/*
+ *  ======== hashParams ========
+ *  FNV-1a hash of the creation params, to quickly skip idle instances
+ *  created with others.
+ */
+static UInt32 hashParams(IALG_Params *params, Int paramsSize)
+{
+    UInt8 *p = (UInt8 *)params;
+    UInt32 hash = 2166136261U;
+    Int i;
+
+    for (i = 0; i < paramsSize; i++) {
+        hash = (hash ^ p[i]) * 16777619U;
+    }
+
+    return (hash);
+}
+
+/*
+ *  ======== takeIdle ========
+ *  Remove and return an idle instance matching the create arguments.
+ */
+static VISA_Obj *takeIdle(Engine_Handle engine, String name, String type,
+    IALG_Params *params, Int paramsSize, UInt32 paramsHash)
+{
+    VISA_Obj **prev;
+    VISA_Obj *visa;
+
+    pthread_mutex_lock(&idleMutex);
+    for (prev = &idleList; (visa = *prev) != NULL; prev = &visa->next) {
+        if (visa->engine == engine && visa->paramsHash == paramsHash &&
+            visa->paramsSize == paramsSize &&
+            strcmp(visa->name, name) == 0 &&
+            (visa->type == NULL ? type == NULL :
+                type != NULL && strcmp(visa->type, type) == 0) &&
+            (paramsSize == 0 ||
+                memcmp(visa->params, params, paramsSize) == 0)) {
+            *prev = visa->next;
+            visa->next = NULL;
+            visa->context = 0;
+            numIdle--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&idleMutex);
+
+    return (visa);
+}
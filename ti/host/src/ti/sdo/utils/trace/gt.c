@@ -0,0 +1,300 @@
+/*
+ *  ======== gt.c ========
+ *  Host implementation of the GT trace module.
+ *
+ *  Trace masks are kept per module name and can be set at any time with
+ *  GT_set() or, before CERuntime_init(), through the CE_TRACE environment
+ *  variable, e.g. CE_TRACE="*=67;OM=01234567".  Settings are remembered
+ *  and applied to masks created later, so the order in which modules
+ *  initialize does not matter.
+ */
+#include <xdc/std.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <ti/sdo/utils/trace/gt.h>
+
+#define MAXNAMELEN      32
+#define MAXSETTINGS     64
+
+typedef struct ModFlags {
+    struct ModFlags *next;
+    Char            name[MAXNAMELEN + 1];
+    UInt8           flags;
+} ModFlags;
+
+typedef struct Setting {
+    Char    name[MAXNAMELEN + 1];   /* "*" matches every module */
+    Char    op;                     /* one of '=', '+', '-' */
+    UInt8   bits;
+} Setting;
+
+static Void printfxn(String fmt, ...);
+static Void errorfxn(String fmt, ...);
+static Void applySetting(ModFlags *mod, Setting *setting);
+static ModFlags *findMod(String modName);
+
+GT_Config _ti_sdo_utils_trace_GT_params = {
+    printfxn,   /* PRINTFXN */
+    NULL,       /* PIDFXN */
+    NULL,       /* TIDFXN */
+    errorfxn,   /* ERRORFXN */
+    NULL,       /* MALLOCFXN */
+    NULL,       /* FREEFXN */
+    NULL,       /* TIMEFXN */
+    NULL,       /* LOCKFXN */
+    NULL,       /* UNLOCKFXN */
+    NULL,       /* INITFXN */
+};
+
+GT_Config *GT = &_ti_sdo_utils_trace_GT_params;
+
+String GT_format = "@%u:[T:0x%08lx] %s - ";
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static ModFlags *modList = NULL;
+static Setting settings[MAXSETTINGS];
+static Int numSettings = 0;
+static Bool enabled = TRUE;
+static Bool initialized = FALSE;
+static struct timespec startTime;
+
+/*
+ *  ======== GT_curTime ========
+ *  Microseconds since GT_init().
+ */
+UInt32 GT_curTime(Void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((UInt32)((now.tv_sec - startTime.tv_sec) * 1000000 +
+        (now.tv_nsec - startTime.tv_nsec) / 1000));
+}
+
+/*
+ *  ======== GT_disable ========
+ */
+Void GT_disable(Void)
+{
+    enabled = FALSE;
+}
+
+/*
+ *  ======== GT_enable ========
+ */
+Void GT_enable(Void)
+{
+    enabled = TRUE;
+}
+
+/*
+ *  ======== GT_getModNameFlags ========
+ */
+Bool GT_getModNameFlags(String modName, UInt8 *flags)
+{
+    ModFlags *mod;
+
+    pthread_mutex_lock(&mutex);
+    if ((mod = findMod(modName)) != NULL) {
+        *flags = mod->flags;
+    }
+    pthread_mutex_unlock(&mutex);
+
+    return (mod != NULL);
+}
+
+/*
+ *  ======== GT_init ========
+ */
+Void GT_init(Void)
+{
+    String env;
+
+    pthread_mutex_lock(&mutex);
+    if (initialized) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    initialized = TRUE;
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    pthread_mutex_unlock(&mutex);
+
+    if ((env = getenv("CE_TRACE")) != NULL) {
+        _GT_set(env);
+    }
+}
+
+/*
+ *  ======== _GT_create ========
+ */
+Void _GT_create(GT_Mask *mask, String modName)
+{
+    ModFlags *mod;
+    Int i;
+
+    pthread_mutex_lock(&mutex);
+
+    if ((mod = findMod(modName)) == NULL) {
+        if ((mod = (ModFlags *)calloc(1, sizeof (ModFlags))) == NULL) {
+            pthread_mutex_unlock(&mutex);
+            (*GT->ERRORFXN)("GT_create: out of memory for '%s'\n", modName);
+            return;
+        }
+        strncpy(mod->name, modName, MAXNAMELEN);
+        for (i = 0; i < numSettings; i++) {
+            applySetting(mod, &settings[i]);
+        }
+        mod->next = modList;
+        modList = mod;
+    }
+
+    mask->modName = mod->name;
+    mask->flags = &mod->flags;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/*
+ *  ======== _GT_set ========
+ *  str is a list of "<mod>[=+-]<digits>" separated by ';' or ','.
+ */
+Void _GT_set(String str)
+{
+    Setting setting;
+    ModFlags *mod;
+    String cp = str;
+    Int len;
+
+    pthread_mutex_lock(&mutex);
+
+    while (*cp != '\0') {
+        /* module name runs up to the operator */
+        len = strcspn(cp, "=+-;,");
+        if (cp[len] != '=' && cp[len] != '+' && cp[len] != '-') {
+            cp += len + (cp[len] != '\0');
+            continue;
+        }
+
+        memset(&setting, 0, sizeof (setting));
+        strncpy(setting.name, cp, len < MAXNAMELEN ? len : MAXNAMELEN);
+        setting.op = cp[len];
+        for (cp += len + 1; *cp >= '0' && *cp <= '7'; cp++) {
+            setting.bits |= (UInt8)(1 << (*cp - '0'));
+        }
+
+        for (mod = modList; mod != NULL; mod = mod->next) {
+            applySetting(mod, &setting);
+        }
+
+        /* an absolute wildcard setting supersedes everything before it */
+        if (setting.op == '=' && strcmp(setting.name, "*") == 0) {
+            numSettings = 0;
+        }
+        if (numSettings < MAXSETTINGS) {
+            settings[numSettings++] = setting;
+        }
+
+        cp += strcspn(cp, ";,");
+        if (*cp != '\0') {
+            cp++;
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/*
+ *  ======== _GT_trace ========
+ */
+Int _GT_trace(GT_Mask *mask, Int classId, String format, ...)
+{
+    va_list va;
+
+    if (!enabled) {
+        return (0);
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    printf(GT_format, GT_curTime(), (ULong)pthread_self(), mask->modName);
+    va_start(va, format);
+    vprintf(format, va);
+    va_end(va);
+    fflush(stdout);
+
+    pthread_mutex_unlock(&mutex);
+
+    return (0);
+}
+
+/*
+ *  ======== applySetting ========
+ */
+static Void applySetting(ModFlags *mod, Setting *setting)
+{
+    if (strcmp(setting->name, "*") != 0 &&
+        strcmp(setting->name, mod->name) != 0) {
+        return;
+    }
+
+    switch (setting->op) {
+        case '=':
+            mod->flags = setting->bits;
+            break;
+        case '+':
+            mod->flags |= setting->bits;
+            break;
+        case '-':
+            mod->flags &= ~setting->bits;
+            break;
+    }
+}
+
+/*
+ *  ======== errorfxn ========
+ */
+static Void errorfxn(String fmt, ...)
+{
+    va_list va;
+
+    fprintf(stderr, "GT ERROR: ");
+    va_start(va, fmt);
+    vfprintf(stderr, fmt, va);
+    va_end(va);
+}
+
+/*
+ *  ======== findMod ========
+ *  Must be called with mutex held.
+ */
+static ModFlags *findMod(String modName)
+{
+    ModFlags *mod;
+
+    for (mod = modList; mod != NULL; mod = mod->next) {
+        if (strcmp(mod->name, modName) == 0) {
+            break;
+        }
+    }
+
+    return (mod);
+}
+
+/*
+ *  ======== printfxn ========
+ */
+static Void printfxn(String fmt, ...)
+{
+    va_list va;
+
+    va_start(va, fmt);
+    vprintf(fmt, va);
+    va_end(va);
+}
@@ -0,0 +1,185 @@
+/*
+ *  ======== batch_test.c ========
+ *  Check batched process calls to local and remote speech decoder
+ *  instances: batches split across several messages, by their size or by
+ *  the number of buffers whose cache they maintain, each frame's results,
+ *  and the answer of servers that predate batches.
+ */
+#include <xdc/std.h>
+
+#include <string.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/visa.h>
+#include <ti/sdo/ce/speech1/sphdec1.h>
+
+#include "test.h"
+
+#define NUMFRAMES       20
+#define FRAMESIZE       64
+
+/*
+ *  Frames with three buffers each, whose batch fits in two messages but
+ *  has more buffers than the 128 the stubs maintain the cache of per
+ *  message, so it takes at least three.
+ */
+#define NUMRANGED       100
+
+/* an inArgs extended so that only a few frames fit in a message */
+typedef struct BigInArgs {
+    SPHDEC1_InArgs      args;
+    XDAS_Int8           ext[1024];
+} BigInArgs;
+
+static Void checkBatch(String name);
+static Void checkManyRanges(Void);
+static Void checkOldServer(Void);
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    CERuntime_init();
+
+    checkBatch("local");
+    checkBatch("remote");
+    checkManyRanges();
+    checkOldServer();
+
+    CERuntime_exit();
+
+    return (Test_exit("batch_test"));
+}
+
+/*
+ *  ======== checkBatch ========
+ *  A batch too big for one message is sent in several, and each frame
+ *  comes back with its own outArgs and status, in order.
+ */
+static Void checkBatch(String name)
+{
+    SPHDEC1_Params params = {sizeof (SPHDEC1_Params)};
+    Engine_Handle engine;
+    SPHDEC1_Handle sph;
+    Test_Batch batch;
+    Int numMsgs = Test_sphBatchMsgs;
+    Int n;
+
+    engine = Engine_open(name, NULL, NULL);
+    sph = SPHDEC1_create(engine, "sph", &params);
+    Test_check(sph != NULL);
+    if (sph == NULL) {
+        Engine_close(engine);
+        return;
+    }
+
+    /* every seventh frame fails */
+    Test_allocBatch(&batch, NUMFRAMES, FRAMESIZE, sizeof (BigInArgs), FALSE);
+    for (n = 3; n < NUMFRAMES; n += 7) {
+        batch.inArgs[n]->frameType = -n;
+    }
+
+    Test_check(SPHDEC1_processBatch(sph, batch.inBufs, batch.outBufs,
+        batch.inArgs, batch.outArgs, NUMFRAMES, batch.retVals) ==
+        SPHDEC1_EFAIL);
+
+    for (n = 0; n < NUMFRAMES; n++) {
+        Test_check(batch.retVals[n] == (n % 7 == 3 ? SPHDEC1_EFAIL :
+            SPHDEC1_EOK));
+        Test_check(batch.outArgs[n]->dataSize ==
+            batch.inArgs[n]->frameType);
+        Test_check(batch.outArgs[n]->extendedError == n + 1);
+        Test_check(memcmp(batch.outBufs[n].buf, batch.inBufs[n].buf,
+            FRAMESIZE) == 0);
+        Test_check(XDM_ISACCESSMODE_WRITE(batch.outBufs[n].accessMask));
+    }
+
+    /* local instances send nothing */
+    numMsgs = Test_sphBatchMsgs - numMsgs;
+    Test_check(strcmp(name, "local") == 0 ? numMsgs == 0 : numMsgs > 1);
+
+    Test_freeBatch(&batch);
+    SPHDEC1_delete(sph);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkManyRanges ========
+ *  A batch with more buffers than a message maintains the cache of is
+ *  sent in several messages, and every frame is processed.
+ */
+static Void checkManyRanges(Void)
+{
+    SPHDEC1_Params params = {sizeof (SPHDEC1_Params)};
+    Engine_Handle engine;
+    SPHDEC1_Handle sph;
+    Test_Batch batch;
+    Int numMsgs = Test_sphBatchMsgs;
+    Int n;
+
+    engine = Engine_open("remote", NULL, NULL);
+    sph = SPHDEC1_create(engine, "sph", &params);
+    Test_check(sph != NULL);
+    if (sph == NULL) {
+        Engine_close(engine);
+        return;
+    }
+
+    Test_allocBatch(&batch, NUMRANGED, FRAMESIZE, sizeof (SPHDEC1_InArgs),
+        TRUE);
+
+    Test_check(SPHDEC1_processBatch(sph, batch.inBufs, batch.outBufs,
+        batch.inArgs, batch.outArgs, NUMRANGED, batch.retVals) ==
+        SPHDEC1_EOK);
+    Test_check(Test_sphBatchMsgs - numMsgs >= 3);
+
+    for (n = 0; n < NUMRANGED; n++) {
+        Test_check(batch.retVals[n] == SPHDEC1_EOK);
+        Test_check(batch.outArgs[n]->dataSize == n);
+        Test_check(memcmp(batch.outBufs[n].buf, batch.inBufs[n].buf,
+            FRAMESIZE) == 0);
+    }
+
+    Test_freeBatch(&batch);
+    SPHDEC1_delete(sph);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkOldServer ========
+ *  A server that predates batches fails each of the batch's frames.
+ */
+static Void checkOldServer(Void)
+{
+    SPHDEC1_Params params = {sizeof (SPHDEC1_Params)};
+    Engine_Handle engine;
+    SPHDEC1_Handle sph;
+    Test_Batch batch;
+    Int n;
+
+    engine = Engine_open("remote", NULL, NULL);
+    sph = SPHDEC1_create(engine, "sph", &params);
+    Test_check(sph != NULL);
+    if (sph == NULL) {
+        Engine_close(engine);
+        return;
+    }
+
+    Test_allocBatch(&batch, NUMFRAMES, FRAMESIZE, sizeof (BigInArgs), FALSE);
+
+    Test_sphOldServer = TRUE;
+    Test_check(SPHDEC1_processBatch(sph, batch.inBufs, batch.outBufs,
+        batch.inArgs, batch.outArgs, NUMFRAMES, batch.retVals) ==
+        SPHDEC1_EFAIL);
+    Test_sphOldServer = FALSE;
+
+    for (n = 0; n < NUMFRAMES; n++) {
+        Test_check(batch.retVals[n] == VISA_EFAIL);
+    }
+
+    Test_freeBatch(&batch);
+    SPHDEC1_delete(sph);
+    Engine_close(engine);
+}
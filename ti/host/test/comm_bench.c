@@ -0,0 +1,194 @@
+/*
+ *  ======== comm_bench.c ========
+ *  Time Comm message traffic between 1 to 32 pairs of threads, each
+ *  putter spreading its messages over all the queues, and message
+ *  allocation from the thread caches.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/osal/Comm.h>
+
+#include "test.h"
+
+#define MAXPAIRS        32
+#define NUMPUTS         20000
+#define NUMALLOCS       1000000
+
+static Void *allocMsgs(Void *arg);
+static Void benchAlloc(Int numThreads);
+static Void benchQueues(Int numPairs);
+static Int compare(const Void *a, const Void *b);
+static Void *getMsgs(Void *arg);
+static Void *putMsgs(Void *arg);
+
+static Int numQueues;
+static Comm_Queue queues[MAXPAIRS];
+static float putTimes[MAXPAIRS][NUMPUTS];
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    Comm_PoolStat stat;
+    Int n;
+
+    CERuntime_init();
+
+    for (n = 1; n <= MAXPAIRS; n *= 2) {
+        benchQueues(n);
+    }
+    for (n = 1; n <= 8; n *= 2) {
+        benchAlloc(n);
+    }
+
+    Comm_poolStat(&stat);
+    printf("pool: %lu messages, %lu idle, %lu hits, %lu misses, "
+        "%lu unpooled\n", stat.numMsgs, stat.numIdle, stat.hits,
+        stat.misses, stat.numUnpooled);
+
+    CERuntime_exit();
+
+    return (0);
+}
+
+/*
+ *  ======== allocMsgs ========
+ */
+static Void *allocMsgs(Void *arg)
+{
+    Comm_Msg msgs[4];
+    Int i;
+    Int k;
+
+    for (i = 0; i < NUMALLOCS / 4; i++) {
+        for (k = 0; k < 4; k++) {
+            Comm_alloc(0, &msgs[k], Comm_MSGSIZE);
+        }
+        for (k = 0; k < 4; k++) {
+            Comm_free(msgs[k]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== benchAlloc ========
+ */
+static Void benchAlloc(Int numThreads)
+{
+    pthread_t threads[8];
+    double start = Test_now();
+    Int i;
+
+    for (i = 0; i < numThreads; i++) {
+        pthread_create(&threads[i], NULL, allocMsgs, NULL);
+    }
+    for (i = 0; i < numThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    printf("%d threads: message alloc+free %.1f ns\n", numThreads,
+        (Test_now() - start) * 1e3 / (numThreads * NUMALLOCS));
+}
+
+/*
+ *  ======== benchQueues ========
+ *  Report the message rate, and the percentiles of the time Comm_put()
+ *  takes, with numPairs putters and getters.
+ */
+static Void benchQueues(Int numPairs)
+{
+    static float times[MAXPAIRS * NUMPUTS];
+    pthread_t putters[MAXPAIRS];
+    pthread_t getters[MAXPAIRS];
+    Comm_Handle handles[MAXPAIRS];
+    Int numTimes = numPairs * NUMPUTS;
+    double start;
+    double time;
+    Int i;
+
+    numQueues = numPairs;
+    for (i = 0; i < numPairs; i++) {
+        handles[i] = Comm_create(NULL, &queues[i], NULL);
+    }
+
+    start = Test_now();
+    for (i = 0; i < numPairs; i++) {
+        pthread_create(&getters[i], NULL, getMsgs, (Void *)(IArg)i);
+        pthread_create(&putters[i], NULL, putMsgs, (Void *)(IArg)i);
+    }
+    for (i = 0; i < numPairs; i++) {
+        pthread_join(putters[i], NULL);
+        pthread_join(getters[i], NULL);
+    }
+    time = Test_now() - start;
+
+    for (i = 0; i < numPairs; i++) {
+        memcpy(&times[i * NUMPUTS], putTimes[i], sizeof (putTimes[i]));
+        Comm_delete(handles[i]);
+    }
+    qsort(times, numTimes, sizeof (float), compare);
+
+    printf("%2d pairs: %6.2f Mmsg/s, put p50 %6.0f ns, p99 %7.0f ns, "
+        "p99.9 %8.0f ns\n", numPairs, numTimes / time,
+        times[numTimes / 2] * 1e3, times[numTimes * 99 / 100] * 1e3,
+        times[numTimes * 999 / 1000] * 1e3);
+}
+
+/*
+ *  ======== compare ========
+ */
+static Int compare(const Void *a, const Void *b)
+{
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+
+    return (x < y ? -1 : x > y);
+}
+
+/*
+ *  ======== getMsgs ========
+ */
+static Void *getMsgs(Void *arg)
+{
+    Comm_Queue queue = queues[(Int)(IArg)arg];
+    Comm_Msg msg;
+    Int i;
+
+    for (i = 0; i < NUMPUTS; i++) {
+        Comm_get(queue, &msg, Comm_FOREVER);
+        Comm_free(msg);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== putMsgs ========
+ *  Put NUMPUTS messages, round-robin over the queues, so that each queue
+ *  gets as many as its getter takes.
+ */
+static Void *putMsgs(Void *arg)
+{
+    Int putter = (Int)(IArg)arg;
+    Comm_Msg msg;
+    double start;
+    Int i;
+
+    for (i = 0; i < NUMPUTS; i++) {
+        Comm_alloc(0, &msg, Comm_MSGSIZE);
+        start = Test_now();
+        Comm_put(queues[(putter + i) % numQueues], msg);
+        putTimes[putter][i] = Test_now() - start;
+    }
+
+    return (NULL);
+}
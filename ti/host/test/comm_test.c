@@ -0,0 +1,188 @@
+/*
+ *  ======== comm_test.c ========
+ *  Check the Comm queues' priority lanes and pollable descriptors, and
+ *  that the thread message caches serve steady allocation.
+ */
+#include <xdc/std.h>
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/osal/Comm.h>
+
+#include "test.h"
+
+#define NUMALLOCS       1000
+
+/*
+ *  ======== Msg ========
+ */
+typedef struct Msg {
+    Comm_MsgHeader header;
+    Int         seq;
+} Msg;
+
+static Void *allocMsgs(Void *arg);
+static Void checkCache(Void);
+static Void checkFd(Void);
+static Void checkLanes(Void);
+static Bool isReadable(Int fd);
+static Void putMsg(Comm_Queue queue, Int seq, Int priority);
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    CERuntime_init();
+
+    checkLanes();
+    checkFd();
+    checkCache();
+
+    CERuntime_exit();
+
+    return (Test_exit("comm_test"));
+}
+
+/*
+ *  ======== allocMsgs ========
+ */
+static Void *allocMsgs(Void *arg)
+{
+    Comm_Msg msg;
+    Int i;
+
+    for (i = 0; i < NUMALLOCS; i++) {
+        if (Comm_alloc(0, &msg, Comm_MSGSIZE) != Comm_EOK) {
+            Test_check(!"Comm_alloc failed");
+            break;
+        }
+        Comm_free(msg);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== checkCache ========
+ *  A thread allocating and freeing messages takes them from the pool
+ *  only once, and its hits are counted by the time it exits.
+ */
+static Void checkCache(Void)
+{
+    Comm_PoolStat before;
+    Comm_PoolStat after;
+    pthread_t thread;
+
+    Comm_poolStat(&before);
+    pthread_create(&thread, NULL, allocMsgs, NULL);
+    pthread_join(thread, NULL);
+    Comm_poolStat(&after);
+
+    Test_check(after.misses - before.misses == 1);
+    Test_check(after.hits - before.hits == NUMALLOCS - 1);
+    Test_check(after.numUnpooled == before.numUnpooled);
+    Test_check(after.numMsgs - after.numIdle == before.numMsgs -
+        before.numIdle);
+}
+
+/*
+ *  ======== checkFd ========
+ *  A queue's descriptor is readable exactly while messages wait.
+ */
+static Void checkFd(Void)
+{
+    Comm_Handle handle;
+    Comm_Queue queue;
+    Comm_Msg msg;
+    Int fd;
+
+    handle = Comm_create(NULL, &queue, NULL);
+    fd = Comm_getFd(handle);
+    Test_check(fd >= 0);
+    Test_check(!isReadable(fd));
+
+    putMsg(queue, 0, Comm_PRIORITYNORMAL);
+    putMsg(queue, 1, Comm_PRIORITYHIGH);
+    Test_check(isReadable(fd));
+
+    Test_check(Comm_get(queue, &msg, Comm_POLL) == Comm_EOK);
+    Comm_free(msg);
+    Test_check(isReadable(fd));
+
+    Test_check(Comm_get(queue, &msg, Comm_POLL) == Comm_EOK);
+    Comm_free(msg);
+    Test_check(!isReadable(fd));
+    Test_check(Comm_get(queue, &msg, Comm_POLL) == Comm_ETIMEOUT);
+
+    Comm_delete(handle);
+}
+
+/*
+ *  ======== checkLanes ========
+ *  High priority messages overtake the normal ones, and each lane keeps
+ *  the order of its puts.
+ */
+static Void checkLanes(Void)
+{
+    static Int expected[] = {10, 11, 12, 0, 1, 2, 3};
+    Comm_Handle handle;
+    Comm_Queue queue;
+    Comm_Msg msg;
+    Int i;
+
+    handle = Comm_create(NULL, &queue, NULL);
+    Test_check(handle != NULL);
+
+    putMsg(queue, 0, Comm_PRIORITYNORMAL);
+    putMsg(queue, 1, Comm_PRIORITYNORMAL);
+    putMsg(queue, 10, Comm_PRIORITYHIGH);
+    putMsg(queue, 2, Comm_PRIORITYNORMAL);
+    putMsg(queue, 11, Comm_PRIORITYHIGH);
+    putMsg(queue, 3, Comm_PRIORITYNORMAL);
+    putMsg(queue, 12, Comm_PRIORITYHIGH + 1);
+
+    for (i = 0; i < sizeof (expected) / sizeof (expected[0]); i++) {
+        if (Comm_get(queue, &msg, Comm_POLL) != Comm_EOK) {
+            Test_check(!"lanes lost a message");
+            break;
+        }
+        Test_check(((Msg *)msg)->seq == expected[i]);
+        Comm_free(msg);
+    }
+    Test_check(Comm_get(queue, &msg, Comm_POLL) == Comm_ETIMEOUT);
+
+    Comm_delete(handle);
+}
+
+/*
+ *  ======== isReadable ========
+ */
+static Bool isReadable(Int fd)
+{
+    struct pollfd pfd;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    return (poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN));
+}
+
+/*
+ *  ======== putMsg ========
+ */
+static Void putMsg(Comm_Queue queue, Int seq, Int priority)
+{
+    Comm_Msg msg;
+
+    if (Comm_alloc(0, &msg, sizeof (Msg)) != Comm_EOK) {
+        Test_check(!"Comm_alloc failed");
+        return;
+    }
+    ((Msg *)msg)->seq = seq;
+    Comm_setPriority(msg, priority);
+    Comm_put(queue, msg);
+}
@@ -0,0 +1,432 @@
+/*
+ *  ======== engine_bench.c ========
+ *  Time opening engines from many threads, privately or shared, the
+ *  round trip of local and remote calls, the latency of control calls
+ *  to a remote codec instance kept busy with process calls, that of
+ *  switching channels, with and without reusing released instances, the
+ *  frame and message rates of remote process calls made in batches, and
+ *  the rate of decoding frames for a sink, into an imported dma-buf of
+ *  the sink's or copied to it.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/speech1/sphdec1.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+
+#include "test.h"
+
+#define MAXTHREADS      16
+#define NUMCALLS        20000
+
+/* process calls kept in flight, and the one a control call takes */
+#define NUMINFLIGHT     4
+UInt VISA_numMsgs = NUMINFLIGHT;
+
+#define NUMFRAMES       1000
+#define FRAMETIME       2000    /* microseconds */
+#define CONTROLPERIOD   20      /* frames */
+
+#define NUMSWITCHES     1000
+
+/* 1080p 4:2:2 frames decoded for a sink */
+#define SINKFRAMESIZE   (1920 * 1080 * 2)
+#define NUMSINKFRAMES   200
+
+static Void benchBatch(Int batchSize);
+static Void benchCalls(String name);
+static Void benchControl(Bool drainFirst);
+static Void benchOpen(Int numThreads, Bool shared);
+static Void benchSink(Bool zeroCopy);
+static Void benchSwitch(String name, Bool reuse);
+static Void *openEngine(Void *arg);
+static UInt32 residentKBytes(Void);
+
+static Bool opened[MAXTHREADS];
+static Bool closing;
+static double openTimes[MAXTHREADS];
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    Int n;
+
+    CERuntime_init();
+
+    for (n = 1; n <= MAXTHREADS; n *= 2) {
+        benchOpen(n, FALSE);
+        benchOpen(n, TRUE);
+    }
+
+    benchCalls("local");
+    benchCalls("remote");
+
+    benchControl(TRUE);
+    benchControl(FALSE);
+
+    benchSwitch("local", FALSE);
+    benchSwitch("local", TRUE);
+    benchSwitch("remote", FALSE);
+    benchSwitch("remote", TRUE);
+
+    for (n = 1; n <= Test_MAXFRAMES; n *= 4) {
+        benchBatch(n);
+    }
+
+    benchSink(FALSE);
+    benchSink(TRUE);
+
+    CERuntime_exit();
+
+    return (0);
+}
+
+/*
+ *  ======== benchBatch ========
+ *  Time NUMCALLS frames of remote speech decoding, each frame a process
+ *  call of its own if batchSize is 1 and else in batches of batchSize,
+ *  and report the frames and messages sent per second.
+ */
+static Void benchBatch(Int batchSize)
+{
+    SPHDEC1_Params params = {sizeof (SPHDEC1_Params)};
+    Engine_Handle engine;
+    SPHDEC1_Handle sph;
+    Test_Batch batch;
+    Int numMsgs = Test_sphBatchMsgs;
+    Int numFrames;
+    double time;
+
+    engine = Engine_open("remote", NULL, NULL);
+    sph = SPHDEC1_create(engine, "sph", &params);
+    Test_allocBatch(&batch, batchSize, 64, sizeof (SPHDEC1_InArgs), FALSE);
+
+    time = Test_now();
+    for (numFrames = 0; numFrames < NUMCALLS; numFrames += batchSize) {
+        if (batchSize == 1) {
+            SPHDEC1_process(sph, &batch.inBufs[0], &batch.outBufs[0],
+                batch.inArgs[0], batch.outArgs[0]);
+        }
+        else {
+            SPHDEC1_processBatch(sph, batch.inBufs, batch.outBufs,
+                batch.inArgs, batch.outArgs, batchSize, batch.retVals);
+        }
+    }
+    time = Test_now() - time;
+
+    /* only batches are counted; each single call is one message */
+    numMsgs = batchSize == 1 ? numFrames : Test_sphBatchMsgs - numMsgs;
+    printf("remote batches of %3d: %.0f frames/s, %.0f msgs/s\n", batchSize,
+        numFrames * 1e6 / time, numMsgs * 1e6 / time);
+
+    Test_freeBatch(&batch);
+    SPHDEC1_delete(sph);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== benchCalls ========
+ *  Time synchronous process calls to a codec instance of an engine.
+ */
+static Void benchCalls(String name)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    double start;
+    Int i;
+
+    engine = Engine_open(name, NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_allocBufs(&bufs, 64);
+
+    start = Test_now();
+    for (i = 0; i < NUMCALLS; i++) {
+        VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs, &bufs.inArgs,
+            &bufs.outArgs);
+    }
+    printf("%s process call: %.2f us\n", name,
+        (Test_now() - start) / NUMCALLS);
+
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== benchControl ========
+ *  Keep NUMINFLIGHT process calls of FRAMETIME each in flight, making a
+ *  control call every CONTROLPERIOD frames, and report the frame rate
+ *  and the time the control calls take.  With drainFirst, the control
+ *  calls wait for the calls in flight first, as they did before they
+ *  could overtake them.
+ */
+static Void benchControl(Bool drainFirst)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    VIDDEC2_DynamicParams dynParams = {sizeof (VIDDEC2_DynamicParams)};
+    VIDDEC2_Status status;
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    Int numFrames = 0;
+    Int numInFlight = 0;
+    Int numControls = 0;
+    double controlTime = 0;
+    double worstTime = 0;
+    double start;
+    double time;
+
+    engine = Engine_open("remote", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_allocBufs(&bufs, 64);
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+    Test_decDelay = FRAMETIME;
+
+    start = Test_now();
+    while (numFrames < NUMFRAMES) {
+        while (numInFlight < NUMINFLIGHT) {
+            VIDDEC2_processAsync(dec, &bufs.inBufs, &bufs.outBufs,
+                &bufs.inArgs, &bufs.outArgs);
+            numInFlight++;
+        }
+        VIDDEC2_processWait(dec, &bufs.inBufs, &bufs.outBufs, &bufs.inArgs,
+            &bufs.outArgs, VISA_FOREVER);
+        numInFlight--;
+        numFrames++;
+
+        if (numFrames % CONTROLPERIOD == 0) {
+            time = Test_now();
+            while (drainFirst && numInFlight > 0) {
+                VIDDEC2_processWait(dec, &bufs.inBufs, &bufs.outBufs,
+                    &bufs.inArgs, &bufs.outArgs, VISA_FOREVER);
+                numInFlight--;
+                numFrames++;
+            }
+            VIDDEC2_control(dec, XDM_GETSTATUS, &dynParams, &status);
+            time = Test_now() - time;
+
+            controlTime += time;
+            worstTime = time > worstTime ? time : worstTime;
+            numControls++;
+        }
+    }
+    time = Test_now() - start;
+
+    while (numInFlight > 0) {
+        VIDDEC2_processWait(dec, &bufs.inBufs, &bufs.outBufs, &bufs.inArgs,
+            &bufs.outArgs, VISA_FOREVER);
+        numInFlight--;
+    }
+
+    printf("control %s: %.1f frames/s, control mean %.0f us, "
+        "worst %.0f us\n", drainFirst ? "after draining" : "overtaking",
+        numFrames * 1e6 / time, controlTime / numControls, worstTime);
+
+    Test_decDelay = 0;
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== benchOpen ========
+ *  Have numThreads threads open the remote engine, and report how long
+ *  their opens took and how much memory the process grew by.
+ */
+static Void benchOpen(Int numThreads, Bool shared)
+{
+    pthread_t threads[MAXTHREADS];
+    UInt32 resident = residentKBytes();
+    double openTime = 0;
+    Int i;
+
+    __atomic_store_n(&closing, FALSE, __ATOMIC_RELEASE);
+    for (i = 0; i < numThreads; i++) {
+        __atomic_store_n(&opened[i], FALSE, __ATOMIC_RELEASE);
+        pthread_create(&threads[i], NULL, openEngine,
+            (Void *)(IArg)(shared ? -1 - i : i));
+    }
+
+    /* measure while all of the engines are open */
+    for (i = 0; i < numThreads; i++) {
+        while (!__atomic_load_n(&opened[i], __ATOMIC_ACQUIRE)) {
+            usleep(1000);
+        }
+        openTime += openTimes[i];
+    }
+    resident = residentKBytes() - resident;
+
+    __atomic_store_n(&closing, TRUE, __ATOMIC_RELEASE);
+    for (i = 0; i < numThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    printf("%2d threads, %s: open %.1f us, %lu KB\n", numThreads,
+        shared ? "Engine_openShared" : "Engine_open      ",
+        openTime / numThreads, resident);
+}
+
+/*
+ *  ======== benchSink ========
+ *  Time remote decoding of frames for a sink, such as a display, whose
+ *  buffer is a dma-buf: here a memfd stands in for one.  With zeroCopy,
+ *  the dma-buf is imported and decoded into; else each frame is decoded
+ *  into a contiguous buffer and copied to the sink's mapping of it.
+ */
+static Void benchSink(Bool zeroCopy)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    XDAS_Int8 *outBuf;
+    XDAS_Int8 *sinkBuf;
+    XDAS_Int8 *imported = NULL;
+    double start;
+    Int fd;
+    Int i;
+
+    fd = memfd_create("engine_bench", MFD_CLOEXEC);
+    if (fd == -1 || ftruncate(fd, SINKFRAMESIZE) != 0 ||
+        (sinkBuf = (XDAS_Int8 *)mmap(NULL, SINKFRAMESIZE,
+        PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        printf("sink, %s: can't map a memfd\n",
+            zeroCopy ? "zero-copy" : "copying");
+        if (fd != -1) {
+            close(fd);
+        }
+        return;
+    }
+
+    engine = Engine_open("remote", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_allocBufs(&bufs, SINKFRAMESIZE);
+    bufs.inArgs.numBytes = SINKFRAMESIZE;
+
+    outBuf = bufs.outBuf[0];
+    if (zeroCopy) {
+        imported = (XDAS_Int8 *)Memory_importDmaBuf(fd, 0);
+        bufs.outBuf[0] = imported;
+    }
+
+    start = Test_now();
+    for (i = 0; i < NUMSINKFRAMES && bufs.outBuf[0] != NULL; i++) {
+        VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs, &bufs.inArgs,
+            &bufs.outArgs);
+        if (!zeroCopy) {
+            memcpy(sinkBuf, outBuf, SINKFRAMESIZE);
+        }
+    }
+    printf("sink, %s: %.1f frames/s\n", zeroCopy ? "zero-copy" : "copying",
+        i * 1e6 / (Test_now() - start));
+
+    if (imported != NULL) {
+        Memory_releaseDmaBuf(imported);
+    }
+    bufs.outBuf[0] = outBuf;
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+
+    munmap(sinkBuf, SINKFRAMESIZE);
+    close(fd);
+}
+
+/*
+ *  ======== benchSwitch ========
+ *  Time switching channels: ending a codec instance, creating the next
+ *  and decoding its first frame.  With reuse, the instance is released
+ *  rather than deleted, so the next create takes it back.
+ */
+static Void benchSwitch(String name, Bool reuse)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    double start;
+    Int i;
+
+    engine = Engine_open(name, NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_allocBufs(&bufs, 64);
+
+    start = Test_now();
+    for (i = 0; i < NUMSWITCHES; i++) {
+        if (reuse) {
+            VIDDEC2_release(dec);
+        }
+        else {
+            VIDDEC2_delete(dec);
+        }
+        dec = VIDDEC2_create(engine, "dec", &params);
+        VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs, &bufs.inArgs,
+            &bufs.outArgs);
+    }
+    printf("%s channel switch, %s: %.2f us\n", name,
+        reuse ? "reusing" : "recreating", (Test_now() - start) / NUMSWITCHES);
+
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== openEngine ========
+ *  Open the remote engine, shared if arg is negative, and keep it open
+ *  until benchOpen() is done measuring.
+ */
+static Void *openEngine(Void *arg)
+{
+    Int i = (Int)(IArg)arg;
+    Bool shared = i < 0;
+    Engine_Handle engine;
+    double start;
+
+    i = shared ? -1 - i : i;
+
+    start = Test_now();
+    engine = shared ? Engine_openShared("remote", NULL, NULL) :
+        Engine_open("remote", NULL, NULL);
+    openTimes[i] = Test_now() - start;
+    __atomic_store_n(&opened[i], TRUE, __ATOMIC_RELEASE);
+
+    while (!__atomic_load_n(&closing, __ATOMIC_ACQUIRE)) {
+        usleep(1000);
+    }
+    Engine_close(engine);
+
+    return (NULL);
+}
+
+/*
+ *  ======== residentKBytes ========
+ */
+static UInt32 residentKBytes(Void)
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    unsigned long size = 0;
+    unsigned long resident = 0;
+
+    if (file != NULL) {
+        if (fscanf(file, "%lu %lu", &size, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(file);
+    }
+
+    return (resident * (getpagesize() / 1024));
+}
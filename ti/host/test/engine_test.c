@@ -0,0 +1,565 @@
+/*
+ *  ======== engine_test.c ========
+ *  Check process calls to local and remote codec instances, their
+ *  pollable descriptors, shared engines, opened while the server creates
+ *  nodes, the order in which a remote codec instance serves its calls,
+ *  the reuse of released instances, and the sizing of the messages that
+ *  carry remote calls.
+ */
+#include <xdc/std.h>
+
+#include <poll.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/skel.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+#include <ti/sdo/ce/video2/_viddec2.h>
+
+#include "test.h"
+
+#define NUMTHREADS      8
+#define NUMOPENS        200
+
+/* args bigger than a pooled message, and bigger than any message */
+#define BIGARGSSIZE     (2 * 8192 + 1000)
+#define MAXMSGSIZE      0xffff
+
+/* seconds after which a deadlocked test is failed */
+#define WATCHDOG        60
+
+/* three calls in flight, and the process call made meanwhile */
+UInt VISA_numMsgs = 4;
+
+static Void checkCalls(String name);
+static Void checkFd(Void);
+static Void checkMsgSizes(Void);
+static Void checkOpenWhileCreating(Void);
+static Void checkOrder(Void);
+static Void checkReuse(Void);
+static Void checkShared(Void);
+static Void *createCodecs(Void *arg);
+static Bool isReadable(Int fd, Int timeout);
+static Void *openShared(Void *arg);
+static Void *useShared(Void *arg);
+static Void waitAll(VIDDEC2_Handle dec, Test_Bufs bufs[]);
+
+extern SKEL_Fxns VIDDEC2_SKEL;
+
+static Engine_Handle sharedEngines[NUMTHREADS];
+static Bool creating;
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    /* the default action of SIGALRM ends the process with a failure */
+    alarm(WATCHDOG);
+
+    CERuntime_init();
+
+    checkCalls("local");
+    checkCalls("remote");
+    checkFd();
+    checkShared();
+    checkOpenWhileCreating();
+    checkOrder();
+    checkReuse();
+    checkMsgSizes();
+
+    CERuntime_exit();
+
+    return (Test_exit("engine_test"));
+}
+
+/*
+ *  ======== checkCalls ========
+ *  Process calls to a codec instance of an engine run the alg on the
+ *  caller's buffers and return what it returned, along with the access
+ *  it reported to each buffer.
+ */
+static Void checkCalls(String name)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    Int i;
+
+    engine = Engine_open(name, NULL, NULL);
+    Test_check(engine != NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL);
+    if (dec == NULL) {
+        Engine_close(engine);
+        return;
+    }
+
+    Test_allocBufs(&bufs, 64);
+    for (i = 0; i < 64; i++) {
+        bufs.inBufs.descs[0].buf[i] = i;
+    }
+
+    for (i = 0; i < 3; i++) {
+        Test_check(VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs,
+            &bufs.inArgs, &bufs.outArgs) == i + 1);
+    }
+    Test_check(bufs.outArgs.bytesConsumed == 64);
+    Test_check(memcmp(bufs.outBuf[0], bufs.inBufs.descs[0].buf, 64) == 0);
+    Test_check(bufs.inBufs.descs[0].accessMask ==
+        1 << XDM_ACCESSMODE_READ);
+    Test_check(bufs.outArgs.decodedBufs.bufDesc[0].buf == bufs.outBuf[0]);
+    Test_check(bufs.outArgs.decodedBufs.bufDesc[0].accessMask ==
+        1 << XDM_ACCESSMODE_WRITE);
+
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkFd ========
+ *  A remote instance's descriptor is readable exactly while a completed
+ *  call waits to be collected, and a local instance has none.
+ */
+static Void checkFd(Void)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    Int fd;
+
+    engine = Engine_open("local", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL && VISA_getFd(dec) == -1);
+    if (dec != NULL) {
+        VIDDEC2_delete(dec);
+    }
+    Engine_close(engine);
+
+    engine = Engine_open("remote", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL);
+    if (dec == NULL) {
+        Engine_close(engine);
+        return;
+    }
+    Test_allocBufs(&bufs, 64);
+
+    fd = VISA_getFd(dec);
+    Test_check(fd >= 0);
+    Test_check(!isReadable(fd, 0));
+
+    Test_check(VIDDEC2_processAsync(dec, &bufs.inBufs, &bufs.outBufs,
+        &bufs.inArgs, &bufs.outArgs) == VIDDEC2_EOK);
+    Test_check(isReadable(fd, 5000));
+    Test_check(VIDDEC2_processWait(dec, &bufs.inBufs, &bufs.outBufs,
+        &bufs.inArgs, &bufs.outArgs, VISA_POLL) > 0);
+    Test_check(!isReadable(fd, 0));
+
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkMsgSizes ========
+ *  A remote instance's message grows to carry args bigger than the one
+ *  it has, in place while it can hold them, and carries the whole of
+ *  args bigger than Comm_MSGSIZE.  The skeleton fails a message too
+ *  small for the args whose sizes it claims.
+ */
+static Void checkMsgSizes(Void)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    VIDDEC2_DynamicParams dynParams = {sizeof (VIDDEC2_DynamicParams)};
+    VIDDEC2_Status *status;
+    VIDDEC2_InArgs *inArgs;
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    VISA_Msg small;
+    VISA_Msg msg;
+    Comm_Msg bad;
+    _VIDDEC2_Msg *badMsg;
+    IVIDDEC2_OutArgs *badOutArgs;
+    Test_Bufs bufs;
+    Int i;
+
+    engine = Engine_open("remote", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL);
+    if (dec == NULL) {
+        Engine_close(engine);
+        return;
+    }
+
+    /* with no calls in flight, each of these takes the same ring slot */
+    small = VISA_allocMsg2(dec, 100);
+    Test_check(small != NULL && Comm_getMsgSize((Comm_Msg)small) == 256);
+    msg = VISA_allocMsg2(dec, 3000);
+    Test_check(msg != NULL && Comm_getMsgSize((Comm_Msg)msg) == 3072);
+    Test_check(VISA_allocMsg2(dec, 8000) == msg);
+    Test_check(Comm_getMsgSize((Comm_Msg)msg) == 8192);
+
+    msg = VISA_allocMsg2(dec, BIGARGSSIZE);
+    Test_check(msg != NULL && Comm_getMsgSize((Comm_Msg)msg) >= BIGARGSSIZE);
+    Test_check(VISA_allocMsg2(dec, 100) == msg);
+    Test_check(Comm_getMsgSize((Comm_Msg)msg) == 256);
+    Test_check(VISA_allocMsg2(dec, BIGARGSSIZE) == msg);
+    Test_check(VISA_allocMsg2(dec, MAXMSGSIZE + 1) == NULL);
+
+    /* an extended status, and inArgs, bigger than Comm_MSGSIZE */
+    status = (VIDDEC2_Status *)calloc(1, BIGARGSSIZE);
+    status->size = BIGARGSSIZE;
+    Test_check(VIDDEC2_control(dec, XDM_GETSTATUS, &dynParams, status) ==
+        VIDDEC2_EOK);
+    for (i = sizeof (IVIDDEC2_Status); i < BIGARGSSIZE; i++) {
+        if (((UInt8 *)status)[i] != (UInt8)i) {
+            break;
+        }
+    }
+    Test_check(i == BIGARGSSIZE && status->size == BIGARGSSIZE);
+    Test_check(status->extendedError == 0);
+
+    Test_allocBufs(&bufs, 64);
+    inArgs = (VIDDEC2_InArgs *)calloc(1, BIGARGSSIZE);
+    inArgs->size = BIGARGSSIZE;
+    inArgs->numBytes = 64;
+    Test_check(VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs, inArgs,
+        &bufs.outArgs) == 1);
+    Test_check(bufs.outArgs.bytesConsumed == 64);
+
+    /* args claiming more than their message holds, in or out */
+    i = offsetof(_VIDDEC2_Msg, cmd.process.inArgs) +
+        sizeof (IVIDDEC2_InArgs) + sizeof (IVIDDEC2_OutArgs);
+    Test_check(Comm_alloc(0, &bad, i) == Comm_EOK);
+    badMsg = (_VIDDEC2_Msg *)bad;
+    badOutArgs = (IVIDDEC2_OutArgs *)(&(badMsg->cmd.process.inArgs) + 1);
+
+    badMsg->visa.cmd = _VIDDEC2_CPROCESS;
+    badMsg->cmd.process.inArgs.size = BIGARGSSIZE;
+    Test_check(VIDDEC2_SKEL.call(dec, (VISA_Msg)bad) == VISA_EFAIL &&
+        badMsg->visa.status == VISA_EFAIL);
+
+    badMsg->cmd.process.inArgs.size = sizeof (IVIDDEC2_InArgs);
+    badOutArgs->size = sizeof (IVIDDEC2_OutArgs) + 1;
+    Test_check(VIDDEC2_SKEL.call(dec, (VISA_Msg)bad) == VISA_EFAIL);
+
+    badMsg->visa.cmd = _VIDDEC2_CCONTROL;
+    badMsg->cmd.control.params.size = BIGARGSSIZE;
+    Test_check(VIDDEC2_SKEL.call(dec, (VISA_Msg)bad) == VISA_EFAIL);
+    Comm_free(bad);
+
+    free(inArgs);
+    free(status);
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkOpenWhileCreating ========
+ *  Shared opens, each a round trip to the server, made while another
+ *  thread creates codecs, whose nodes the server creates by opening the
+ *  local engine.
+ */
+static Void checkOpenWhileCreating(Void)
+{
+    pthread_t creator;
+    pthread_t opener;
+    Engine_Handle engine;
+
+    engine = Engine_open("remote", NULL, NULL);
+    Test_check(engine != NULL);
+
+    __atomic_store_n(&creating, TRUE, __ATOMIC_RELEASE);
+    pthread_create(&creator, NULL, createCodecs, engine);
+    pthread_create(&opener, NULL, openShared, NULL);
+
+    pthread_join(opener, NULL);
+    __atomic_store_n(&creating, FALSE, __ATOMIC_RELEASE);
+    pthread_join(creator, NULL);
+
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkOrder ========
+ *  A process call completes after the calls in flight before it, and a
+ *  control call overtakes them.
+ */
+static Void checkOrder(Void)
+{
+    static XDAS_Int32 expected[] = {1, 2, 3, 99, 1, Test_LOGCONTROL, 2, 3};
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    VIDDEC2_DynamicParams dynParams = {sizeof (VIDDEC2_DynamicParams)};
+    VIDDEC2_Status status;
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs[4];
+    Int i;
+
+    engine = Engine_open("remote", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL);
+    if (dec == NULL) {
+        Engine_close(engine);
+        return;
+    }
+
+    for (i = 0; i < 4; i++) {
+        Test_allocBufs(&bufs[i], 64);
+        bufs[i].inArgs.numBytes = i < 3 ? i + 1 : 99;
+    }
+
+    /* there is nothing to wait for yet */
+    Test_check(VIDDEC2_processWait(dec, &bufs[0].inBufs, &bufs[0].outBufs,
+        &bufs[0].inArgs, &bufs[0].outArgs, VISA_POLL) == VIDDEC2_EFAIL);
+
+    Test_decDelay = 5000;
+    Test_decLogLen = 0;
+
+    for (i = 0; i < 3; i++) {
+        Test_check(VIDDEC2_processAsync(dec, &bufs[i].inBufs,
+            &bufs[i].outBufs, &bufs[i].inArgs, &bufs[i].outArgs) ==
+            VIDDEC2_EOK);
+    }
+    Test_check(VIDDEC2_process(dec, &bufs[3].inBufs, &bufs[3].outBufs,
+        &bufs[3].inArgs, &bufs[3].outArgs) > 0);
+    waitAll(dec, bufs);
+
+    for (i = 0; i < 3; i++) {
+        Test_check(VIDDEC2_processAsync(dec, &bufs[i].inBufs,
+            &bufs[i].outBufs, &bufs[i].inArgs, &bufs[i].outArgs) ==
+            VIDDEC2_EOK);
+    }
+    memset(&status, 0, sizeof (status));
+    status.size = sizeof (status);
+    Test_check(VIDDEC2_control(dec, XDM_GETSTATUS, &dynParams, &status) ==
+        VIDDEC2_EOK);
+    waitAll(dec, bufs);
+
+    /* the control may overtake the first call too, if it hadn't started */
+    Test_check(Test_decLogLen == sizeof (expected) / sizeof (expected[0]));
+    if (Test_decLog[4] == Test_LOGCONTROL) {
+        Test_decLog[4] = Test_decLog[5];
+        Test_decLog[5] = Test_LOGCONTROL;
+    }
+    for (i = 0; i < Test_decLogLen && i < Test_MAXLOG; i++) {
+        Test_check(Test_decLog[i] == expected[i]);
+    }
+    Test_decDelay = 0;
+
+    for (i = 0; i < 4; i++) {
+        Test_freeBufs(&bufs[i]);
+    }
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== checkReuse ========
+ *  A released instance is handed to the next creator asking for the same
+ *  alg and params, and its memory is then charged to that creator; one
+ *  asking for other params gets a new instance.
+ */
+static Void checkReuse(Void)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Memory_AccountStat stat;
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    VIDDEC2_Handle other;
+    Int first = Memory_createAccount(Memory_NOACCOUNT);
+    Int second = Memory_createAccount(Memory_NOACCOUNT);
+    Int prev;
+
+    engine = Engine_open("local", NULL, NULL);
+    Test_check(engine != NULL);
+
+    prev = Memory_setAccount(first);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL);
+    Test_check(Memory_getAccountStat(first, &stat) && stat.used > 0);
+    VIDDEC2_release(dec);
+
+    Memory_setAccount(second);
+    Test_check(VIDDEC2_create(engine, "dec", &params) == dec);
+    Test_check(Memory_getAccountStat(first, &stat) && stat.used == 0);
+    Test_check(Memory_getAccountStat(second, &stat) && stat.used > 0);
+
+    params.maxWidth = 720;
+    other = VIDDEC2_create(engine, "dec", &params);
+    Test_check(other != NULL && other != dec);
+    Memory_setAccount(prev);
+
+    VIDDEC2_delete(other);
+    VIDDEC2_delete(dec);
+    Test_check(Memory_getAccountStat(second, &stat) && stat.used == 0);
+    Engine_close(engine);
+
+    Memory_deleteAccount(second);
+    Memory_deleteAccount(first);
+}
+
+/*
+ *  ======== checkShared ========
+ *  Threads opening an engine at once share one handle, which lasts until
+ *  the last of them closes it.
+ */
+static Void checkShared(Void)
+{
+    pthread_t threads[NUMTHREADS];
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Int i;
+
+    for (i = 0; i < NUMTHREADS; i++) {
+        pthread_create(&threads[i], NULL, useShared, (Void *)(IArg)i);
+    }
+    for (i = 0; i < NUMTHREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < NUMTHREADS; i++) {
+        Test_check(sharedEngines[i] != NULL);
+        Test_check(sharedEngines[i] == sharedEngines[0]);
+    }
+
+    /* the last close closed it, so this opens another */
+    engine = Engine_openShared("remote", NULL, NULL);
+    Test_check(engine != NULL);
+    Test_check(Engine_openShared("remote", NULL, NULL) == engine);
+    Engine_close(engine);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    Test_check(dec != NULL);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+
+    Test_check(Engine_openShared("nosuchengine", NULL, NULL) == NULL);
+}
+
+/*
+ *  ======== createCodecs ========
+ */
+static Void *createCodecs(Void *arg)
+{
+    Engine_Handle engine = (Engine_Handle)arg;
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    VIDDEC2_Handle dec;
+
+    while (__atomic_load_n(&creating, __ATOMIC_ACQUIRE)) {
+        if ((dec = VIDDEC2_create(engine, "dec", &params)) == NULL) {
+            Test_check(!"VIDDEC2_create failed");
+            break;
+        }
+        VIDDEC2_delete(dec);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== isReadable ========
+ *  Whether fd becomes readable within timeout milliseconds.
+ */
+static Bool isReadable(Int fd, Int timeout)
+{
+    struct pollfd pfd;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    return (poll(&pfd, 1, timeout) == 1 && (pfd.revents & POLLIN));
+}
+
+/*
+ *  ======== openShared ========
+ *  Open and close engines under new procIds, so each open calls the
+ *  server.
+ */
+static Void *openShared(Void *arg)
+{
+    Engine_Attrs attrs = Engine_ATTRS;
+    Engine_Handle engine;
+    Char procId[16];
+    Int i;
+
+    for (i = 0; i < NUMOPENS; i++) {
+        sprintf(procId, "proc%d", i);
+        attrs.procId = procId;
+        if ((engine = Engine_openShared("remote", &attrs, NULL)) == NULL) {
+            Test_check(!"Engine_openShared failed");
+            break;
+        }
+        Engine_close(engine);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== useShared ========
+ */
+static Void *useShared(Void *arg)
+{
+    Int i = (Int)(IArg)arg;
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    Int k;
+
+    engine = Engine_openShared("remote", NULL, NULL);
+    sharedEngines[i] = engine;
+    if (engine == NULL) {
+        return (NULL);
+    }
+
+    Test_allocBufs(&bufs, 64);
+    if ((dec = VIDDEC2_create(engine, "dec", &params)) != NULL) {
+        for (k = 0; k < 20; k++) {
+            Test_check(VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs,
+                &bufs.inArgs, &bufs.outArgs) == k + 1);
+        }
+        VIDDEC2_delete(dec);
+    }
+    else {
+        Test_check(!"VIDDEC2_create failed");
+    }
+    Test_freeBufs(&bufs);
+
+    /* wait for the others to have opened it before closing it */
+    sleep(1);
+    Engine_close(engine);
+
+    return (NULL);
+}
+
+/*
+ *  ======== waitAll ========
+ *  Collect the three calls in flight, in the order they were made.
+ */
+static Void waitAll(VIDDEC2_Handle dec, Test_Bufs bufs[])
+{
+    Int i;
+
+    for (i = 0; i < 3; i++) {
+        bufs[i].outArgs.bytesConsumed = 0;
+        Test_check(VIDDEC2_processWait(dec, &bufs[i].inBufs,
+            &bufs[i].outBufs, &bufs[i].inArgs, &bufs[i].outArgs,
+            VISA_FOREVER) > 0);
+        Test_check(bufs[i].outArgs.bytesConsumed == i + 1);
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ *  ======== index_bench.c ========
+ *  Time the startup of the runtime and its lookups of algs by name, with
+ *  tables of NUMALGS algs, both with the runtime's indices and, in a
+ *  child process whose indices fail to allocate, with the scans they
+ *  fall back to.
+ */
+#include <xdc/std.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+
+#include "test.h"
+
+#define NUMALGS         1000
+#define NUMROUNDS       100
+
+static Void benchLookups(String how);
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    pid_t pid;
+
+    Test_addAlgs(NUMALGS);
+
+    if ((pid = fork()) == 0) {
+        Test_failIndices = TRUE;
+        benchLookups("scanning");
+        fflush(stdout);
+        _exit(0);
+    }
+    waitpid(pid, NULL, 0);
+
+    benchLookups("indexed");
+
+    return (0);
+}
+
+/*
+ *  ======== benchLookups ========
+ *  Time starting the runtime and opening an engine, which starts the
+ *  server, and then looking up each of the engine's algs NUMROUNDS times.
+ */
+static Void benchLookups(String how)
+{
+    Engine_Handle engine;
+    Char names[NUMALGS][16];
+    Ptr idmaFxns;
+    Ptr iresFxns;
+    Int groupId;
+    Bool isLocal;
+    double start;
+    double startup;
+    Int i;
+    Int n;
+
+    for (i = 0; i < NUMALGS; i++) {
+        snprintf(names[i], sizeof (names[i]), "alg%d", i);
+    }
+
+    start = Test_now();
+    CERuntime_init();
+    engine = Engine_open("remote", NULL, NULL);
+    startup = Test_now() - start;
+
+    start = Test_now();
+    for (n = 0; n < NUMROUNDS; n++) {
+        for (i = 0; i < NUMALGS; i++) {
+            Engine_getFxns(engine, names[i], "ti.sdo.ce.video2.IVIDDEC2",
+                &isLocal, &idmaFxns, &iresFxns, &groupId);
+        }
+    }
+    printf("%s, %d algs: startup %.0f us, alg lookup %.1f ns\n", how,
+        NUMALGS, startup, (Test_now() - start) * 1e3 / NUMROUNDS / NUMALGS);
+
+    Engine_close(engine);
+    CERuntime_exit();
+}
@@ -0,0 +1,119 @@
+/*
+ *  ======== index_test.c ========
+ *  Check the lookups of engines, algs and server nodes by name, with the
+ *  runtime's indices and, in a child process whose indices fail to
+ *  allocate, with the scans they fall back to.
+ */
+#include <xdc/std.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+
+#include "test.h"
+
+#define NUMALGS         1000
+
+#define AUDTYPE         "ti.sdo.ce.audio1.IAUDDEC1"
+#define DECTYPE         "ti.sdo.ce.video2.IVIDDEC2"
+
+static Void checkLookups(Void);
+static Bool hasAlg(Engine_Handle engine, String name, String type,
+    Bool *isLocal);
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    Int status;
+    pid_t pid;
+
+    Test_addAlgs(NUMALGS);
+
+    if ((pid = fork()) == 0) {
+        Test_failIndices = TRUE;
+        checkLookups();
+        status = Test_exit("index_test, scanning");
+        fflush(stdout);
+        _exit(status);
+    }
+    Test_check(pid > 0);
+
+    checkLookups();
+
+    Test_check(waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+        WEXITSTATUS(status) == 0);
+
+    return (Test_exit("index_test"));
+}
+
+/*
+ *  ======== checkLookups ========
+ *  Every name is found, in a table of NUMALGS, and only in its table;
+ *  the first of two algs or nodes with the same name is the one found,
+ *  even if it isn't of the type asked for.
+ */
+static Void checkLookups(Void)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle local;
+    Engine_Handle remote;
+    VIDDEC2_Handle dec;
+    Char name[16];
+    Bool isLocal;
+    Int i;
+
+    CERuntime_init();
+
+    local = Engine_open("local", NULL, NULL);
+    remote = Engine_open("remote", NULL, NULL);
+    Test_check(local != NULL && remote != NULL);
+    Test_check(Engine_open("alg0", NULL, NULL) == NULL);
+
+    Test_check(hasAlg(local, "dec", DECTYPE, &isLocal) && isLocal);
+    Test_check(!hasAlg(local, "dec", AUDTYPE, &isLocal));
+    Test_check(!hasAlg(remote, "dec", AUDTYPE, &isLocal));
+
+    for (i = 0; i < NUMALGS; i++) {
+        snprintf(name, sizeof (name), "alg%d", i);
+        Test_check(hasAlg(local, name, NULL, &isLocal) && isLocal);
+        Test_check(hasAlg(remote, name, DECTYPE, &isLocal) && !isLocal);
+    }
+    snprintf(name, sizeof (name), "alg%d", NUMALGS);
+    Test_check(!hasAlg(local, name, NULL, &isLocal));
+    Test_check(!hasAlg(local, "local", NULL, &isLocal));
+
+    /* the server's second "dec" node can't create a video decoder */
+    dec = VIDDEC2_create(remote, "dec", &params);
+    Test_check(dec != NULL);
+    VIDDEC2_delete(dec);
+
+    snprintf(name, sizeof (name), "alg%d", NUMALGS - 1);
+    dec = VIDDEC2_create(remote, name, &params);
+    Test_check(dec != NULL);
+    VIDDEC2_delete(dec);
+
+    Engine_close(remote);
+    Engine_close(local);
+
+    CERuntime_exit();
+}
+
+/*
+ *  ======== hasAlg ========
+ */
+static Bool hasAlg(Engine_Handle engine, String name, String type,
+    Bool *isLocal)
+{
+    Ptr idmaFxns;
+    Ptr iresFxns;
+    Int groupId;
+
+    return (Engine_getFxns(engine, name, type, isLocal, &idmaFxns,
+        &iresFxns, &groupId) != NULL);
+}
@@ -0,0 +1,148 @@
+/*
+ *  ======== link_bench.c ========
+ *  Time remote process calls to a server in another process, through
+ *  the shared memory link, one at a time and pipelined.
+ *
+ *  The program forks the server, which runs the skeletons of RMS_nodeTab
+ *  until the client closes the pipe between them.
+ */
+#include <xdc/std.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/rms.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+
+#include "test.h"
+
+#define NUMCALLS        20000
+
+/* process calls kept in flight when pipelined */
+#define NUMINFLIGHT     2
+UInt VISA_numMsgs = NUMINFLIGHT;
+
+static Void benchCalls(Int numInFlight);
+static Void serve(Int readyFd, Int doneFd);
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    Int ready[2];
+    Int done[2];
+    pid_t server;
+    Char c;
+
+    Comm_shmName = "/ce_link_bench";
+    Memory_emulatedHeapName = "/ce_link_bench_heap";
+
+    if (pipe(ready) != 0 || pipe(done) != 0) {
+        return (1);
+    }
+    if ((server = fork()) == 0) {
+        close(ready[0]);
+        close(done[1]);
+        serve(ready[1], done[0]);
+        _exit(0);
+    }
+    close(ready[1]);
+    close(done[0]);
+
+    /* the client attaches to the link the server created */
+    if (server < 0 || read(ready[0], &c, 1) != 1) {
+        printf("link_bench: server failed to start\n");
+        return (1);
+    }
+
+    Memory_emulateCmem = TRUE;
+    CERuntime_init();
+
+    benchCalls(1);
+    benchCalls(NUMINFLIGHT);
+
+    CERuntime_exit();
+
+    close(done[1]);
+    waitpid(server, NULL, 0);
+
+    return (0);
+}
+
+/*
+ *  ======== benchCalls ========
+ *  Time process calls with numInFlight of them in flight at a time.
+ */
+static Void benchCalls(Int numInFlight)
+{
+    VIDDEC2_Params params = {sizeof (VIDDEC2_Params)};
+    Engine_Handle engine;
+    VIDDEC2_Handle dec;
+    Test_Bufs bufs;
+    double start;
+    Int i;
+
+    engine = Engine_open("remote", NULL, NULL);
+    dec = VIDDEC2_create(engine, "dec", &params);
+    if (dec == NULL) {
+        printf("link_bench: no codec instance on the server\n");
+        Engine_close(engine);
+        return;
+    }
+    Test_allocBufs(&bufs, 64);
+
+    start = Test_now();
+    if (numInFlight == 1) {
+        for (i = 0; i < NUMCALLS; i++) {
+            VIDDEC2_process(dec, &bufs.inBufs, &bufs.outBufs, &bufs.inArgs,
+                &bufs.outArgs);
+        }
+    }
+    else {
+        for (i = 0; i < numInFlight; i++) {
+            VIDDEC2_processAsync(dec, &bufs.inBufs, &bufs.outBufs,
+                &bufs.inArgs, &bufs.outArgs);
+        }
+        for (i = 0; i < NUMCALLS; i++) {
+            VIDDEC2_processWait(dec, &bufs.inBufs, &bufs.outBufs,
+                &bufs.inArgs, &bufs.outArgs, VISA_FOREVER);
+            if (i + numInFlight < NUMCALLS) {
+                VIDDEC2_processAsync(dec, &bufs.inBufs, &bufs.outBufs,
+                    &bufs.inArgs, &bufs.outArgs);
+            }
+        }
+    }
+    printf("linked process call, %d in flight: %.2f us\n", numInFlight,
+        (Test_now() - start) / NUMCALLS);
+
+    Test_freeBufs(&bufs);
+    VIDDEC2_delete(dec);
+    Engine_close(engine);
+}
+
+/*
+ *  ======== serve ========
+ */
+static Void serve(Int readyFd, Int doneFd)
+{
+    Char c = 0;
+
+    Comm_shmServer = TRUE;
+    CERuntime_init();
+    RMS_init();
+
+    if (write(readyFd, &c, 1) == 1) {
+        while (read(doneFd, &c, 1) > 0) {
+        }
+    }
+
+    RMS_exit();
+    CERuntime_exit();
+}
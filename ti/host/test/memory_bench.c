@@ -0,0 +1,447 @@
+/*
+ *  ======== memory_bench.c ========
+ *  Time the contiguous memory paths: address translation against the
+ *  index of known buffers and, for their base addresses, the table of
+ *  registered ones, pooled and heap allocation, frame sweeps with and
+ *  without huge pages, and pooled allocation by many threads.
+ *
+ *  The frame sweeps also count data TLB misses, where the kernel lets the
+ *  process open a perf event counter for them.
+ */
+#include <xdc/std.h>
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include "test.h"
+
+#define HEAPSIZE        (64 * 1024 * 1024)
+
+/* a 1080p 4:2:2 frame, and a pipeline's worth of them */
+#define FRAMESIZE       (1920 * 1080 * 2)
+#define NUMFRAMES       8
+
+#define REGBUFSIZE      (64 * 1024)
+#define REGPHYSBASE     0x40000000
+
+#define NUMLOOKUPS      1000000
+#define NUMPOOLALLOCS   1000000
+#define NUMCHURNS       100000
+#define NUMLIVEBLOCKS   16
+#define NUMTHREADALLOCS 1000000
+
+UInt32 Memory_contigHeapSize = HEAPSIZE;
+
+static Void *allocBufs(Void *arg);
+static Void benchHeap(Void);
+static Void benchHugePages(Void);
+static Void benchIndex(Int numBufs);
+static Void benchPool(Void);
+static Void benchRegistered(Int numBufs);
+static Void benchThreads(Int numThreads);
+static Int openTlbCounter(Void);
+static Void startTlbCounter(Int fd);
+static Void stopTlbCounter(Int fd, Char *buf, UInt size, double per);
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    Int n;
+
+    Memory_init();
+
+    for (n = 10; n <= 1000; n *= 10) {
+        benchIndex(n);
+    }
+    for (n = 10; n <= 1000; n *= 10) {
+        benchRegistered(n);
+    }
+    benchPool();
+    benchHeap();
+    for (n = 1; n <= 16; n *= 2) {
+        benchThreads(n);
+    }
+
+    Memory_exit();
+
+    benchHugePages();
+
+    return (0);
+}
+
+/*
+ *  ======== allocBufs ========
+ *  Allocate and free NUMTHREADALLOCS small pooled buffers, four at a
+ *  time.
+ */
+static Void *allocBufs(Void *arg)
+{
+    Memory_AllocParams params = Memory_DEFAULTPARAMS;
+    Ptr bufs[4];
+    Int i;
+    Int k;
+
+    params.type = Memory_CONTIGPOOL;
+
+    for (i = 0; i < NUMTHREADALLOCS / 4; i++) {
+        for (k = 0; k < 4; k++) {
+            bufs[k] = Memory_alloc(4000, &params);
+        }
+        for (k = 0; k < 4; k++) {
+            Memory_free(bufs[k], 4000, &params);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== benchHeap ========
+ *  Churn the buddy heap with blocks of up to a frame, reporting how many
+ *  allocations succeed, how long they take and how fragmented the heap
+ *  gets, for each tenth of the run.
+ */
+static Void benchHeap(Void)
+{
+    Memory_AllocParams params = Memory_DEFAULTPARAMS;
+    Memory_HeapStat stat;
+    Ptr bufs[NUMLIVEBLOCKS];
+    UInt sizes[NUMLIVEBLOCKS];
+    Int numFailed = 0;
+    double time = 0;
+    double start;
+    Int i;
+    Int k;
+
+    params.type = Memory_CONTIGHEAP;
+    memset(bufs, 0, sizeof (bufs));
+    srand(1);
+
+    printf("heap churn, %d MB, %d blocks of up to %d bytes:\n",
+        HEAPSIZE >> 20, NUMLIVEBLOCKS, FRAMESIZE);
+    for (k = 1; k <= NUMCHURNS; k++) {
+        i = rand() % NUMLIVEBLOCKS;
+        if (bufs[i] != NULL) {
+            Memory_free(bufs[i], sizes[i], &params);
+        }
+        sizes[i] = 1 + rand() % FRAMESIZE;
+
+        start = Test_now();
+        bufs[i] = Memory_alloc(sizes[i], &params);
+        time += Test_now() - start;
+        if (bufs[i] == NULL) {
+            numFailed++;
+        }
+
+        if (k % (NUMCHURNS / 10) == 0) {
+            Memory_contigHeapStat(&stat);
+            printf("  %6d allocs: %5.1f%% failed, %5.2f us each, "
+                "used %3lu MB, largest free %3lu MB, fragmentation %d%%\n",
+                k, numFailed * 100.0 / (NUMCHURNS / 10),
+                time / (NUMCHURNS / 10), stat.used >> 20,
+                stat.largestFree >> 20, stat.fragmentation);
+            numFailed = 0;
+            time = 0;
+        }
+    }
+
+    for (i = 0; i < NUMLIVEBLOCKS; i++) {
+        if (bufs[i] != NULL) {
+            Memory_free(bufs[i], sizes[i], &params);
+        }
+    }
+}
+
+/*
+ *  ======== benchHugePages ========
+ *  Copy frames, and walk them down their columns as a rotation would,
+ *  which takes a TLB miss per row without huge pages.  Report the copy
+ *  throughput and the TLB misses per MB copied, and the time and TLB
+ *  misses per row walked.
+ */
+static Void benchHugePages(Void)
+{
+    UInt8 *frames[NUMFRAMES];
+    volatile UInt32 sum = 0;
+    Int tlbFd = openTlbCounter();
+    Char copyMisses[32];
+    Char walkMisses[32];
+    double copyTime;
+    double walkTime;
+    double start;
+    Int huge;
+    Int i;
+    Int x;
+    Int y;
+
+    for (huge = 0; huge < 2; huge++) {
+        Memory_hugePageMinSize = huge ? 1024 * 1024 : 0;
+        Memory_init();
+
+        for (i = 0; i < NUMFRAMES; i++) {
+            frames[i] = (UInt8 *)Memory_contigAlloc(FRAMESIZE, 0);
+            memset(frames[i], i, FRAMESIZE);
+        }
+
+        startTlbCounter(tlbFd);
+        start = Test_now();
+        for (i = 0; i < 10 * NUMFRAMES; i++) {
+            memcpy(frames[(i + 1) % NUMFRAMES], frames[i % NUMFRAMES],
+                FRAMESIZE);
+        }
+        copyTime = Test_now() - start;
+        stopTlbCounter(tlbFd, copyMisses, sizeof (copyMisses),
+            10.0 * NUMFRAMES * FRAMESIZE / (1024 * 1024));
+
+        startTlbCounter(tlbFd);
+        start = Test_now();
+        for (i = 0; i < NUMFRAMES; i++) {
+            for (x = 0; x < 1920 * 2; x += 64) {
+                for (y = 0; y < 1080; y++) {
+                    sum += frames[i][y * 1920 * 2 + x];
+                }
+            }
+        }
+        walkTime = Test_now() - start;
+        stopTlbCounter(tlbFd, walkMisses, sizeof (walkMisses),
+            NUMFRAMES * 60 * 1080);
+
+        printf("%s pages: frame copy %.2f GB/s, TLB misses/MB %s; "
+            "column walk %.2f ns/row, TLB misses/row %s\n",
+            huge ? "huge" : "4 KB", 10.0 * NUMFRAMES * FRAMESIZE /
+            copyTime / 1e3, copyMisses,
+            walkTime * 1e3 / (NUMFRAMES * 60 * 1080), walkMisses);
+
+        for (i = 0; i < NUMFRAMES; i++) {
+            Memory_contigFree(frames[i], FRAMESIZE);
+        }
+        Memory_exit();
+    }
+
+    if (tlbFd >= 0) {
+        close(tlbFd);
+    }
+}
+
+/*
+ *  ======== benchIndex ========
+ *  Translate addresses both ways with numBufs buffers registered.
+ */
+static Void benchIndex(Int numBufs)
+{
+    UInt8 **bufs = (UInt8 **)malloc(numBufs * sizeof (UInt8 *));
+    volatile UInt32 sum = 0;
+    double virtToPhys;
+    double physToVirt;
+    double start;
+    Int i;
+
+    for (i = 0; i < numBufs; i++) {
+        bufs[i] = (UInt8 *)malloc(REGBUFSIZE);
+        Memory_registerContigBuf((UInt32)bufs[i], REGBUFSIZE,
+            REGPHYSBASE + i * 2 * REGBUFSIZE);
+    }
+
+    start = Test_now();
+    for (i = 0; i < NUMLOOKUPS; i++) {
+        sum += Memory_getBufferPhysicalAddress(bufs[(i * 7) % numBufs] +
+            i % REGBUFSIZE, 1, NULL);
+    }
+    virtToPhys = (Test_now() - start) * 1e3 / NUMLOOKUPS;
+
+    start = Test_now();
+    for (i = 0; i < NUMLOOKUPS; i++) {
+        sum += (UInt32)Memory_getBufferVirtualAddress(REGPHYSBASE +
+            ((i * 7) % numBufs) * 2 * REGBUFSIZE + i % REGBUFSIZE, 1);
+    }
+    physToVirt = (Test_now() - start) * 1e3 / NUMLOOKUPS;
+
+    printf("%4d buffers registered: virt->phys %6.1f ns, "
+        "phys->virt %6.1f ns\n", numBufs, virtToPhys, physToVirt);
+
+    for (i = 0; i < numBufs; i++) {
+        Memory_unregisterContigBuf((UInt32)bufs[i], REGBUFSIZE);
+        free(bufs[i]);
+    }
+    free(bufs);
+}
+
+/*
+ *  ======== benchPool ========
+ *  Allocate and free frames, which the pool recycles.
+ */
+static Void benchPool(Void)
+{
+    Memory_PoolStat stat;
+    Ptr frames[4];
+    double start;
+    Int i;
+    Int k;
+
+    Memory_poolReserve(FRAMESIZE, 4);
+
+    start = Test_now();
+    for (i = 0; i < NUMPOOLALLOCS / 4; i++) {
+        for (k = 0; k < 4; k++) {
+            frames[k] = Memory_contigAlloc(FRAMESIZE, 0);
+        }
+        for (k = 0; k < 4; k++) {
+            Memory_contigFree(frames[k], FRAMESIZE);
+        }
+    }
+    Memory_poolStat(&stat);
+
+    printf("pooled frame alloc+free: %.1f ns, %lu hits, %lu misses\n",
+        (Test_now() - start) * 1e3 / NUMPOOLALLOCS, stat.hits, stat.misses);
+}
+
+/*
+ *  ======== benchRegistered ========
+ *  Translate the base addresses of numBufs known buffers both ways, as
+ *  the stubs do a process call's buffers, before and after registering
+ *  them with Memory_registerBuf().
+ */
+static Void benchRegistered(Int numBufs)
+{
+    UInt8 **bufs = (UInt8 **)malloc(numBufs * sizeof (UInt8 *));
+    Memory_BufHandle *handles = (Memory_BufHandle *)malloc(numBufs *
+        sizeof (Memory_BufHandle));
+    volatile UInt32 sum = 0;
+    double times[2][2];
+    double start;
+    Int pass;
+    Int i;
+
+    for (i = 0; i < numBufs; i++) {
+        bufs[i] = (UInt8 *)malloc(REGBUFSIZE);
+        Memory_registerContigBuf((UInt32)bufs[i], REGBUFSIZE,
+            REGPHYSBASE + i * 2 * REGBUFSIZE);
+    }
+
+    for (pass = 0; pass < 2; pass++) {
+        start = Test_now();
+        for (i = 0; i < NUMLOOKUPS; i++) {
+            sum += Memory_getBufferPhysicalAddress(bufs[(i * 7) % numBufs],
+                REGBUFSIZE, NULL);
+        }
+        times[pass][0] = (Test_now() - start) * 1e3 / NUMLOOKUPS;
+
+        start = Test_now();
+        for (i = 0; i < NUMLOOKUPS; i++) {
+            sum += (UInt32)Memory_getBufferVirtualAddress(REGPHYSBASE +
+                ((i * 7) % numBufs) * 2 * REGBUFSIZE, REGBUFSIZE);
+        }
+        times[pass][1] = (Test_now() - start) * 1e3 / NUMLOOKUPS;
+
+        for (i = 0; pass == 0 && i < numBufs; i++) {
+            handles[i] = Memory_registerBuf(bufs[i], REGBUFSIZE);
+        }
+    }
+
+    printf("%4d buffers, base addresses: virt->phys %6.1f ns, "
+        "registered %5.1f ns; phys->virt %6.1f ns, registered %5.1f ns\n",
+        numBufs, times[0][0], times[1][0], times[0][1], times[1][1]);
+
+    for (i = 0; i < numBufs; i++) {
+        Memory_unregisterBuf(handles[i]);
+        Memory_unregisterContigBuf((UInt32)bufs[i], REGBUFSIZE);
+        free(bufs[i]);
+    }
+    free(handles);
+    free(bufs);
+}
+
+/*
+ *  ======== benchThreads ========
+ *  Allocate and free small pooled buffers from numThreads threads.
+ */
+static Void benchThreads(Int numThreads)
+{
+    pthread_t threads[16];
+    Memory_Stat before;
+    Memory_Stat after;
+    double start;
+    Int i;
+
+    Memory_contigStat(&before);
+    start = Test_now();
+
+    for (i = 0; i < numThreads; i++) {
+        pthread_create(&threads[i], NULL, allocBufs, NULL);
+    }
+    for (i = 0; i < numThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    Memory_contigStat(&after);
+    printf("%2d threads: pooled alloc+free %.1f ns, "
+        "%lu lock acquires, %lu waits\n", numThreads,
+        (Test_now() - start) * 1e3 / (numThreads * NUMTHREADALLOCS),
+        after.lockAcquires - before.lockAcquires,
+        after.lockWaits - before.lockWaits);
+}
+
+/*
+ *  ======== openTlbCounter ========
+ *  Open a counter of this thread's data TLB load misses, or return -1
+ *  if the CPU or the kernel's perf_event_paranoid setting won't allow it.
+ */
+static Int openTlbCounter(Void)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+/*
+ *  ======== startTlbCounter ========
+ */
+static Void startTlbCounter(Int fd)
+{
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+/*
+ *  ======== stopTlbCounter ========
+ *  Print the misses counted since startTlbCounter(), divided by per, to
+ *  buf, or "unavailable" without a counter.
+ */
+static Void stopTlbCounter(Int fd, Char *buf, UInt size, double per)
+{
+    __u64 count;
+
+    if (fd < 0) {
+        snprintf(buf, size, "unavailable");
+        return;
+    }
+
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof (count)) != sizeof (count)) {
+        snprintf(buf, size, "unavailable");
+        return;
+    }
+    snprintf(buf, size, "%.2f", count / per);
+}
@@ -0,0 +1,526 @@
+/*
+ *  ======== memory_test.c ========
+ *  Check the contiguous memory paths: the index of known buffers, the
+ *  table of registered ones, the pool and its thread caches, the buddy
+ *  heap, the accounts, cache maintenance and dma-bufs, natively and with
+ *  CMEM emulated.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include "test.h"
+
+#define HEAPSIZE        (4 * 1024 * 1024)
+
+#define NUMREGBUFS      300
+#define REGBUFSIZE      4096
+#define REGPHYSBASE     0x40000000
+
+/* buffers registered and unregistered while another thread translates */
+#define NUMFASTBUFS     64
+#define NUMREGROUNDS    2000
+
+#define NUMTHREADS      8
+#define NUMALLOCS       20000
+
+UInt32 Memory_contigHeapSize = HEAPSIZE;
+
+static Void *allocBufs(Void *arg);
+static Void checkAccounts(Void);
+static Void checkCacheRanges(Void);
+static Void checkDmaBuf(Void);
+static Void checkHeap(Void);
+static Void checkIndex(Void);
+static Void checkPool(Void);
+static Void checkRegistered(Void);
+static Void checkThreads(Void);
+static Void *translateBufs(Void *arg);
+
+static UInt8 *fastBufs[NUMFASTBUFS];
+static Bool translating;
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    Memory_init();
+
+    checkIndex();
+    checkRegistered();
+    checkPool();
+    checkThreads();
+    checkHeap();
+    checkAccounts();
+    checkCacheRanges();
+    checkDmaBuf();
+
+    Memory_exit();
+
+    /* only the emulated CMEM heap's blocks can be exported */
+    Memory_emulateCmem = TRUE;
+    Memory_init();
+    checkDmaBuf();
+    Memory_exit();
+
+    return (Test_exit("memory_test"));
+}
+
+/*
+ *  ======== allocBufs ========
+ *  Allocate and free pooled buffers of two sizes, checking no other
+ *  thread has them meanwhile.
+ */
+static Void *allocBufs(Void *arg)
+{
+    Memory_AllocParams params = Memory_DEFAULTPARAMS;
+    UInt8 fill = (UInt8)(IArg)arg;
+    UInt8 *buf;
+    UInt size;
+    Int i;
+
+    params.type = Memory_CONTIGPOOL;
+
+    for (i = 0; i < NUMALLOCS; i++) {
+        size = (i & 1) ? 256 : 4000;
+        if ((buf = (UInt8 *)Memory_alloc(size, &params)) == NULL) {
+            Test_check(!"pooled Memory_alloc failed");
+            break;
+        }
+        memset(buf, fill, size);
+        Test_check(buf[0] == fill && buf[size - 1] == fill);
+        Test_check(Memory_free(buf, size, &params));
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== checkAccounts ========
+ *  A buffer is charged to the allocating thread's account and its
+ *  parents, moves with the account to a new parent, and is credited back
+ *  when freed.
+ */
+static Void checkAccounts(Void)
+{
+    Memory_AccountStat stat;
+    Int parent = Memory_createAccount(Memory_NOACCOUNT);
+    Int child = Memory_createAccount(parent);
+    Int other = Memory_createAccount(Memory_NOACCOUNT);
+    Int prev;
+    Ptr buf;
+
+    Test_check(parent != Memory_NOACCOUNT && child != Memory_NOACCOUNT);
+
+    prev = Memory_setAccount(child);
+    buf = Memory_contigAlloc(10000, 0);
+    Test_check(Memory_getAccountStat(child, &stat));
+    Test_check(stat.used >= 10000 && stat.numAllocs == 1);
+    Test_check(Memory_getAccountStat(parent, &stat));
+    Test_check(stat.used >= 10000 && stat.numAllocs == 1);
+
+    /* no account can be its own ancestor */
+    Test_check(!Memory_setAccountParent(parent, child));
+    Test_check(!Memory_setAccountParent(child, child));
+
+    Test_check(Memory_setAccountParent(child, other));
+    Test_check(Memory_getAccountStat(parent, &stat));
+    Test_check(stat.used == 0 && stat.numAllocs == 1);
+    Test_check(Memory_getAccountStat(other, &stat));
+    Test_check(stat.used >= 10000 && stat.peak >= 10000 &&
+        stat.numAllocs == 0);
+
+    Memory_contigFree(buf, 10000);
+    Test_check(Memory_getAccountStat(other, &stat));
+    Test_check(stat.used == 0 && stat.numFrees == 1);
+    Test_check(Memory_getAccountStat(child, &stat));
+    Test_check(stat.used == 0 && stat.peak >= 10000 && stat.numFrees == 1);
+    Memory_setAccount(prev);
+
+    Memory_deleteAccount(child);
+    Memory_deleteAccount(other);
+    Memory_deleteAccount(parent);
+    Test_check(!Memory_getAccountStat(child, &stat));
+}
+
+/*
+ *  ======== checkCacheRanges ========
+ *  Cache maintenance takes no lock until a buffer has been marked dirty
+ *  or clean; this must run before anything marks one.
+ */
+static Void checkCacheRanges(Void)
+{
+    Memory_CacheRange range;
+    Memory_Stat before;
+    Memory_Stat after;
+
+    range.addr = Memory_contigAlloc(4096, 0);
+    range.sizeInBytes = 4096;
+
+    Memory_contigStat(&before);
+    Memory_cacheWbRanges(&range, 1);
+    Memory_cacheWbInvRanges(&range, 1);
+    Memory_contigStat(&after);
+
+    /* the one acquire is Memory_contigStat()'s own */
+    Test_check(after.lockAcquires - before.lockAcquires == 1);
+
+    Test_check(Memory_setBufferDirty(range.addr, TRUE));
+    Memory_contigStat(&before);
+    Memory_cacheWbInvRanges(&range, 1);
+    Memory_contigStat(&after);
+    Test_check(after.lockAcquires - before.lockAcquires == 2);
+
+    Memory_contigFree(range.addr, 4096);
+}
+
+/*
+ *  ======== checkDmaBuf ========
+ *  An imported dma-buf, here a memfd standing in for one, shows what was
+ *  written to it and translates both ways until it is released.  With
+ *  CMEM emulated, and /dev/udmabuf there, a block of the heap exports as
+ *  a dma-buf that imports as another view of it; without the device, or
+ *  CMEM emulated, the export is refused.
+ */
+static Void checkDmaBuf(Void)
+{
+    UInt32 pageSize = (UInt32)sysconf(_SC_PAGESIZE);
+    UInt8 *buf;
+    UInt8 *view;
+    UInt32 phys;
+    Int fd;
+
+    fd = memfd_create("memory_test", MFD_CLOEXEC);
+    Test_check(fd != -1 && ftruncate(fd, 2 * pageSize) == 0 &&
+        pwrite(fd, "dma", 4, pageSize) == 4);
+    buf = (UInt8 *)Memory_importDmaBuf(fd, 0);
+    close(fd);
+    Test_check(buf != NULL);
+    if (buf == NULL) {
+        return;
+    }
+    Test_check(strcmp((Char *)buf + pageSize, "dma") == 0);
+
+    /* emulated CMEM fakes the physical addresses of imports */
+    phys = Memory_getBufferPhysicalAddress(buf + pageSize, 4, NULL);
+    Test_check(phys != 0);
+    Test_check((phys == (UInt32)(buf + pageSize)) == !Memory_emulateCmem);
+    Test_check(Memory_getBufferVirtualAddress(phys, 4) == buf + pageSize);
+
+    Test_check(!Memory_releaseDmaBuf(buf + pageSize));
+    Test_check(Memory_releaseDmaBuf(buf));
+    Test_check(!Memory_releaseDmaBuf(buf));
+    if (Memory_emulateCmem) {
+        Test_check(Memory_getBufferVirtualAddress(phys, 4) == NULL);
+    }
+
+    buf = (UInt8 *)Memory_contigAlloc(2 * pageSize, pageSize);
+    Test_check(buf != NULL);
+    Test_check(Memory_exportDmaBuf(buf, 0) == -1);
+
+    if (!Memory_emulateCmem || access("/dev/udmabuf", R_OK | W_OK) != 0) {
+        Test_check(Memory_exportDmaBuf(buf, 2 * pageSize) == -1);
+    }
+    else {
+        memcpy(buf, "dma", 4);
+        fd = Memory_exportDmaBuf(buf, 2 * pageSize);
+        Test_check(fd != -1);
+        view = (UInt8 *)Memory_importDmaBuf(fd, 0);
+        close(fd);
+        Test_check(view != NULL && view != buf &&
+            strcmp((Char *)view, "dma") == 0);
+        Test_check(Memory_releaseDmaBuf(view));
+    }
+
+    Memory_contigFree(buf, 2 * pageSize);
+}
+
+/*
+ *  ======== checkHeap ========
+ *  Freed buddies coalesce, and a heap churned then emptied is whole.
+ */
+static Void checkHeap(Void)
+{
+    Memory_AllocParams params = Memory_DEFAULTPARAMS;
+    Memory_HeapStat stat;
+    Ptr quarters[4];
+    Ptr bufs[64];
+    UInt sizes[64];
+    Int i;
+    Int k;
+
+    params.type = Memory_CONTIGHEAP;
+
+    Test_check(Memory_contigHeapStat(&stat));
+    Test_check(stat.size == HEAPSIZE && stat.largestFree == HEAPSIZE);
+
+    for (i = 0; i < 4; i++) {
+        quarters[i] = Memory_alloc(HEAPSIZE / 4, &params);
+        Test_check(quarters[i] != NULL);
+    }
+    Test_check(Memory_alloc(Memory_HEAPMINBLOCK, &params) == NULL);
+
+    /* 1 and 2 aren't buddies, so they stay apart */
+    Memory_free(quarters[1], HEAPSIZE / 4, &params);
+    Memory_free(quarters[2], HEAPSIZE / 4, &params);
+    Memory_contigHeapStat(&stat);
+    Test_check(stat.largestFree == HEAPSIZE / 4);
+    Test_check(stat.fragmentation == 50);
+
+    Memory_free(quarters[0], HEAPSIZE / 4, &params);
+    Memory_contigHeapStat(&stat);
+    Test_check(stat.largestFree == HEAPSIZE / 2);
+
+    Memory_free(quarters[3], HEAPSIZE / 4, &params);
+    Memory_contigHeapStat(&stat);
+    Test_check(stat.used == 0 && stat.largestFree == HEAPSIZE);
+    Test_check(stat.fragmentation == 0);
+
+    /* churn blocks of random sizes, then free them all */
+    srand(1);
+    memset(bufs, 0, sizeof (bufs));
+    for (k = 0; k < 10000; k++) {
+        i = rand() % 64;
+        if (bufs[i] != NULL) {
+            Memory_free(bufs[i], sizes[i], &params);
+        }
+        sizes[i] = 1 + rand() % 65536;
+        bufs[i] = Memory_alloc(sizes[i], &params);
+    }
+    for (i = 0; i < 64; i++) {
+        if (bufs[i] != NULL) {
+            Memory_free(bufs[i], sizes[i], &params);
+        }
+    }
+    Memory_contigHeapStat(&stat);
+    Test_check(stat.used == 0 && stat.largestFree == HEAPSIZE);
+}
+
+/*
+ *  ======== checkIndex ========
+ *  Registered buffers translate both ways at any offset, and those
+ *  unregistered no longer do.
+ */
+static Void checkIndex(Void)
+{
+    static UInt8 *bufs[NUMREGBUFS];
+    UInt32 phys;
+    Int numWrong = 0;
+    Int offset;
+    Int i;
+
+    for (i = 0; i < NUMREGBUFS; i++) {
+        bufs[i] = (UInt8 *)malloc(REGBUFSIZE);
+        Memory_registerContigBuf((UInt32)bufs[i], REGBUFSIZE,
+            REGPHYSBASE + i * 2 * REGBUFSIZE);
+    }
+
+    for (i = 0; i < NUMREGBUFS; i++) {
+        offset = (i * 97) % REGBUFSIZE;
+        phys = REGPHYSBASE + i * 2 * REGBUFSIZE + offset;
+        if (Memory_getBufferPhysicalAddress(bufs[i] + offset, 1, NULL) !=
+            phys ||
+            Memory_getBufferVirtualAddress(phys, 1) != bufs[i] + offset) {
+            numWrong++;
+        }
+    }
+    Test_check(numWrong == 0);
+
+    /* a range crossing the end of a buffer isn't contiguous */
+    Test_check(Memory_getBufferPhysicalAddress(bufs[0] + REGBUFSIZE - 1, 2,
+        NULL) != REGPHYSBASE + REGBUFSIZE - 1);
+
+    for (i = 0; i < NUMREGBUFS; i += 2) {
+        Memory_unregisterContigBuf((UInt32)bufs[i], REGBUFSIZE);
+    }
+
+    numWrong = 0;
+    for (i = 0; i < NUMREGBUFS; i++) {
+        phys = REGPHYSBASE + i * 2 * REGBUFSIZE;
+        if ((Memory_getBufferPhysicalAddress(bufs[i], 1, NULL) == phys) !=
+            (i % 2 == 1)) {
+            numWrong++;
+        }
+    }
+    Test_check(numWrong == 0);
+
+    for (i = 0; i < NUMREGBUFS; i++) {
+        if (i % 2 == 1) {
+            Memory_unregisterContigBuf((UInt32)bufs[i], REGBUFSIZE);
+        }
+        free(bufs[i]);
+    }
+}
+
+/*
+ *  ======== checkPool ========
+ *  Freed buffers are reused by allocations of their size class, and
+ *  reserved ones serve the first allocations.
+ */
+static Void checkPool(Void)
+{
+    Memory_PoolStat before;
+    Memory_PoolStat after;
+    Ptr bufs[3];
+    Ptr buf;
+    Int i;
+
+    buf = Memory_contigAlloc(8000, 0);
+    Memory_contigFree(buf, 8000);
+    Test_check(Memory_contigAlloc(8100, 0) == buf);
+    Memory_contigFree(buf, 8100);
+
+    /* buffers over 64 KB aren't cached by threads */
+    Memory_poolStat(&before);
+    Test_check(Memory_poolReserve(1024 * 1024, 3));
+    Memory_poolStat(&after);
+    Test_check(after.numIdle == before.numIdle + 3);
+    Test_check(after.idleBytes == before.idleBytes + 3 * 1024 * 1024);
+
+    for (i = 0; i < 3; i++) {
+        bufs[i] = Memory_contigAlloc(1024 * 1024, 0);
+    }
+    Memory_poolStat(&after);
+    Test_check(after.hits == before.hits + 3);
+    Test_check(after.numIdle == before.numIdle);
+
+    for (i = 0; i < 3; i++) {
+        Memory_contigFree(bufs[i], 1024 * 1024);
+    }
+    Memory_poolStat(&after);
+    Test_check(after.numIdle == before.numIdle + 3);
+}
+
+/*
+ *  ======== checkRegistered ========
+ *  Registered buffers translate both ways without taking the lock, and
+ *  keep translating correctly while other buffers are registered and
+ *  unregistered, reusing the table's entries, by another thread.
+ */
+static Void checkRegistered(Void)
+{
+    Memory_BufHandle handles[NUMFASTBUFS];
+    Memory_Stat before;
+    Memory_Stat after;
+    pthread_t thread;
+    Ptr numWrong;
+    Int round;
+    Int i;
+    Int k;
+
+    for (i = 0; i < NUMFASTBUFS; i++) {
+        fastBufs[i] = (UInt8 *)malloc(REGBUFSIZE);
+        Memory_registerContigBuf((UInt32)fastBufs[i], REGBUFSIZE,
+            REGPHYSBASE + i * 2 * REGBUFSIZE);
+        handles[i] = Memory_registerBuf(fastBufs[i], REGBUFSIZE);
+        Test_check(handles[i] != NULL);
+    }
+    Test_check(Memory_registerBuf(fastBufs[0], REGBUFSIZE) == NULL);
+
+    Memory_contigStat(&before);
+    for (i = 0; i < NUMFASTBUFS; i++) {
+        Test_check(Memory_getBufferPhysicalAddress(fastBufs[i], REGBUFSIZE,
+            NULL) == REGPHYSBASE + i * 2 * REGBUFSIZE);
+        Test_check(Memory_getBufferVirtualAddress(REGPHYSBASE +
+            i * 2 * REGBUFSIZE, REGBUFSIZE) == fastBufs[i]);
+    }
+    Memory_contigStat(&after);
+
+    /* the one acquisition is Memory_contigStat()'s own */
+    Test_check(after.lockAcquires - before.lockAcquires == 1);
+
+    for (i = 0; i < NUMFASTBUFS; i++) {
+        Memory_unregisterBuf(handles[i]);
+    }
+
+    /*
+     *  Each round registers the buffers in a different order, so each
+     *  goes to entries that others had, and unregisters half of them.
+     */
+    __atomic_store_n(&translating, TRUE, __ATOMIC_RELEASE);
+    pthread_create(&thread, NULL, translateBufs, NULL);
+
+    for (round = 0; round < NUMREGROUNDS; round++) {
+        for (i = 0; i < NUMFASTBUFS; i++) {
+            k = (i * 7 + round) % NUMFASTBUFS;
+            if (handles[k] == NULL) {
+                handles[k] = Memory_registerBuf(fastBufs[k], REGBUFSIZE);
+            }
+        }
+        for (i = round % 2; i < NUMFASTBUFS; i += 2) {
+            Memory_unregisterBuf(handles[i]);
+            handles[i] = NULL;
+        }
+    }
+
+    __atomic_store_n(&translating, FALSE, __ATOMIC_RELEASE);
+    pthread_join(thread, &numWrong);
+    Test_check(numWrong == NULL);
+
+    for (i = 0; i < NUMFASTBUFS; i++) {
+        Memory_unregisterBuf(handles[i]);
+        Memory_unregisterContigBuf((UInt32)fastBufs[i], REGBUFSIZE);
+        free(fastBufs[i]);
+    }
+}
+
+/*
+ *  ======== checkThreads ========
+ *  Threads allocating pooled buffers at once get distinct ones, mostly
+ *  from their caches, without taking the allocator's lock.
+ */
+static Void checkThreads(Void)
+{
+    pthread_t threads[NUMTHREADS];
+    Memory_Stat before;
+    Memory_Stat after;
+    Int i;
+
+    Memory_contigStat(&before);
+
+    for (i = 0; i < NUMTHREADS; i++) {
+        pthread_create(&threads[i], NULL, allocBufs, (Void *)(IArg)(i + 1));
+    }
+    for (i = 0; i < NUMTHREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    Memory_contigStat(&after);
+    Test_check(after.used == before.used);
+    Test_check(after.lockAcquires - before.lockAcquires <
+        NUMTHREADS * NUMALLOCS / 100);
+}
+
+/*
+ *  ======== translateBufs ========
+ *  Translate the base addresses of fastBufs both ways until told to
+ *  stop, and return how many translations were wrong.
+ */
+static Void *translateBufs(Void *arg)
+{
+    IArg numWrong = 0;
+    UInt32 phys;
+    Int i;
+
+    do {
+        for (i = 0; i < NUMFASTBUFS; i++) {
+            phys = REGPHYSBASE + i * 2 * REGBUFSIZE;
+            if (Memory_getBufferPhysicalAddress(fastBufs[i], REGBUFSIZE,
+                NULL) != phys ||
+                Memory_getBufferVirtualAddress(phys, REGBUFSIZE) !=
+                fastBufs[i]) {
+                numWrong++;
+            }
+        }
+    } while (__atomic_load_n(&translating, __ATOMIC_ACQUIRE));
+
+    return ((Void *)numWrong);
+}
@@ -0,0 +1,183 @@
+/*
+ *  ======== queue_test.c ========
+ *  Check that a Queue_Fifo, and a Comm queue built on them, keep the
+ *  order of each of many concurrent putters' elements and lose none.
+ */
+#include <xdc/std.h>
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Queue.h>
+
+#include "test.h"
+
+#define NUMPUTTERS      8
+#define NUMPUTS         100000
+
+/*
+ *  ======== Elem ========
+ */
+typedef struct Elem {
+    Queue_Link  link;
+    Int         putter;
+    Int         seq;
+} Elem;
+
+/*
+ *  ======== Msg ========
+ */
+typedef struct Msg {
+    Comm_MsgHeader header;
+    Int         putter;
+    Int         seq;
+} Msg;
+
+static Void checkComm(Void);
+static Void checkFifo(Void);
+static Void *putComm(Void *arg);
+static Void *putFifo(Void *arg);
+
+static Queue_Fifo fifo;
+static Elem elems[NUMPUTTERS][NUMPUTS];
+static Comm_Queue commQueue;
+
+/*
+ *  ======== main ========
+ */
+Int main(Int argc, String argv[])
+{
+    CERuntime_init();
+
+    checkFifo();
+    checkComm();
+
+    CERuntime_exit();
+
+    return (Test_exit("queue_test"));
+}
+
+/*
+ *  ======== checkComm ========
+ *  Get the messages of NUMPUTTERS threads putting to one Comm queue.
+ */
+static Void checkComm(Void)
+{
+    pthread_t putters[NUMPUTTERS];
+    Int next[NUMPUTTERS] = {0};
+    Comm_Handle handle;
+    Comm_Msg msg;
+    Int numOutOfOrder = 0;
+    Int numGot;
+    Int status = Comm_EOK;
+    Int i;
+
+    handle = Comm_create(NULL, &commQueue, NULL);
+    Test_check(handle != NULL);
+
+    for (i = 0; i < NUMPUTTERS; i++) {
+        pthread_create(&putters[i], NULL, putComm, (Void *)(IArg)i);
+    }
+
+    for (numGot = 0; numGot < NUMPUTTERS * NUMPUTS; numGot++) {
+        status = Comm_get(commQueue, &msg, 5000000);
+        if (status != Comm_EOK) {
+            break;
+        }
+        if (((Msg *)msg)->seq != next[((Msg *)msg)->putter]++) {
+            numOutOfOrder++;
+        }
+        Comm_free(msg);
+    }
+    Test_check(status == Comm_EOK);
+    Test_check(numOutOfOrder == 0);
+
+    for (i = 0; i < NUMPUTTERS; i++) {
+        pthread_join(putters[i], NULL);
+    }
+
+    Test_check(Comm_get(commQueue, &msg, Comm_POLL) == Comm_ETIMEOUT);
+    Comm_delete(handle);
+}
+
+/*
+ *  ======== checkFifo ========
+ *  Get the elements of NUMPUTTERS threads putting to one Queue_Fifo.
+ */
+static Void checkFifo(Void)
+{
+    pthread_t putters[NUMPUTTERS];
+    Int next[NUMPUTTERS] = {0};
+    Elem *elem;
+    Int numOutOfOrder = 0;
+    Int numGot = 0;
+    double start = Test_now();
+    Int i;
+
+    Queue_fifoNew(&fifo);
+    Test_check(Queue_fifoEmpty(&fifo));
+    Test_check(Queue_fifoGet(&fifo) == NULL);
+
+    for (i = 0; i < NUMPUTTERS; i++) {
+        pthread_create(&putters[i], NULL, putFifo, (Void *)(IArg)i);
+    }
+
+    while (numGot < NUMPUTTERS * NUMPUTS && Test_now() - start < 5000000) {
+        if ((elem = (Elem *)Queue_fifoGet(&fifo)) != NULL) {
+            if (elem->seq != next[elem->putter]++) {
+                numOutOfOrder++;
+            }
+            numGot++;
+        }
+    }
+    Test_check(numGot == NUMPUTTERS * NUMPUTS);
+    Test_check(numOutOfOrder == 0);
+
+    for (i = 0; i < NUMPUTTERS; i++) {
+        pthread_join(putters[i], NULL);
+    }
+
+    Test_check(Queue_fifoEmpty(&fifo));
+    Test_check(Queue_fifoGet(&fifo) == NULL);
+}
+
+/*
+ *  ======== putComm ========
+ */
+static Void *putComm(Void *arg)
+{
+    Int putter = (Int)(IArg)arg;
+    Comm_Msg msg;
+    Int i;
+
+    for (i = 0; i < NUMPUTS; i++) {
+        if (Comm_alloc(0, &msg, sizeof (Msg)) != Comm_EOK) {
+            Test_check(!"Comm_alloc failed");
+            break;
+        }
+        ((Msg *)msg)->putter = putter;
+        ((Msg *)msg)->seq = i;
+        Comm_put(commQueue, msg);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== putFifo ========
+ */
+static Void *putFifo(Void *arg)
+{
+    Int putter = (Int)(IArg)arg;
+    Int i;
+
+    for (i = 0; i < NUMPUTS; i++) {
+        elems[putter][i].putter = putter;
+        elems[putter][i].seq = i;
+        Queue_fifoPut(&fifo, &elems[putter][i]);
+    }
+
+    return (NULL);
+}
@@ -0,0 +1,461 @@
+/*
+ *  ======== test.c ========
+ *  Helpers and configuration shared by the host build's test and
+ *  benchmark programs; see test.h.
+ */
+#include <xdc/std.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ti/xdais/ialg.h>
+#include <ti/xdais/dm/iauddec1.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/node/_node.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/speech1/sphdec1.h>
+#include <ti/sdo/ce/speech1/_sphdec1.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+
+#include "test.h"
+
+/* algs the tables list before those Test_addAlgs() appends */
+#define NUMFIXED        3
+
+/*
+ *  ======== Dec_Obj ========
+ */
+typedef struct Dec_Obj {
+    IALG_Obj    alg;
+    Int         numCalls;
+} Dec_Obj;
+
+static Int decAlloc(const IALG_Params *params, IALG_Fxns **parentFxns,
+    IALG_MemRec memTab[]);
+static XDAS_Int32 decControl(IVIDDEC2_Handle h, IVIDDEC2_Cmd id,
+    IVIDDEC2_DynamicParams *params, IVIDDEC2_Status *status);
+static Int decFree(IALG_Handle alg, IALG_MemRec memTab[]);
+static Int decInit(IALG_Handle alg, const IALG_MemRec memTab[],
+    IALG_Handle parent, const IALG_Params *params);
+static Void decLog(XDAS_Int32 entry);
+static Int decNumAlloc(Void);
+static XDAS_Int32 decProcess(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs,
+    IVIDDEC2_OutArgs *outArgs);
+static VISA_Status sphCall(VISA_Handle visa, VISA_Msg msg);
+static XDAS_Int32 sphControl(ISPHDEC1_Handle h, ISPHDEC1_Cmd id,
+    ISPHDEC1_DynamicParams *params, ISPHDEC1_Status *status);
+static XDAS_Int32 sphProcess(ISPHDEC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHDEC1_InArgs *inArgs,
+    ISPHDEC1_OutArgs *outArgs);
+
+extern SKEL_Fxns AUDDEC1_SKEL;
+extern SKEL_Fxns VIDDEC2_SKEL;
+extern IAUDDEC1_Fxns AUDDEC1_STUBS;
+extern IVIDDEC2_Fxns VIDDEC2_STUBS;
+extern Ptr __real_calloc(size_t numElems, size_t size);
+
+static IVIDDEC2_Fxns DEC_FXNS = {
+    {&DEC_FXNS, NULL, decAlloc, NULL, NULL, decFree, decInit, NULL,
+        decNumAlloc},
+    decProcess,
+    decControl,
+};
+
+static ISPHDEC1_Fxns SPH_FXNS = {
+    {&SPH_FXNS, NULL, decAlloc, NULL, NULL, decFree, decInit, NULL,
+        decNumAlloc},
+    sphProcess,
+    sphControl,
+};
+
+/* the speech decoder's skeleton, counting the batches it gets */
+static SKEL_Fxns SPH_SKEL = {
+    sphCall,
+    (SKEL_CREATEFXN)&SPHDEC1_create,
+    (SKEL_DESTROYFXN)&SPHDEC1_delete,
+};
+
+static String decTypes[] = {"ti.sdo.ce.video2.IVIDDEC2", NULL};
+static String sphTypes[] = {"ti.sdo.ce.speech1.ISPHDEC1", NULL};
+static String audTypes[] = {"ti.sdo.ce.audio1.IAUDDEC1", NULL};
+
+/*
+ *  Each table lists a second "dec", an audio decoder, which the first
+ *  shadows; Test_addAlgs() appends to the tables.
+ */
+static Engine_AlgDesc localAlgs[NUMFIXED + Test_MAXALGS + 1] = {
+    {"dec", {0}, (IALG_Fxns *)&DEC_FXNS, NULL, decTypes, TRUE, -1, 1, NULL,
+        NULL},
+    {"sph", {0}, (IALG_Fxns *)&SPH_FXNS, NULL, sphTypes, TRUE, -1, 1, NULL,
+        NULL},
+    {"dec", {0}, (IALG_Fxns *)&AUDDEC1_STUBS, NULL, audTypes, FALSE, -1, 1,
+        NULL, NULL},
+    {NULL},
+};
+
+static Engine_AlgDesc remoteAlgs[NUMFIXED + Test_MAXALGS + 1] = {
+    {"dec", {0}, (IALG_Fxns *)&VIDDEC2_STUBS, NULL, decTypes, FALSE, -1, 1,
+        NULL, NULL},
+    {"sph", {0}, (IALG_Fxns *)&SPHDEC1_STUBS, NULL, sphTypes, FALSE, -1, 1,
+        NULL, NULL},
+    {"dec", {0}, (IALG_Fxns *)&AUDDEC1_STUBS, NULL, audTypes, FALSE, -1, 1,
+        NULL, NULL},
+    {NULL},
+};
+
+static Engine_Desc engines[] = {
+    {"local", localAlgs, NULL, NULL, 0},
+    {"remote", remoteAlgs, "server.x64P", NULL, 0},
+    {NULL},
+};
+
+Engine_Config Engine_config = {engines, "local"};
+
+/* the server's nodes run the local engine's algs behind the skeletons */
+NODE_Desc RMS_nodeTab[NUMFIXED + Test_MAXALGS + 1] = {
+    {"dec", {0}, &VIDDEC2_SKEL, 1, 0},
+    {"sph", {0}, &SPH_SKEL, 1, 0},
+    {"dec", {0}, &AUDDEC1_SKEL, 1, 0},
+    {NULL},
+};
+
+UInt32 Test_decDelay = 0;
+Bool Test_failIndices = FALSE;
+Int Test_sphBatchMsgs = 0;
+Bool Test_sphOldServer = FALSE;
+XDAS_Int32 Test_decLog[Test_MAXLOG];
+Int Test_decLogLen = 0;
+
+static Int numFailed = 0;
+static Int numAdded = 0;
+
+/*
+ *  ======== Test_addAlgs ========
+ */
+Void Test_addAlgs(Int numAlgs)
+{
+    Char name[16];
+    Int i;
+    Int k;
+
+    for (i = 0; i < numAlgs && numAdded < Test_MAXALGS; i++, numAdded++) {
+        snprintf(name, sizeof (name), "alg%d", numAdded);
+        k = NUMFIXED + numAdded;
+
+        localAlgs[k] = localAlgs[0];
+        localAlgs[k].name = strdup(name);
+        remoteAlgs[k] = remoteAlgs[0];
+        remoteAlgs[k].name = localAlgs[k].name;
+        RMS_nodeTab[k] = RMS_nodeTab[0];
+        RMS_nodeTab[k].name = localAlgs[k].name;
+    }
+}
+
+/*
+ *  ======== Test_allocBatch ========
+ */
+Void Test_allocBatch(Test_Batch *batch, Int numFrames, UInt size,
+    UInt inArgsSize, Bool withData)
+{
+    XDM1_SingleBufDesc *data;
+    Int n;
+
+    memset(batch, 0, sizeof (Test_Batch));
+    batch->numFrames = numFrames;
+
+    for (n = 0; n < numFrames; n++) {
+        batch->inBufs[n].buf = (XDAS_Int8 *)Memory_contigAlloc(size, 0);
+        batch->inBufs[n].bufSize = size;
+        memset(batch->inBufs[n].buf, n, size);
+        batch->outBufs[n].buf = (XDAS_Int8 *)Memory_contigAlloc(size, 0);
+        batch->outBufs[n].bufSize = size;
+
+        batch->inArgs[n] = (SPHDEC1_InArgs *)calloc(1, inArgsSize);
+        batch->inArgs[n]->size = inArgsSize;
+        batch->inArgs[n]->frameType = n;
+        if (withData) {
+            data = &batch->inArgs[n]->data;
+            data->buf = (XDAS_Int8 *)Memory_contigAlloc(size, 0);
+            data->bufSize = size;
+        }
+
+        batch->outArgs[n] = (SPHDEC1_OutArgs *)calloc(1,
+            sizeof (SPHDEC1_OutArgs));
+        batch->outArgs[n]->size = sizeof (SPHDEC1_OutArgs);
+    }
+}
+
+/*
+ *  ======== Test_allocBufs ========
+ */
+Void Test_allocBufs(Test_Bufs *bufs, UInt size)
+{
+    memset(bufs, 0, sizeof (Test_Bufs));
+
+    bufs->inBufs.numBufs = 1;
+    bufs->inBufs.descs[0].buf = (XDAS_Int8 *)Memory_contigAlloc(size, 0);
+    bufs->inBufs.descs[0].bufSize = size;
+
+    bufs->outBuf[0] = (XDAS_Int8 *)Memory_contigAlloc(size, 0);
+    bufs->outBufSize[0] = size;
+    bufs->outBufs.bufs = bufs->outBuf;
+    bufs->outBufs.numBufs = 1;
+    bufs->outBufs.bufSizes = bufs->outBufSize;
+
+    bufs->inArgs.size = sizeof (VIDDEC2_InArgs);
+    bufs->inArgs.numBytes = size;
+    bufs->outArgs.size = sizeof (VIDDEC2_OutArgs);
+}
+
+/*
+ *  ======== Test_exit ========
+ */
+Int Test_exit(String name)
+{
+    if (numFailed != 0) {
+        printf("%s: %d check(s) failed\n", name, numFailed);
+        return (1);
+    }
+
+    printf("%s: passed\n", name);
+
+    return (0);
+}
+
+/*
+ *  ======== Test_fail ========
+ */
+Void Test_fail(String file, Int line, String cond)
+{
+    __atomic_add_fetch(&numFailed, 1, __ATOMIC_RELAXED);
+    printf("%s:%d: check failed: %s\n", file, line, cond);
+}
+
+/*
+ *  ======== Test_freeBatch ========
+ */
+Void Test_freeBatch(Test_Batch *batch)
+{
+    XDM1_SingleBufDesc *data;
+    Int n;
+
+    for (n = 0; n < batch->numFrames; n++) {
+        Memory_contigFree(batch->inBufs[n].buf, batch->inBufs[n].bufSize);
+        Memory_contigFree(batch->outBufs[n].buf, batch->outBufs[n].bufSize);
+
+        data = &batch->inArgs[n]->data;
+        if (data->buf != NULL) {
+            Memory_contigFree(data->buf, data->bufSize);
+        }
+        free(batch->inArgs[n]);
+        free(batch->outArgs[n]);
+    }
+}
+
+/*
+ *  ======== Test_freeBufs ========
+ */
+Void Test_freeBufs(Test_Bufs *bufs)
+{
+    Memory_contigFree(bufs->inBufs.descs[0].buf,
+        bufs->inBufs.descs[0].bufSize);
+    Memory_contigFree(bufs->outBuf[0], bufs->outBufSize[0]);
+}
+
+/*
+ *  ======== Test_now ========
+ */
+double Test_now(Void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec * 1e6 + now.tv_nsec / 1e3);
+}
+
+/*
+ *  ======== sphCall ========
+ *  Count the batch messages, answering them as a server predating them
+ *  would if Test_sphOldServer is set, and pass the rest to the speech
+ *  decoders' skeleton.
+ */
+static VISA_Status sphCall(VISA_Handle visa, VISA_Msg msg)
+{
+    if (msg->cmd == _SPHDEC1_CPROCESSBATCH) {
+        __atomic_add_fetch(&Test_sphBatchMsgs, 1, __ATOMIC_RELAXED);
+        if (Test_sphOldServer) {
+            msg->status = VISA_EFAIL;
+            return (VISA_EOK);
+        }
+    }
+
+    return (SPHDEC1_SKEL.call(visa, msg));
+}
+
+/*
+ *  ======== sphControl ========
+ */
+static XDAS_Int32 sphControl(ISPHDEC1_Handle h, ISPHDEC1_Cmd id,
+    ISPHDEC1_DynamicParams *params, ISPHDEC1_Status *status)
+{
+    status->extendedError = ((Dec_Obj *)h)->numCalls;
+
+    return (ISPHDEC1_EOK);
+}
+
+/*
+ *  ======== sphProcess ========
+ *  Copy the input to the output buffer and return the frame type as the
+ *  output's size, and the number of calls made so far as the extended
+ *  error.  Frames of negative type fail.
+ */
+static XDAS_Int32 sphProcess(ISPHDEC1_Handle h, XDM1_SingleBufDesc *inBuf,
+    XDM1_SingleBufDesc *outBuf, ISPHDEC1_InArgs *inArgs,
+    ISPHDEC1_OutArgs *outArgs)
+{
+    Dec_Obj *dec = (Dec_Obj *)h;
+    XDAS_Int32 size = inBuf->bufSize;
+
+    if (outBuf->bufSize < size) {
+        size = outBuf->bufSize;
+    }
+    memcpy(outBuf->buf, inBuf->buf, size);
+    XDM_SETACCESSMODE_READ(inBuf->accessMask);
+    XDM_SETACCESSMODE_WRITE(outBuf->accessMask);
+
+    outArgs->dataSize = inArgs->frameType;
+    outArgs->extendedError = ++dec->numCalls;
+
+    return (inArgs->frameType < 0 ? ISPHDEC1_EFAIL : ISPHDEC1_EOK);
+}
+
+/*
+ *  ======== __wrap_calloc ========
+ *  The programs link with calloc() wrapped, so that they can make the
+ *  runtime's indices fail to allocate.  They are its only calloc()s of
+ *  several elements of more than a byte.
+ */
+Ptr __wrap_calloc(size_t numElems, size_t size)
+{
+    if (Test_failIndices && numElems > 1 && size > 1) {
+        return (NULL);
+    }
+
+    return (__real_calloc(numElems, size));
+}
+
+/*
+ *  ======== decAlloc ========
+ */
+static Int decAlloc(const IALG_Params *params, IALG_Fxns **parentFxns,
+    IALG_MemRec memTab[])
+{
+    memTab[0].size = sizeof (Dec_Obj);
+    memTab[0].alignment = 8;
+    memTab[0].space = IALG_EXTERNAL;
+    memTab[0].attrs = IALG_PERSIST;
+
+    return (1);
+}
+
+/*
+ *  ======== decControl ========
+ *  Report the number of process calls made as the extended error, and
+ *  fill each byte of an extended status with its offset's low byte.
+ */
+static XDAS_Int32 decControl(IVIDDEC2_Handle h, IVIDDEC2_Cmd id,
+    IVIDDEC2_DynamicParams *params, IVIDDEC2_Status *status)
+{
+    XDAS_Int32 i;
+
+    decLog(Test_LOGCONTROL);
+    status->extendedError = ((Dec_Obj *)h)->numCalls;
+
+    for (i = sizeof (IVIDDEC2_Status); i < status->size; i++) {
+        ((UInt8 *)status)[i] = (UInt8)i;
+    }
+
+    return (IVIDDEC2_EOK);
+}
+
+/*
+ *  ======== decFree ========
+ */
+static Int decFree(IALG_Handle alg, IALG_MemRec memTab[])
+{
+    decAlloc(NULL, NULL, memTab);
+    memTab[0].base = alg;
+
+    return (1);
+}
+
+/*
+ *  ======== decInit ========
+ */
+static Int decInit(IALG_Handle alg, const IALG_MemRec memTab[],
+    IALG_Handle parent, const IALG_Params *params)
+{
+    ((Dec_Obj *)alg)->numCalls = 0;
+
+    return (IALG_EOK);
+}
+
+/*
+ *  ======== decLog ========
+ */
+static Void decLog(XDAS_Int32 entry)
+{
+    Int i = __atomic_fetch_add(&Test_decLogLen, 1, __ATOMIC_RELAXED);
+
+    if (i < Test_MAXLOG) {
+        Test_decLog[i] = entry;
+    }
+}
+
+/*
+ *  ======== decNumAlloc ========
+ */
+static Int decNumAlloc(Void)
+{
+    return (1);
+}
+
+/*
+ *  ======== decProcess ========
+ *  Copy the input to the first output buffer, taking Test_decDelay
+ *  microseconds, report that it read the one and wrote the other, and
+ *  return the number of calls made so far.
+ */
+static XDAS_Int32 decProcess(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, IVIDDEC2_InArgs *inArgs,
+    IVIDDEC2_OutArgs *outArgs)
+{
+    Dec_Obj *dec = (Dec_Obj *)h;
+    double start = Test_now();
+    XDAS_Int32 size = inBufs->descs[0].bufSize;
+
+    if (outBufs->bufSizes[0] < size) {
+        size = outBufs->bufSizes[0];
+    }
+    memcpy(outBufs->bufs[0], inBufs->descs[0].buf, size);
+    XDM_SETACCESSMODE_READ(inBufs->descs[0].accessMask);
+
+    /* spin rather than sleep, as a codec would keep the core busy */
+    while (Test_now() - start < Test_decDelay) {
+    }
+
+    decLog(inArgs->numBytes);
+
+    outArgs->bytesConsumed = inArgs->numBytes;
+    outArgs->outputID[0] = 0;
+    outArgs->decodedBufs.numBufs = 1;
+    outArgs->decodedBufs.bufDesc[0].buf = outBufs->bufs[0];
+    outArgs->decodedBufs.bufDesc[0].bufSize = size;
+    XDM_SETACCESSMODE_WRITE(outArgs->decodedBufs.bufDesc[0].accessMask);
+
+    return (++dec->numCalls);
+}
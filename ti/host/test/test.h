@@ -0,0 +1,132 @@
+/*
+ *  ======== test.h ========
+ *  Helpers shared by the host build's test and benchmark programs.
+ *
+ *  test.c also supplies the configuration the runtime expects of an
+ *  application: a "local" engine whose "dec" alg runs in the caller's
+ *  thread, and a "remote" one whose "dec" runs, through the IVIDDEC2 stubs
+ *  and skeleton, in a node thread of the in-process server.  Both run the
+ *  same fake decoder, whose behavior the programs control through the
+ *  Test_dec* variables.  Test_addAlgs() adds more such algs.  Both also
+ *  have an "sph" alg, a fake ISPHDEC1 speech decoder.
+ */
+#ifndef ti_host_test_
+#define ti_host_test_
+
+#include <ti/sdo/ce/speech1/sphdec1.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+
+/*
+ *  ======== Test_check ========
+ *  Count and report a failed check, but carry on.
+ */
+#define Test_check(cond) \
+    ((cond) ? (Void)0 : Test_fail(__FILE__, __LINE__, #cond))
+
+/* most calls of the fake decoder Test_decLog records */
+#define Test_MAXLOG     64
+
+/* what Test_decLog records for a control call */
+#define Test_LOGCONTROL (-1)
+
+/* most algs Test_addAlgs() adds */
+#define Test_MAXALGS    1024
+
+/* most frames of a Test_Batch */
+#define Test_MAXFRAMES  128
+
+/*
+ *  ======== Test_Bufs ========
+ *  The arguments of a VIDDEC2_process() call.
+ */
+typedef struct Test_Bufs {
+    XDM1_BufDesc        inBufs;
+    XDM_BufDesc         outBufs;
+    XDAS_Int8           *outBuf[1];     /* outBufs.bufs */
+    XDAS_Int32          outBufSize[1];  /* outBufs.bufSizes */
+    VIDDEC2_InArgs      inArgs;
+    VIDDEC2_OutArgs     outArgs;
+} Test_Bufs;
+
+/*
+ *  ======== Test_Batch ========
+ *  The arguments of an SPHDEC1_processBatch() call.
+ */
+typedef struct Test_Batch {
+    XDM1_SingleBufDesc  inBufs[Test_MAXFRAMES];
+    XDM1_SingleBufDesc  outBufs[Test_MAXFRAMES];
+    SPHDEC1_InArgs      *inArgs[Test_MAXFRAMES];
+    SPHDEC1_OutArgs     *outArgs[Test_MAXFRAMES];
+    XDAS_Int32          retVals[Test_MAXFRAMES];
+    Int                 numFrames;
+} Test_Batch;
+
+/* microseconds the fake decoder's process calls take */
+extern UInt32 Test_decDelay;
+
+/* if set, the runtime's engine, alg and node indices fail to allocate */
+extern Bool Test_failIndices;
+
+/* batch messages the server's "sph" nodes received */
+extern Int Test_sphBatchMsgs;
+
+/* if set, the "sph" nodes answer batches as a server predating them */
+extern Bool Test_sphOldServer;
+
+/* inArgs->numBytes of the fake decoder's process calls, in call order */
+extern XDAS_Int32 Test_decLog[Test_MAXLOG];
+extern Int Test_decLogLen;
+
+/*
+ *  ======== Test_addAlgs ========
+ *  Before CERuntime_init(), add numAlgs more algs, named "alg0", "alg1"
+ *  and so on, like "dec": to the "local" and "remote" engines and as
+ *  server nodes.
+ */
+extern Void Test_addAlgs(Int numAlgs);
+
+/*
+ *  ======== Test_allocBatch ========
+ *  Allocate numFrames frames for batch, each with a contiguous input and
+ *  output buffer of size bytes filled with the frame's number, and an
+ *  inArgs of inArgsSize bytes whose frameType is that number.  With
+ *  withData, each inArgs also has a contiguous data buffer.
+ */
+extern Void Test_allocBatch(Test_Batch *batch, Int numFrames, UInt size,
+    UInt inArgsSize, Bool withData);
+
+/*
+ *  ======== Test_allocBufs ========
+ *  Allocate one contiguous input and one output buffer of size bytes for
+ *  bufs, and default its inArgs and outArgs.
+ */
+extern Void Test_allocBufs(Test_Bufs *bufs, UInt size);
+
+/*
+ *  ======== Test_exit ========
+ *  Report whether all checks passed and return the program's exit status.
+ */
+extern Int Test_exit(String name);
+
+/*
+ *  ======== Test_fail ========
+ */
+extern Void Test_fail(String file, Int line, String cond);
+
+/*
+ *  ======== Test_freeBatch ========
+ */
+extern Void Test_freeBatch(Test_Batch *batch);
+
+/*
+ *  ======== Test_freeBufs ========
+ */
+extern Void Test_freeBufs(Test_Bufs *bufs);
+
+/*
+ *  ======== Test_now ========
+ *  Monotonic time in microseconds.
+ */
+extern double Test_now(Void);
+
+#endif
@@ -33,6 +33,7 @@ extern "C" {
 
 #include <ti/sdo/ce/Server.h>
 #include <ti/sdo/ce/osal/Comm.h>
+#include <ti/sdo/ce/osal/Memory.h>
 #include <ti/xdais/ialg.h>
 #include <ti/sdo/ce/node/node.h>
 
@@ -81,6 +82,7 @@ typedef Int Engine_Error;
                                  *   a required resource is in use.
                                  */
 #define Engine_ENOTFOUND    15  /**< Entity was not found. */
+#define Engine_ETIMEOUT     16  /**< Timed out waiting for a reply. */
 
 /** @cond INTERNAL */
 
@@ -201,6 +203,31 @@ extern Engine_Config Engine_config;
  */
 extern Int Engine_call(Engine_Node node, Comm_Msg *msg);
 
+/*
+ *  ======== Engine_callAsync ========
+ *  Send msg to node without waiting for the reply; Engine_callWait()
+ *  collects it.
+ */
+extern Int Engine_callAsync(Engine_Node node, Comm_Msg *msg);
+
+/*
+ *  ======== Engine_callPriority ========
+ *  Send msg to node at a Comm priority and wait for its reply.  At
+ *  Comm_PRIORITYHIGH the node serves it ahead of the calls already
+ *  queued; at Comm_PRIORITYNORMAL, after them.  Replies to earlier
+ *  Engine_callAsync()s that arrive first are kept for Engine_callWait(),
+ *  in order.
+ */
+extern Int Engine_callPriority(Engine_Node node, Comm_Msg *msg,
+    Int priority);
+
+/*
+ *  ======== Engine_callWait ========
+ *  Wait up to timeout for the reply to a message sent by
+ *  Engine_callAsync().  Returns Engine_ETIMEOUT if there is none yet.
+ */
+extern Int Engine_callWait(Engine_Node node, Comm_Msg *msg, UInt timeout);
+
 /*
  *  ======== Engine_ctrlNode ========
  */
@@ -215,7 +242,12 @@ extern Int Engine_ctrlNode(Engine_Node node, Comm_Msg *msg, Engine_Ctrl code);
  *  @brief      Close an Engine.
  *
  *  @param[in]  engine          The handle to an engine, previously acquired
- *                              by a call to Engine_open().
+ *                              by a call to Engine_open() or
+ *                              Engine_openShared().
+ *
+ *  @remarks    A handle from Engine_openShared() must be closed once for
+ *              each time it was returned; the engine itself is closed by
+ *              the last of these calls.
  *
  *  @pre        @c engine must not be referenced by any codec instance
  *              object; i.e., you must first delete all codec instances
@@ -301,6 +333,11 @@ extern String Engine_getConstName(Engine_Handle engine, String name,
 extern IALG_Fxns *Engine_getFxns(Engine_Handle svr, String name,
     String type, Bool *isLocal, Ptr *idmaFxns, Ptr *iresFxns, Int *groupId);
 
+/*
+ *  ======== Engine_getMemAccount ========
+ */
+extern Int Engine_getMemAccount(Engine_Handle engine);
+
 /*
  *  ======== Engine_getMemId ========
  */
@@ -348,6 +385,11 @@ extern UInt32 Engine_getRemoteVisa(Engine_Node node);
 extern Ptr Engine_getCodecClassConfig(Engine_Handle engine, String name,
     String type);
 
+/*
+ *  ======== Engine_getNodeFd ========
+ */
+extern Int Engine_getNodeFd(Engine_Node node);
+
 /*
  *  ======== Engine_getNodeQueues ========
  */
@@ -424,6 +466,40 @@ extern Engine_Error Engine_restoreHeap(Server_Handle server, String name);
 extern Engine_Handle Engine_open(String name, Engine_Attrs *attrs,
     Engine_Error *ec);
 
+/*
+ *  ======== Engine_openShared ========
+ */
+/**
+ *  @brief Open an Engine, sharing it with other users of the same engine.
+ *
+ *  All callers passing the same @c name and @c attrs->procId get the same,
+ *  reference counted handle; only the first call actually opens the
+ *  engine, and so loads the server.  Unlike handles from Engine_open(),
+ *  shared handles may be used by several threads concurrently.
+ *
+ *  @param[in]  name            The name of the engine to open.  @c name is
+ *                              specified in the engine configuration.
+ *  @param[in]  attrs           Attributes for the open engine.
+ *  @param[out] ec              Optional output error code
+ *
+ *  @retval     NULL            An error has occurred.
+ *  @retval     non-NULL        The handle to the opened engine.
+ *
+ *  @pre        As for Engine_open().
+ *
+ *  @post       As for Engine_open().
+ *
+ *  @remarks    Each successful call must be matched by an Engine_close().
+ *
+ *  @remarks    Engine_getLastError() on a shared handle reports the last
+ *              error of any of its users.
+ *
+ *  @sa         Engine_open()
+ *  @sa         Engine_close()
+ */
+extern Engine_Handle Engine_openShared(String name, Engine_Attrs *attrs,
+    Engine_Error *ec);
+
 /*
  *  ======== Engine_fwriteTrace ========
  */
@@ -537,6 +613,36 @@ extern Int Engine_getCpuLoad(Engine_Handle engine);
  */
 extern Engine_Error Engine_getLastError(Engine_Handle engine);
 
+/*
+ *  ======== Engine_getMemUsage ========
+ */
+/**
+ *  @brief              Get the memory used by an Engine's codec instances
+ *
+ *  @param[in]  engine  The handle to the opened engine.
+ *  @param[out] stat    Filled with the bytes of contiguous memory (alg
+ *                      memTabs included) the engine's codec instances,
+ *                      local or on its server, have allocated and not
+ *                      freed, their peak, and the numbers of buffers
+ *                      allocated and freed.
+ *
+ *  @retval     #Engine_EOK         Success.
+ *  @retval     #Engine_ENOTAVAIL   The engine's memory isn't accounted,
+ *                                  as all Memory accounts were in use
+ *                                  when it was opened.
+ *
+ *  @pre        @c engine is a valid (non-NULL) engine handle and the engine
+ *              is in the open state.
+ *
+ *  @remarks    Unlike Engine_getUsedMem(), this counts only this engine's
+ *              instances, and doesn't need a server.  VISA_getMemUsage()
+ *              gives the share of each instance.
+ *
+ *  @sa         VISA_getMemUsage()
+ */
+extern Engine_Error Engine_getMemUsage(Engine_Handle engine,
+    Memory_AccountStat *stat);
+
 /*
  *  ======== Engine_getNumAlgs ========
  */
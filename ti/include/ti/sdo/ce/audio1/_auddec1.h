@@ -22,6 +22,18 @@ extern "C" {
 
 #define _AUDDEC1_CPROCESS        0
 #define _AUDDEC1_CCONTROL        1
+#define _AUDDEC1_CPROCESSBATCH   2
+
+/*
+ *  One frame of a batch message.  The frame's inArgs follows it, then its
+ *  outArgs, then padding up to size, where the next frame starts.
+ */
+typedef struct {
+    XDM1_BufDesc        inBufs;
+    XDM1_BufDesc        outBufs;
+    XDAS_Int32          status;     /* returned by process() */
+    XDAS_Int32          size;       /* of this frame, args and padding */
+} _AUDDEC1_BatchFrame;
 
 /* msgq message to decode */
 typedef struct {
@@ -60,6 +72,10 @@ typedef struct {
              */
             UInt8               pad[256];
         } control;
+        struct {
+            XDAS_Int32          numFrames;
+            _AUDDEC1_BatchFrame frame;  /* first of numFrames */
+        } batch;
     } cmd;
 } _AUDDEC1_Msg;
 
@@ -49,6 +49,9 @@ extern "C" {
 /** @copydoc IAUDDEC1_EUNSUPPORTED */
 #define AUDDEC1_EUNSUPPORTED IAUDDEC1_EUNSUPPORTED
 
+/**< Timed out waiting for AUDDEC1_processWait() */
+#define AUDDEC1_ETIMEOUT VISA_ETIMEOUT
+
 
 /**
  *  @brief      Opaque handle to a AUDDEC1 codec.
@@ -173,6 +176,31 @@ extern AUDDEC1_Handle AUDDEC1_create(Engine_Handle e, String name,
  */
 extern Void AUDDEC1_delete(AUDDEC1_Handle handle);
 
+/*
+ *  ======== AUDDEC1_release ========
+ */
+/**
+ *  @brief      Release the instance of an audio decoder algorithm for reuse.
+ *
+ *  @param[in]  handle  Handle to a created audio decoder instance.
+ *
+ *  @remark     The instance is reset with #XDM_RESET and kept idle.  A
+ *              later AUDDEC1_create() of the same algorithm, on the same
+ *              engine and with the same params, returns it instead of
+ *              creating a new instance, which is much faster.
+ *
+ *  @remark     Up to #VISA_maxIdle instances are kept; beyond that, and
+ *              for instances that fail to reset, this is AUDDEC1_delete().
+ *
+ *  @pre        @c handle is a valid (non-NULL) handle which is
+ *              in the created state.
+ *
+ *  @sa         AUDDEC1_create()
+ *  @sa         AUDDEC1_delete()
+ *  @sa         VISA_flush()
+ */
+extern Void AUDDEC1_release(AUDDEC1_Handle handle);
+
 
 /*
  *  ======== AUDDEC1_process ========
@@ -212,6 +240,97 @@ extern Void AUDDEC1_delete(AUDDEC1_Handle handle);
 extern Int32 AUDDEC1_process(AUDDEC1_Handle handle, XDM1_BufDesc *inBufs,
     XDM1_BufDesc *outBufs, AUDDEC1_InArgs *inArgs, AUDDEC1_OutArgs *outArgs);
 
+/*
+ *  ======== AUDDEC1_processAsync ========
+ */
+/**
+ *  @brief      Start the process() method in this instance of a audio decoder
+ *              algorithm, without waiting for it to complete.
+ *
+ *  @param[in]  handle  Handle to a created audio decoder instance.
+ *
+ *  @remark     The other arguments are as for AUDDEC1_process().  They, and
+ *              the buffers they describe, must not be used by the caller
+ *              until the matching AUDDEC1_processWait() has returned.
+ *
+ *  @remark     Up to #VISA_numMsgs calls may be in flight on an instance.
+ *              They complete in the order they were started, and each must
+ *              be collected by a AUDDEC1_processWait() with the same
+ *              arguments, in that order.  On a remote instance, a
+ *              AUDDEC1_control() made meanwhile overtakes the calls not yet
+ *              started, while a AUDDEC1_process() completes after them.
+ *
+ *  @remark     A local instance runs its process() method in
+ *              AUDDEC1_processWait(), in the caller's thread.
+ *
+ *  @retval     #AUDDEC1_EOK         The call was sent.
+ *  @retval     #AUDDEC1_EFAIL       Failure; there is nothing to wait for.
+ *
+ *  @sa         AUDDEC1_processWait()
+ *  @sa         AUDDEC1_process()
+ */
+extern Int32 AUDDEC1_processAsync(AUDDEC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDDEC1_InArgs *inArgs, AUDDEC1_OutArgs *outArgs);
+
+/*
+ *  ======== AUDDEC1_processBatch ========
+ */
+/**
+ *  @brief      Execute the process() method in this instance of an audio
+ *              decoder algorithm, once for each of several frames.
+ *
+ *  @param[in]  handle  Handle to a created audio decoder instance.
+ *  @param[in]  inBufs  The frames' input buffer descriptors.
+ *  @param[out] outBufs The frames' output buffer descriptors.
+ *  @param[in]  inArgs  The frames' input arguments.
+ *  @param[out] outArgs The frames' output arguments.
+ *  @param[in]  numFrames   Number of entries in each of the above arrays.
+ *  @param[out] retVals The value AUDDEC1_process() returned for each
+ *                      frame.
+ *
+ *  @pre        @c handle is a valid (non-NULL) audio decoder handle
+ *              and the audio decoder is in the created state.
+ *
+ *  @retval     #AUDDEC1_EOK         Every frame was decoded successfully.
+ *  @retval     #AUDDEC1_EFAIL       Failure; see @c retVals for the frames
+ *                               that failed.
+ *
+ *  @remark     This is a blocking call.  For a remote instance, the frames
+ *              are sent to the server together, as many to a message as
+ *              will fit, and decoded back-to-back there; short frames
+ *              then cost far fewer round trips than with AUDDEC1_process().
+ *
+ *  @sa         AUDDEC1_process()
+ */
+extern Int32 AUDDEC1_processBatch(AUDDEC1_Handle handle,
+    XDM1_BufDesc inBufs[], XDM1_BufDesc outBufs[],
+    AUDDEC1_InArgs *inArgs[], AUDDEC1_OutArgs *outArgs[], Int numFrames,
+    XDAS_Int32 retVals[]);
+
+/*
+ *  ======== AUDDEC1_processWait ========
+ */
+/**
+ *  @brief      Wait for the process() call started by AUDDEC1_processAsync()
+ *              to complete.
+ *
+ *  @param[in]  handle  Handle to a created audio decoder instance.
+ *  @param[in]  timeout Microseconds to wait, or #VISA_FOREVER.
+ *
+ *  @remark     The other arguments must be those passed to
+ *              AUDDEC1_processAsync(); the outputs are returned through them
+ *              as by AUDDEC1_process().
+ *
+ *  @retval     #AUDDEC1_ETIMEOUT    The data has not been decoded yet; call
+ *                               AUDDEC1_processWait() again.
+ *  @retval     other            As for AUDDEC1_process().
+ *
+ *  @sa         AUDDEC1_processAsync()
+ */
+extern Int32 AUDDEC1_processWait(AUDDEC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDDEC1_InArgs *inArgs, AUDDEC1_OutArgs *outArgs,
+    UInt timeout);
+
 
 /*@}*/
 
@@ -49,6 +49,9 @@ extern "C" {
 /** @copydoc IAUDENC1_EUNSUPPORTED */
 #define AUDENC1_EUNSUPPORTED IAUDENC1_EUNSUPPORTED
 
+/**< Timed out waiting for AUDENC1_processWait() */
+#define AUDENC1_ETIMEOUT VISA_ETIMEOUT
+
 
 /**
  *  @brief      Opaque handle to a AUDENC1 codec.
@@ -173,6 +176,31 @@ extern AUDENC1_Handle AUDENC1_create(Engine_Handle e, String name,
  */
 extern Void AUDENC1_delete(AUDENC1_Handle handle);
 
+/*
+ *  ======== AUDENC1_release ========
+ */
+/**
+ *  @brief      Release the instance of an audio encoder algorithm for reuse.
+ *
+ *  @param[in]  handle  Handle to a created audio encoder instance.
+ *
+ *  @remark     The instance is reset with #XDM_RESET and kept idle.  A
+ *              later AUDENC1_create() of the same algorithm, on the same
+ *              engine and with the same params, returns it instead of
+ *              creating a new instance, which is much faster.
+ *
+ *  @remark     Up to #VISA_maxIdle instances are kept; beyond that, and
+ *              for instances that fail to reset, this is AUDENC1_delete().
+ *
+ *  @pre        @c handle is a valid (non-NULL) handle which is
+ *              in the created state.
+ *
+ *  @sa         AUDENC1_create()
+ *  @sa         AUDENC1_delete()
+ *  @sa         VISA_flush()
+ */
+extern Void AUDENC1_release(AUDENC1_Handle handle);
+
 
 /*
  *  ======== AUDENC1_process ========
@@ -212,6 +240,97 @@ extern Void AUDENC1_delete(AUDENC1_Handle handle);
 extern Int32 AUDENC1_process(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
     XDM1_BufDesc *outBufs, AUDENC1_InArgs *inArgs, AUDENC1_OutArgs *outArgs);
 
+/*
+ *  ======== AUDENC1_processAsync ========
+ */
+/**
+ *  @brief      Start the process() method in this instance of a audio encoder
+ *              algorithm, without waiting for it to complete.
+ *
+ *  @param[in]  handle  Handle to a created audio encoder instance.
+ *
+ *  @remark     The other arguments are as for AUDENC1_process().  They, and
+ *              the buffers they describe, must not be used by the caller
+ *              until the matching AUDENC1_processWait() has returned.
+ *
+ *  @remark     Up to #VISA_numMsgs calls may be in flight on an instance.
+ *              They complete in the order they were started, and each must
+ *              be collected by a AUDENC1_processWait() with the same
+ *              arguments, in that order.  On a remote instance, a
+ *              AUDENC1_control() made meanwhile overtakes the calls not yet
+ *              started, while a AUDENC1_process() completes after them.
+ *
+ *  @remark     A local instance runs its process() method in
+ *              AUDENC1_processWait(), in the caller's thread.
+ *
+ *  @retval     #AUDENC1_EOK         The call was sent.
+ *  @retval     #AUDENC1_EFAIL       Failure; there is nothing to wait for.
+ *
+ *  @sa         AUDENC1_processWait()
+ *  @sa         AUDENC1_process()
+ */
+extern Int32 AUDENC1_processAsync(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDENC1_InArgs *inArgs, AUDENC1_OutArgs *outArgs);
+
+/*
+ *  ======== AUDENC1_processBatch ========
+ */
+/**
+ *  @brief      Execute the process() method in this instance of an audio
+ *              encoder algorithm, once for each of several frames.
+ *
+ *  @param[in]  handle  Handle to a created audio encoder instance.
+ *  @param[in]  inBufs  The frames' input buffer descriptors.
+ *  @param[out] outBufs The frames' output buffer descriptors.
+ *  @param[in]  inArgs  The frames' input arguments.
+ *  @param[out] outArgs The frames' output arguments.
+ *  @param[in]  numFrames   Number of entries in each of the above arrays.
+ *  @param[out] retVals The value AUDENC1_process() returned for each
+ *                      frame.
+ *
+ *  @pre        @c handle is a valid (non-NULL) audio encoder handle
+ *              and the audio encoder is in the created state.
+ *
+ *  @retval     #AUDENC1_EOK         Every frame was encoded successfully.
+ *  @retval     #AUDENC1_EFAIL       Failure; see @c retVals for the frames
+ *                               that failed.
+ *
+ *  @remark     This is a blocking call.  For a remote instance, the frames
+ *              are sent to the server together, as many to a message as
+ *              will fit, and encoded back-to-back there; short frames
+ *              then cost far fewer round trips than with AUDENC1_process().
+ *
+ *  @sa         AUDENC1_process()
+ */
+extern Int32 AUDENC1_processBatch(AUDENC1_Handle handle,
+    XDM1_BufDesc inBufs[], XDM1_BufDesc outBufs[],
+    AUDENC1_InArgs *inArgs[], AUDENC1_OutArgs *outArgs[], Int numFrames,
+    XDAS_Int32 retVals[]);
+
+/*
+ *  ======== AUDENC1_processWait ========
+ */
+/**
+ *  @brief      Wait for the process() call started by AUDENC1_processAsync()
+ *              to complete.
+ *
+ *  @param[in]  handle  Handle to a created audio encoder instance.
+ *  @param[in]  timeout Microseconds to wait, or #VISA_FOREVER.
+ *
+ *  @remark     The other arguments must be those passed to
+ *              AUDENC1_processAsync(); the outputs are returned through them
+ *              as by AUDENC1_process().
+ *
+ *  @retval     #AUDENC1_ETIMEOUT    The data has not been encoded yet; call
+ *                               AUDENC1_processWait() again.
+ *  @retval     other            As for AUDENC1_process().
+ *
+ *  @sa         AUDENC1_processAsync()
+ */
+extern Int32 AUDENC1_processWait(AUDENC1_Handle handle, XDM1_BufDesc *inBufs,
+    XDM1_BufDesc *outBufs, AUDENC1_InArgs *inArgs, AUDENC1_OutArgs *outArgs,
+    UInt timeout);
+
 
 /*@}*/
 
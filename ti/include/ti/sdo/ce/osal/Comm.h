@@ -26,6 +26,41 @@ extern "C" {
  */
 extern UInt32 Comm_MSGSIZE;
 
+/*
+ *  ======== Comm_poolMsgs ========
+ *  Number of Comm_MSGSIZE messages preallocated for Comm_alloc() of 1 KB
+ *  or more, and the most kept idle, beyond those threads cache.
+ */
+extern Int Comm_poolMsgs;
+
+/*
+ *  ======== Comm_PoolStat ========
+ *  Statistics of the message pool, which the counts of cache hits lag
+ *  by up to a few dozen allocations per thread.
+ */
+typedef struct Comm_PoolStat {
+    UInt32 msgSize;     /* size of the pooled messages */
+    UInt32 numMsgs;     /* pooled messages allocated, in use or idle */
+    UInt32 numIdle;     /* idle ones in the pool, not in threads' caches */
+    UInt32 hits;        /* allocations served by the thread's cache */
+    UInt32 misses;      /* allocations that refilled the thread's cache */
+    UInt32 numUnpooled; /* other allocations, from the C heap */
+} Comm_PoolStat;
+
+/*
+ *  ======== Comm_shmName ========
+ *  Name of the POSIX shared memory object linking queues of this process
+ *  with those of one other process, or NULL (the default) to keep all
+ *  queues in this process.  Both processes define it, and the one that
+ *  plays the DSP server also sets Comm_shmServer, calls CERuntime_init()
+ *  and RMS_init(), and keeps running; the other's engines with a server
+ *  name then use that server.  Comm_shmRingSize is the size, rounded up
+ *  to a power of 2, of the server's ring in each direction.
+ */
+extern String Comm_shmName;
+extern Bool Comm_shmServer;
+extern UInt32 Comm_shmRingSize;
+
 /*
  *  ======== Comm_Queue ========
  */
@@ -86,6 +121,17 @@ typedef struct Comm_MsgHeader {
  */
 #define Comm_EOK            0
 #define Comm_EFAIL          1
+#define Comm_ETIMEOUT       2
+
+/*
+ *  ======== message priorities ========
+ *  Comm_get() returns a queue's Comm_PRIORITYHIGH messages ahead of its
+ *  Comm_PRIORITYNORMAL ones, and those of each priority in the order they
+ *  were put.  Comm_alloc() makes messages of normal priority.
+ */
+#define Comm_PRIORITYNORMAL 0
+#define Comm_PRIORITYHIGH   1
+#define Comm_NUMPRIORITIES  2
 
 /*
  *  ======== timeout values ========
@@ -93,6 +139,13 @@ typedef struct Comm_MsgHeader {
 #define Comm_FOREVER        ((UInt)-1)
 #define Comm_POLL           ((UInt)0)
 
+/*
+ *  ======== Comm_isLocal ========
+ *  Whether a queue is in this process, rather than on the other side of
+ *  the Comm_shmName link
+ */
+extern Bool Comm_isLocal(Comm_Queue queue);
+
 /*
  *  ======== Comm_locate ========
  *  Locate an existing communication queue
@@ -111,6 +164,12 @@ extern Int Comm_alloc(UInt16 poolId, Comm_Msg *msg, UInt16 size);
  */
 extern Int Comm_free(Comm_Msg msg);
 
+/*
+ *  ======== Comm_poolStat ========
+ *  Get statistics of the message pool
+ */
+extern Bool Comm_poolStat(Comm_PoolStat *statbuf);
+
 /*
  *  ======== Comm_put ========
  *  Send message to specified communication queue
@@ -123,12 +182,28 @@ extern Int Comm_put(Comm_Queue queue, Comm_Msg msg);
  */
 extern Int Comm_get(Comm_Queue queue, Comm_Msg *msg, UInt timeout);
 
+/*
+ *  ======== Comm_getFd ========
+ *  Get a file descriptor that poll()/epoll report readable while the
+ *  queue has messages, which Comm_get() with Comm_POLL then drains.  Must
+ *  be called by the queue's reader, not while it is in Comm_get().  The
+ *  descriptor belongs to the queue, which closes it when deleted.
+ *  Returns -1 on failure.
+ */
+extern Int Comm_getFd(Comm_Handle msgq);
+
 /*
  *  ======== Comm_getMsgSize ========
  *  Get size of the specified message
  */
 extern Int Comm_getMsgSize(Comm_Msg msg);
 
+/*
+ *  ======== Comm_getPriority ========
+ *  Get the priority of a message
+ */
+extern Int Comm_getPriority(Comm_Msg msg);
+
 /*
  *  ======== Comm_getSrcQueue ========
  *  Get id of sender queue from message
@@ -141,6 +216,21 @@ extern Int Comm_getSrcQueue(Comm_Msg msg, Comm_Queue *queue);
  */
 extern Void Comm_setSrcQueue(Comm_Msg msg, Comm_Queue queue);
 
+/*
+ *  ======== Comm_setMsgSize ========
+ *  Resize a message in place, within the memory it was allocated with,
+ *  which for a pooled message is Comm_MSGSIZE bytes whatever size it was
+ *  allocated at.  Returns Comm_EFAIL if it doesn't fit.
+ */
+extern Int Comm_setMsgSize(Comm_Msg msg, UInt16 size);
+
+/*
+ *  ======== Comm_setPriority ========
+ *  Set the priority, Comm_PRIORITYNORMAL or Comm_PRIORITYHIGH, at which
+ *  a message is queued by Comm_put(); replies keep it
+ */
+extern Void Comm_setPriority(Comm_Msg msg, Int priority);
+
 /*
  *  ======== Comm_create ========
  *  Create a new communication queue
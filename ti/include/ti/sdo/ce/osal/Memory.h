@@ -53,10 +53,173 @@ typedef struct Memory_Stat {
     UInt size;       /**< Original size of segment. */
     UInt used;       /**< Number of bytes used in segment. */
     UInt length;     /**< Length of largest contiguous block. */
+    UInt32 lockAcquires; /**< Times the allocator's lock was taken. */
+    UInt32 lockWaits;    /**< Times a thread had to wait for it. */
 } Memory_Stat;
 
 /** @endcond */
 
+/**
+ *  @brief      Statistics of the contiguous buffer pool.
+ *
+ *  @sa         Memory_poolStat()
+ */
+typedef struct Memory_PoolStat {
+    UInt32 hits;        /**< Pooled allocations served by an idle buffer. */
+    UInt32 misses;      /**< Pooled allocations that needed new memory. */
+    UInt32 numIdle;     /**< Number of idle buffers in the pool, not
+                         *   counting those threads cache.
+                         */
+    UInt32 idleBytes;   /**< Bytes held by those idle buffers. */
+} Memory_PoolStat;
+
+/**
+ *  @brief      The "no account" account.
+ *
+ *  @sa         Memory_setAccount()
+ */
+#define Memory_NOACCOUNT        0
+
+/**
+ *  @brief      Contiguous memory charged to an account.
+ *
+ *  @sa         Memory_getAccountStat()
+ */
+typedef struct Memory_AccountStat {
+    UInt32 used;        /**< Bytes of the buffers charged, and not freed. */
+    UInt32 peak;        /**< Greatest value of @c used. */
+    UInt32 numAllocs;   /**< Number of buffers ever charged. */
+    UInt32 numFrees;    /**< Number of those since freed. */
+} Memory_AccountStat;
+
+/**
+ *  @brief      Maximum number of bytes the contiguous buffer pool keeps
+ *              idle.
+ *
+ *  @remarks    This defaults to 64 MB.  Freed pooled buffers that would
+ *              exceed it are returned to the system.  An application may
+ *              define it as 0 to disable pooling.
+ *
+ *  @remarks    Besides these, each thread caches up to 8 idle buffers of
+ *              each of up to 8 size classes of at most 64 KB, which it
+ *              allocates and frees without taking any lock.
+ */
+extern UInt32 Memory_poolMaxIdle;
+
+/**
+ *  @brief      A buffer to maintain the cache of, in one of a list of
+ *              buffers passed to Memory_cacheInvRanges(),
+ *              Memory_cacheWbRanges() or Memory_cacheWbInvRanges().
+ */
+typedef struct Memory_CacheRange {
+    Ptr addr;           /**< Address of the beginning of the buffer. */
+    Int sizeInBytes;    /**< Size of the buffer. */
+} Memory_CacheRange;
+
+/**
+ *  @brief      Smallest block of the contiguous heap, in bytes.
+ */
+#define Memory_HEAPMINBLOCK     128
+
+/**
+ *  @brief      Number of block sizes in the contiguous heap, from
+ *              #Memory_HEAPMINBLOCK bytes doubling up to 1 GB.
+ */
+#define Memory_HEAPORDERS       24
+
+/**
+ *  @brief      Statistics of the contiguous heap.
+ *
+ *  @sa         Memory_contigHeapStat()
+ */
+typedef struct Memory_HeapStat {
+    UInt32 size;            /**< Size of the heap. */
+    UInt32 used;            /**< Bytes in allocated blocks. */
+    UInt32 largestFree;     /**< Size of the largest free block. */
+    UInt32 numFree[Memory_HEAPORDERS];  /**< Free blocks of each size,
+                                         *   #Memory_HEAPMINBLOCK << i. */
+    Int fragmentation;      /**< Percentage of the free bytes outside the
+                             *   largest free block. */
+} Memory_HeapStat;
+
+/**
+ *  @brief      Size of the heap Memory_CONTIGHEAP allocations come from.
+ *
+ *  @remarks    This defaults to 0, which allocates Memory_CONTIGHEAP
+ *              buffers from the C heap.  An application may define it to
+ *              have a buddy heap of that size mapped by Memory_init();
+ *              its blocks are powers of 2 in size, so each allocation
+ *              may use up to twice its size.
+ */
+extern UInt32 Memory_contigHeapSize;
+
+/**
+ *  @brief      Size of the smallest contiguous buffers backed by huge
+ *              pages.
+ *
+ *  @remarks    This defaults to 0, which uses no huge pages.  If an
+ *              application defines it, pool size classes of at least this
+ *              many bytes are rounded to whole 2 MB huge pages and their
+ *              buffers aligned on them, and the heap, if there is one, is
+ *              mapped on huge pages too.  Those come from hugetlbfs if the
+ *              system has reserved some, or else from transparent huge
+ *              pages.  Code that sweeps frame buffers with the CPU then
+ *              takes far fewer TLB misses.
+ */
+extern UInt32 Memory_hugePageMinSize;
+
+/**
+ *  @brief      Emulate CMEM on a Linux host without cmemk.ko.
+ *
+ *  @remarks    This defaults to FALSE.  An application may define it as
+ *              TRUE to have Memory_init() map a heap of
+ *              #Memory_contigHeapSize bytes (64 MB if that's 0) from a
+ *              memfd and allocate all contiguous buffers, pooled ones
+ *              included, from it.  The buffers get fake physical
+ *              addresses from #Memory_emulatedPhysBase, and, as with
+ *              CMEM, memory outside known contiguous buffers can't be
+ *              translated, so tests of the memory paths behave as they
+ *              would on a device.
+ */
+extern Bool Memory_emulateCmem;
+
+/**
+ *  @brief      Physical address of the start of the emulated CMEM heap.
+ *
+ *  @remarks    This defaults to 0x80000000.  It should be aligned on
+ *              2 MB, and the fake physical addresses must not overlap
+ *              the virtual addresses of memory the application passes
+ *              to the codecs outside contiguous buffers.
+ *
+ *  @sa         Memory_emulateCmem
+ */
+extern UInt32 Memory_emulatedPhysBase;
+
+/**
+ *  @brief      Name of a POSIX shared memory object for the emulated CMEM
+ *              heap, for a server process to map.
+ *
+ *  @remarks    This defaults to NULL, which maps the heap from an
+ *              anonymous memfd.  In a process that also sets
+ *              #Memory_emulateCmem, the heap is mapped from the named
+ *              object instead, which isn't removed at exit, and can't be
+ *              exported by Memory_exportDmaBuf().  In a process that
+ *              doesn't, such as a server linked to the first by
+ *              Comm_shmName, the object is mapped the first time a
+ *              physical address is translated, so the physical addresses
+ *              of the first process's buffers translate to their
+ *              addresses in it.  Both must use the same
+ *              #Memory_emulatedPhysBase.
+ *
+ *  @sa         Memory_emulateCmem
+ */
+extern String Memory_emulatedHeapName;
+
+/**
+ *  @brief      Handle to a buffer registered with Memory_registerBuf().
+ */
+typedef struct Memory_BufObj *Memory_BufHandle;
+
 /**
  *  @brief      Enum values for Memory_AllocParams.type
  *
@@ -167,6 +330,25 @@ extern Ptr Memory_alloc(UInt size, Memory_AllocParams *params);
 extern Void Memory_cacheInv(Ptr addr, Int sizeInBytes);
 
 
+/*
+ *  ======== Memory_cacheInvRanges ========
+ */
+/**
+ *  @brief      Invalidate the cache of a list of buffers.
+ *
+ *  @param[in]  ranges          Array of the buffers to invalidate.
+ *  @param[in]  numRanges       Number of elements in @c ranges.
+ *
+ *  @remarks    This does what calling Memory_cacheInv() on each buffer
+ *              would, but with a single call to the cache driver, so a
+ *              stub or skeleton can maintain all of a call's buffers for
+ *              the cost of one.
+ *
+ *  @sa         Memory_cacheInv()
+ */
+extern Void Memory_cacheInvRanges(Memory_CacheRange ranges[], Int numRanges);
+
+
 /*
  *  ======== Memory_cacheWb ========
  */
@@ -199,6 +381,46 @@ extern Void Memory_cacheWb(Ptr addr, Int sizeInBytes);
 extern Void Memory_cacheWbInv(Ptr addr, Int sizeInBytes);
 
 
+/*
+ *  ======== Memory_cacheWbInvRanges ========
+ */
+/**
+ *  @brief      Write back and invalidate the cache of a list of buffers.
+ *
+ *  @param[in]  ranges          Array of the buffers to writeback and
+ *                              invalidate.
+ *  @param[in]  numRanges       Number of elements in @c ranges.
+ *
+ *  @remarks    Buffers marked clean with Memory_setBufferDirty() are
+ *              skipped, and dirty ones are marked clean once written back.
+ *
+ *  @sa         Memory_cacheWbInv()
+ *  @sa         Memory_cacheInvRanges()
+ *  @sa         Memory_setBufferDirty()
+ */
+extern Void Memory_cacheWbInvRanges(Memory_CacheRange ranges[],
+    Int numRanges);
+
+
+/*
+ *  ======== Memory_cacheWbRanges ========
+ */
+/**
+ *  @brief      Write back the cache of a list of buffers.
+ *
+ *  @param[in]  ranges          Array of the buffers to writeback.
+ *  @param[in]  numRanges       Number of elements in @c ranges.
+ *
+ *  @remarks    Buffers marked clean with Memory_setBufferDirty() are
+ *              skipped, and dirty ones are marked clean once written back.
+ *
+ *  @sa         Memory_cacheWb()
+ *  @sa         Memory_cacheInvRanges()
+ *  @sa         Memory_setBufferDirty()
+ */
+extern Void Memory_cacheWbRanges(Memory_CacheRange ranges[], Int numRanges);
+
+
 /*
  *  ======== Memory_contigAlloc ========
  */
@@ -259,6 +481,22 @@ extern Ptr Memory_contigAlloc(UInt size, UInt align);
  */
 extern Bool Memory_contigFree(Ptr addr, UInt size);
 
+/*
+ *  ======== Memory_contigHeapStat ========
+ */
+/**
+ *  @brief      Obtain the statistics of the contiguous heap.
+ *
+ *  @param[out] statbuf Buffer to fill with statistics data.
+ *
+ *  @retval     TRUE    The statistics were captured, and @c statbuf has been
+ *                      filled.
+ *  @retval     FALSE   There is no heap; #Memory_contigHeapSize is 0.
+ *
+ *  @sa         Memory_contigHeapSize
+ */
+extern Bool Memory_contigHeapStat(Memory_HeapStat *statbuf);
+
 
 /** @cond INTERNAL */
 
@@ -280,6 +518,12 @@ extern Bool Memory_contigFree(Ptr addr, UInt size);
  *  @pre        @c statbuf must be a pointer to memory of size
  *              <tt>sizeof(#Memory_Stat)</tt>.
  *
+ *  @remarks    @c lockAcquires and @c lockWaits count the acquisitions
+ *              of the lock that serializes the allocator's bookkeeping, and
+ *              those that found it held by another thread.  Pooled
+ *              allocations and frees that a thread's cache of idle
+ *              buffers, or its size class' depot, can serve don't take it.
+ *
  *  @sa         Memory_contigAlloc()
  *  @sa         Memory_contigFree()
  */
@@ -288,6 +532,43 @@ extern Bool Memory_contigStat(Memory_Stat *statbuf);
 /** @endcond  */
 
 
+/*
+ *  ======== Memory_createAccount ========
+ */
+/**
+ *  @brief      Create an account to charge contiguous allocations to.
+ *
+ *  @param[in]  parent  An account that is charged, in turn, whatever this
+ *                      one is, or #Memory_NOACCOUNT.
+ *
+ *  @retval     #Memory_NOACCOUNT   All accounts are in use.
+ *  @retval     other               The new account, whose statistics
+ *                                  start at 0.
+ *
+ *  @remarks    The Codec Engine charges the memory of each codec instance
+ *              to an account of its own, whose parent is the account its
+ *              creating thread charges, if any, or else its engine's.
+ *
+ *  @sa         Memory_deleteAccount()
+ *  @sa         Memory_setAccount()
+ */
+extern Int Memory_createAccount(Int parent);
+
+
+/*
+ *  ======== Memory_deleteAccount ========
+ */
+/**
+ *  @brief      Delete an account created by Memory_createAccount().
+ *
+ *  @param[in]  account The account, or #Memory_NOACCOUNT.
+ *
+ *  @remarks    Buffers still charged to @c account can be freed later;
+ *              they are no longer credited to it, or to its parents.
+ */
+extern Void Memory_deleteAccount(Int account);
+
+
 /*
  *  ======== Memory_free ========
  */
@@ -334,6 +615,79 @@ extern Bool Memory_free(Ptr addr, UInt size, Memory_AllocParams *params);
 extern Void Memory_dumpKnownContigBufsList(Void);
 
 
+/*
+ *  ======== Memory_exportDmaBuf ========
+ */
+/**
+ *  @brief      Export a contiguous buffer as a dma-buf, to hand it to
+ *              another driver (e.g. V4L2 or DRM) without copying it.
+ *
+ *  @param[in]  virtualAddress  Address of a buffer allocated by
+ *                              Memory_alloc() or Memory_contigAlloc().
+ *  @param[in]  sizeInBytes     Size of the buffer.
+ *
+ *  @retval     >=0     The dma-buf's file descriptor, which the caller
+ *                      must close.  The buffer must not be freed while
+ *                      the dma-buf is in use.
+ *  @retval     -1      The buffer can't be exported.
+ *
+ *  @remarks    On a Linux host, only buffers of the #Memory_emulateCmem
+ *              heap can be exported, through @c /dev/udmabuf.  The
+ *              buffer must start on a page, and its size is rounded up
+ *              to pages, so it must be at least a page.
+ *
+ *  @sa         Memory_importDmaBuf()
+ */
+extern Int Memory_exportDmaBuf(Ptr virtualAddress, UInt32 sizeInBytes);
+
+
+/*
+ *  ======== Memory_getAccount ========
+ */
+/**
+ *  @brief      Get the account the calling thread charges its contiguous
+ *              allocations to.
+ *
+ *  @retval     The account last set by Memory_setAccount() in this
+ *              thread, or #Memory_NOACCOUNT.
+ */
+extern Int Memory_getAccount(Void);
+
+
+/*
+ *  ======== Memory_getAccountStat ========
+ */
+/**
+ *  @brief      Obtain the memory charged to an account.
+ *
+ *  @param[in]  account The account.
+ *  @param[out] statbuf Buffer to fill with the statistics.
+ *
+ *  @retval     TRUE    @c statbuf has been filled.
+ *  @retval     FALSE   @c account doesn't exist.
+ *
+ *  @remarks    An account's statistics include those of the accounts
+ *              created with it as their parent, so its @c peak is that
+ *              of their sum.
+ */
+extern Bool Memory_getAccountStat(Int account, Memory_AccountStat *statbuf);
+
+
+/*
+ *  ======== Memory_getBufPhysicalAddress ========
+ */
+/**
+ *  @brief      Obtain the physical address of a registered buffer.
+ *
+ *  @param[in]  buf     Handle returned by Memory_registerBuf().
+ *
+ *  @retval     The physical address computed when @c buf was registered.
+ *
+ *  @sa         Memory_registerBuf()
+ */
+extern UInt32 Memory_getBufPhysicalAddress(Memory_BufHandle buf);
+
+
 /*
  *  ======== Memory_getBufferPhysicalAddress ========
  */
@@ -430,6 +784,79 @@ static inline UInt32 Memory_getPhysicalAddress(Ptr virtualAddress)
 extern Ptr Memory_getBufferVirtualAddress(UInt32 physicalAddress,
     Int sizeInBytes);
 
+
+/*
+ *  ======== Memory_importDmaBuf ========
+ */
+/**
+ *  @brief      Map a dma-buf allocated by another driver (e.g. a V4L2
+ *              capture device), and register it as a contiguous buffer.
+ *
+ *  @param[in]  fd          The dma-buf's file descriptor.  The caller may
+ *                          close it once this returns.
+ *  @param[in]  sizeInBytes Size to map, or 0 for all of the dma-buf.
+ *
+ *  @retval     non-NULL    Address of the mapped buffer, which may be used
+ *                          as an XDM buffer, e.g. as the @c buf of an
+ *                          XDM1_SingleBufDesc whose @c bufSize is the
+ *                          buffer's size.
+ *  @retval     NULL        The dma-buf can't be mapped.
+ *
+ *  @remarks    The buffer is registered as Memory_registerContigBuf()
+ *              would, so the VISA stubs translate it.  Its physical
+ *              address is its virtual address on a Linux host, or a fake
+ *              one above the heap's if #Memory_emulateCmem is set.
+ *
+ *  @sa         Memory_exportDmaBuf()
+ *  @sa         Memory_releaseDmaBuf()
+ */
+extern Ptr Memory_importDmaBuf(Int fd, UInt32 sizeInBytes);
+
+
+/*
+ *  ======== Memory_poolReserve ========
+ */
+/**
+ *  @brief      Put idle buffers of a size in the contiguous buffer pool.
+ *
+ *  @param[in]  size    Size of the buffers.
+ *  @param[in]  count   Number of buffers.
+ *
+ *  @retval     TRUE    The buffers were added.
+ *  @retval     FALSE   Memory could not be allocated, or the pool
+ *                      reached #Memory_poolMaxIdle, before @c count
+ *                      buffers were added.
+ *
+ *  @remarks    Memory_contigAlloc() and #Memory_CONTIGPOOL allocations
+ *              are pooled: Memory_contigFree() keeps their memory idle,
+ *              and later allocations of the same size class reuse it.
+ *              Size classes are sizes rounded up to 128 bytes, or to
+ *              4 KB from 4 KB on.
+ *
+ *  @remarks    An application typically calls this once per entry of a
+ *              codec's XDM_AlgBufInfo (e.g. @c minOutBufSize[i], for as
+ *              many frames as its pipeline holds), so that even its first
+ *              frame allocations are served by the pool.
+ *
+ *  @sa         Memory_poolStat()
+ */
+extern Bool Memory_poolReserve(UInt size, Int count);
+
+
+/*
+ *  ======== Memory_poolStat ========
+ */
+/**
+ *  @brief      Obtain the statistics of the contiguous buffer pool.
+ *
+ *  @param[out] statbuf Buffer to fill with the statistics.
+ *
+ *  @retval     TRUE    @c statbuf has been filled.
+ *
+ *  @sa         Memory_poolReserve()
+ */
+extern Bool Memory_poolStat(Memory_PoolStat *statbuf);
+
 /** @cond INTERNAL */
 
 /*
@@ -467,6 +894,39 @@ extern Bool Memory_redefine(Int segId, Uint32 base, Uint32 size);
 
 /** @endcond */
 
+/*
+ *  ======== Memory_registerBuf ========
+ */
+/**
+ *  @brief      Register a buffer the application passes to VISA calls
+ *              repeatedly, such as a decoder's frame buffers.
+ *
+ *  @param[in]  virtualAddress  Base address of the buffer.
+ *  @param[in]  sizeInBytes     Size of the buffer.
+ *
+ *  @retval     NULL            The buffer is not contiguous, is already
+ *                              registered, or the registered buffer
+ *                              table is full.
+ *  @retval     non-NULL        Handle to the registered buffer.
+ *
+ *  @remarks    The buffer's physical address is computed once, here.
+ *              Memory_getBufferPhysicalAddress() and
+ *              Memory_getBufferVirtualAddress() find registered buffers
+ *              by their base addresses without taking the module's lock or
+ *              searching the list of known contiguous buffers, so the
+ *              stubs' per-call translations of them cost a table probe.
+ *              Addresses within a registered buffer are translated as
+ *              before.
+ *
+ *  @remarks    The buffer must be unregistered before it is freed.
+ *
+ *  @sa         Memory_unregisterBuf()
+ *  @sa         Memory_getBufPhysicalAddress()
+ */
+extern Memory_BufHandle Memory_registerBuf(Ptr virtualAddress,
+    Int sizeInBytes);
+
+
 /*
  *  ======== Memory_registerContigBuf ========
  */
@@ -502,6 +962,23 @@ extern Bool Memory_redefine(Int segId, Uint32 base, Uint32 size);
 extern Void Memory_registerContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
     UInt32 physicalAddress);
 
+
+/*
+ *  ======== Memory_releaseDmaBuf ========
+ */
+/**
+ *  @brief      Unregister and unmap a dma-buf mapped by
+ *              Memory_importDmaBuf().
+ *
+ *  @param[in]  virtualAddress  Address Memory_importDmaBuf() returned.
+ *
+ *  @retval     TRUE    The buffer was released.
+ *  @retval     FALSE   @c virtualAddress isn't an imported dma-buf.
+ *
+ *  @sa         Memory_importDmaBuf()
+ */
+extern Bool Memory_releaseDmaBuf(Ptr virtualAddress);
+
 /** @cond INTERNAL */
 
 /*
@@ -585,6 +1062,92 @@ extern Bool Memory_segStat(Int segId, Memory_Stat *statbuf);
 
 /** @endcond */
 
+/*
+ *  ======== Memory_setAccount ========
+ */
+/**
+ *  @brief      Set the account the calling thread charges its contiguous
+ *              allocations to.
+ *
+ *  @param[in]  account The account, or #Memory_NOACCOUNT to charge none.
+ *
+ *  @retval     The account the thread charged until now, for the caller
+ *              to restore.
+ *
+ *  @remarks    Each buffer Memory_contigAlloc() or Memory_alloc() returns
+ *              is charged to the account then set, and credited back to
+ *              it when freed, by whichever thread.
+ *
+ *  @sa         Memory_getAccountStat()
+ */
+extern Int Memory_setAccount(Int account);
+
+/*
+ *  ======== Memory_setAccountParent ========
+ */
+/**
+ *  @brief      Move an account under another parent.
+ *
+ *  @param[in]  account The account.
+ *  @param[in]  parent  Its new parent, or #Memory_NOACCOUNT.
+ *
+ *  @retval     TRUE    The memory charged to @c account is now charged to
+ *                      @c parent and its parents, instead of the old ones.
+ *  @retval     FALSE   @c account does not exist, or @c parent is
+ *                      @c account or one of its children.
+ *
+ *  @remarks    The Codec Engine moves an idle codec instance's account
+ *              under the account its new creator would charge.
+ *
+ *  @remarks    No buffer charged to @c account should be allocated or
+ *              freed meanwhile.
+ *
+ *  @sa         Memory_createAccount()
+ */
+extern Bool Memory_setAccountParent(Int account, Int parent);
+
+/*
+ *  ======== Memory_setBufferDirty ========
+ */
+/**
+ *  @brief      Record whether the CPU has written a contiguous buffer since
+ *              its cache was last written back.
+ *
+ *  @param[in]  addr    Address of a buffer allocated by Memory_contigAlloc()
+ *                      or registered with Memory_registerContigBuf().
+ *  @param[in]  dirty   TRUE if the CPU has written the buffer.
+ *
+ *  @retval     TRUE    The flag was set.
+ *  @retval     FALSE   @c addr isn't in a known contiguous buffer.
+ *
+ *  @remarks    Until this is first called on a buffer, the VISA stubs
+ *              write back its cache on every call.  From then on they
+ *              write it back only while it is marked dirty, and mark it
+ *              clean when they do, so an application that tracks a buffer
+ *              must mark it dirty each time it writes to it.  This saves
+ *              the writeback of large buffers only the remote processor
+ *              writes, such as a decoder's reference frames.
+ *
+ *  @sa         Memory_cacheWbRanges()
+ *  @sa         Memory_cacheWbInvRanges()
+ */
+extern Bool Memory_setBufferDirty(Ptr addr, Bool dirty);
+
+/*
+ *  ======== Memory_unregisterBuf ========
+ */
+/**
+ *  @brief      Unregister a buffer registered with Memory_registerBuf().
+ *
+ *  @param[in]  buf     Handle returned by Memory_registerBuf().
+ *
+ *  @remarks    @c buf is invalid once this returns.
+ *
+ *  @sa         Memory_registerBuf()
+ */
+extern Void Memory_unregisterBuf(Memory_BufHandle buf);
+
+
 /*
  *  ======== Memory_unregisterContigBuf ========
  */
@@ -98,6 +98,9 @@ typedef struct RMS_CmdSetCreateNodeIn {
                                         * allocating alg's memory, 0: use
                                         * algAlloc() mem requests.
                                         */
+    RMS_Word    memAccount;            /* host only: Memory account the
+                                        * node's memory is charged to
+                                        */
     /* todo: include node attrs and other things */
 } RMS_CmdSetCreateNodeIn;
 
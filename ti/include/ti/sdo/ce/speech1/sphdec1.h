@@ -49,6 +49,9 @@ extern "C" {
 /** @copydoc ISPHDEC1_EUNSUPPORTED */
 #define SPHDEC1_EUNSUPPORTED ISPHDEC1_EUNSUPPORTED
 
+/**< Timed out waiting for SPHDEC1_processWait() */
+#define SPHDEC1_ETIMEOUT VISA_ETIMEOUT
+
 
 /**
  *  @brief      Opaque handle to a SPHDEC1 codec.
@@ -173,6 +176,31 @@ extern SPHDEC1_Handle SPHDEC1_create(Engine_Handle e, String name,
  */
 extern Void SPHDEC1_delete(SPHDEC1_Handle handle);
 
+/*
+ *  ======== SPHDEC1_release ========
+ */
+/**
+ *  @brief      Release the instance of a speech decoder algorithm for reuse.
+ *
+ *  @param[in]  handle  Handle to a created speech decoder instance.
+ *
+ *  @remark     The instance is reset with #XDM_RESET and kept idle.  A
+ *              later SPHDEC1_create() of the same algorithm, on the same
+ *              engine and with the same params, returns it instead of
+ *              creating a new instance, which is much faster.
+ *
+ *  @remark     Up to #VISA_maxIdle instances are kept; beyond that, and
+ *              for instances that fail to reset, this is SPHDEC1_delete().
+ *
+ *  @pre        @c handle is a valid (non-NULL) handle which is
+ *              in the created state.
+ *
+ *  @sa         SPHDEC1_create()
+ *  @sa         SPHDEC1_delete()
+ *  @sa         VISA_flush()
+ */
+extern Void SPHDEC1_release(SPHDEC1_Handle handle);
+
 
 /*
  *  ======== SPHDEC1_process ========
@@ -213,6 +241,98 @@ extern Int32 SPHDEC1_process(SPHDEC1_Handle handle,
     XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
     SPHDEC1_InArgs *inArgs, SPHDEC1_OutArgs *outArgs);
 
+/*
+ *  ======== SPHDEC1_processAsync ========
+ */
+/**
+ *  @brief      Start the process() method in this instance of a speech decoder
+ *              algorithm, without waiting for it to complete.
+ *
+ *  @param[in]  handle  Handle to a created speech decoder instance.
+ *
+ *  @remark     The other arguments are as for SPHDEC1_process().  They, and
+ *              the buffers they describe, must not be used by the caller
+ *              until the matching SPHDEC1_processWait() has returned.
+ *
+ *  @remark     Up to #VISA_numMsgs calls may be in flight on an instance.
+ *              They complete in the order they were started, and each must
+ *              be collected by a SPHDEC1_processWait() with the same
+ *              arguments, in that order.  On a remote instance, a
+ *              SPHDEC1_control() made meanwhile overtakes the calls not yet
+ *              started, while a SPHDEC1_process() completes after them.
+ *
+ *  @remark     A local instance runs its process() method in
+ *              SPHDEC1_processWait(), in the caller's thread.
+ *
+ *  @retval     #SPHDEC1_EOK         The call was sent.
+ *  @retval     #SPHDEC1_EFAIL       Failure; there is nothing to wait for.
+ *
+ *  @sa         SPHDEC1_processWait()
+ *  @sa         SPHDEC1_process()
+ */
+extern Int32 SPHDEC1_processAsync(SPHDEC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHDEC1_InArgs *inArgs, SPHDEC1_OutArgs *outArgs);
+
+/*
+ *  ======== SPHDEC1_processBatch ========
+ */
+/**
+ *  @brief      Execute the process() method in this instance of a speech
+ *              decoder algorithm, once for each of several frames.
+ *
+ *  @param[in]  handle  Handle to a created speech decoder instance.
+ *  @param[in]  inBufs  The frames' input buffer descriptors.
+ *  @param[out] outBufs The frames' output buffer descriptors.
+ *  @param[in]  inArgs  The frames' input arguments.
+ *  @param[out] outArgs The frames' output arguments.
+ *  @param[in]  numFrames   Number of entries in each of the above arrays.
+ *  @param[out] retVals The value SPHDEC1_process() returned for each
+ *                      frame.
+ *
+ *  @pre        @c handle is a valid (non-NULL) speech decoder handle
+ *              and the speech decoder is in the created state.
+ *
+ *  @retval     #SPHDEC1_EOK         Every frame was decoded successfully.
+ *  @retval     #SPHDEC1_EFAIL       Failure; see @c retVals for the frames
+ *                               that failed.
+ *
+ *  @remark     This is a blocking call.  For a remote instance, the frames
+ *              are sent to the server together, as many to a message as
+ *              will fit, and decoded back-to-back there; short frames
+ *              then cost far fewer round trips than with SPHDEC1_process().
+ *
+ *  @sa         SPHDEC1_process()
+ */
+extern Int32 SPHDEC1_processBatch(SPHDEC1_Handle handle,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    SPHDEC1_InArgs *inArgs[], SPHDEC1_OutArgs *outArgs[], Int numFrames,
+    XDAS_Int32 retVals[]);
+
+/*
+ *  ======== SPHDEC1_processWait ========
+ */
+/**
+ *  @brief      Wait for the process() call started by SPHDEC1_processAsync()
+ *              to complete.
+ *
+ *  @param[in]  handle  Handle to a created speech decoder instance.
+ *  @param[in]  timeout Microseconds to wait, or #VISA_FOREVER.
+ *
+ *  @remark     The other arguments must be those passed to
+ *              SPHDEC1_processAsync(); the outputs are returned through them
+ *              as by SPHDEC1_process().
+ *
+ *  @retval     #SPHDEC1_ETIMEOUT    The data has not been decoded yet; call
+ *                               SPHDEC1_processWait() again.
+ *  @retval     other            As for SPHDEC1_process().
+ *
+ *  @sa         SPHDEC1_processAsync()
+ */
+extern Int32 SPHDEC1_processWait(SPHDEC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHDEC1_InArgs *inArgs, SPHDEC1_OutArgs *outArgs, UInt timeout);
+
 
 /*@}*/
 
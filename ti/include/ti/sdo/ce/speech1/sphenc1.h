@@ -49,6 +49,9 @@ extern "C" {
 /** @copydoc ISPHENC1_EUNSUPPORTED */
 #define SPHENC1_EUNSUPPORTED ISPHENC1_EUNSUPPORTED
 
+/**< Timed out waiting for SPHENC1_processWait() */
+#define SPHENC1_ETIMEOUT VISA_ETIMEOUT
+
 
 /**
  *  @brief      Opaque handle to a SPHENC1 codec.
@@ -173,6 +176,31 @@ extern SPHENC1_Handle SPHENC1_create(Engine_Handle e, String name,
  */
 extern Void SPHENC1_delete(SPHENC1_Handle handle);
 
+/*
+ *  ======== SPHENC1_release ========
+ */
+/**
+ *  @brief      Release the instance of a speech encoder algorithm for reuse.
+ *
+ *  @param[in]  handle  Handle to a created speech encoder instance.
+ *
+ *  @remark     The instance is reset with #XDM_RESET and kept idle.  A
+ *              later SPHENC1_create() of the same algorithm, on the same
+ *              engine and with the same params, returns it instead of
+ *              creating a new instance, which is much faster.
+ *
+ *  @remark     Up to #VISA_maxIdle instances are kept; beyond that, and
+ *              for instances that fail to reset, this is SPHENC1_delete().
+ *
+ *  @pre        @c handle is a valid (non-NULL) handle which is
+ *              in the created state.
+ *
+ *  @sa         SPHENC1_create()
+ *  @sa         SPHENC1_delete()
+ *  @sa         VISA_flush()
+ */
+extern Void SPHENC1_release(SPHENC1_Handle handle);
+
 
 /*
  *  ======== SPHENC1_process ========
@@ -213,6 +241,98 @@ extern Int32 SPHENC1_process(SPHENC1_Handle handle,
     XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
     SPHENC1_InArgs *inArgs, SPHENC1_OutArgs *outArgs);
 
+/*
+ *  ======== SPHENC1_processAsync ========
+ */
+/**
+ *  @brief      Start the process() method in this instance of a speech encoder
+ *              algorithm, without waiting for it to complete.
+ *
+ *  @param[in]  handle  Handle to a created speech encoder instance.
+ *
+ *  @remark     The other arguments are as for SPHENC1_process().  They, and
+ *              the buffers they describe, must not be used by the caller
+ *              until the matching SPHENC1_processWait() has returned.
+ *
+ *  @remark     Up to #VISA_numMsgs calls may be in flight on an instance.
+ *              They complete in the order they were started, and each must
+ *              be collected by a SPHENC1_processWait() with the same
+ *              arguments, in that order.  On a remote instance, a
+ *              SPHENC1_control() made meanwhile overtakes the calls not yet
+ *              started, while a SPHENC1_process() completes after them.
+ *
+ *  @remark     A local instance runs its process() method in
+ *              SPHENC1_processWait(), in the caller's thread.
+ *
+ *  @retval     #SPHENC1_EOK         The call was sent.
+ *  @retval     #SPHENC1_EFAIL       Failure; there is nothing to wait for.
+ *
+ *  @sa         SPHENC1_processWait()
+ *  @sa         SPHENC1_process()
+ */
+extern Int32 SPHENC1_processAsync(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHENC1_InArgs *inArgs, SPHENC1_OutArgs *outArgs);
+
+/*
+ *  ======== SPHENC1_processBatch ========
+ */
+/**
+ *  @brief      Execute the process() method in this instance of a speech
+ *              encoder algorithm, once for each of several frames.
+ *
+ *  @param[in]  handle  Handle to a created speech encoder instance.
+ *  @param[in]  inBufs  The frames' input buffer descriptors.
+ *  @param[out] outBufs The frames' output buffer descriptors.
+ *  @param[in]  inArgs  The frames' input arguments.
+ *  @param[out] outArgs The frames' output arguments.
+ *  @param[in]  numFrames   Number of entries in each of the above arrays.
+ *  @param[out] retVals The value SPHENC1_process() returned for each
+ *                      frame.
+ *
+ *  @pre        @c handle is a valid (non-NULL) speech encoder handle
+ *              and the speech encoder is in the created state.
+ *
+ *  @retval     #SPHENC1_EOK         Every frame was encoded successfully.
+ *  @retval     #SPHENC1_EFAIL       Failure; see @c retVals for the frames
+ *                               that failed.
+ *
+ *  @remark     This is a blocking call.  For a remote instance, the frames
+ *              are sent to the server together, as many to a message as
+ *              will fit, and encoded back-to-back there; short frames
+ *              then cost far fewer round trips than with SPHENC1_process().
+ *
+ *  @sa         SPHENC1_process()
+ */
+extern Int32 SPHENC1_processBatch(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc inBufs[], XDM1_SingleBufDesc outBufs[],
+    SPHENC1_InArgs *inArgs[], SPHENC1_OutArgs *outArgs[], Int numFrames,
+    XDAS_Int32 retVals[]);
+
+/*
+ *  ======== SPHENC1_processWait ========
+ */
+/**
+ *  @brief      Wait for the process() call started by SPHENC1_processAsync()
+ *              to complete.
+ *
+ *  @param[in]  handle  Handle to a created speech encoder instance.
+ *  @param[in]  timeout Microseconds to wait, or #VISA_FOREVER.
+ *
+ *  @remark     The other arguments must be those passed to
+ *              SPHENC1_processAsync(); the outputs are returned through them
+ *              as by SPHENC1_process().
+ *
+ *  @retval     #SPHENC1_ETIMEOUT    The data has not been encoded yet; call
+ *                               SPHENC1_processWait() again.
+ *  @retval     other            As for SPHENC1_process().
+ *
+ *  @sa         SPHENC1_processAsync()
+ */
+extern Int32 SPHENC1_processWait(SPHENC1_Handle handle,
+    XDM1_SingleBufDesc *inBuf, XDM1_SingleBufDesc *outBuf,
+    SPHENC1_InArgs *inArgs, SPHENC1_OutArgs *outArgs, UInt timeout);
+
 
 /*@}*/
 
@@ -50,6 +50,9 @@ typedef IVIDENC1_Status VIDENC1_Status;       /**< @copydoc IVIDENC1_Status */
 /**< @copydoc IVIDENC1_EUNSUPPORTED */
 #define VIDENC1_EUNSUPPORTED IVIDENC1_EUNSUPPORTED
 
+/**< Timed out waiting for VIDENC1_processWait() */
+#define VIDENC1_ETIMEOUT VISA_ETIMEOUT
+
 
 /**
  *  @brief      Opaque handle to a VIDENC1 codec.
@@ -164,6 +167,63 @@ extern VIDENC1_Handle VIDENC1_create(Engine_Handle e, String name,
 extern Int32 VIDENC1_process(VIDENC1_Handle handle, IVIDEO1_BufDescIn *inBufs,
     XDM_BufDesc *outBufs, VIDENC1_InArgs *inArgs, VIDENC1_OutArgs *outArgs);
 
+/*
+ *  ======== VIDENC1_processAsync ========
+ */
+/**
+ *  @brief      Start the process() method in this instance of a video encoder
+ *              algorithm, without waiting for it to complete.
+ *
+ *  @param[in]  handle  Handle to a created video encoder instance.
+ *
+ *  @remark     The other arguments are as for VIDENC1_process().  They, and
+ *              the buffers they describe, must not be used by the caller
+ *              until the matching VIDENC1_processWait() has returned.
+ *
+ *  @remark     Up to #VISA_numMsgs calls may be in flight on an instance.
+ *              They complete in the order they were started, and each must
+ *              be collected by a VIDENC1_processWait() with the same
+ *              arguments, in that order.  On a remote instance, a
+ *              VIDENC1_control() made meanwhile overtakes the calls not yet
+ *              started, while a VIDENC1_process() completes after them.
+ *
+ *  @remark     A local instance runs its process() method in
+ *              VIDENC1_processWait(), in the caller's thread.
+ *
+ *  @retval     #VIDENC1_EOK         The call was sent.
+ *  @retval     #VIDENC1_EFAIL       Failure; there is nothing to wait for.
+ *
+ *  @sa         VIDENC1_processWait()
+ *  @sa         VIDENC1_process()
+ */
+extern Int32 VIDENC1_processAsync(VIDENC1_Handle handle,
+    IVIDEO1_BufDescIn *inBufs, XDM_BufDesc *outBufs, VIDENC1_InArgs *inArgs,
+    VIDENC1_OutArgs *outArgs);
+
+/*
+ *  ======== VIDENC1_processWait ========
+ */
+/**
+ *  @brief      Wait for the process() call started by VIDENC1_processAsync()
+ *              to complete.
+ *
+ *  @param[in]  handle  Handle to a created video encoder instance.
+ *  @param[in]  timeout Microseconds to wait, or #VISA_FOREVER.
+ *
+ *  @remark     The other arguments must be those passed to
+ *              VIDENC1_processAsync(); the outputs are returned through them
+ *              as by VIDENC1_process().
+ *
+ *  @retval     #VIDENC1_ETIMEOUT    The data has not been encoded yet; call
+ *                               VIDENC1_processWait() again.
+ *  @retval     other            As for VIDENC1_process().
+ *
+ *  @sa         VIDENC1_processAsync()
+ */
+extern Int32 VIDENC1_processWait(VIDENC1_Handle handle,
+    IVIDEO1_BufDescIn *inBufs, XDM_BufDesc *outBufs, VIDENC1_InArgs *inArgs,
+    VIDENC1_OutArgs *outArgs, UInt timeout);
+
 
 /*
  *  ======== VIDENC1_control ========
@@ -216,6 +276,31 @@ extern Int32 VIDENC1_control(VIDENC1_Handle handle, VIDENC1_Cmd id,
  */
 extern Void VIDENC1_delete(VIDENC1_Handle handle);
 
+/*
+ *  ======== VIDENC1_release ========
+ */
+/**
+ *  @brief      Release the instance of a video encoder algorithm for reuse.
+ *
+ *  @param[in]  handle  Handle to a created video encoder instance.
+ *
+ *  @remark     The instance is reset with #XDM_RESET and kept idle.  A
+ *              later VIDENC1_create() of the same algorithm, on the same
+ *              engine and with the same params, returns it instead of
+ *              creating a new instance, which is much faster.
+ *
+ *  @remark     Up to #VISA_maxIdle instances are kept; beyond that, and
+ *              for instances that fail to reset, this is VIDENC1_delete().
+ *
+ *  @pre        @c handle is a valid (non-NULL) handle which is
+ *              in the created state.
+ *
+ *  @sa         VIDENC1_create()
+ *  @sa         VIDENC1_delete()
+ *  @sa         VISA_flush()
+ */
+extern Void VIDENC1_release(VIDENC1_Handle handle);
+
 /*@}*/  /* ingroup */
 
 #ifdef __cplusplus
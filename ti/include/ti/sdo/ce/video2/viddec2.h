@@ -50,6 +50,9 @@ typedef IVIDDEC2_Status VIDDEC2_Status;       /**< @copydoc IVIDDEC2_Status */
 /**< @copydoc IVIDDEC2_EUNSUPPORTED */
 #define VIDDEC2_EUNSUPPORTED IVIDDEC2_EUNSUPPORTED
 
+/**< Timed out waiting for VIDDEC2_processWait() */
+#define VIDDEC2_ETIMEOUT VISA_ETIMEOUT
+
 
 /**
  *  @brief      Opaque handle to a VIDDEC2 codec.
@@ -164,6 +167,62 @@ extern VIDDEC2_Handle VIDDEC2_create(Engine_Handle e, String name,
 extern Int32 VIDDEC2_process(VIDDEC2_Handle handle, XDM1_BufDesc *inBufs,
     XDM_BufDesc *outBufs, VIDDEC2_InArgs *inArgs, VIDDEC2_OutArgs *outArgs);
 
+/*
+ *  ======== VIDDEC2_processAsync ========
+ */
+/**
+ *  @brief      Start the process() method in this instance of a video decoder
+ *              algorithm, without waiting for it to complete.
+ *
+ *  @param[in]  handle  Handle to a created video decoder instance.
+ *
+ *  @remark     The other arguments are as for VIDDEC2_process().  They, and
+ *              the buffers they describe, must not be used by the caller
+ *              until the matching VIDDEC2_processWait() has returned.
+ *
+ *  @remark     Up to #VISA_numMsgs calls may be in flight on an instance.
+ *              They complete in the order they were started, and each must
+ *              be collected by a VIDDEC2_processWait() with the same
+ *              arguments, in that order.  On a remote instance, a
+ *              VIDDEC2_control() made meanwhile overtakes the calls not yet
+ *              started, while a VIDDEC2_process() completes after them.
+ *
+ *  @remark     A local instance runs its process() method in
+ *              VIDDEC2_processWait(), in the caller's thread.
+ *
+ *  @retval     #VIDDEC2_EOK         The call was sent.
+ *  @retval     #VIDDEC2_EFAIL       Failure; there is nothing to wait for.
+ *
+ *  @sa         VIDDEC2_processWait()
+ *  @sa         VIDDEC2_process()
+ */
+extern Int32 VIDDEC2_processAsync(VIDDEC2_Handle handle, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, VIDDEC2_InArgs *inArgs, VIDDEC2_OutArgs *outArgs);
+
+/*
+ *  ======== VIDDEC2_processWait ========
+ */
+/**
+ *  @brief      Wait for the process() call started by VIDDEC2_processAsync()
+ *              to complete.
+ *
+ *  @param[in]  handle  Handle to a created video decoder instance.
+ *  @param[in]  timeout Microseconds to wait, or #VISA_FOREVER.
+ *
+ *  @remark     The other arguments must be those passed to
+ *              VIDDEC2_processAsync(); the outputs are returned through them
+ *              as by VIDDEC2_process().
+ *
+ *  @retval     #VIDDEC2_ETIMEOUT    The data has not been decoded yet; call
+ *                               VIDDEC2_processWait() again.
+ *  @retval     other            As for VIDDEC2_process().
+ *
+ *  @sa         VIDDEC2_processAsync()
+ */
+extern Int32 VIDDEC2_processWait(VIDDEC2_Handle handle, XDM1_BufDesc *inBufs,
+    XDM_BufDesc *outBufs, VIDDEC2_InArgs *inArgs, VIDDEC2_OutArgs *outArgs,
+    UInt timeout);
+
 
 /*
  *  ======== VIDDEC2_control ========
@@ -216,6 +275,31 @@ extern Int32 VIDDEC2_control(VIDDEC2_Handle handle, VIDDEC2_Cmd id,
  */
 extern Void VIDDEC2_delete(VIDDEC2_Handle handle);
 
+/*
+ *  ======== VIDDEC2_release ========
+ */
+/**
+ *  @brief      Release the instance of a video decoder algorithm for reuse.
+ *
+ *  @param[in]  handle  Handle to a created video decoder instance.
+ *
+ *  @remark     The instance is reset with #XDM_RESET and kept idle.  A
+ *              later VIDDEC2_create() of the same algorithm, on the same
+ *              engine and with the same params, returns it instead of
+ *              creating a new instance, which is much faster.
+ *
+ *  @remark     Up to #VISA_maxIdle instances are kept; beyond that, and
+ *              for instances that fail to reset, this is VIDDEC2_delete().
+ *
+ *  @pre        @c handle is a valid (non-NULL) handle which is
+ *              in the created state.
+ *
+ *  @sa         VIDDEC2_create()
+ *  @sa         VIDDEC2_delete()
+ *  @sa         VISA_flush()
+ */
+extern Void VIDDEC2_release(VIDDEC2_Handle handle);
+
 /*@}*/  /* ingroup */
 
 #ifdef __cplusplus
@@ -71,6 +71,47 @@ typedef Int VISA_Status;
  */
 #define VISA_EFAIL   -2
 
+/**
+ *  @brief      Timed out waiting for an asynchronous call.
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ *
+ *  @remarks    -3 is skipped; the class APIs return it as XDM_EUNSUPPORTED.
+ */
+#define VISA_ETIMEOUT   -4
+
+/**
+ *  @brief      Timeout value to wait forever.
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ */
+#define VISA_FOREVER    ((UInt)-1)
+
+/**
+ *  @brief      Timeout value to not wait at all.
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ */
+#define VISA_POLL       ((UInt)0)
+
+/**
+ *  @brief      Number of messages, and so of calls in flight, per remote
+ *              algorithm instance.
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ *
+ *  @remarks    This defaults to 1.  An application may define it, e.g. as 2,
+ *              so that the next call is already queued on the server when
+ *              the current one completes.
+ */
+extern UInt VISA_numMsgs;
+
+/**
+ *  @brief      Maximum number of idle algorithm instances kept for reuse
+ *              by VISA_release().
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ *
+ *  @remarks    This defaults to 4.  An application may define it as 0 to
+ *              have VISA_release() simply delete instances.
+ */
+extern UInt VISA_maxIdle;
+
 /**
  *  @brief      Opaque handle to a node.
  */
@@ -94,25 +135,79 @@ typedef struct VISA_MsgHeader {
  */
 typedef VISA_MsgHeader *VISA_Msg;
 
+/**
+ *  @brief      Whether a remote algorithm wrote the buffer an
+ *              XDM1_SingleBufDesc describes.
+ *
+ *  @ingroup    ti_sdo_ce_VISA_STUB
+ *
+ *  @remarks    Stubs clear the accessMask of each buffer descriptor they
+ *              marshall, for the algorithm to declare its access in.  A
+ *              mask still clear after the call means the algorithm didn't
+ *              say, and is taken to mean it may have written the buffer.
+ */
+#define VISA_WROTEBUF(desc) \
+    ((desc).accessMask == 0 || XDM_ISACCESSMODE_WRITE((desc).accessMask))
+
 /*
  *  ======== VISA_allocMsg ========
  */
 /**
- *  @brief      Obtain an algorithm instance's message.
+ *  @brief      Obtain an algorithm instance's next free message.
  *
  *  @ingroup    ti_sdo_ce_VISA_STUB
  *
  *  @param[in]  visa        Handle to an algorithm instance.
  *
- *  @retval     NULL        General system error
+ *  @retval     NULL        All of the instance's messages are in flight
  *  @retval     non-NULL    The remote algorithm's message.
  *
  *  @remarks    This is typically called by an algorithm class' stub.
  *
- *  @sa         VISA_allocMsg()
+ *  @remarks    Successive calls return the same message until it is sent
+ *              with VISA_call() or VISA_callAsync().
+ *
+ *  @remarks    The message holds at least #Comm_MSGSIZE bytes.  Stubs
+ *              that know how much of it they use should call
+ *              VISA_allocMsg2() instead.
+ *
+ *  @sa         VISA_allocMsg2()
  */
 extern VISA_Msg VISA_allocMsg(VISA_Handle visa);
 
+/*
+ *  ======== VISA_allocMsg2 ========
+ */
+/**
+ *  @brief      Obtain an algorithm instance's next free message, holding
+ *              at least @c size bytes.
+ *
+ *  @ingroup    ti_sdo_ce_VISA_STUB
+ *
+ *  @param[in]  visa        Handle to an algorithm instance.
+ *  @param[in]  size        Size of the message, in bytes, including its
+ *                          VISA_MsgHeader.
+ *
+ *  @retval     NULL        @c size exceeds the 64 KB a message can hold,
+ *                          or the message could not be allocated.
+ *  @retval     non-NULL    The remote algorithm's message.
+ *
+ *  @remarks    This is typically called by an algorithm class' stub, with
+ *              a size computed from the @c size fields of the args it
+ *              marshals.
+ *
+ *  @remarks    While all of the instance's #VISA_numMsgs messages are in
+ *              flight, this returns one that only VISA_call() or
+ *              VISA_callUrgent() can send.
+ *
+ *  @remarks    The message is grown, if need be, before it is returned,
+ *              so the caller must not expect anything it wrote into an
+ *              earlier return of the message to still be there.
+ *
+ *  @sa         VISA_allocMsg()
+ */
+extern VISA_Msg VISA_allocMsg2(VISA_Handle visa, size_t size);
+
 /*
  *  ======== VISA_call ========
  */
@@ -128,12 +223,98 @@ extern VISA_Msg VISA_allocMsg(VISA_Handle visa);
  *
  *  @remarks    This is typically called by an algorithm class' stub.
  *
+ *  @remarks    The call may be made while calls sent by VISA_callAsync()
+ *              are in flight, and is served after them.  They are still
+ *              collected by VISA_wait(), in order.
+ *
  *  @retval         VISA_EOK        Success
+ *  @retval         VISA_EFAIL      @c msg is not the instance's free
+ *                                  message
  *  @retval         VISA_ERUNTIME   General system error
  *
+ *  @sa         VISA_callUrgent()
  */
 extern VISA_Status VISA_call(VISA_Handle visa, VISA_Msg *msg);
 
+/*
+ *  ======== VISA_callUrgent ========
+ */
+/**
+ *  @brief      Invoke the operation specified in the message ahead of the
+ *              calls in flight, and wait for it to complete.
+ *
+ *  @ingroup    ti_sdo_ce_VISA_STUB
+ *
+ *  @param[in]  visa    Handle to an algorithm instance.
+ *  @param[out] msg     The remote algorithm's message,
+ *                          to be sent to the skeleton.
+ *
+ *  @remarks    This is typically called by an algorithm class' control()
+ *              stub.  The call overtakes those sent by VISA_callAsync()
+ *              that the skeleton hasn't started yet, so it waits for no
+ *              more than the one in progress.  The calls in flight are
+ *              still collected by VISA_wait(), in order.
+ *
+ *  @retval         VISA_EOK        Success
+ *  @retval         VISA_EFAIL      @c msg is not the instance's free
+ *                                  message
+ *  @retval         VISA_ERUNTIME   General system error
+ *
+ *  @sa         VISA_call()
+ */
+extern VISA_Status VISA_callUrgent(VISA_Handle visa, VISA_Msg *msg);
+
+/*
+ *  ======== VISA_callAsync ========
+ */
+/**
+ *  @brief      Send the operation specified in the message without waiting
+ *              for it to complete.
+ *
+ *  @ingroup    ti_sdo_ce_VISA_STUB
+ *
+ *  @param[in]  visa    Handle to an algorithm instance.
+ *  @param[in]  msg     The remote algorithm's message,
+ *                          to be sent to the skeleton.
+ *
+ *  @remarks    @c msg must be the message last returned by
+ *              VISA_allocMsg().  Up to #VISA_numMsgs calls may be in
+ *              flight; each is collected by a VISA_wait(), in the order
+ *              they were sent.
+ *
+ *  @retval         VISA_EOK        Success
+ *  @retval         VISA_EFAIL      @c msg is not the next free message
+ *  @retval         VISA_ERUNTIME   General system error
+ *
+ *  @sa         VISA_wait()
+ */
+extern VISA_Status VISA_callAsync(VISA_Handle visa, VISA_Msg *msg);
+
+/*
+ *  ======== VISA_wait ========
+ */
+/**
+ *  @brief      Wait for the oldest operation sent by VISA_callAsync() to
+ *              complete.
+ *
+ *  @ingroup    ti_sdo_ce_VISA_STUB
+ *
+ *  @param[in]  visa    Handle to an algorithm instance.
+ *  @param[out] msg     The remote algorithm's message,
+ *                          as returned by the skeleton, or NULL if
+ *                          no reply was collected.
+ *  @param[in]  timeout Microseconds to wait, #VISA_POLL, or #VISA_FOREVER.
+ *
+ *  @retval         VISA_ETIMEOUT   The operation has not completed yet;
+ *                                  it is still in flight.
+ *  @retval         VISA_EFAIL      No call is in flight
+ *  @retval         VISA_ERUNTIME   General system error
+ *  @retval         other           The status returned by the skeleton
+ *
+ *  @sa         VISA_callAsync()
+ */
+extern VISA_Status VISA_wait(VISA_Handle visa, VISA_Msg *msg, UInt timeout);
+
 /*
  *  ======== VISA_freeMsg ========
  */
@@ -208,6 +389,42 @@ extern VISA_Handle VISA_create(Engine_Handle engine, String name,
  */
 extern Void VISA_delete(VISA_Handle visa);
 
+/*
+ *  ======== VISA_release ========
+ */
+/**
+ *  @brief      Release an instance of an algorithm for reuse.
+ *
+ *  @param[in]  visa    Handle to an algorithm instance to release.
+ *
+ *  @remarks    The instance is kept idle, and a later VISA_create() with
+ *              the same engine, name, type and creation params returns it
+ *              rather than creating a new instance.  The caller must have
+ *              reset the algorithm, e.g. with an XDM_RESET control call.
+ *
+ *  @remarks    When #VISA_maxIdle instances are already idle, the least
+ *              recently released one is deleted.
+ *
+ *  @sa         VISA_create()
+ *  @sa         VISA_flush()
+ */
+extern Void VISA_release(VISA_Handle visa);
+
+/*
+ *  ======== VISA_flush ========
+ */
+/**
+ *  @brief      Delete idle algorithm instances kept by VISA_release().
+ *
+ *  @param[in]  engine  Engine whose idle instances to delete, or NULL to
+ *                      delete all of them.
+ *
+ *  @remarks    Engine_close() does this for the engine being closed.
+ *
+ *  @sa         VISA_release()
+ */
+extern Void VISA_flush(Engine_Handle engine);
+
 
 /*
  *  ======== VISA_create2 ========
@@ -376,6 +593,73 @@ extern Void VISA_getContext(VISA_Handle visa, UInt32 * pContext);
  */
 extern Ptr VISA_getCodecClassConfig(VISA_Handle visa);
 
+/*
+ *  ======== VISA_getFd ========
+ */
+/**
+ *  @brief      Get a file descriptor to poll for the completion of an
+ *              algorithm instance's asynchronous calls
+ *
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ *
+ *  @param[in]  visa        Handle to an algorithm instance.
+ *
+ *  @retval     >=0         A descriptor that poll(), select() and epoll
+ *                          report readable while a call started by
+ *                          VISA_callAsync() (e.g. by a class'
+ *                          processAsync()) has completed and not been
+ *                          collected.
+ *  @retval     -1          The instance is local, so its calls complete
+ *                          in the wait call itself, or no descriptor
+ *                          could be created.
+ *
+ *  @pre        @c visa <b>must</b> be a valid algorithm instance handle.
+ *
+ *  @remarks    This lets an event loop serve many instances without a
+ *              thread blocked in each.  When the descriptor is readable,
+ *              collect the completed calls with VISA_wait() (or the
+ *              class' processWait()) and a #VISA_POLL timeout, until it
+ *              returns #VISA_ETIMEOUT; don't read the descriptor.
+ *
+ *  @remarks    Call this from the thread that collects the instance's
+ *              calls, while it isn't waiting for one.  The descriptor is
+ *              closed when the instance is deleted.
+ *
+ *  @sa         VISA_wait()
+ */
+extern Int VISA_getFd(VISA_Handle visa);
+
+/*
+ *  ======== VISA_getMemUsage ========
+ */
+/**
+ *  @brief      Get the memory used by an algorithm instance
+ *
+ *  @ingroup    ti_sdo_ce_VISA_GEN
+ *
+ *  @param[in]  visa        Handle to an algorithm instance.
+ *  @param[out] stat        Filled with the bytes of contiguous memory (its
+ *                          memTabs included) the instance, local or
+ *                          remote, has allocated and not freed, their
+ *                          peak, and the numbers of buffers allocated and
+ *                          freed.
+ *
+ *  @retval     #VISA_EOK   Success.
+ *  @retval     #VISA_EFAIL The instance's memory isn't accounted, as all
+ *                          Memory accounts were in use when it was
+ *                          created.
+ *
+ *  @pre        @c visa <b>must</b> be a valid algorithm instance handle.
+ *
+ *  @remarks    Only memory allocated while the instance is created is
+ *              counted; the instance's messages, and the buffers the
+ *              application passes it, are not.
+ *
+ *  @sa         Engine_getMemUsage()
+ */
+extern VISA_Status VISA_getMemUsage(VISA_Handle visa,
+    Memory_AccountStat *stat);
+
 /*
  *  ======== VISA_isChecked ========
  */